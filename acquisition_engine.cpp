@@ -0,0 +1,644 @@
+#include "acquisition_engine.h"
+#include <QDebug>
+#include <QByteArray>
+#include <QDateTime>
+#include <QTime>
+#include <cstring>
+#include "can_rx_tx.h"
+#include "can_timestamp.h"
+#include "can_command_codec.h"
+
+AcquisitionEngine::AcquisitionEngine(QObject *parent)
+    : QObject(parent)
+    , m_canTxRx(nullptr)
+    , m_paramDictionary(new ParamDictionary(this))
+    , m_requestTimer(new QTimer(this))
+    , m_nodeId(5)
+    , m_isAcquiring(false)
+    , m_startTime(0)
+    , m_requestCount(0)
+    , m_responseCount(0)
+{
+    m_requestTimer->setInterval(DEFAULT_REQUEST_INTERVAL_MS);
+    m_requestTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_requestTimer, &QTimer::timeout, this, &AcquisitionEngine::requestParameters);
+}
+
+AcquisitionEngine::~AcquisitionEngine()
+{
+    stop();
+    if (m_canTxRx) {
+        m_canTxRx->dispatcher()->unsubscribe(this);
+    }
+}
+
+void AcquisitionEngine::setCANTxRx(CANTxRx *canTxRx)
+{
+    if (m_canTxRx) {
+        m_canTxRx->dispatcher()->unsubscribe(this);
+    }
+    m_canTxRx = canTxRx;
+    if (!m_canTxRx) {
+        qWarning() << "【数据采集】CANTxRx为空，无法连接信号";
+        return;
+    }
+
+    // 只订阅数据上抛协议帧 (0x500-0x5FF)，按批次投递到本对象所在线程
+    int subscription = m_canTxRx->dispatcher()->subscribeRange(0x500, 0x5FF, this,
+            [this](const CANFrameBatch &frames) {
+        processFrames(frames);
+    });
+
+    if (subscription >= 0) {
+        qDebug() << "【数据采集】✅ CAN数据上抛协议订阅成功";
+    } else {
+        qCritical() << "【数据采集】❌ CAN数据上抛协议订阅失败！";
+    }
+}
+
+void AcquisitionEngine::setNodeId(uint8_t nodeId)
+{
+    m_nodeId = nodeId;
+}
+
+void AcquisitionEngine::setChannelConfigs(const QVector<ChannelConfig> &configs)
+{
+    m_channelConfigs = configs;
+}
+
+void AcquisitionEngine::setChannelParameter(int channelIndex, uint16_t index, uint8_t subindex)
+{
+    if (channelIndex < 0 || channelIndex >= m_channelConfigs.size())
+        return;
+    m_channelConfigs[channelIndex].parameterIndex = index;
+    m_channelConfigs[channelIndex].parameterSubindex = subindex;
+    m_channelConfigs[channelIndex].parameterName = getParameterName(index, subindex);
+}
+
+int AcquisitionEngine::enabledChannelCount() const
+{
+    int enabled = 0;
+    for (const auto& config : m_channelConfigs) {
+        if (config.enabled) {
+            enabled++;
+        }
+    }
+    return enabled;
+}
+
+void AcquisitionEngine::setRequestInterval(int intervalMs)
+{
+    m_requestTimer->setInterval(qMax(1, intervalMs));
+}
+
+void AcquisitionEngine::start()
+{
+    if (m_isAcquiring) {
+        qDebug() << "【采集】已经在采集中，忽略";
+        return;
+    }
+    m_isAcquiring = true;
+
+    // 只有在第一次采集或数据被清空后才设置起始时间
+    if (m_startTime <= 0) {
+        m_startTime = canMonotonicUs() / 1000000.0;
+        qDebug() << "【采集】设置新的startTime =" << m_startTime;
+    } else {
+        qDebug() << "【采集】使用现有的startTime =" << m_startTime << "，继续从上次位置采集";
+    }
+
+    // 重置统计
+    m_requestCount = 0;
+    m_responseCount = 0;
+    m_requestTimer->start();
+
+    int enabledChannels = enabledChannelCount();
+    qDebug() << "【采集】总通道数:" << m_channelConfigs.size() << "启用通道数:" << enabledChannels;
+    if (enabledChannels > 0) {
+        qDebug() << "【采集】第一个启用通道: index=0x" << QString::number(m_channelConfigs[0].parameterIndex, 16)
+                 << " subindex=0x" << QString::number(m_channelConfigs[0].parameterSubindex, 16);
+    } else {
+        qCritical() << "【采集】❌ 错误：没有启用的通道，数据采集将无法工作！";
+    }
+
+    emit acquisitionStateChanged(true);
+}
+
+void AcquisitionEngine::stop()
+{
+    if (!m_isAcquiring) {
+        return;
+    }
+    m_isAcquiring = false;
+    m_requestTimer->stop();
+    emit acquisitionStateChanged(false);
+}
+
+void AcquisitionEngine::resetTimeBase()
+{
+    m_startTime = -1.0;
+}
+
+// ==================== CAN通信函数 ====================
+
+uint32_t AcquisitionEngine::buildUpdateCOBId(uint8_t cmdType, uint8_t nodeId)
+{
+    return UPDATE_COB_ID_BASE + (cmdType << 4) + (nodeId & 0x0F);
+}
+
+void AcquisitionEngine::sendCANFrame(const VCI_CAN_OBJ &frame)
+{
+    // 详细打印发送的CAN数据
+    QString dataHex = "";
+    for (int i = 0; i < frame.DataLen; i++) {
+        dataHex += QString("%1 ").arg(frame.Data[i], 2, 16, QLatin1Char('0')).toUpper();
+    }
+    
+    qDebug() << QString("【CAN发送详情】ID:0x%1 Len:%2 Data:[%3]")
+                .arg(frame.ID, 0, 16)
+                .arg(frame.DataLen)
+                .arg(dataHex.trimmed());
+    
+    if (m_canTxRx) {
+        m_canTxRx->sendCANFrame(frame);
+        qDebug() << "【CAN发送】已调用m_canTxRx->sendCANFrame()";
+    } else {
+        qCritical() << "【CAN发送】❌ m_canTxRx为空，无法发送CAN帧！";
+    }
+}
+
+void AcquisitionEngine::sendParameterRead(uint8_t nodeId, uint16_t index, uint8_t subindex)
+{
+    uint32_t cobId = buildUpdateCOBId(UPDATE_CMD_READ_SINGLE, nodeId);
+    
+    // 每10次请求打印一次调试信息（减少打印频率）
+    static int debugCount = 0;
+    if (++debugCount % 10 == 0) {
+        qDebug() << QString("【CAN发送】NodeID:%1 Index:0x%2 SubIndex:0x%3 COB-ID:0x%4")
+                    .arg(nodeId)
+                    .arg(index, 4, 16, QLatin1Char('0'))
+                    .arg(subindex, 2, 16, QLatin1Char('0'))
+                    .arg(cobId, 0, 16);
+    }
+    
+    sendCANFrame(canEncodeUpdateRead(cobId, index, subindex));
+}
+
+void AcquisitionEngine::sendMultiParameterRead(uint8_t nodeId, uint16_t index1, uint8_t subindex1, uint16_t index2, uint8_t subindex2)
+{
+    uint32_t cobId = buildUpdateCOBId(UPDATE_CMD_READ_MULTI, nodeId);
+    
+    // 每10次请求打印一次调试信息（减少打印频率）
+    static int debugCount = 0;
+    if (++debugCount % 10 == 0) {
+        qDebug() << QString("【CAN多通道发送】NodeID:%1 Ch1:0x%2:0x%3 Ch2:0x%4:0x%5 COB-ID:0x%6")
+                    .arg(nodeId)
+                    .arg(index1, 4, 16, QLatin1Char('0'))
+                    .arg(subindex1, 2, 16, QLatin1Char('0'))
+                    .arg(index2, 4, 16, QLatin1Char('0'))
+                    .arg(subindex2, 2, 16, QLatin1Char('0'))
+                    .arg(cobId, 0, 16);
+    }
+    
+    sendCANFrame(canEncodeUpdateReadMulti(cobId, index1, subindex1, index2, subindex2));
+}
+
+void AcquisitionEngine::processFrames(const CANFrameBatch &frames)
+{
+    // 一批数据上抛协议帧只占一个界面事件
+    for (const VCI_CAN_OBJ &frame : frames) {
+        processFrame(frame);
+    }
+}
+
+void AcquisitionEngine::processFrame(const VCI_CAN_OBJ &frame)
+{
+    static int frameCount = 0;
+    frameCount++;
+    
+    // 详细打印接收的CAN数据
+    QString dataHex = "";
+    for (int i = 0; i < frame.DataLen; i++) {
+        dataHex += QString("%1 ").arg(frame.Data[i], 2, 16, QLatin1Char('0')).toUpper();
+    }
+    
+    qDebug() << QString("【CAN接收详情】ID:0x%1 Len:%2 Data:[%3]")
+                .arg(frame.ID, 0, 16)
+                .arg(frame.DataLen)
+                .arg(dataHex.trimmed());
+    
+    // 每10帧打印一次统计日志
+    if (frameCount % 10 == 0) {
+        qDebug() << "【CAN接收统计】已接收" << frameCount << "帧";
+    }
+    
+    // 更新接收计数
+    m_responseCount++;
+    
+    // 解析CAN帧并添加到示波器
+    parseScopeFrame(frame);
+}
+
+void AcquisitionEngine::parseScopeFrame(const VCI_CAN_OBJ &frame)
+{
+    // 添加基本安全检查
+    if (!frame.Data || frame.DataLen < 4 || frame.DataLen > 8) {
+        qDebug() << "【示波器】无效的CAN帧：DataLen=" << frame.DataLen;
+        return; // 无效的CAN帧
+    }
+    
+    if(frame.ID>0x5ff  || frame.ID <0x500)
+        return;
+    // 使用正确的COB-ID解析方式
+    uint8_t receivedNodeId = frame.ID & 0x0F;  // 低4位是NodeID
+    uint8_t cmdType = (frame.ID >> 4) & 0x0F; // 高4位是命令类型
+    uint8_t expectedNodeId = m_nodeId;
+    
+    qDebug() << QString("【COB-ID解析】ID:0x%1 NodeID:%2 CmdType:%3")
+                .arg(frame.ID, 0, 16)
+                .arg(receivedNodeId)
+                .arg(cmdType);
+    
+    // 只处理与当前请求匹配的响应数据
+    if (receivedNodeId != expectedNodeId) {
+        // 不是我们请求的节点，忽略
+        qDebug() << QString("【示波器过滤】忽略NodeID %1，期望 %2").arg(receivedNodeId).arg(expectedNodeId);
+        return;
+    }
+    
+    // 打印接收到的CAN帧信息
+    QString dataHex = "";
+    for (int i = 0; i < frame.DataLen; i++) {
+        dataHex += QString("%1 ").arg(frame.Data[i], 2, 16, QLatin1Char('0')).toUpper();
+    }
+    qDebug() << QString("【示波器解析】ID:0x%1 Len:%2 Data:[%3]")
+                .arg(frame.ID, 0, 16)
+                .arg(frame.DataLen)
+                .arg(dataHex.trimmed());
+    
+    // 根据当前启用的通道数量决定解析方式
+    try {
+        // 检查当前启用的通道数量
+        int enabledChannelCount = 0;
+        for (const auto& config : m_channelConfigs) {
+            if (config.enabled) {
+                enabledChannelCount++;
+            }
+        }
+        
+        // 如果启用的通道数量为2，解析为多通道数据
+        if (enabledChannelCount == 2 && cmdType == UPDATE_CMD_RESPONSE && frame.DataLen == 8) {
+            // 多通道响应：前4个字节是第一个通道的数据，后4个字节是第二个通道的数据
+            qDebug() << "【示波器解析】检测到多通道响应数据，通道数:" << enabledChannelCount;
+            
+            // 解析第一个通道的数据（前4个字节）
+            parseMultiChannelData(frame, 0, 4, receivedNodeId);
+            
+            // 解析第二个通道的数据（后4个字节）
+            parseMultiChannelData(frame, 4, 8, receivedNodeId);
+        } else {
+            // 单通道响应：解析参数数据（使用已解析的NodeID）
+            uint16_t parameterIndex = (frame.Data[0] << 8) | frame.Data[1];
+            uint8_t parameterSubindex = frame.Data[2];
+            
+            qDebug() << QString("【示波器解析】NodeID:%1 Index:0x%2 SubIndex:0x%3")
+                        .arg(receivedNodeId)
+                        .arg(parameterIndex, 4, 16, QLatin1Char('0'))
+                        .arg(parameterSubindex, 2, 16, QLatin1Char('0'));
+            
+            // 获取参数值（从第4字节开始）
+            if (frame.DataLen >= 8) {
+                // 根据参数字典解析数据
+                ODEntry paramEntry = m_paramDictionary->getParameter(parameterIndex, parameterSubindex);
+                
+                if (paramEntry.index != 0) { // 找到参数定义
+                    float floatValue = 0.0f;
+                    
+                    // 根据参数类型解析数据
+                    switch (paramEntry.type) {
+                        case OD_TYPE_FLOAT:
+                            memcpy(&floatValue, &frame.Data[4], 4);
+                            break;
+                        case OD_TYPE_INT32:
+                            {
+                                int32_t intValue;
+                                memcpy(&intValue, &frame.Data[4], 4);
+                                floatValue = static_cast<float>(intValue);
+                            }
+                            break;
+                        case OD_TYPE_UINT32:
+                            {
+                                uint32_t uintValue;
+                                memcpy(&uintValue, &frame.Data[4], 4);
+                                floatValue = static_cast<float>(uintValue);
+                            }
+                            break;
+                        case OD_TYPE_INT16:
+                            {
+                                int16_t intValue;
+                                memcpy(&intValue, &frame.Data[4], 2);
+                                floatValue = static_cast<float>(intValue);
+                            }
+                            break;
+                        case OD_TYPE_UINT16:
+                            {
+                                uint16_t uintValue;
+                                memcpy(&uintValue, &frame.Data[4], 2);
+                                floatValue = static_cast<float>(uintValue);
+                            }
+                            break;
+                        case OD_TYPE_INT8:
+                            {
+                                int8_t intValue;
+                                memcpy(&intValue, &frame.Data[4], 1);
+                                floatValue = static_cast<float>(intValue);
+                            }
+                            break;
+                        case OD_TYPE_UINT8:
+                            {
+                                uint8_t uintValue;
+                                memcpy(&uintValue, &frame.Data[4], 1);
+                                floatValue = static_cast<float>(uintValue);
+                            }
+                            break;
+                        default:
+                            // 默认按32位整数处理
+                            {
+                                int32_t intValue;
+                                memcpy(&intValue, &frame.Data[4], 4);
+                                floatValue = static_cast<float>(intValue);
+                            }
+                            break;
+                    }
+                    
+                    // 检查数据有效性
+                    if (!qIsNaN(floatValue) && !qIsInf(floatValue)) {
+                        // 帧到达总线的时间（接收线程已映射为主机单调时间），不受界面排队延迟影响
+                        double currentTime = canFrameTimeSec(frame);
+                        
+                        // 如果是第一次接收数据，设置起始时间
+                        if (m_startTime <= 0) {
+                            m_startTime = currentTime;
+                        }
+                        
+                        // 计算相对时间戳（相对于起始时间）
+                        double relativeTime = currentTime - m_startTime;
+
+                        // 根据通道配置确定通道名称
+                        QString channelName;
+                        QString displayName;
+                        
+                        // 查找匹配的通道配置
+                        bool foundMatchingChannel = false;
+                        for (const auto& config : m_channelConfigs) {
+                            if (config.enabled && 
+                                config.parameterIndex == parameterIndex && 
+                                config.parameterSubindex == parameterSubindex) {
+                                channelName = QString("CH%1_%2").arg(config.channelIndex + 1).arg(paramEntry.name);
+                                displayName = QString("通道%1: %2 (%3)").arg(config.channelIndex + 1).arg(paramEntry.name).arg(paramEntry.unit);
+                                foundMatchingChannel = true;
+                                break;
+                            }
+                        }
+                        
+                        // 如果没有找到匹配的通道配置，使用默认通道名称
+                        if (!foundMatchingChannel) {
+                            channelName = QString("CH%1_%2").arg(expectedNodeId).arg(paramEntry.name);
+                            displayName = QString("%1 (%2)").arg(paramEntry.name).arg(paramEntry.unit);
+                        }
+                            
+                        emit dataPointAdded(channelName, relativeTime, floatValue, displayName);
+                    }
+                } else {
+                    // 未找到参数定义，使用原始数据
+                    int32_t paramValue;
+                    memcpy(&paramValue, &frame.Data[4], 4);
+                    float floatValue = static_cast<float>(paramValue);
+                    
+                    qDebug() << QString("【示波器原始数据】参数值:0x%1 (%2)")
+                                .arg(paramValue, 8, 16, QLatin1Char('0'))
+                                .arg(floatValue, 0, 'f', 3);
+                    
+                    // 帧到达总线的时间
+                    double currentTime = canFrameTimeSec(frame);
+                    
+                    // 如果是第一次接收数据，设置起始时间
+                    if (m_startTime <= 0) {
+                        m_startTime = currentTime;
+                    }
+                    
+                    // 计算相对时间戳（相对于起始时间）
+                    double relativeTime = currentTime - m_startTime;
+
+                    // 添加数据点到示波器
+                    QString paramName = QString("参数0x%1.%2").arg(parameterIndex, 4, 16, QLatin1Char('0')).arg(parameterSubindex, 2, 16, QLatin1Char('0'));
+                    QString channelName = QString("CH%1_%2").arg(expectedNodeId).arg(paramName);
+                    
+                    qDebug() << QString("【示波器原始数据】通道:%1 时间:%2 值:%3")
+                                .arg(channelName)
+                                .arg(relativeTime, 0, 'f', 3)
+                                .arg(floatValue, 0, 'f', 3);
+                    
+                    emit dataPointAdded(channelName, relativeTime, floatValue, paramName);
+                }
+            }
+        }
+    } catch (const std::exception &e) {
+        qDebug() << "解析CAN帧时发生异常:" << e.what();
+    } catch (...) {
+        qDebug() << "解析CAN帧时发生未知异常";
+    }
+}
+
+void AcquisitionEngine::parseMultiChannelData(const VCI_CAN_OBJ &frame, int startByte, int endByte, uint8_t nodeId)
+{
+    // 解析4字节数据
+    if (endByte - startByte != 4) {
+        qDebug() << "【多通道解析】数据长度错误，期望4字节，实际" << (endByte - startByte) << "字节";
+        return;
+    }
+    
+    // 根据通道索引确定通道配置
+    int channelIndex = (startByte == 0) ? 0 : 1; // 前4字节是通道1，后4字节是通道2
+    
+    // 查找匹配的通道配置
+    ChannelConfig* channelConfig = nullptr;
+    for (auto& config : m_channelConfigs) {
+        if (config.enabled && config.channelIndex == channelIndex) {
+            channelConfig = &config;
+            break;
+        }
+    }
+    
+    if (!channelConfig) {
+        qDebug() << QString("【多通道解析】未找到通道%1的配置").arg(channelIndex + 1);
+        return;
+    }
+    
+    // 帧到达总线的时间
+    double currentTime = canFrameTimeSec(frame);
+    
+    // 如果是第一次接收数据，设置起始时间
+    if (m_startTime <= 0) {
+        m_startTime = currentTime;
+    }
+    
+    // 计算相对时间戳（相对于起始时间）
+    double relativeTime = currentTime - m_startTime;
+    
+    // 根据参数类型解析数据
+    float floatValue = 0.0f;
+    
+    // 获取参数定义
+    ODEntry paramEntry = m_paramDictionary->getParameter(channelConfig->parameterIndex, channelConfig->parameterSubindex);
+    
+    if (paramEntry.index != 0) { // 找到参数定义
+        // 根据参数类型解析数据
+        switch (paramEntry.type) {
+            case OD_TYPE_FLOAT:
+                memcpy(&floatValue, &frame.Data[startByte], 4);
+                break;
+            case OD_TYPE_INT32:
+                {
+                    int32_t intValue;
+                    memcpy(&intValue, &frame.Data[startByte], 4);
+                    floatValue = static_cast<float>(intValue);
+                }
+                break;
+            case OD_TYPE_UINT32:
+                {
+                    uint32_t uintValue;
+                    memcpy(&uintValue, &frame.Data[startByte], 4);
+                    floatValue = static_cast<float>(uintValue);
+                }
+                break;
+            case OD_TYPE_INT16:
+                {
+                    int16_t intValue;
+                    memcpy(&intValue, &frame.Data[startByte], 2);
+                    floatValue = static_cast<float>(intValue);
+                }
+                break;
+            case OD_TYPE_UINT16:
+                {
+                    uint16_t uintValue;
+                    memcpy(&uintValue, &frame.Data[startByte], 2);
+                    floatValue = static_cast<float>(uintValue);
+                }
+                break;
+            case OD_TYPE_INT8:
+                {
+                    int8_t intValue;
+                    memcpy(&intValue, &frame.Data[startByte], 1);
+                    floatValue = static_cast<float>(intValue);
+                }
+                break;
+            case OD_TYPE_UINT8:
+                {
+                    uint8_t uintValue;
+                    memcpy(&uintValue, &frame.Data[startByte], 1);
+                    floatValue = static_cast<float>(uintValue);
+                }
+                break;
+            default:
+                // 默认按32位整数处理
+                {
+                    int32_t intValue;
+                    memcpy(&intValue, &frame.Data[startByte], 4);
+                    floatValue = static_cast<float>(intValue);
+                }
+                break;
+        }
+    } else {
+        // 未找到参数定义，使用原始数据
+        int32_t paramValue;
+        memcpy(&paramValue, &frame.Data[startByte], 4);
+        floatValue = static_cast<float>(paramValue);
+    }
+    
+    // 检查数据有效性
+    if (qIsNaN(floatValue) || qIsInf(floatValue)) {
+        qDebug() << "【多通道解析】无效数据值:" << floatValue;
+        return;
+    }
+    
+    // 生成通道名称和显示名称
+    QString channelName = QString("CH%1_%2").arg(channelIndex + 1).arg(channelConfig->parameterName);
+    QString displayName = QString("通道%1: %2").arg(channelIndex + 1).arg(channelConfig->parameterName);
+    
+    qDebug() << QString("【多通道解析】通道%1 时间:%2 值:%3 参数:%4")
+                .arg(channelIndex + 1)
+                .arg(relativeTime, 0, 'f', 3)
+                .arg(floatValue, 0, 'f', 3)
+                .arg(channelConfig->parameterName);
+    
+    // 发送数据点到示波器
+    emit dataPointAdded(channelName, relativeTime, floatValue, displayName);
+}
+
+void AcquisitionEngine::requestParameters()
+{
+    static int callCount = 0;
+    static QTime lastSecondTime = QTime::currentTime();
+    static qint64 lastSendTimeMs = 0;
+    
+    callCount++;
+    
+    // 每秒统计
+    QTime currentTime = QTime::currentTime();
+    if (lastSecondTime.msecsTo(currentTime) >= 1000) {
+        qDebug() << QString("📊 每秒统计 - 发送:%1次 接收:%2次")
+                    .arg(m_requestCount)
+                    .arg(m_responseCount);
+        emit requestStatisticsUpdated(m_requestCount, m_responseCount);
+        
+        m_requestCount = 0;
+        m_responseCount = 0;
+        lastSecondTime = currentTime;
+    }
+    
+    // 使用QElapsedTimer进行精确的时间控制
+    qint64 currentTimeMs = QDateTime::currentDateTime().toMSecsSinceEpoch();
+    if (currentTimeMs - lastSendTimeMs < 5) { // 5ms间隔
+        return;
+    }
+    
+    // 异步发送，避免阻塞定时器
+    QMetaObject::invokeMethod(this, [this]() {
+        // 在下一个事件循环中发送，不阻塞当前定时器
+        // 检查启用的通道数量
+        QVector<ChannelConfig> enabledChannels;
+        for (const auto& config : m_channelConfigs) {
+            if (config.enabled) {
+                enabledChannels.append(config);
+            }
+        }
+        
+        // 如果启用的通道数量为2，使用多通道读取命令
+        if (enabledChannels.size() == 2) {
+            sendMultiParameterRead(m_nodeId, 
+                                 enabledChannels[0].parameterIndex, enabledChannels[0].parameterSubindex,
+                                 enabledChannels[1].parameterIndex, enabledChannels[1].parameterSubindex);
+            m_requestCount++;
+        } else {
+            // 其他情况使用单通道读取命令
+            for (const auto& config : enabledChannels) {
+                sendParameterRead(m_nodeId, config.parameterIndex, config.parameterSubindex);
+                m_requestCount++;
+            }
+        }
+    }, Qt::QueuedConnection);
+    
+    lastSendTimeMs = currentTimeMs;
+}
+
+QString AcquisitionEngine::getParameterName(uint16_t index, uint8_t subindex) const
+{
+    if (m_paramDictionary) {
+        ODEntry param = m_paramDictionary->getParameter(index, subindex);
+        if (param.index != 0) {
+            return param.name;
+        }
+    }
+    return QString("参数0x%1.%2").arg(index, 4, 16, QLatin1Char('0')).arg(subindex, 2, 16, QLatin1Char('0'));
+}
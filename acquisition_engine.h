@@ -0,0 +1,119 @@
+#ifndef ACQUISITION_ENGINE_H
+#define ACQUISITION_ENGINE_H
+
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+#include <QString>
+#include "ControlCAN.h"
+#include "can_types.h"
+#include "param_dictionary.h"
+
+class CANTxRx;
+
+// 数据上抛命令类型定义
+#define UPDATE_CMD_READ_SINGLE     0x01
+#define UPDATE_CMD_READ_MULTI      0x02
+#define UPDATE_CMD_WRITE_SINGLE    0x03
+#define UPDATE_CMD_WRITE_MULTI     0x04
+#define UPDATE_CMD_RESPONSE        0x05
+#define UPDATE_CMD_STREAM_START    0x06
+#define UPDATE_CMD_STREAM_STOP     0x07
+#define UPDATE_CMD_STREAM_DATA     0x08
+
+// 数据上抛基础ID
+#define UPDATE_COB_ID_BASE 0x500
+
+// 参数信息结构体
+struct ParameterInfo {
+    uint16_t index;
+    uint8_t subindex;
+    QString name;
+    QString unit;
+    double scale;
+};
+
+// 数据点结构体
+struct DataPoint {
+    double timestamp;
+    double value;
+    QString parameterName;
+};
+
+// 通道配置结构体
+struct ChannelConfig {
+    int channelIndex;
+    uint16_t parameterIndex;
+    uint8_t parameterSubindex;
+    QString parameterName;
+    bool enabled;
+};
+
+// 示波器数据采集引擎（只依赖QtCore）：按通道配置周期发送数据上抛读取请求，
+// 解析0x500-0x5FF应答并输出带总线时间的数据点
+// 示波器界面DataAcquisition和无界面记录程序共用
+class AcquisitionEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int MAX_CHANNELS = 4;
+    static const int DEFAULT_REQUEST_INTERVAL_MS = 25;
+
+    explicit AcquisitionEngine(QObject *parent = nullptr);
+    ~AcquisitionEngine();
+
+    // 订阅数据上抛协议帧，请求经canTxRx发送
+    void setCANTxRx(CANTxRx *canTxRx);
+    ParamDictionary *paramDictionary() const { return m_paramDictionary; }
+
+    void setNodeId(uint8_t nodeId);
+    uint8_t nodeId() const { return m_nodeId; }
+    void setChannelConfigs(const QVector<ChannelConfig> &configs);
+    const QVector<ChannelConfig> &channelConfigs() const { return m_channelConfigs; }
+    void setChannelParameter(int channelIndex, uint16_t index, uint8_t subindex);
+    int enabledChannelCount() const;
+    void setRequestInterval(int intervalMs);
+
+    void start();
+    void stop();
+    bool isAcquiring() const { return m_isAcquiring; }
+    // 清空数据后调用，下一次采集重新确定时间零点
+    void resetTimeBase();
+
+    QString getParameterName(uint16_t index, uint8_t subindex) const;
+
+public slots:
+    void requestParameters();
+    void processFrames(const CANFrameBatch &frames);
+    void processFrame(const VCI_CAN_OBJ &frame);
+
+signals:
+    // timestamp为相对采集起点的秒数（帧到达总线的时间）
+    void dataPointAdded(const QString &key, double timestamp, double value, const QString &name);
+    // 每秒一次的请求/应答计数
+    void requestStatisticsUpdated(int requestsPerSecond, int responsesPerSecond);
+    void acquisitionStateChanged(bool acquiring);
+
+private:
+    uint32_t buildUpdateCOBId(uint8_t cmdType, uint8_t nodeId);
+    void sendCANFrame(const VCI_CAN_OBJ &frame);
+    void sendParameterRead(uint8_t nodeId, uint16_t index, uint8_t subindex);
+    void sendMultiParameterRead(uint8_t nodeId, uint16_t index1, uint8_t subindex1, uint16_t index2, uint8_t subindex2);
+    void parseScopeFrame(const VCI_CAN_OBJ &frame);
+    void parseMultiChannelData(const VCI_CAN_OBJ &frame, int startByte, int endByte, uint8_t nodeId);
+
+    CANTxRx *m_canTxRx;
+    ParamDictionary *m_paramDictionary;
+    QTimer *m_requestTimer;
+    QVector<ChannelConfig> m_channelConfigs;
+    uint8_t m_nodeId;
+    bool m_isAcquiring;
+    double m_startTime;
+
+    // 频率统计
+    int m_requestCount;
+    int m_responseCount;
+};
+
+#endif // ACQUISITION_ENGINE_H
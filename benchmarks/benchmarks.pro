@@ -0,0 +1,8 @@
+# 基准程序：随顶层工程一起构建，避免源文件增减后失修
+#   rx_pipeline_bench   - 接收链路基准，链接核心库
+#   status_decode_bench - 状态反馈帧解码基准
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    rx_pipeline_bench \
+    status_decode_bench
@@ -0,0 +1,416 @@
+#include <QApplication>
+#include <QTimer>
+#include <QThread>
+#include <QVector>
+#include <QAtomicInteger>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "can_backend_loopback.h"
+#include "can_device_manager.h"
+#include "can_overflow_policy.h"
+#include "can_rx_tx.h"
+#include "can_timestamp.h"
+#include "canthread.h"
+#include "data_acquisition.h"
+#include "global_vars.h"
+
+// ==================== 内存分配计数 ====================
+// glibc下截获malloc系列（Qt容器和QString直接走malloc），其他平台截获operator new
+
+static QAtomicInteger<quint64> g_allocations(0);
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size) noexcept
+{
+    g_allocations.fetchAndAddRelaxed(1);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) noexcept
+{
+    g_allocations.fetchAndAddRelaxed(1);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) noexcept
+{
+    g_allocations.fetchAndAddRelaxed(1);
+    return __libc_realloc(ptr, size);
+}
+}
+#else
+void *operator new(size_t size)
+{
+    g_allocations.fetchAndAddRelaxed(1);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+#endif
+
+namespace {
+    const int AXES = 24;
+    const int SCOPE_NODE = 5;                 // DataAcquisition界面默认节点
+    const quint16 SCOPE_INDEX = 0x7F00;       // 参数字典中不存在的索引：按原始int32显示，值即帧序号
+    const int SEQ_BITS = 20;
+    const quint32 SEQ_MASK = (1u << SEQ_BITS) - 1;
+    const int MAX_CHUNK = 4096;
+    const int MAX_LATENCY_SAMPLES = 4 * 1024 * 1024;
+    const int DRAIN_MS = 500;                 // 停止注入后等待链路排空
+
+    QAtomicInteger<quint64> g_logMessages(0);
+
+    // 应用代码逐帧打印大量日志，基准中只计数不输出（实际程序写日志文件的开销不在统计内）
+    void countingMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &message)
+    {
+        Q_UNUSED(type);
+        Q_UNUSED(context);
+        Q_UNUSED(message);
+        g_logMessages.fetchAndAddRelaxed(1);
+    }
+
+    // 某一阶段的延迟样本（从帧到达总线起算，微秒），容量预先分配，统计过程不产生内存分配
+    struct LatencyStage
+    {
+        explicit LatencyStage(const char *stageName) : name(stageName), count(0)
+        {
+            samples.reserve(MAX_LATENCY_SAMPLES);
+        }
+
+        void add(qint64 us)
+        {
+            count++;
+            if (samples.size() < samples.capacity()) {
+                samples.append(us);
+            }
+        }
+
+        void report()
+        {
+            if (samples.isEmpty()) {
+                printf("  %-22s %10s\n", name, "无样本");
+                return;
+            }
+            std::sort(samples.begin(), samples.end());
+            auto pct = [this](double p) {
+                int index = qMin(samples.size() - 1, static_cast<int>(p * samples.size()));
+                return samples.at(index) / 1000.0;
+            };
+            printf("  %-22s %10llu %9.2f %9.2f %9.2f %9.2f %9.2f\n", name,
+                   static_cast<unsigned long long>(count),
+                   pct(0.50), pct(0.90), pct(0.99), pct(0.999), samples.last() / 1000.0);
+        }
+
+        const char *name;
+        quint64 count;
+        QVector<qint64> samples;
+    };
+
+    // 合成流量发生器：按固定帧率向仿真总线注入，状态帧走通道0，其余走通道1
+    class TrafficGenerator : public QThread
+    {
+    public:
+        TrafficGenerator(LoopbackCANBackend *backend, QAtomicInteger<qint64> *scopeSentUs)
+            : m_backend(backend)
+            , m_scopeSentUs(scopeSentUs)
+            , m_rate(100000)
+            , m_durationUs(5000000)
+            , m_statusPercent(70)
+            , m_scopePercent(20)
+            , m_sdoPercent(5)
+            , m_injected(0)
+            , m_rejected(0)
+            , m_elapsedUs(0)
+        {
+        }
+
+        void configure(int rate, int seconds, int statusPercent, int scopePercent, int sdoPercent)
+        {
+            m_rate = rate;
+            m_durationUs = static_cast<qint64>(seconds) * 1000000;
+            m_statusPercent = statusPercent;
+            m_scopePercent = scopePercent;
+            m_sdoPercent = sdoPercent;
+        }
+
+        quint64 injected() const { return m_injected.load(); }
+        quint64 rejected() const { return m_rejected.load(); }
+        qint64 elapsedUs() const { return m_elapsedUs; }
+
+    protected:
+        void run() override
+        {
+            QVector<VCI_CAN_OBJ> status(MAX_CHUNK);
+            QVector<VCI_CAN_OBJ> others(MAX_CHUNK);
+            quint32 seed = 12345;
+            auto next = [&seed]() {
+                seed = seed * 1103515245u + 12345u;
+                return seed >> 8;
+            };
+
+            quint64 generated = 0;
+            quint32 scopeSeq = 0;
+            int statusNode = 0;
+            const qint64 startUs = canMonotonicUs();
+
+            while (true) {
+                qint64 nowUs = canMonotonicUs();
+                qint64 elapsed = nowUs - startUs;
+                if (elapsed >= m_durationUs)
+                    break;
+
+                quint64 due = static_cast<quint64>(elapsed * static_cast<double>(m_rate) / 1e6);
+                int n = static_cast<int>(qMin<quint64>(due - generated, MAX_CHUNK));
+                if (n <= 0) {
+                    QThread::usleep(100);
+                    continue;
+                }
+
+                int statusCount = 0;
+                int otherCount = 0;
+                for (int i = 0; i < n; i++) {
+                    int kind = static_cast<int>(next() % 100);
+                    VCI_CAN_OBJ *frame;
+                    if (kind < m_statusPercent) {
+                        frame = &status[statusCount++];
+                    } else {
+                        frame = &others[otherCount++];
+                    }
+                    memset(frame, 0, sizeof(VCI_CAN_OBJ));
+                    frame->DataLen = 8;
+
+                    if (kind < m_statusPercent) {
+                        // 状态反馈：各轴轮流
+                        frame->ID = 1 + statusNode;
+                        statusNode = (statusNode + 1) % AXES;
+                        for (int b = 0; b < 8; b++) {
+                            frame->Data[b] = static_cast<BYTE>(next());
+                        }
+                    } else if (kind < m_statusPercent + m_scopePercent) {
+                        // 数据上抛应答：Data[4..7]为帧序号，用于在示波器阶段找回注入时间
+                        quint32 seq = scopeSeq++ & SEQ_MASK;
+                        qint32 value = static_cast<qint32>(seq);
+                        frame->ID = UPDATE_COB_ID_BASE | (UPDATE_CMD_RESPONSE << 4) | SCOPE_NODE;
+                        frame->Data[0] = static_cast<BYTE>(SCOPE_INDEX >> 8);
+                        frame->Data[1] = static_cast<BYTE>(SCOPE_INDEX & 0xFF);
+                        memcpy(&frame->Data[4], &value, 4);
+                        m_scopeSentUs[seq].store(nowUs);
+                    } else if (kind < m_statusPercent + m_scopePercent + m_sdoPercent) {
+                        // SDO上传应答，避开示波器节点（否则会被当作示波器数据解析）
+                        int node = 1 + static_cast<int>(next() % AXES);
+                        if (node == SCOPE_NODE)
+                            node++;
+                        frame->ID = 0x580 + node;
+                        frame->Data[0] = 0x43;
+                        frame->Data[1] = 0x00;
+                        frame->Data[2] = 0x20;
+                        frame->Data[3] = 0x01;
+                        quint32 value = next();
+                        memcpy(&frame->Data[4], &value, 4);
+                    } else {
+                        // 心跳
+                        frame->ID = 0x700 + 1 + static_cast<int>(next() % AXES);
+                        frame->DataLen = 1;
+                        frame->Data[0] = 0x05;
+                    }
+                }
+
+                int accepted = m_backend->inject(0, status.constData(), statusCount) +
+                               m_backend->inject(1, others.constData(), otherCount);
+                m_injected.fetchAndAddRelaxed(static_cast<quint64>(accepted));
+                m_rejected.fetchAndAddRelaxed(static_cast<quint64>(n - accepted));
+                generated += static_cast<quint64>(n);
+            }
+            m_elapsedUs = canMonotonicUs() - startUs;
+        }
+
+    private:
+        LoopbackCANBackend *m_backend;
+        QAtomicInteger<qint64> *m_scopeSentUs;
+        int m_rate;
+        qint64 m_durationUs;
+        int m_statusPercent;
+        int m_scopePercent;
+        int m_sdoPercent;
+        QAtomicInteger<quint64> m_injected;
+        QAtomicInteger<quint64> m_rejected;
+        qint64 m_elapsedUs;
+    };
+}
+
+int main(int argc, char *argv[])
+{
+    int rate = argc > 1 ? atoi(argv[1]) : 100000;
+    int seconds = argc > 2 ? atoi(argv[2]) : 5;
+    int statusPercent = argc > 3 ? atoi(argv[3]) : 70;
+    int scopePercent = argc > 4 ? atoi(argv[4]) : 20;
+    int sdoPercent = argc > 5 ? atoi(argv[5]) : 5;
+    if (rate <= 0 || seconds <= 0 || statusPercent < 0 || scopePercent < 0 || sdoPercent < 0 ||
+        statusPercent + scopePercent + sdoPercent > 100) {
+        printf("用法: %s [帧率] [秒数] [状态帧%%] [示波器帧%%] [SDO帧%%]（其余为心跳帧）\n", argv[0]);
+        return 1;
+    }
+
+    // 无显示环境下也能创建示波器控件
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+    qInstallMessageHandler(countingMessageHandler);
+
+    // 仿真总线：关闭内置节点的周期状态帧，只保留发生器的流量
+    CANDeviceManager manager;
+    int slot = manager.openDevice(CANBackend::LoopbackType, 4, 0, 1000);
+    if (slot < 0) {
+        printf("仿真总线打开失败\n");
+        return 2;
+    }
+    LoopbackCANBackend *loopback = static_cast<LoopbackCANBackend *>(manager.device(slot)->backend());
+    loopback->setSimulatedNodes(QList<int>());
+    loopback->setStatusPeriodUs(0);
+
+    CANTxRx txrx;
+    g_canTxRx = &txrx;
+    txrx.setDeviceManager(&manager);
+
+    DataAcquisition *acquisition = new DataAcquisition();
+    acquisition->setCANTxRx(&txrx);
+
+    QVector<QAtomicInteger<qint64>> scopeSentUs(static_cast<int>(SEQ_MASK) + 1);
+    LatencyStage rxStage("接收线程->CANTxRx");
+    LatencyStage statusStage("状态样本批次");
+    LatencyStage parseStage("示波器解析");
+    LatencyStage plotStage("示波器addDataPoint");
+    quint64 framesAtTxRx = 0;
+    qint64 lastArrivalUs = 0;
+
+    // CANTxRx::onFramesProcessed转发的全部帧（连接此信号会让接收线程转发全部帧，与数据监视界面打开时相同）
+    QObject::connect(&txrx, &CANTxRx::framesReceived, [&](const CANFrameBatch &frames) {
+        qint64 nowUs = canMonotonicUs();
+        for (const VCI_CAN_OBJ &frame : frames) {
+            rxStage.add(nowUs - canFrameTimeUs(frame, nowUs));
+        }
+        framesAtTxRx += static_cast<quint64>(frames.size());
+        lastArrivalUs = nowUs;
+    });
+    QObject::connect(&txrx, &CANTxRx::statusSamplesReceived, [&](const CANStatusBatch &samples) {
+        qint64 nowUs = canMonotonicUs();
+        for (const CANStatusSample &sample : samples) {
+            statusStage.add(nowUs - sample.timeUs);
+        }
+    });
+
+    // DataAcquisition在构造时把dataPointAdded连到示波器，重新连接以便在示波器前后各取一次时间
+    auto scopeLatency = [&](double value, qint64 nowUs) {
+        quint32 seq = static_cast<quint32>(value) & SEQ_MASK;
+        return nowUs - scopeSentUs[static_cast<int>(seq)].load();
+    };
+    OscilloscopeWidget *oscilloscope = acquisition->findChild<OscilloscopeWidget *>();
+    if (oscilloscope) {
+        QObject::disconnect(acquisition, &DataAcquisition::dataPointAdded,
+                            oscilloscope, &OscilloscopeWidget::onDataPointAdded);
+    }
+    QObject::connect(acquisition, &DataAcquisition::dataPointAdded,
+                     [&](const QString &, double, double value, const QString &) {
+        parseStage.add(scopeLatency(value, canMonotonicUs()));
+    });
+    if (oscilloscope) {
+        QObject::connect(acquisition, &DataAcquisition::dataPointAdded,
+                         oscilloscope, &OscilloscopeWidget::onDataPointAdded);
+    }
+    QObject::connect(acquisition, &DataAcquisition::dataPointAdded,
+                     [&](const QString &, double, double value, const QString &) {
+        plotStage.add(scopeLatency(value, canMonotonicUs()));
+    });
+
+    TrafficGenerator generator(loopback, scopeSentUs.data());
+    generator.configure(rate, seconds, statusPercent, scopePercent, sdoPercent);
+    QObject::connect(&generator, &QThread::finished, [&app]() {
+        QTimer::singleShot(DRAIN_MS, &app, &QApplication::quit);
+    });
+
+    txrx.startReceiving(true);
+    QThread::msleep(100);
+
+    printf("目标帧率 %d 帧/秒，%d 秒，状态帧 %d%%，示波器帧 %d%%，SDO帧 %d%%，心跳 %d%%\n\n",
+           rate, seconds, statusPercent, scopePercent, sdoPercent,
+           100 - statusPercent - scopePercent - sdoPercent);
+
+    quint64 logsBefore = g_logMessages.load();
+    quint64 allocationsBefore = g_allocations.load();
+    qint64 startUs = canMonotonicUs();
+    generator.start(QThread::HighPriority);
+    app.exec();
+    quint64 allocations = g_allocations.load() - allocationsBefore;
+    quint64 logs = g_logMessages.load() - logsBefore;
+
+    CANTxRx::CANStatistics stats = txrx.getStatistics();
+    quint64 injected = generator.injected();
+    double generatorSec = generator.elapsedUs() / 1e6;
+    double pipelineSec = (lastArrivalUs > startUs ? lastArrivalUs - startUs : 1) / 1e6;
+
+    printf("吞吐\n");
+    printf("  注入仿真总线     %10llu 帧  %10.0f 帧/秒（总线队列满拒绝 %llu 帧）\n",
+           static_cast<unsigned long long>(injected), injected / generatorSec,
+           static_cast<unsigned long long>(generator.rejected()));
+    printf("  到达CANTxRx      %10llu 帧  %10.0f 帧/秒\n",
+           static_cast<unsigned long long>(framesAtTxRx), framesAtTxRx / pipelineSec);
+    printf("  示波器数据点     %10llu 个\n\n", static_cast<unsigned long long>(plotStage.count));
+
+    printf("各阶段延迟（自帧到达总线起，毫秒）\n");
+    printf("  %-22s %10s %9s %9s %9s %9s %9s\n", "阶段", "样本数", "p50", "p90", "p99", "p99.9", "最大");
+    rxStage.report();
+    statusStage.report();
+    parseStage.report();
+    plotStage.report();
+
+    printf("\n资源\n");
+    printf("  内存分配         %10llu 次  %8.2f 次/帧\n",
+           static_cast<unsigned long long>(allocations), injected ? static_cast<double>(allocations) / injected : 0.0);
+    printf("  日志消息         %10llu 条  %8.2f 条/帧\n",
+           static_cast<unsigned long long>(logs), injected ? static_cast<double>(logs) / injected : 0.0);
+
+    printf("\n溢出\n");
+    printf("  接收队列溢出事件 %10d\n", stats.queueOverflows);
+    for (int ch = 0; ch < stats.channelCount; ch++) {
+        printf("  通道%d 接收 %d 帧，环形缓冲丢弃 %d 帧\n", ch,
+               stats.channelFramesReceived[ch], stats.channelFramesDropped[ch]);
+    }
+    for (int cls = 0; cls < CANClassCount; cls++) {
+        QByteArray name = canTrafficClassName(static_cast<CANTrafficClass>(cls)).toLocal8Bit();
+        printf("  %-10s 丢弃 %llu  溢写 %llu  阻塞 %llu\n", name.constData(),
+               static_cast<unsigned long long>(stats.classFramesDropped[cls]),
+               static_cast<unsigned long long>(stats.classFramesSpilled[cls]),
+               static_cast<unsigned long long>(stats.classBlockEvents[cls]));
+    }
+
+    txrx.stopReceiving();
+    delete acquisition;
+    txrx.setDeviceManager(nullptr);
+    manager.closeAll();
+    g_canTxRx = nullptr;
+    return 0;
+}
@@ -0,0 +1,23 @@
+# 接收链路基准：仿真总线注入合成流量（状态帧/数据上抛应答/SDO应答/心跳），
+# 经CANThread -> CANReceiver -> CANTxRx -> AcquisitionEngine -> OscilloscopeWidget，
+# 报告吞吐、各阶段延迟分位数、每帧内存分配次数和溢出计数
+# 用法：rx_pipeline_bench [帧率] [秒数] [状态帧%] [示波器帧%] [SDO帧%]
+QT       += core gui widgets printsupport
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = rx_pipeline_bench
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# 核心代码链接核心静态库，这里只编译基准用到的界面源文件
+include(../../motor_can_core_link.pri)
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../data_acquisition.cpp
+
+HEADERS += \
+    $$PWD/../../data_acquisition.h
@@ -0,0 +1,184 @@
+#include <QVector>
+#include <QElapsedTimer>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "can_status_decoder.h"
+#include "can_status_sample.h"
+#include "can_timestamp.h"
+#include "can_types.h"
+
+namespace {
+    const int AXES = 24;
+
+    // 模拟24轴现场总线：状态帧按节点轮流出现，其余为示波器/SDO/心跳帧
+    QVector<VCI_CAN_OBJ> makeFrames(int count, int statusPercent)
+    {
+        QVector<VCI_CAN_OBJ> frames(count);
+        quint32 seed = 12345;
+        auto next = [&seed]() {
+            seed = seed * 1103515245u + 12345u;
+            return seed >> 8;
+        };
+
+        qint64 now = canMonotonicUs();
+        int node = 0;
+        for (int i = 0; i < count; i++) {
+            VCI_CAN_OBJ &frame = frames[i];
+            memset(&frame, 0, sizeof(frame));
+            frame.TimeFlag = CAN_TIME_HOST_US;
+            frame.TimeStamp = static_cast<UINT>(now - (count - i));
+            frame.DataLen = 8;
+            setCanFrameChannel(frame, i & 1);
+
+            if (static_cast<int>(next() % 100) < statusPercent) {
+                frame.ID = 1 + node;
+                node = (node + 1) % AXES;
+            } else {
+                static const UINT others[] = { 0x500, 0x581, 0x701, 0x0A0 };
+                frame.ID = others[next() % 4];
+            }
+            for (int b = 0; b < 8; b++) {
+                frame.Data[b] = static_cast<BYTE>(next());
+            }
+        }
+        return frames;
+    }
+
+    struct Columns {
+        explicit Columns(int count)
+            : timeUs(count), speed(count), position(count), current(count), node(count), channel(count) {}
+
+        CANStatusColumnArrays arrays()
+        {
+            CANStatusColumnArrays out = { timeUs.data(), speed.data(), position.data(),
+                                          current.data(), node.data(), channel.data() };
+            return out;
+        }
+
+        QVector<qint64> timeUs;
+        QVector<float> speed;
+        QVector<float> position;
+        QVector<float> current;
+        QVector<quint8> node;
+        QVector<quint8> channel;
+    };
+
+    // 原接收线程的逐帧路径
+    int decodePerFrame(const QVector<VCI_CAN_OBJ> &frames, CANStatusSample *out)
+    {
+        int n = 0;
+        for (int i = 0; i < frames.size(); i++) {
+            if (decodeCanStatus(frames.at(i), &out[n])) {
+                n++;
+            }
+        }
+        return n;
+    }
+
+    bool sameBits(float a, float b)
+    {
+        return memcmp(&a, &b, sizeof(float)) == 0;
+    }
+
+    bool verify(const QVector<CANStatusSample> &reference, int referenceCount,
+                Columns &columns, int count, const char *name)
+    {
+        if (count != referenceCount) {
+            printf("%-18s 样本数不一致: %d / %d\n", name, count, referenceCount);
+            return false;
+        }
+        for (int i = 0; i < count; i++) {
+            const CANStatusSample &sample = reference.at(i);
+            if (!sameBits(sample.speed, columns.speed.at(i)) ||
+                !sameBits(sample.position, columns.position.at(i)) ||
+                !sameBits(sample.current, columns.current.at(i)) ||
+                sample.node != columns.node.at(i) ||
+                sample.channel != columns.channel.at(i) ||
+                sample.timeUs != columns.timeUs.at(i)) {
+                printf("%-18s 第%d个样本与逐帧解码不一致\n", name, i);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void report(const char *name, qint64 bestNs, int frames, qint64 baselineNs)
+    {
+        double mfps = frames * 1000.0 / bestNs;
+        printf("%-18s %9.2f ms  %8.1f Mframe/s  %5.2fx\n",
+               name, bestNs / 1e6, mfps, static_cast<double>(baselineNs) / bestNs);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int frameCount = argc > 1 ? atoi(argv[1]) : 1000000;
+    int rounds = argc > 2 ? atoi(argv[2]) : 20;
+    int statusPercent = argc > 3 ? atoi(argv[3]) : 90;
+    if (frameCount <= 0 || rounds <= 0) {
+        printf("用法: %s [帧数] [轮数] [状态帧百分比]\n", argv[0]);
+        return 1;
+    }
+
+    QVector<VCI_CAN_OBJ> frames = makeFrames(frameCount, statusPercent);
+    printf("帧数 %d，轮数 %d，状态帧约 %d%%，CPU最高支持 %s\n\n", frameCount, rounds, statusPercent,
+           canStatusDecoderIsaName(canStatusDecoderIsa()));
+
+    QVector<CANStatusSample> reference(frameCount);
+    int referenceCount = decodePerFrame(frames, reference.data());
+
+    // 先逐一对照逐帧解码结果，保证各实现输出逐位一致
+    Columns columns(frameCount);
+    const CANStatusDecodeIsa isas[] = { CANDecodeScalar, CANDecodeSse2, CANDecodeAvx2 };
+    for (CANStatusDecodeIsa isa : isas) {
+        if (!canStatusDecoderSupports(isa))
+            continue;
+        memset(columns.speed.data(), 0xFF, frameCount * sizeof(float));
+        int count = decodeCanStatusColumnsWith(isa, frames.constData(), frameCount, columns.arrays(),
+                                               canMonotonicUs());
+        if (!verify(reference, referenceCount, columns, count, canStatusDecoderIsaName(isa)))
+            return 2;
+    }
+
+    QElapsedTimer timer;
+    volatile int sink = 0;
+
+    qint64 perFrameNs = 0;
+    for (int r = 0; r < rounds; r++) {
+        timer.start();
+        sink += decodePerFrame(frames, reference.data());
+        qint64 ns = timer.nsecsElapsed();
+        perFrameNs = (r == 0 || ns < perFrameNs) ? ns : perFrameNs;
+    }
+    printf("%-18s %9s     %8s            %s\n", "实现", "最短耗时", "吞吐", "加速比");
+    report("per-frame", perFrameNs, frameCount, perFrameNs);
+
+    for (CANStatusDecodeIsa isa : isas) {
+        if (!canStatusDecoderSupports(isa))
+            continue;
+        qint64 best = 0;
+        for (int r = 0; r < rounds; r++) {
+            timer.start();
+            sink += decodeCanStatusColumnsWith(isa, frames.constData(), frameCount, columns.arrays(),
+                                               canMonotonicUs());
+            qint64 ns = timer.nsecsElapsed();
+            best = (r == 0 || ns < best) ? ns : best;
+        }
+        char name[32];
+        snprintf(name, sizeof(name), "batch %s", canStatusDecoderIsaName(isa));
+        report(name, best, frameCount, perFrameNs);
+    }
+
+    // 接收线程实际使用的样本数组输出
+    qint64 samplesNs = 0;
+    for (int r = 0; r < rounds; r++) {
+        timer.start();
+        sink += decodeCanStatusSamples(frames.constData(), frameCount, reference.data(), canMonotonicUs());
+        qint64 ns = timer.nsecsElapsed();
+        samplesNs = (r == 0 || ns < samplesNs) ? ns : samplesNs;
+    }
+    report("batch samples", samplesNs, frameCount, perFrameNs);
+
+    return sink == 0 ? 3 : 0;
+}
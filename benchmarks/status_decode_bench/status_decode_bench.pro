@@ -0,0 +1,26 @@
+# 状态反馈帧解码基准：逐帧decodeCanStatus与批量解码（标量/SSE2/AVX2）对比
+# 用法：status_decode_bench [帧数] [轮数] [状态帧百分比]
+QT       -= gui
+QT       += core
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = status_decode_bench
+
+INCLUDEPATH += $$PWD/../..
+
+SOURCES += \
+    main.cpp \
+    $$PWD/../../can_status_decoder.cpp \
+    $$PWD/../../can_timestamp.cpp
+
+HEADERS += \
+    $$PWD/../../can_status_decoder.h \
+    $$PWD/../../can_status_sample.h \
+    $$PWD/../../can_timestamp.h \
+    $$PWD/../../can_types.h
+
+# ControlCAN.h的函数声明带__stdcall，Linux下定义为空（与motor_can_core.pri一致）
+unix: DEFINES += __stdcall=
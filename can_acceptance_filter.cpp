@@ -0,0 +1,204 @@
+#include "can_acceptance_filter.h"
+#include <QtGlobal>
+#include <QStringList>
+#include <algorithm>
+
+namespace {
+    const UINT STD_ID_MASK = 0x7FF;
+    const UINT EXT_ID_MASK = 0x1FFFFFFF;
+
+    // 区间内取值可变的低位
+    UINT varyingBits(UINT first, UINT last)
+    {
+        UINT diff = first ^ last;
+        UINT bits = 0;
+        while (diff) {
+            bits = (bits << 1) | 1;
+            diff >>= 1;
+        }
+        return bits;
+    }
+}
+
+CANAcceptanceFilter::CANAcceptanceFilter()
+    : m_acceptAll(false)
+{
+}
+
+CANAcceptanceFilter CANAcceptanceFilter::acceptAll()
+{
+    CANAcceptanceFilter filter;
+    filter.m_acceptAll = true;
+    return filter;
+}
+
+bool CANAcceptanceFilter::acceptAllRequested()
+{
+    return qgetenv("MOTOR_CAN_ACCEPT_ALL") == "1";
+}
+
+void CANAcceptanceFilter::addRange(UINT first, UINT last, bool extended)
+{
+    UINT idMask = extended ? EXT_ID_MASK : STD_ID_MASK;
+    if (first > last)
+        std::swap(first, last);
+    if (first > idMask)
+        return;
+    CANIdRange range;
+    range.first = first;
+    range.last = qMin(last, idMask);
+    range.extended = extended;
+    m_ranges.append(range);
+    normalize();
+}
+
+void CANAcceptanceFilter::unite(const CANAcceptanceFilter &other)
+{
+    m_acceptAll = m_acceptAll || other.m_acceptAll;
+    m_ranges += other.m_ranges;
+    normalize();
+}
+
+void CANAcceptanceFilter::clear()
+{
+    m_ranges.clear();
+    m_acceptAll = false;
+}
+
+bool CANAcceptanceFilter::hasStandard() const
+{
+    for (const CANIdRange &range : m_ranges) {
+        if (!range.extended)
+            return true;
+    }
+    return false;
+}
+
+bool CANAcceptanceFilter::hasExtended() const
+{
+    for (const CANIdRange &range : m_ranges) {
+        if (range.extended)
+            return true;
+    }
+    return false;
+}
+
+bool CANAcceptanceFilter::accepts(UINT id, bool extended) const
+{
+    if (m_acceptAll)
+        return true;
+    for (const CANIdRange &range : m_ranges) {
+        if (range.extended == extended && id >= range.first && id <= range.last)
+            return true;
+    }
+    return false;
+}
+
+void CANAcceptanceFilter::maskApproximation(bool extended, UINT *code, UINT *mask) const
+{
+    UINT idMask = extended ? EXT_ID_MASK : STD_ID_MASK;
+    bool first = true;
+    UINT commonCode = 0;
+    UINT dontCare = 0;
+
+    for (const CANIdRange &range : m_ranges) {
+        if (range.extended != extended)
+            continue;
+        UINT varying = varyingBits(range.first, range.last);
+        UINT prefix = range.first & ~varying;
+        if (first) {
+            commonCode = prefix;
+            dontCare = varying;
+            first = false;
+        } else {
+            dontCare |= varying | (prefix ^ commonCode);
+        }
+        commonCode &= ~dontCare;
+    }
+
+    if (m_acceptAll || first) {
+        // 全部接收；没有该类型帧的订阅时由调用方决定是否屏蔽该帧类型
+        commonCode = 0;
+        dontCare = idMask;
+    }
+    *code = commonCode & idMask;
+    *mask = dontCare & idMask;
+}
+
+bool CANAcceptanceFilter::toMaskList(bool extended, QVector<QPair<UINT, UINT>> *entries, int maxEntries) const
+{
+    UINT idMask = extended ? EXT_ID_MASK : STD_ID_MASK;
+    entries->clear();
+
+    for (const CANIdRange &range : m_ranges) {
+        if (range.extended != extended)
+            continue;
+        // 区间拆分为按2的幂对齐的块，每块对应一个(id, mask)
+        quint64 id = range.first;
+        while (id <= range.last) {
+            quint64 size = id ? (id & (~id + 1)) : (quint64(idMask) + 1);
+            while (id + size - 1 > range.last)
+                size >>= 1;
+            if (entries->size() >= maxEntries)
+                return false;
+            entries->append(qMakePair(static_cast<UINT>(id),
+                                      static_cast<UINT>(~(size - 1)) & idMask));
+            id += size;
+        }
+    }
+    return true;
+}
+
+QString CANAcceptanceFilter::toString() const
+{
+    if (m_acceptAll)
+        return "全部";
+    QStringList parts;
+    for (const CANIdRange &range : m_ranges) {
+        int width = range.extended ? 8 : 3;
+        QString part = QString("0x%1").arg(range.first, width, 16, QLatin1Char('0'));
+        if (range.last != range.first)
+            part += QString("-0x%1").arg(range.last, width, 16, QLatin1Char('0'));
+        if (range.extended)
+            part += "(扩展)";
+        parts << part;
+    }
+    return parts.isEmpty() ? QString("无") : parts.join(", ");
+}
+
+bool CANAcceptanceFilter::operator==(const CANAcceptanceFilter &other) const
+{
+    if (m_acceptAll != other.m_acceptAll || m_ranges.size() != other.m_ranges.size())
+        return false;
+    for (int i = 0; i < m_ranges.size(); i++) {
+        const CANIdRange &a = m_ranges.at(i);
+        const CANIdRange &b = other.m_ranges.at(i);
+        if (a.first != b.first || a.last != b.last || a.extended != b.extended)
+            return false;
+    }
+    return true;
+}
+
+void CANAcceptanceFilter::normalize()
+{
+    std::sort(m_ranges.begin(), m_ranges.end(), [](const CANIdRange &a, const CANIdRange &b) {
+        if (a.extended != b.extended)
+            return !a.extended;
+        return a.first < b.first;
+    });
+
+    // 合并重叠或相邻的区间
+    QVector<CANIdRange> merged;
+    for (const CANIdRange &range : m_ranges) {
+        if (!merged.isEmpty()) {
+            CANIdRange &last = merged.last();
+            if (last.extended == range.extended &&
+                static_cast<quint64>(range.first) <= static_cast<quint64>(last.last) + 1) {
+                last.last = qMax(last.last, range.last);
+                continue;
+            }
+        }
+        merged.append(range);
+    }
+    m_ranges = merged;
+}
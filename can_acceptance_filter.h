@@ -0,0 +1,61 @@
+#ifndef CAN_ACCEPTANCE_FILTER_H
+#define CAN_ACCEPTANCE_FILTER_H
+
+#include <QVector>
+#include <QPair>
+#include <QString>
+#include "ControlCAN.h"
+
+// 一段连续的COB-ID（闭区间）
+struct CANIdRange {
+    UINT first;
+    UINT last;
+    bool extended;    // 扩展帧（29位）
+};
+
+// 接收验收过滤：上层订阅的COB-ID集合
+// 由后端换算成硬件过滤（USBCAN-E-U滤波表、SJA1000验收码/屏蔽码、SocketCAN CAN_RAW_FILTER），
+// 不需要的帧在适配器或内核中丢弃，不占用USB带宽和主机CPU
+class CANAcceptanceFilter
+{
+public:
+    CANAcceptanceFilter();
+
+    // 不过滤，接收总线上的所有帧（总线监视/调试）
+    static CANAcceptanceFilter acceptAll();
+    // 环境变量MOTOR_CAN_ACCEPT_ALL=1：关闭硬件过滤，忽略订阅
+    static bool acceptAllRequested();
+
+    void addRange(UINT first, UINT last, bool extended = false);
+    void addId(UINT id, bool extended = false) { addRange(id, id, extended); }
+    void unite(const CANAcceptanceFilter &other);
+    void clear();
+
+    bool isAcceptAll() const { return m_acceptAll; }
+    void setAcceptAll(bool acceptAll) { m_acceptAll = acceptAll; }
+    bool isEmpty() const { return !m_acceptAll && m_ranges.isEmpty(); }
+    bool hasStandard() const;
+    bool hasExtended() const;
+
+    // 合并后的区间，按(extended, first)排序且互不重叠
+    const QVector<CANIdRange> &ranges() const { return m_ranges; }
+    bool accepts(UINT id, bool extended) const;
+
+    // 覆盖所有区间的单组验收码/屏蔽码（屏蔽位为1表示不关心），可能多接收一部分帧
+    void maskApproximation(bool extended, UINT *code, UINT *mask) const;
+    // 精确拆分为(id, mask)对，mask位为1表示需要匹配；超过maxEntries返回false
+    bool toMaskList(bool extended, QVector<QPair<UINT, UINT>> *entries, int maxEntries) const;
+
+    QString toString() const;
+
+    bool operator==(const CANAcceptanceFilter &other) const;
+    bool operator!=(const CANAcceptanceFilter &other) const { return !(*this == other); }
+
+private:
+    void normalize();
+
+    QVector<CANIdRange> m_ranges;
+    bool m_acceptAll;
+};
+
+#endif // CAN_ACCEPTANCE_FILTER_H
@@ -0,0 +1,83 @@
+#include "can_backend.h"
+#include "can_backend_controlcan.h"
+#include "can_backend_socketcan.h"
+#include "can_backend_loopback.h"
+#include <QDebug>
+
+CANBackend *CANBackend::create(Type type)
+{
+    switch (type) {
+#ifdef MOTOR_CAN_HAS_CONTROLCAN
+    case ControlCANType:
+        return new ControlCANBackend();
+#endif
+#ifdef Q_OS_LINUX
+    case SocketCANType:
+        return new SocketCANBackend();
+#endif
+    case LoopbackType:
+        return new LoopbackCANBackend();
+    default:
+        break;
+    }
+    qWarning() << "CAN后端不可用:" << typeName(type) << "，改用仿真总线";
+    return new LoopbackCANBackend();
+}
+
+bool CANBackend::isAvailable(Type type)
+{
+    switch (type) {
+    case ControlCANType:
+#ifdef MOTOR_CAN_HAS_CONTROLCAN
+        return true;
+#else
+        return false;
+#endif
+    case SocketCANType:
+#ifdef Q_OS_LINUX
+        return true;
+#else
+        return false;
+#endif
+    case LoopbackType:
+        return true;
+    }
+    return false;
+}
+
+QString CANBackend::typeName(Type type)
+{
+    switch (type) {
+    case ControlCANType: return "ZLG USBCAN";
+    case SocketCANType:  return "SocketCAN";
+    case LoopbackType:   return "仿真总线";
+    }
+    return QString();
+}
+
+QList<CANBackend::Type> CANBackend::availableTypes()
+{
+    QList<Type> types;
+    for (Type type : {ControlCANType, SocketCANType, LoopbackType}) {
+        if (isAvailable(type))
+            types.append(type);
+    }
+    return types;
+}
+
+CANBackend::Type CANBackend::defaultType()
+{
+    QByteArray env = qgetenv("MOTOR_CAN_BACKEND").trimmed().toLower();
+    if (env == "controlcan" || env == "usbcan")
+        return isAvailable(ControlCANType) ? ControlCANType : LoopbackType;
+    if (env == "socketcan")
+        return isAvailable(SocketCANType) ? SocketCANType : LoopbackType;
+    if (env == "loopback" || env == "sim")
+        return LoopbackType;
+
+    if (isAvailable(ControlCANType))
+        return ControlCANType;
+    if (isAvailable(SocketCANType))
+        return SocketCANType;
+    return LoopbackType;
+}
@@ -0,0 +1,62 @@
+#ifndef CAN_BACKEND_H
+#define CAN_BACKEND_H
+
+#include <QString>
+#include <QList>
+#include "ControlCAN.h"
+#include "can_acceptance_filter.h"
+
+// CAN传输后端抽象接口
+// CANThread只通过此接口访问总线，具体实现可以是ZLG USBCAN、Linux SocketCAN或进程内仿真总线
+// 帧格式统一使用VCI_CAN_OBJ，TimeStamp以0.1ms为单位，TimeFlag=1表示时间戳有效
+class CANBackend
+{
+public:
+    enum Type {
+        ControlCANType = 0,   // ZLG USBCAN (ControlCAN库)
+        SocketCANType,        // Linux SocketCAN (can0/vcan0)
+        LoopbackType          // 进程内仿真总线
+    };
+
+    virtual ~CANBackend() {}
+
+    virtual Type type() const = 0;
+    virtual QString name() const = 0;
+    virtual int channelCount() const { return 2; }
+
+    // 1.打开设备
+    virtual bool open(UINT deviceType, UINT deviceIndex) = 0;
+    // 2.初始化所有通道（波特率单位Kbps）
+    virtual bool configure(UINT baudRate) = 0;
+    // 3.启动所有通道
+    virtual bool start() = 0;
+    // 0.复位所有通道
+    virtual bool reset() = 0;
+    // 5.关闭设备
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // 批量发送，返回实际发送成功的帧数，失败返回-1
+    virtual int transmit(UINT channel, const VCI_CAN_OBJ *frames, int count) = 0;
+    // 批量接收，最多等待waitMs毫秒，返回接收帧数，失败返回-1
+    virtual int receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs) = 0;
+    // 待接收帧数，不支持时返回-1
+    virtual int pendingCount(UINT channel) = 0;
+    // receive()的waitMs是否真正阻塞等待数据（USBCAN的WaitTime参数无效，需要轮询）
+    virtual bool supportsBlockingReceive() const { return false; }
+    virtual bool clearBuffer(UINT channel) { Q_UNUSED(channel); return true; }
+    // 硬件接收过滤，在configure()之前设置；返回false表示不支持，只能由软件过滤
+    virtual bool setAcceptanceFilter(const CANAcceptanceFilter &filter) { Q_UNUSED(filter); return false; }
+
+    virtual bool readBoardInfo(VCI_BOARD_INFO *info) { Q_UNUSED(info); return false; }
+
+    // 后端工厂
+    static CANBackend *create(Type type);
+    static bool isAvailable(Type type);
+    static QString typeName(Type type);
+    static QList<Type> availableTypes();
+    // 默认后端，可通过环境变量MOTOR_CAN_BACKEND=controlcan|socketcan|loopback覆盖
+    static Type defaultType();
+};
+
+#endif // CAN_BACKEND_H
@@ -0,0 +1,220 @@
+#include "can_backend_controlcan.h"
+
+#ifdef MOTOR_CAN_HAS_CONTROLCAN
+
+#include <QDebug>
+
+ControlCANBackend::ControlCANBackend()
+    : m_deviceType(VCI_USBCAN2)
+    , m_deviceIndex(0)
+    , m_open(false)
+    , m_filter(CANAcceptanceFilter::acceptAll())
+{
+}
+
+ControlCANBackend::~ControlCANBackend()
+{
+    close();
+}
+
+bool ControlCANBackend::open(UINT deviceType, UINT deviceIndex)
+{
+    m_deviceType = deviceType;/* USBCAN-2A或USBCAN-2C或CANalyst-II */
+    m_deviceIndex = deviceIndex;/* 第1个设备 */
+    m_open = (VCI_OpenDevice(m_deviceType, m_deviceIndex, 0) == 1);
+    return m_open;
+}
+
+bool ControlCANBackend::baudRateTiming(UINT baudRate, UCHAR *timing0, UCHAR *timing1)
+{
+    switch (baudRate) {
+    case 10:   *timing0 = 0x31; *timing1 = 0x1c; break;
+    case 20:   *timing0 = 0x18; *timing1 = 0x1c; break;
+    case 40:   *timing0 = 0x87; *timing1 = 0xff; break;
+    case 50:   *timing0 = 0x09; *timing1 = 0x1c; break;
+    case 80:   *timing0 = 0x83; *timing1 = 0xff; break;
+    case 100:  *timing0 = 0x04; *timing1 = 0x1c; break;
+    case 125:  *timing0 = 0x03; *timing1 = 0x1c; break;
+    case 200:  *timing0 = 0x81; *timing1 = 0xfa; break;
+    case 250:  *timing0 = 0x01; *timing1 = 0x1c; break;
+    case 400:  *timing0 = 0x80; *timing1 = 0xfa; break;
+    case 500:  *timing0 = 0x00; *timing1 = 0x1c; break;
+    case 666:  *timing0 = 0x80; *timing1 = 0xb6; break;
+    case 800:  *timing0 = 0x00; *timing1 = 0x16; break;
+    case 1000: *timing0 = 0x00; *timing1 = 0x14; break;
+    case 33:   *timing0 = 0x09; *timing1 = 0x6f; break;
+    case 66:   *timing0 = 0x04; *timing1 = 0x6f; break;
+    case 83:   *timing0 = 0x03; *timing1 = 0x6f; break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+bool ControlCANBackend::configure(UINT baudRate)
+{
+    VCI_ClearBuffer(m_deviceType, m_deviceIndex, 0);
+    VCI_ClearBuffer(m_deviceType, m_deviceIndex, 1);
+
+    VCI_INIT_CONFIG vic;
+    vic.AccCode = 0x80000008;
+    vic.AccMask = 0xFFFFFFFF;
+    vic.Filter = 1;
+    vic.Mode = 0;
+    applyAcceptanceCode(&vic);
+    vic.Timing0 = 0x00;
+    vic.Timing1 = 0x14;
+    if (!baudRateTiming(baudRate, &vic.Timing0, &vic.Timing1)) {
+        qWarning() << "不支持的波特率:" << baudRate << "Kbps，使用1000Kbps";
+    }
+
+    if (VCI_InitCAN(m_deviceType, m_deviceIndex, 0, &vic) != 1)
+        return false;
+    if (VCI_InitCAN(m_deviceType, m_deviceIndex, 1, &vic) != 1)
+        return false;
+
+    // 滤波表需在InitCAN之后、StartCAN之前设置
+    if (hasFilterTable()) {
+        for (UINT channel = 0; channel < 2; channel++) {
+            if (!applyFilterTable(channel))
+                qWarning() << "通道" << channel << "滤波表设置失败，接收全部帧";
+        }
+    }
+    return true;
+}
+
+bool ControlCANBackend::setAcceptanceFilter(const CANAcceptanceFilter &filter)
+{
+    m_filter = filter;
+    // 滤波表可在运行中重设；验收码/屏蔽码只能在InitCAN时写入，下次configure生效
+    if (m_open && hasFilterTable()) {
+        for (UINT channel = 0; channel < 2; channel++) {
+            if (!applyFilterTable(channel))
+                qWarning() << "通道" << channel << "滤波表更新失败";
+        }
+    }
+    return true;
+}
+
+bool ControlCANBackend::hasFilterTable() const
+{
+    // USBCAN-E-U系列支持按区间设置的滤波表，其余型号只有SJA1000验收码/屏蔽码
+    return m_deviceType == VCI_USBCAN_E_U || m_deviceType == VCI_USBCAN_2E_U;
+}
+
+void ControlCANBackend::applyAcceptanceCode(VCI_INIT_CONFIG *config) const
+{
+    // 空订阅按全部接收处理，避免误配置导致收不到任何帧
+    if (m_filter.isAcceptAll() || m_filter.isEmpty() || hasFilterTable())
+        return;
+    // 单滤波只能覆盖一种帧格式，同时订阅扩展帧时不做硬件过滤
+    if (m_filter.hasExtended())
+        return;
+
+    UINT code = 0;
+    UINT mask = 0;
+    m_filter.maskApproximation(false, &code, &mask);
+    // 标准帧ID对齐到验收码的bit31..21，低位(RTR/数据)不关心
+    config->AccCode = code << 21;
+    config->AccMask = (mask << 21) | 0x001FFFFF;
+    config->Filter = 2;   // 只接收标准帧
+    qDebug() << QString("硬件验收码:0x%1 屏蔽码:0x%2")
+                .arg(config->AccCode, 8, 16, QLatin1Char('0'))
+                .arg(config->AccMask, 8, 16, QLatin1Char('0'));
+}
+
+bool ControlCANBackend::applyFilterTable(UINT channel)
+{
+    // RefType: 1添加滤波表项 2启用滤波表 3清除滤波表
+    VCI_SetReference(m_deviceType, m_deviceIndex, channel, 3, nullptr);
+    if (m_filter.isAcceptAll() || m_filter.isEmpty())
+        return true;
+
+    for (const CANIdRange &range : m_filter.ranges()) {
+        VCI_FILTER_RECORD record;
+        record.ExtFrame = range.extended ? 1 : 0;
+        record.Start = range.first;
+        record.End = range.last;
+        if (VCI_SetReference(m_deviceType, m_deviceIndex, channel, 1, &record) != 1)
+            return false;
+    }
+    if (VCI_SetReference(m_deviceType, m_deviceIndex, channel, 2, nullptr) != 1)
+        return false;
+    qDebug() << "通道" << channel << "滤波表:" << m_filter.toString();
+    return true;
+}
+
+bool ControlCANBackend::start()
+{
+    for (UINT channel = 0; channel < 2; channel++) {
+        if (VCI_StartCAN(m_deviceType, m_deviceIndex, channel) != 1) {
+            qDebug() << "start" << channel << "fail.";
+            return false;
+        }
+        qDebug() << "start" << channel << "success.";
+    }
+    return true;
+}
+
+bool ControlCANBackend::reset()
+{
+    for (UINT channel = 0; channel < 2; channel++) {
+        if (VCI_ResetCAN(m_deviceType, m_deviceIndex, channel) != 1) {
+            qDebug() << "reset" << channel << "fail.";
+            return false;
+        }
+        qDebug() << "reset" << channel << "success.";
+    }
+    return true;
+}
+
+void ControlCANBackend::close()
+{
+    if (m_open) {
+        VCI_CloseDevice(m_deviceType, m_deviceIndex);
+        m_open = false;
+    }
+}
+
+int ControlCANBackend::transmit(UINT channel, const VCI_CAN_OBJ *frames, int count)
+{
+    if (count <= 0) return 0;
+
+    ULONG sent = VCI_Transmit(m_deviceType, m_deviceIndex, channel,
+                              const_cast<PVCI_CAN_OBJ>(frames), static_cast<ULONG>(count));
+    if (sent == static_cast<ULONG>(0xFFFFFFFF))
+        return -1;
+    return static_cast<int>(sent);
+}
+
+int ControlCANBackend::receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs)
+{
+    if (maxFrames <= 0) return 0;
+
+    ULONG received = VCI_Receive(m_deviceType, m_deviceIndex, channel,
+                                 frames, static_cast<ULONG>(maxFrames), waitMs);
+    // USBCAN在设备异常时返回0xFFFFFFFF
+    if (received == static_cast<ULONG>(0xFFFFFFFF) || received > static_cast<ULONG>(maxFrames))
+        return -1;
+    return static_cast<int>(received);
+}
+
+int ControlCANBackend::pendingCount(UINT channel)
+{
+    ULONG pending = VCI_GetReceiveNum(m_deviceType, m_deviceIndex, channel);
+    if (pending == static_cast<ULONG>(0xFFFFFFFF))
+        return -1;
+    return static_cast<int>(pending);
+}
+
+bool ControlCANBackend::clearBuffer(UINT channel)
+{
+    return VCI_ClearBuffer(m_deviceType, m_deviceIndex, channel) == 1;
+}
+
+bool ControlCANBackend::readBoardInfo(VCI_BOARD_INFO *info)
+{
+    return VCI_ReadBoardInfo(m_deviceType, m_deviceIndex, info) == 1;
+}
+
+#endif // MOTOR_CAN_HAS_CONTROLCAN
@@ -0,0 +1,47 @@
+#ifndef CAN_BACKEND_CONTROLCAN_H
+#define CAN_BACKEND_CONTROLCAN_H
+
+#include "can_backend.h"
+
+#ifdef MOTOR_CAN_HAS_CONTROLCAN
+
+// ZLG USBCAN后端，封装ControlCAN库的VCI_*接口
+class ControlCANBackend : public CANBackend
+{
+public:
+    ControlCANBackend();
+    ~ControlCANBackend() override;
+
+    Type type() const override { return ControlCANType; }
+    QString name() const override { return "ZLG USBCAN"; }
+
+    bool open(UINT deviceType, UINT deviceIndex) override;
+    bool configure(UINT baudRate) override;
+    bool start() override;
+    bool reset() override;
+    void close() override;
+    bool isOpen() const override { return m_open; }
+
+    int transmit(UINT channel, const VCI_CAN_OBJ *frames, int count) override;
+    int receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs) override;
+    int pendingCount(UINT channel) override;
+    bool clearBuffer(UINT channel) override;
+    bool setAcceptanceFilter(const CANAcceptanceFilter &filter) override;
+
+    bool readBoardInfo(VCI_BOARD_INFO *info) override;
+
+private:
+    static bool baudRateTiming(UINT baudRate, UCHAR *timing0, UCHAR *timing1);
+    void applyAcceptanceCode(VCI_INIT_CONFIG *config) const;
+    bool applyFilterTable(UINT channel);
+    bool hasFilterTable() const;
+
+    UINT m_deviceType;
+    UINT m_deviceIndex;
+    bool m_open;
+    CANAcceptanceFilter m_filter;
+};
+
+#endif // MOTOR_CAN_HAS_CONTROLCAN
+
+#endif // CAN_BACKEND_CONTROLCAN_H
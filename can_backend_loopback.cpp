@@ -0,0 +1,480 @@
+#include "can_backend_loopback.h"
+#include <QDebug>
+#include <QStringList>
+#include <cstring>
+#include <cmath>
+
+// 仿真节点参数索引（与参数字典一致）
+static const quint16 SIM_INDEX_POSITION  = 0x6064;
+static const quint16 SIM_INDEX_SPEED     = 0x606C;
+static const quint16 SIM_INDEX_IQ        = 0x6072;
+static const quint16 SIM_INDEX_MODE      = 0x6060;
+
+static quint32 floatBits(float value)
+{
+    quint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float bitsToFloat(const BYTE *data)
+{
+    float value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+LoopbackCANBackend::LoopbackCANBackend()
+    : m_lastStepUs(0)
+    , m_statusPeriodUs(1000)
+    , m_open(false)
+    , m_started(false)
+    , m_transmitted(0)
+    , m_filter(CANAcceptanceFilter::acceptAll())
+{
+    QList<int> nodeIds;
+    QByteArray nodesEnv = qgetenv("MOTOR_CAN_SIM_NODES");
+    if (!nodesEnv.isEmpty()) {
+        for (const QString &item : QString::fromLocal8Bit(nodesEnv).split(',', QString::SkipEmptyParts)) {
+            bool ok = false;
+            int id = item.trimmed().toInt(&ok, 0);
+            if (ok && id > 0 && id < 0x80)
+                nodeIds.append(id);
+        }
+    }
+    if (nodeIds.isEmpty())
+        nodeIds.append(1);
+    setSimulatedNodes(nodeIds);
+
+    bool ok = false;
+    int periodUs = qgetenv("MOTOR_CAN_SIM_PERIOD_US").toInt(&ok);
+    if (ok && periodUs >= 0)
+        m_statusPeriodUs = periodUs;
+
+    m_clock.start();
+}
+
+LoopbackCANBackend::~LoopbackCANBackend()
+{
+    close();
+}
+
+bool LoopbackCANBackend::open(UINT deviceType, UINT deviceIndex)
+{
+    Q_UNUSED(deviceType);
+    Q_UNUSED(deviceIndex);
+    QMutexLocker locker(&m_mutex);
+    m_open = true;
+    return true;
+}
+
+bool LoopbackCANBackend::configure(UINT baudRate)
+{
+    Q_UNUSED(baudRate);
+    QMutexLocker locker(&m_mutex);
+    m_rxQueue[0].clear();
+    m_rxQueue[1].clear();
+    return m_open;
+}
+
+bool LoopbackCANBackend::start()
+{
+    QMutexLocker locker(&m_mutex);
+    m_started = m_open;
+    m_lastStepUs = m_clock.nsecsElapsed() / 1000;
+    return m_started;
+}
+
+bool LoopbackCANBackend::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_rxQueue[0].clear();
+    m_rxQueue[1].clear();
+    m_started = false;
+    return m_open;
+}
+
+void LoopbackCANBackend::close()
+{
+    QMutexLocker locker(&m_mutex);
+    m_open = false;
+    m_started = false;
+    m_rxQueue[0].clear();
+    m_rxQueue[1].clear();
+    m_dataReady.wakeAll();
+}
+
+bool LoopbackCANBackend::isOpen() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_open;
+}
+
+int LoopbackCANBackend::transmit(UINT channel, const VCI_CAN_OBJ *frames, int count)
+{
+    if (channel > 1)
+        return -1;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_open)
+        return -1;
+
+    for (int i = 0; i < count; i++) {
+        handleFrame(channel, frames[i]);
+    }
+    m_transmitted += static_cast<quint64>(count);
+    if (!m_rxQueue[channel].isEmpty())
+        m_dataReady.wakeAll();
+    return count;
+}
+
+int LoopbackCANBackend::receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs)
+{
+    if (channel > 1 || maxFrames <= 0)
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_open)
+        return -1;
+
+    qint64 nowUs = m_clock.nsecsElapsed() / 1000;
+    stepSimulation(nowUs);
+    if (m_rxQueue[channel].isEmpty() && waitMs > 0) {
+        // 状态帧是按需生成的，等待时间不超过下一个状态周期
+        if (m_started && m_statusPeriodUs > 0) {
+            qint64 untilNextUs = m_lastStepUs + m_statusPeriodUs - nowUs;
+            waitMs = qBound(1, static_cast<int>((untilNextUs + 999) / 1000), waitMs);
+        }
+        m_dataReady.wait(&m_mutex, static_cast<unsigned long>(waitMs));
+        stepSimulation(m_clock.nsecsElapsed() / 1000);
+    }
+
+    QQueue<VCI_CAN_OBJ> &queue = m_rxQueue[channel];
+    int count = qMin(maxFrames, queue.size());
+    for (int i = 0; i < count; i++) {
+        frames[i] = queue.dequeue();
+    }
+    return count;
+}
+
+int LoopbackCANBackend::pendingCount(UINT channel)
+{
+    if (channel > 1)
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+    stepSimulation(m_clock.nsecsElapsed() / 1000);
+    return m_rxQueue[channel].size();
+}
+
+bool LoopbackCANBackend::clearBuffer(UINT channel)
+{
+    if (channel > 1)
+        return false;
+
+    QMutexLocker locker(&m_mutex);
+    m_rxQueue[channel].clear();
+    return true;
+}
+
+bool LoopbackCANBackend::readBoardInfo(VCI_BOARD_INFO *info)
+{
+    memset(info, 0, sizeof(VCI_BOARD_INFO));
+    info->can_Num = 2;
+    strncpy(info->str_Serial_Num, "SIM-000000", sizeof(info->str_Serial_Num) - 1);
+    strncpy(info->str_hw_Type, "Loopback", sizeof(info->str_hw_Type) - 1);
+    return true;
+}
+
+void LoopbackCANBackend::setSimulatedNodes(const QList<int> &nodeIds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_nodes.clear();
+    for (int id : nodeIds) {
+        SimNode node;
+        node.id = id;
+        node.mode = 2;
+        node.enabled = false;
+        node.speed = 0.0f;
+        node.position = 0.0f;
+        node.current = 0.0f;
+        node.targetSpeed = 0.0f;
+        node.targetPosition = 0.0f;
+        node.maxSpeed = 0.0f;
+        node.targetCurrent = 0.0f;
+        m_nodes.insert(id, node);
+    }
+}
+
+void LoopbackCANBackend::setStatusPeriodUs(int periodUs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_statusPeriodUs = qMax(0, periodUs);
+}
+
+int LoopbackCANBackend::inject(UINT channel, const VCI_CAN_OBJ *frames, int count)
+{
+    if (channel > 1)
+        return 0;
+
+    QMutexLocker locker(&m_mutex);
+    QQueue<VCI_CAN_OBJ> &queue = m_rxQueue[channel];
+    int accepted = qMin(count, MAX_PENDING - queue.size());
+    UINT stamp = timeStamp();
+    int enqueued = 0;
+    for (int i = 0; i < accepted; i++) {
+        VCI_CAN_OBJ frame = frames[i];
+        if (!m_filter.accepts(frame.ID, frame.ExternFlag != 0))
+            continue;   // 被过滤的帧不进入接收队列
+        if (!frame.TimeFlag) {
+            frame.TimeStamp = stamp;
+            frame.TimeFlag = 1;
+        }
+        queue.enqueue(frame);
+        enqueued++;
+    }
+    if (enqueued > 0)
+        m_dataReady.wakeAll();
+    return enqueued;
+}
+
+bool LoopbackCANBackend::setAcceptanceFilter(const CANAcceptanceFilter &filter)
+{
+    QMutexLocker locker(&m_mutex);
+    m_filter = filter;
+    return true;
+}
+
+quint64 LoopbackCANBackend::transmittedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_transmitted;
+}
+
+UINT LoopbackCANBackend::timeStamp() const
+{
+    // 0.1ms为单位，与USBCAN一致
+    return static_cast<UINT>(m_clock.nsecsElapsed() / 100000);
+}
+
+void LoopbackCANBackend::enqueue(UINT channel, DWORD id, const BYTE *data, BYTE len)
+{
+    QQueue<VCI_CAN_OBJ> &queue = m_rxQueue[channel];
+    if (queue.size() >= MAX_PENDING || !m_filter.accepts(id, false))
+        return;
+
+    VCI_CAN_OBJ frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.ID = id;
+    frame.TimeStamp = timeStamp();
+    frame.TimeFlag = 1;
+    frame.DataLen = qMin<BYTE>(len, 8);
+    memcpy(frame.Data, data, frame.DataLen);
+    queue.enqueue(frame);
+}
+
+void LoopbackCANBackend::handleFrame(UINT channel, const VCI_CAN_OBJ &frame)
+{
+    if (frame.ExternFlag || frame.RemoteFlag)
+        return;
+
+    DWORD id = frame.ID;
+    if (id >= 0x600 && id < 0x680) {
+        auto it = m_nodes.find(static_cast<int>(id - 0x600));
+        if (it != m_nodes.end())
+            handleSdo(channel, it.value(), frame);
+        return;
+    }
+
+    if (id >= 0x500 && id < 0x600) {
+        // 数据上抛协议: 0x500 + (cmd<<4) + (node&0x0F)
+        int cmdType = (id >> 4) & 0x0F;
+        int nodeLow = id & 0x0F;
+        for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it) {
+            if ((it.key() & 0x0F) == nodeLow)
+                handleUpdateRead(channel, it.value(), cmdType, frame);
+        }
+        return;
+    }
+
+    if (id < 0x200) {
+        // 电机命令: (cmd<<7) | node
+        auto it = m_nodes.find(static_cast<int>(id & 0x7F));
+        if (it != m_nodes.end())
+            handleMotorCommand(it.value(), static_cast<int>(id >> 7), frame);
+    }
+}
+
+void LoopbackCANBackend::handleMotorCommand(SimNode &node, int cmd, const VCI_CAN_OBJ &frame)
+{
+    if (frame.DataLen != 8)
+        return;
+
+    const BYTE *d = frame.Data;
+    bool special = d[0] == 0xFF && d[1] == 0xFF && d[2] == 0xFF &&
+                   d[3] == 0xFF && d[4] == 0xFF && d[5] == 0xFF;
+    if (cmd == 0 && special) {
+        if (d[7] == 0xFD) {                 // 停止
+            node.enabled = false;
+            node.targetSpeed = 0.0f;
+            node.targetCurrent = 0.0f;
+        } else if (d[7] == 0xFC) {
+            if (d[6] == 0xFF)               // 启动
+                node.enabled = true;
+            else if (d[6] <= 0x03)          // 模式切换
+                node.mode = d[6];
+        }
+        return;
+    }
+
+    switch (cmd) {
+    case 0x00:
+        if (d[0] == 0x01 || d[0] == 0x02) {
+            // 点动：固定速度
+            node.mode = 2;
+            node.targetSpeed = (d[0] == 0x01) ? 1.0f : -1.0f;
+        }
+        break;
+    case 0x01:
+        node.targetPosition = bitsToFloat(&d[0]);
+        node.maxSpeed = qAbs(bitsToFloat(&d[4]));
+        break;
+    case 0x02:
+        node.targetSpeed = bitsToFloat(&d[0]);
+        break;
+    case 0x03:
+        node.targetCurrent = bitsToFloat(&d[0]);
+        break;
+    default:
+        break;
+    }
+}
+
+quint32 LoopbackCANBackend::readParam(const SimNode &node, quint16 index, quint8 sub) const
+{
+    switch (index) {
+    case SIM_INDEX_POSITION: return floatBits(node.position);
+    case SIM_INDEX_SPEED:    return floatBits(node.speed);
+    case SIM_INDEX_IQ:       return floatBits(node.current);
+    case SIM_INDEX_MODE:     return static_cast<quint32>(node.mode);
+    default:
+        break;
+    }
+    return node.params.value((static_cast<quint32>(index) << 8) | sub, 0);
+}
+
+void LoopbackCANBackend::handleSdo(UINT channel, SimNode &node, const VCI_CAN_OBJ &frame)
+{
+    if (frame.DataLen < 4)
+        return;
+
+    BYTE cs = frame.Data[0];
+    quint16 index = static_cast<quint16>(frame.Data[1] | (frame.Data[2] << 8));
+    quint8 sub = frame.Data[3];
+
+    BYTE reply[8] = {0};
+    reply[1] = frame.Data[1];
+    reply[2] = frame.Data[2];
+    reply[3] = sub;
+
+    if (cs == 0x40) {
+        // 上传（读）：按4字节加速上传应答
+        quint32 value = readParam(node, index, sub);
+        reply[0] = 0x43;
+        memcpy(&reply[4], &value, 4);
+    } else if (cs == 0x2F || cs == 0x2B || cs == 0x23) {
+        // 下载（写）
+        quint32 value = 0;
+        int size = (cs == 0x2F) ? 1 : (cs == 0x2B ? 2 : 4);
+        memcpy(&value, &frame.Data[4], static_cast<size_t>(size));
+        node.params.insert((static_cast<quint32>(index) << 8) | sub, value);
+        reply[0] = 0x60;
+    } else {
+        return;
+    }
+    enqueue(channel, 0x580 + static_cast<DWORD>(node.id), reply, 8);
+}
+
+void LoopbackCANBackend::handleUpdateRead(UINT channel, SimNode &node, int cmdType, const VCI_CAN_OBJ &frame)
+{
+    BYTE reply[8] = {0};
+    DWORD replyId = 0x500 + (0x05 << 4) + (static_cast<DWORD>(node.id) & 0x0F);
+
+    if (cmdType == 0x01 && frame.DataLen >= 3) {
+        // 单参数读取：回复 [索引高, 索引低, 子索引, 0, 值(4字节)]
+        quint16 index = static_cast<quint16>((frame.Data[0] << 8) | frame.Data[1]);
+        quint32 value = readParam(node, index, frame.Data[2]);
+        reply[0] = frame.Data[0];
+        reply[1] = frame.Data[1];
+        reply[2] = frame.Data[2];
+        memcpy(&reply[4], &value, 4);
+        enqueue(channel, replyId, reply, 8);
+    } else if (cmdType == 0x02 && frame.DataLen >= 6) {
+        // 双参数读取：回复两个4字节值
+        quint16 index1 = static_cast<quint16>((frame.Data[0] << 8) | frame.Data[1]);
+        quint16 index2 = static_cast<quint16>((frame.Data[3] << 8) | frame.Data[4]);
+        quint32 value1 = readParam(node, index1, frame.Data[2]);
+        quint32 value2 = readParam(node, index2, frame.Data[5]);
+        memcpy(&reply[0], &value1, 4);
+        memcpy(&reply[4], &value2, 4);
+        enqueue(channel, replyId, reply, 8);
+    }
+}
+
+void LoopbackCANBackend::stepSimulation(qint64 nowUs)
+{
+    if (!m_started || m_statusPeriodUs <= 0) {
+        m_lastStepUs = nowUs;
+        return;
+    }
+
+    // 落后太多时只补最近的若干周期，避免一次性灌入大量帧
+    const int MAX_CATCH_UP = 100;
+    qint64 steps = (nowUs - m_lastStepUs) / m_statusPeriodUs;
+    if (steps <= 0)
+        return;
+    if (steps > MAX_CATCH_UP) {
+        m_lastStepUs = nowUs - MAX_CATCH_UP * static_cast<qint64>(m_statusPeriodUs);
+        steps = MAX_CATCH_UP;
+    }
+
+    const float dt = m_statusPeriodUs / 1e6f;
+    for (qint64 s = 0; s < steps; s++) {
+        m_lastStepUs += m_statusPeriodUs;
+
+        for (auto it = m_nodes.begin(); it != m_nodes.end(); ++it) {
+            SimNode &node = it.value();
+
+            float commandSpeed = 0.0f;
+            if (node.enabled) {
+                if (node.mode == 1) {
+                    float error = node.targetPosition - node.position;
+                    float limit = node.maxSpeed > 0.0f ? node.maxSpeed : 10.0f;
+                    commandSpeed = qBound(-limit, error * 20.0f, limit);
+                } else if (node.mode == 3) {
+                    commandSpeed = node.speed + node.targetCurrent * 50.0f * dt;
+                } else {
+                    commandSpeed = node.targetSpeed;
+                }
+            }
+
+            // 一阶惯性环节模拟电机响应
+            float accel = (commandSpeed - node.speed) * 50.0f;
+            node.speed += accel * dt;
+            node.position += node.speed * dt;
+            node.current = accel * 0.01f;
+
+            BYTE data[8];
+            qint16 speedRaw = static_cast<qint16>(qBound(-32768.0f, std::round(node.speed * 10.0f), 32767.0f));
+            qint32 positionRaw = static_cast<qint32>(std::round(node.position * 1000.0f));
+            qint16 currentRaw = static_cast<qint16>(qBound(-32768.0f, std::round(node.current * 1000.0f), 32767.0f));
+            memcpy(&data[0], &speedRaw, 2);
+            memcpy(&data[2], &positionRaw, 4);
+            memcpy(&data[6], &currentRaw, 2);
+            enqueue(0, static_cast<DWORD>(node.id), data, 8);
+        }
+    }
+
+    if (!m_rxQueue[0].isEmpty())
+        m_dataReady.wakeAll();
+}
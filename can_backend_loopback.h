@@ -0,0 +1,90 @@
+#ifndef CAN_BACKEND_LOOPBACK_H
+#define CAN_BACKEND_LOOPBACK_H
+
+#include "can_backend.h"
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QQueue>
+#include <QMap>
+#include <QHash>
+
+// 进程内仿真总线：不依赖任何硬件，模拟若干电机节点
+// - 周期发送状态反馈帧 (ID=节点号, 速度/位置/电流)
+// - 响应模式切换/启动/停止/速度/位置/电流/点动命令
+// - 响应SDO读写 (0x600+n -> 0x580+n)
+// - 响应数据上抛读取 (0x510+n/0x520+n -> 0x550+n)
+// 可用于在Linux构建机上做吞吐和延迟基准测试
+// 节点列表和状态周期可通过环境变量 MOTOR_CAN_SIM_NODES=1,2,3 / MOTOR_CAN_SIM_PERIOD_US=1000 指定
+class LoopbackCANBackend : public CANBackend
+{
+public:
+    LoopbackCANBackend();
+    ~LoopbackCANBackend() override;
+
+    Type type() const override { return LoopbackType; }
+    QString name() const override { return "仿真总线"; }
+
+    bool open(UINT deviceType, UINT deviceIndex) override;
+    bool configure(UINT baudRate) override;
+    bool start() override;
+    bool reset() override;
+    void close() override;
+    bool isOpen() const override;
+
+    int transmit(UINT channel, const VCI_CAN_OBJ *frames, int count) override;
+    int receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs) override;
+    int pendingCount(UINT channel) override;
+    bool supportsBlockingReceive() const override { return true; }
+    bool clearBuffer(UINT channel) override;
+    bool setAcceptanceFilter(const CANAcceptanceFilter &filter) override;
+
+    bool readBoardInfo(VCI_BOARD_INFO *info) override;
+
+    // 仿真配置
+    void setSimulatedNodes(const QList<int> &nodeIds);
+    void setStatusPeriodUs(int periodUs);      // 0表示不发送周期状态帧
+    // 直接注入接收帧（基准测试用），返回实际注入帧数
+    int inject(UINT channel, const VCI_CAN_OBJ *frames, int count);
+    quint64 transmittedCount() const;
+
+private:
+    struct SimNode {
+        int id;
+        int mode;             // 0:运控 1:位置 2:速度 3:电流
+        bool enabled;
+        float speed;
+        float position;
+        float current;
+        float targetSpeed;
+        float targetPosition;
+        float maxSpeed;
+        float targetCurrent;
+        QHash<quint32, quint32> params;   // (index<<8|sub) -> 原始值
+    };
+
+    static const int MAX_PENDING = 65536;   // 每通道最多缓存帧数
+
+    void handleFrame(UINT channel, const VCI_CAN_OBJ &frame);
+    void handleMotorCommand(SimNode &node, int cmd, const VCI_CAN_OBJ &frame);
+    void handleSdo(UINT channel, SimNode &node, const VCI_CAN_OBJ &frame);
+    void handleUpdateRead(UINT channel, SimNode &node, int cmdType, const VCI_CAN_OBJ &frame);
+    quint32 readParam(const SimNode &node, quint16 index, quint8 sub) const;
+    void stepSimulation(qint64 nowUs);
+    void enqueue(UINT channel, DWORD id, const BYTE *data, BYTE len);
+    UINT timeStamp() const;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_dataReady;
+    QQueue<VCI_CAN_OBJ> m_rxQueue[2];
+    QMap<int, SimNode> m_nodes;
+    QElapsedTimer m_clock;
+    qint64 m_lastStepUs;
+    int m_statusPeriodUs;
+    bool m_open;
+    bool m_started;
+    quint64 m_transmitted;
+    CANAcceptanceFilter m_filter;       // 模拟适配器的硬件过滤
+};
+
+#endif // CAN_BACKEND_LOOPBACK_H
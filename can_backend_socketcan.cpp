@@ -0,0 +1,286 @@
+#include "can_backend_socketcan.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QDebug>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <poll.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+
+SocketCANBackend::SocketCANBackend()
+    : m_filter(CANAcceptanceFilter::acceptAll())
+{
+    m_sockets[0] = -1;
+    m_sockets[1] = -1;
+}
+
+SocketCANBackend::~SocketCANBackend()
+{
+    close();
+}
+
+QStringList SocketCANBackend::interfaceNames(UINT deviceIndex)
+{
+    QByteArray env = qgetenv("MOTOR_CAN_SOCKETCAN_IF");
+    if (!env.isEmpty()) {
+        QStringList names = QString::fromLocal8Bit(env).split(',', QString::SkipEmptyParts);
+        if (!names.isEmpty())
+            return names;
+    }
+    // 设备索引n对应 can(2n) / can(2n+1)
+    return QStringList() << QString("can%1").arg(deviceIndex * 2)
+                         << QString("can%1").arg(deviceIndex * 2 + 1);
+}
+
+int SocketCANBackend::openSocket(const QString &ifName)
+{
+    int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+    if (fd < 0)
+        return -1;
+
+    struct ifreq ifr;
+    memset(&ifr, 0, sizeof(ifr));
+    strncpy(ifr.ifr_name, ifName.toLocal8Bit().constData(), IFNAMSIZ - 1);
+    if (::ioctl(fd, SIOCGIFINDEX, &ifr) < 0) {
+        ::close(fd);
+        return -1;
+    }
+
+    // 内核接收时间戳，换算到VCI_CAN_OBJ::TimeStamp
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &on, sizeof(on));
+    applyFilter(fd);
+
+    struct sockaddr_can addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.can_family = AF_CAN;
+    addr.can_ifindex = ifr.ifr_ifindex;
+    if (::bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+bool SocketCANBackend::open(UINT deviceType, UINT deviceIndex)
+{
+    Q_UNUSED(deviceType);
+    close();
+
+    m_interfaces = interfaceNames(deviceIndex);
+    for (int i = 0; i < 2 && i < m_interfaces.size(); i++) {
+        m_sockets[i] = openSocket(m_interfaces.at(i));
+        if (m_sockets[i] < 0 && i == 0) {
+            qDebug() << "SocketCAN接口打开失败:" << m_interfaces.at(i) << strerror(errno);
+            return false;
+        }
+    }
+    qDebug() << "SocketCAN打开:" << m_interfaces;
+    return true;
+}
+
+bool SocketCANBackend::configure(UINT baudRate)
+{
+    qDebug() << "SocketCAN波特率由系统配置，忽略" << baudRate << "Kbps";
+    return isOpen();
+}
+
+bool SocketCANBackend::start()
+{
+    return isOpen();
+}
+
+bool SocketCANBackend::reset()
+{
+    for (UINT channel = 0; channel < 2; channel++)
+        clearBuffer(channel);
+    return isOpen();
+}
+
+void SocketCANBackend::close()
+{
+    for (int i = 0; i < 2; i++) {
+        if (m_sockets[i] >= 0) {
+            ::close(m_sockets[i]);
+            m_sockets[i] = -1;
+        }
+    }
+}
+
+int SocketCANBackend::transmit(UINT channel, const VCI_CAN_OBJ *frames, int count)
+{
+    if (channel > 1 || m_sockets[channel] < 0)
+        return -1;
+
+    struct can_frame cf[MAX_BATCH];
+    struct mmsghdr msgs[MAX_BATCH];
+    struct iovec iov[MAX_BATCH];
+
+    int sent = 0;
+    while (sent < count) {
+        int batch = qMin(count - sent, MAX_BATCH);
+        for (int i = 0; i < batch; i++) {
+            const VCI_CAN_OBJ &src = frames[sent + i];
+            memset(&cf[i], 0, sizeof(cf[i]));
+            cf[i].can_id = src.ExternFlag ? ((src.ID & CAN_EFF_MASK) | CAN_EFF_FLAG)
+                                          : (src.ID & CAN_SFF_MASK);
+            if (src.RemoteFlag)
+                cf[i].can_id |= CAN_RTR_FLAG;
+            cf[i].can_dlc = qMin<BYTE>(src.DataLen, 8);
+            memcpy(cf[i].data, src.Data, cf[i].can_dlc);
+
+            iov[i].iov_base = &cf[i];
+            iov[i].iov_len = sizeof(struct can_frame);
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov = &iov[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        int n = ::sendmmsg(m_sockets[channel], msgs, batch, 0);
+        if (n <= 0)
+            return sent > 0 ? sent : (errno == EAGAIN || errno == ENOBUFS ? 0 : -1);
+        sent += n;
+        if (n < batch)
+            break;
+    }
+    return sent;
+}
+
+int SocketCANBackend::receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs)
+{
+    if (channel > 1 || m_sockets[channel] < 0)
+        return 0;
+    if (maxFrames <= 0)
+        return 0;
+
+    if (waitMs > 0) {
+        struct pollfd pfd;
+        pfd.fd = m_sockets[channel];
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        int ready = ::poll(&pfd, 1, waitMs);
+        if (ready <= 0)
+            return ready < 0 && errno != EINTR ? -1 : 0;
+    }
+
+    struct can_frame cf[MAX_BATCH];
+    struct mmsghdr msgs[MAX_BATCH];
+    struct iovec iov[MAX_BATCH];
+    char control[MAX_BATCH][CMSG_SPACE(sizeof(struct timeval))];
+
+    int batch = qMin(maxFrames, MAX_BATCH);
+    for (int i = 0; i < batch; i++) {
+        iov[i].iov_base = &cf[i];
+        iov[i].iov_len = sizeof(struct can_frame);
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        msgs[i].msg_hdr.msg_control = control[i];
+        msgs[i].msg_hdr.msg_controllen = sizeof(control[i]);
+    }
+
+    int n = ::recvmmsg(m_sockets[channel], msgs, batch, MSG_DONTWAIT, nullptr);
+    if (n < 0)
+        return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1;
+
+    for (int i = 0; i < n; i++) {
+        VCI_CAN_OBJ &dst = frames[i];
+        memset(&dst, 0, sizeof(dst));
+        dst.ExternFlag = (cf[i].can_id & CAN_EFF_FLAG) ? 1 : 0;
+        dst.RemoteFlag = (cf[i].can_id & CAN_RTR_FLAG) ? 1 : 0;
+        dst.ID = dst.ExternFlag ? (cf[i].can_id & CAN_EFF_MASK) : (cf[i].can_id & CAN_SFF_MASK);
+        dst.DataLen = qMin<BYTE>(cf[i].can_dlc, 8);
+        memcpy(dst.Data, cf[i].data, dst.DataLen);
+
+        for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg;
+             cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_TIMESTAMP) {
+                struct timeval tv;
+                memcpy(&tv, CMSG_DATA(cmsg), sizeof(tv));
+                // 0.1ms为单位，与USBCAN一致（32位自然回绕）
+                dst.TimeStamp = static_cast<UINT>(static_cast<quint64>(tv.tv_sec) * 10000ULL
+                                                  + static_cast<quint64>(tv.tv_usec) / 100ULL);
+                dst.TimeFlag = 1;
+            }
+        }
+    }
+    return n;
+}
+
+int SocketCANBackend::pendingCount(UINT channel)
+{
+    if (channel > 1 || m_sockets[channel] < 0)
+        return 0;
+
+    // 原始套接字只能得到下一帧的字节数，这里只区分“有/无”
+    int bytes = 0;
+    if (::ioctl(m_sockets[channel], FIONREAD, &bytes) < 0)
+        return -1;
+    return bytes > 0 ? 1 : 0;
+}
+
+bool SocketCANBackend::clearBuffer(UINT channel)
+{
+    VCI_CAN_OBJ scratch[MAX_BATCH];
+    while (receive(channel, scratch, MAX_BATCH, 0) > 0) {
+    }
+    return true;
+}
+
+bool SocketCANBackend::setAcceptanceFilter(const CANAcceptanceFilter &filter)
+{
+    m_filter = filter;
+    // 内核过滤可随时修改，已打开的接口立即生效
+    for (int i = 0; i < 2; i++) {
+        if (m_sockets[i] >= 0)
+            applyFilter(m_sockets[i]);
+    }
+    return true;
+}
+
+void SocketCANBackend::applyFilter(int fd)
+{
+    QVector<struct can_filter> filters;
+    if (!m_filter.isAcceptAll() && !m_filter.isEmpty()) {
+        QVector<QPair<UINT, UINT>> standard;
+        QVector<QPair<UINT, UINT>> extended;
+        if (m_filter.toMaskList(false, &standard, MAX_FILTERS) &&
+            m_filter.toMaskList(true, &extended, MAX_FILTERS - standard.size())) {
+            for (const auto &entry : standard) {
+                struct can_filter f;
+                f.can_id = entry.first;
+                f.can_mask = entry.second | CAN_EFF_FLAG;
+                filters.append(f);
+            }
+            for (const auto &entry : extended) {
+                struct can_filter f;
+                f.can_id = entry.first | CAN_EFF_FLAG;
+                f.can_mask = entry.second | CAN_EFF_FLAG;
+                filters.append(f);
+            }
+        } else {
+            qWarning() << "SocketCAN过滤条目过多，接收全部帧";
+        }
+    }
+
+    if (filters.isEmpty()) {
+        // 全部接收
+        struct can_filter f;
+        f.can_id = 0;
+        f.can_mask = 0;
+        filters.append(f);
+    }
+    if (::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters.constData(),
+                     static_cast<socklen_t>(filters.size() * sizeof(struct can_filter))) < 0) {
+        qWarning() << "SocketCAN设置接收过滤失败:" << strerror(errno);
+    }
+}
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,52 @@
+#ifndef CAN_BACKEND_SOCKETCAN_H
+#define CAN_BACKEND_SOCKETCAN_H
+
+#include "can_backend.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QStringList>
+
+// Linux SocketCAN后端，通道0/1对应两个网络接口（默认can0/can1，可用vcan测试）
+// 接口名可通过环境变量MOTOR_CAN_SOCKETCAN_IF=vcan0,vcan1指定
+// 波特率需在系统中用 ip link set canX type can bitrate ... 配置，这里不做修改
+class SocketCANBackend : public CANBackend
+{
+public:
+    SocketCANBackend();
+    ~SocketCANBackend() override;
+
+    Type type() const override { return SocketCANType; }
+    QString name() const override { return "SocketCAN"; }
+
+    bool open(UINT deviceType, UINT deviceIndex) override;
+    bool configure(UINT baudRate) override;
+    bool start() override;
+    bool reset() override;
+    void close() override;
+    bool isOpen() const override { return m_sockets[0] >= 0; }
+
+    int transmit(UINT channel, const VCI_CAN_OBJ *frames, int count) override;
+    int receive(UINT channel, VCI_CAN_OBJ *frames, int maxFrames, int waitMs) override;
+    int pendingCount(UINT channel) override;
+    bool supportsBlockingReceive() const override { return true; }
+    bool clearBuffer(UINT channel) override;
+    bool setAcceptanceFilter(const CANAcceptanceFilter &filter) override;
+
+    static QStringList interfaceNames(UINT deviceIndex);
+
+private:
+    static const int MAX_BATCH = 64;   // 单次recvmmsg/sendmmsg的最大帧数
+    static const int MAX_FILTERS = 64; // CAN_RAW_FILTER最多条目，超出时不过滤
+
+    int openSocket(const QString &ifName);
+    void applyFilter(int fd);
+
+    int m_sockets[2];
+    QStringList m_interfaces;
+    CANAcceptanceFilter m_filter;
+};
+
+#endif // Q_OS_LINUX
+
+#endif // CAN_BACKEND_SOCKETCAN_H
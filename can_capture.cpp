@@ -0,0 +1,322 @@
+#include "can_capture.h"
+#include <QDateTime>
+#include <QDebug>
+#include <cstring>
+#include "can_types.h"
+#include "can_timestamp.h"
+
+namespace {
+    const char CAPTURE_MAGIC[8] = { 'M', 'C', 'A', 'N', 'C', 'A', 'P', '1' };
+    const unsigned long IDLE_WAIT_MS = 100;
+}
+
+static_assert(sizeof(CANCaptureHeader) == 64, "抓包文件头应为64字节");
+static_assert(sizeof(CANCaptureRecord) == 32, "抓包记录应为32字节");
+
+const int CANCaptureWriter::RING_CAPACITY;
+const int CANCaptureWriter::WRITE_BLOCK_RECORDS;
+const qint64 CANCaptureReader::MAP_WINDOW_BYTES;
+
+void canCaptureRecordFromFrame(const VCI_CAN_OBJ &frame, qint64 timeUs, CANCaptureRecord *record)
+{
+    record->timeUs = timeUs;
+    record->id = frame.ID;
+    record->channel = static_cast<quint8>(canFrameChannel(frame));
+    record->flags = (frame.ExternFlag ? CAN_CAPTURE_EXTENDED : 0) |
+                    (frame.RemoteFlag ? CAN_CAPTURE_REMOTE : 0);
+    record->dataLen = qMin<quint8>(frame.DataLen, 8);
+    record->reserved0 = 0;
+    memcpy(record->data, frame.Data, 8);
+    record->droppedBefore = 0;
+    record->reserved1 = 0;
+}
+
+void canCaptureRecordToFrame(const CANCaptureRecord &record, qint64 timeUs, VCI_CAN_OBJ *frame)
+{
+    memset(frame, 0, sizeof(VCI_CAN_OBJ));
+    frame->ID = record.id;
+    frame->TimeStamp = static_cast<UINT>(static_cast<quint32>(timeUs));
+    frame->TimeFlag = CAN_TIME_HOST_US;
+    frame->ExternFlag = (record.flags & CAN_CAPTURE_EXTENDED) ? 1 : 0;
+    frame->RemoteFlag = (record.flags & CAN_CAPTURE_REMOTE) ? 1 : 0;
+    frame->DataLen = qMin<quint8>(record.dataLen, 8);
+    memcpy(frame->Data, record.data, 8);
+    setCanFrameChannel(*frame, record.channel);
+}
+
+// ==================== CANCaptureWriter ====================
+
+CANCaptureWriter::CANCaptureWriter(QObject *parent)
+    : QThread(parent)
+    , m_ring(RING_CAPACITY)
+    , m_block(WRITE_BLOCK_RECORDS)
+    , m_blockCount(0)
+    , m_lastOverflow(0)
+    , m_written(0)
+    , m_running(false)
+{
+    memset(&m_header, 0, sizeof(m_header));
+    m_ring.setNotifier(&m_notifier);
+}
+
+CANCaptureWriter::~CANCaptureWriter()
+{
+    stop();
+}
+
+bool CANCaptureWriter::open(const QString &path)
+{
+    if (isRunning() || m_file.isOpen()) {
+        m_error = "录制已在进行";
+        return false;
+    }
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Unbuffered)) {
+        m_error = QString("无法创建抓包文件 %1: %2").arg(path).arg(m_file.errorString());
+        return false;
+    }
+
+    memset(&m_header, 0, sizeof(m_header));
+    memcpy(m_header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC));
+    m_header.headerSize = sizeof(CANCaptureHeader);
+    m_header.recordSize = sizeof(CANCaptureRecord);
+    m_header.startTimeUs = canMonotonicUs();
+    m_header.startWallMs = QDateTime::currentMSecsSinceEpoch();
+    if (m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header)) != sizeof(m_header)) {
+        m_error = QString("写入抓包文件头失败: %1").arg(m_file.errorString());
+        m_file.close();
+        return false;
+    }
+
+    m_blockCount = 0;
+    m_lastOverflow = m_ring.overflowCount();
+    m_written.store(0);
+    m_error.clear();
+    // 在start()之前置位：线程还没跑起来就调用的stop()不会被run()覆盖
+    m_running = true;
+    return true;
+}
+
+QString CANCaptureWriter::fileName() const
+{
+    return m_file.fileName();
+}
+
+QString CANCaptureWriter::errorString() const
+{
+    return m_error;
+}
+
+void CANCaptureWriter::capture(const VCI_CAN_OBJ *frames, int count)
+{
+    // 放不下的帧由环形缓冲计入溢出，写线程据此记录丢帧数
+    m_ring.push(frames, count);
+}
+
+void CANCaptureWriter::stop()
+{
+    if (isRunning()) {
+        m_running = false;
+        m_notifier.notify();
+        wait();
+    } else if (m_file.isOpen()) {
+        finish();
+    }
+}
+
+quint64 CANCaptureWriter::framesWritten() const
+{
+    return m_written.load();
+}
+
+quint64 CANCaptureWriter::framesDropped() const
+{
+    return m_ring.overflowCount();
+}
+
+void CANCaptureWriter::run()
+{
+    qDebug() << "开始录制CAN抓包:" << m_file.fileName();
+
+    while (m_running) {
+        if (!drain())
+            break;
+        m_notifier.wait(IDLE_WAIT_MS);
+    }
+
+    finish();
+}
+
+bool CANCaptureWriter::drain()
+{
+    const VCI_CAN_OBJ *frames = nullptr;
+    int count;
+    while ((count = m_ring.beginRead(&frames, WRITE_BLOCK_RECORDS - m_blockCount)) > 0) {
+        qint64 nowUs = canMonotonicUs();
+        quint64 overflow = m_ring.overflowCount();
+        quint32 dropped = static_cast<quint32>(qMin<quint64>(overflow - m_lastOverflow, 0xFFFFFFFFu));
+        m_lastOverflow = overflow;
+
+        CANCaptureRecord *records = m_block.data() + m_blockCount;
+        for (int i = 0; i < count; i++) {
+            canCaptureRecordFromFrame(frames[i], canFrameTimeUs(frames[i], nowUs), &records[i]);
+        }
+        records[0].droppedBefore = dropped;
+        m_ring.commitRead(count);
+        m_blockCount += count;
+
+        if (m_blockCount >= WRITE_BLOCK_RECORDS && !flushBlock())
+            return false;
+    }
+    // 空闲时把未满的块也写出，避免停顿期间的数据只留在内存里
+    return flushBlock();
+}
+
+bool CANCaptureWriter::flushBlock()
+{
+    if (m_blockCount == 0)
+        return true;
+
+    qint64 bytes = static_cast<qint64>(m_blockCount) * sizeof(CANCaptureRecord);
+    if (m_file.write(reinterpret_cast<const char *>(m_block.constData()), bytes) != bytes) {
+        m_error = QString("写入抓包文件失败: %1").arg(m_file.errorString());
+        qWarning() << m_error;
+        emit writeError(m_error);
+        m_blockCount = 0;
+        return false;
+    }
+    m_written.fetchAndAddRelaxed(static_cast<quint64>(m_blockCount));
+    m_blockCount = 0;
+    return true;
+}
+
+void CANCaptureWriter::finish()
+{
+    if (!m_file.isOpen())
+        return;
+
+    if (m_error.isEmpty()) {
+        drain();
+    }
+
+    // 正常结束：回写记录数和丢帧数
+    m_header.recordCount = m_written.load();
+    m_header.droppedFrames = m_ring.overflowCount();
+    if (m_file.seek(0)) {
+        m_file.write(reinterpret_cast<const char *>(&m_header), sizeof(m_header));
+    }
+    m_file.close();
+    qDebug() << "CAN抓包录制结束:" << m_header.recordCount << "帧，丢弃" << m_header.droppedFrames << "帧";
+}
+
+// ==================== CANCaptureReader ====================
+
+CANCaptureReader::CANCaptureReader()
+    : m_count(0)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowSize(0)
+{
+    memset(&m_header, 0, sizeof(m_header));
+}
+
+CANCaptureReader::~CANCaptureReader()
+{
+    close();
+}
+
+bool CANCaptureReader::open(const QString &path)
+{
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = QString("无法打开抓包文件 %1: %2").arg(path).arg(m_file.errorString());
+        return false;
+    }
+
+    if (m_file.read(reinterpret_cast<char *>(&m_header), sizeof(m_header)) != sizeof(m_header) ||
+        memcmp(m_header.magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 ||
+        m_header.headerSize != sizeof(CANCaptureHeader) ||
+        m_header.recordSize != sizeof(CANCaptureRecord)) {
+        m_error = QString("不是支持的抓包文件: %1").arg(path);
+        m_file.close();
+        return false;
+    }
+
+    // 未正常结束的文件按长度计算，丢掉末尾不完整的记录
+    quint64 bySize = static_cast<quint64>(m_file.size() - sizeof(CANCaptureHeader)) / sizeof(CANCaptureRecord);
+    m_count = (m_header.recordCount > 0) ? qMin(m_header.recordCount, bySize) : bySize;
+    m_error.clear();
+    return true;
+}
+
+void CANCaptureReader::close()
+{
+    if (m_window) {
+        m_file.unmap(m_window);
+        m_window = nullptr;
+    }
+    m_windowOffset = 0;
+    m_windowSize = 0;
+    m_count = 0;
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+}
+
+qint64 CANCaptureReader::firstTimeUs()
+{
+    const CANCaptureRecord *record = nullptr;
+    return (m_count > 0 && read(0, &record, 1) == 1) ? record->timeUs : 0;
+}
+
+qint64 CANCaptureReader::lastTimeUs()
+{
+    const CANCaptureRecord *record = nullptr;
+    return (m_count > 0 && read(m_count - 1, &record, 1) == 1) ? record->timeUs : 0;
+}
+
+bool CANCaptureReader::mapWindow(qint64 offset)
+{
+    if (m_window) {
+        m_file.unmap(m_window);
+        m_window = nullptr;
+    }
+
+    // 窗口起点按窗口大小对齐（满足系统映射粒度）；文件头和记录都是32字节的整数倍，记录不会跨窗口
+    m_windowOffset = (offset / MAP_WINDOW_BYTES) * MAP_WINDOW_BYTES;
+    m_windowSize = qMin(MAP_WINDOW_BYTES, m_file.size() - m_windowOffset);
+    if (m_windowSize <= 0) {
+        m_windowSize = 0;
+        return false;
+    }
+    m_window = m_file.map(m_windowOffset, m_windowSize);
+    if (!m_window) {
+        m_error = QString("抓包文件映射失败: %1").arg(m_file.errorString());
+        m_windowSize = 0;
+        return false;
+    }
+    return true;
+}
+
+int CANCaptureReader::read(quint64 index, const CANCaptureRecord **records, int maxCount)
+{
+    if (!m_file.isOpen() || index >= m_count || maxCount <= 0)
+        return 0;
+
+    qint64 offset = static_cast<qint64>(sizeof(CANCaptureHeader) + index * sizeof(CANCaptureRecord));
+    if (!m_window || offset < m_windowOffset ||
+        offset + static_cast<qint64>(sizeof(CANCaptureRecord)) > m_windowOffset + m_windowSize) {
+        if (!mapWindow(offset))
+            return 0;
+    }
+
+    qint64 inWindow = (m_windowOffset + m_windowSize - offset) / static_cast<qint64>(sizeof(CANCaptureRecord));
+    quint64 remaining = m_count - index;
+    int count = static_cast<int>(qMin<qint64>(qMin<qint64>(inWindow, maxCount),
+                                              static_cast<qint64>(qMin<quint64>(remaining, INT_MAX))));
+    *records = reinterpret_cast<const CANCaptureRecord *>(m_window + (offset - m_windowOffset));
+    return count;
+}
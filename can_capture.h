@@ -0,0 +1,135 @@
+#ifndef CAN_CAPTURE_H
+#define CAN_CAPTURE_H
+
+#include <QThread>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QAtomicInteger>
+#include "ControlCAN.h"
+#include "can_frame_ring.h"
+
+// 二进制抓包文件格式（小端）：
+//   64字节文件头 CANCaptureHeader，之后是定长32字节记录 CANCaptureRecord
+//   记录时间为帧到达总线的主机单调时间（硬件时间戳经CANTimestampMapper映射，见can_timestamp.h）
+//   录制中断的文件recordCount为0，按文件长度计算记录数，末尾不完整的记录忽略
+
+struct CANCaptureHeader
+{
+    char magic[8];              // "MCANCAP1"
+    quint32 headerSize;         // sizeof(CANCaptureHeader)
+    quint32 recordSize;         // sizeof(CANCaptureRecord)
+    qint64 startTimeUs;         // 开始录制时的canMonotonicUs()
+    qint64 startWallMs;         // 开始录制时的系统时间（UTC毫秒）
+    quint64 recordCount;        // 正常结束时写入，0表示未正常结束
+    quint64 droppedFrames;      // 录制队列满丢弃的帧数
+    quint8 reserved[16];
+};
+
+enum {
+    CAN_CAPTURE_EXTENDED = 0x01,
+    CAN_CAPTURE_REMOTE = 0x02
+};
+
+struct CANCaptureRecord
+{
+    qint64 timeUs;
+    quint32 id;
+    quint8 channel;             // 全局通道号（见can_types.h）
+    quint8 flags;               // CAN_CAPTURE_*
+    quint8 dataLen;
+    quint8 reserved0;
+    quint8 data[8];
+    quint32 droppedBefore;      // 此记录之前因录制队列满丢失的帧数（通常为0）
+    quint32 reserved1;
+};
+
+// 记录 <-> 帧转换；转换出的帧为主机时间（TimeFlag=CAN_TIME_HOST_US，TimeStamp取timeUs低32位）
+void canCaptureRecordFromFrame(const VCI_CAN_OBJ &frame, qint64 timeUs, CANCaptureRecord *record);
+void canCaptureRecordToFrame(const CANCaptureRecord &record, qint64 timeUs, VCI_CAN_OBJ *frame);
+
+// 后台抓包写线程：接收线程调用capture()把帧拷入无锁环形缓冲，写线程攒成大块顺序写入文件
+// 写线程跟不上时多出的帧丢弃并计数（不阻塞接收线程）
+class CANCaptureWriter : public QThread
+{
+    Q_OBJECT
+public:
+    static const int RING_CAPACITY = 65536;
+    static const int WRITE_BLOCK_RECORDS = 32768;  // 每次写入1MB
+
+    explicit CANCaptureWriter(QObject *parent = nullptr);
+    ~CANCaptureWriter();
+
+    // 创建文件并写入文件头，然后调用start()
+    bool open(const QString &path);
+    QString fileName() const;
+    QString errorString() const;
+
+    // 接收线程（唯一生产者）：帧必须已映射为主机时间
+    void capture(const VCI_CAN_OBJ *frames, int count);
+
+    // 写完已接收的帧，更新文件头并关闭文件
+    void stop();
+
+    quint64 framesWritten() const;
+    quint64 framesDropped() const;
+
+signals:
+    void writeError(const QString &message);
+
+protected:
+    void run() override;
+
+private:
+    bool drain();
+    bool flushBlock();
+    void finish();
+
+    QFile m_file;
+    QString m_error;
+    CANCaptureHeader m_header;
+    CANRxNotifier m_notifier;
+    CANFrameRing m_ring;
+    QVector<CANCaptureRecord> m_block;
+    int m_blockCount;
+    quint64 m_lastOverflow;
+    QAtomicInteger<quint64> m_written;
+    volatile bool m_running;
+};
+
+// 抓包文件读取：按窗口内存映射（64MB），超过地址空间的长时间抓包也能顺序读取
+class CANCaptureReader
+{
+public:
+    static const qint64 MAP_WINDOW_BYTES = 64 * 1024 * 1024;
+
+    CANCaptureReader();
+    ~CANCaptureReader();
+
+    bool open(const QString &path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString errorString() const { return m_error; }
+
+    const CANCaptureHeader &header() const { return m_header; }
+    quint64 recordCount() const { return m_count; }
+    // 第一条和最后一条记录的时间（无记录时为0）
+    qint64 firstTimeUs();
+    qint64 lastTimeUs();
+
+    // 从index起取连续记录，返回可用条数（不超过maxCount，不跨映射窗口），指针在下次read前有效
+    int read(quint64 index, const CANCaptureRecord **records, int maxCount);
+
+private:
+    bool mapWindow(qint64 offset);
+
+    QFile m_file;
+    QString m_error;
+    CANCaptureHeader m_header;
+    quint64 m_count;
+    uchar *m_window;
+    qint64 m_windowOffset;
+    qint64 m_windowSize;
+};
+
+#endif // CAN_CAPTURE_H
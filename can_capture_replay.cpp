@@ -0,0 +1,121 @@
+#include "can_capture_replay.h"
+#include <QDebug>
+#include "can_timestamp.h"
+
+namespace {
+    const int READ_CHUNK = 4096;
+    const qint64 MAX_SLEEP_US = 10000;      // 等待下一帧的计划时间时最长睡眠10ms，便于及时响应stop
+    const unsigned long FULL_WAIT_US = 100; // 接收源已满时的等待
+}
+
+const int CANCaptureReplayer::RING_CAPACITY;
+
+CANCaptureReplayer::CANCaptureReplayer(QObject *parent)
+    : QThread(parent)
+    , m_speed(1.0)
+    , m_ring(RING_CAPACITY)
+    , m_replayed(0)
+    , m_running(false)
+{
+}
+
+CANCaptureReplayer::~CANCaptureReplayer()
+{
+    stop();
+}
+
+void CANCaptureReplayer::setFileName(const QString &path)
+{
+    m_fileName = path;
+}
+
+void CANCaptureReplayer::setSpeed(double speed)
+{
+    m_speed = speed;
+}
+
+void CANCaptureReplayer::startReplay()
+{
+    // 在start()之前置位：线程还没跑起来就调用的stop()不会被run()覆盖
+    m_running = true;
+    start();
+}
+
+void CANCaptureReplayer::stop()
+{
+    m_running = false;
+    wait();
+}
+
+quint64 CANCaptureReplayer::replayedFrames() const
+{
+    return m_replayed.load();
+}
+
+void CANCaptureReplayer::run()
+{
+    m_replayed.store(0);
+
+    CANCaptureReader reader;
+    if (!reader.open(m_fileName)) {
+        qWarning() << reader.errorString();
+        emit replayError(reader.errorString());
+        emit replayFinished(0, 0);
+        return;
+    }
+
+    const quint64 total = reader.recordCount();
+    const qint64 firstUs = reader.firstTimeUs();
+    const qint64 startUs = canMonotonicUs();
+    const bool paced = m_speed > 0.0;
+    // 记录时间 -> 回放计划时间（当前主机时间轴）
+    auto schedule = [&](const CANCaptureRecord &record) {
+        return startUs + static_cast<qint64>((record.timeUs - firstUs) / (paced ? m_speed : 1.0));
+    };
+
+    qDebug() << "开始回放CAN抓包:" << m_fileName << total << "帧，速度"
+             << (paced ? QString::number(m_speed) : QString("不限速"));
+
+    quint64 index = 0;
+    while (m_running && index < total) {
+        const CANCaptureRecord *records = nullptr;
+        int count = reader.read(index, &records, READ_CHUNK);
+        if (count <= 0) {
+            qWarning() << "抓包文件读取失败:" << reader.errorString();
+            emit replayError(reader.errorString());
+            break;
+        }
+
+        qint64 nowUs = canMonotonicUs();
+        if (paced) {
+            // 只发送计划时间已到的记录，下一条未到时睡到它的计划时间
+            int due = 0;
+            while (due < count && schedule(records[due]) <= nowUs) {
+                due++;
+            }
+            if (due == 0) {
+                QThread::usleep(static_cast<unsigned long>(qMin(schedule(records[0]) - nowUs, MAX_SLEEP_US)));
+                continue;
+            }
+            count = due;
+        }
+
+        VCI_CAN_OBJ *frames = nullptr;
+        int space = m_ring.beginWrite(&frames, count);
+        if (space <= 0) {
+            // 接收线程跟不上：等待而不是丢帧，回放结果与录制内容一致
+            QThread::usleep(FULL_WAIT_US);
+            continue;
+        }
+        for (int i = 0; i < space; i++) {
+            canCaptureRecordToFrame(records[i], paced ? schedule(records[i]) : nowUs, &frames[i]);
+        }
+        m_ring.commitWrite(space);
+        index += static_cast<quint64>(space);
+        m_replayed.store(index);
+    }
+
+    qint64 elapsedUs = canMonotonicUs() - startUs;
+    qDebug() << "CAN抓包回放结束:" << index << "/" << total << "帧，耗时" << elapsedUs / 1000 << "ms";
+    emit replayFinished(index, elapsedUs);
+}
@@ -0,0 +1,51 @@
+#ifndef CAN_CAPTURE_REPLAY_H
+#define CAN_CAPTURE_REPLAY_H
+
+#include <QThread>
+#include <QString>
+#include <QAtomicInteger>
+#include "can_capture.h"
+#include "can_frame_ring.h"
+
+// 抓包回放线程：按记录时间把帧写入自己的环形缓冲，该缓冲作为接收源挂到CANReceiver上，
+// 之后与硬件接收帧走完全相同的解码/分发路径
+// speed = 1 实时，> 1 按倍数加速，<= 0 不限速（接收线程跟不上时等待，不丢帧）
+// 回放帧的时间戳换算为当前主机时间（保持原始帧间隔，按speed缩放）
+class CANCaptureReplayer : public QThread
+{
+    Q_OBJECT
+public:
+    static const int RING_CAPACITY = 65536;
+
+    explicit CANCaptureReplayer(QObject *parent = nullptr);
+    ~CANCaptureReplayer();
+
+    // 线程启动前设置
+    void setFileName(const QString &path);
+    void setSpeed(double speed);
+    double speed() const { return m_speed; }
+
+    CANFrameRing *ring() { return &m_ring; }
+
+    // 启动回放线程（不要直接调用start()）
+    void startReplay();
+    void stop();
+    quint64 replayedFrames() const;
+
+signals:
+    void replayError(const QString &message);
+    // 回放结束（播完或被停止），frames为已写入接收源的帧数，elapsedUs为回放耗时
+    void replayFinished(quint64 frames, qint64 elapsedUs);
+
+protected:
+    void run() override;
+
+private:
+    QString m_fileName;
+    double m_speed;
+    CANFrameRing m_ring;
+    QAtomicInteger<quint64> m_replayed;
+    volatile bool m_running;
+};
+
+#endif // CAN_CAPTURE_REPLAY_H
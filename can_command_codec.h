@@ -0,0 +1,224 @@
+#ifndef CAN_COMMAND_CODEC_H
+#define CAN_COMMAND_CODEC_H
+
+#include <cstdint>
+#include <cstring>
+#include "ControlCAN.h"
+
+// 命令帧编码：直接在栈上生成VCI_CAN_OBJ，不经过QByteArray，发送热路径上没有堆分配
+// 固定内容的命令（模式切换、启停、点动、SDO读）为constexpr，可在编译期求值；
+// 浮点命令需要取浮点数的位模式，为inline函数
+//
+// 电机命令帧ID = 功能码<<7 | 节点号(0x00-0x7F)
+//   功能码0 控制：模式切换/启动/停止 FF FF FF FF FF FF <模式> FC|FD，点动 01|02 00..00，运控(MIT)
+//   功能码1 位置：float目标位置 + float最大转速
+//   功能码2 速度：float目标速度 + float输出限制
+//   功能码3 电流：float Iq + float Id
+enum CANCommandFunction {
+    CAN_CMD_FUNC_CONTROL = 0x00,
+    CAN_CMD_FUNC_POSITION = 0x01,
+    CAN_CMD_FUNC_SPEED = 0x02,
+    CAN_CMD_FUNC_CURRENT = 0x03
+};
+
+// 模式切换帧Data[6]
+enum CANControlMode {
+    CAN_MODE_MOTION = 0x00,     // 运控(MIT)
+    CAN_MODE_POSITION = 0x01,
+    CAN_MODE_SPEED = 0x02,
+    CAN_MODE_TORQUE = 0x03
+};
+
+constexpr UINT canCommandId(UINT function, UINT node)
+{
+    return (function << 7) | (node & 0x7F);
+}
+
+// 8字节标准数据帧
+constexpr VCI_CAN_OBJ canCommandFrame(UINT id, BYTE d0, BYTE d1, BYTE d2, BYTE d3,
+                                      BYTE d4, BYTE d5, BYTE d6, BYTE d7)
+{
+    return VCI_CAN_OBJ{ id, 0, 0, 0, 0, 0, 8, { d0, d1, d2, d3, d4, d5, d6, d7 }, { 0, 0, 0 } };
+}
+
+constexpr VCI_CAN_OBJ canEncodeModeSwitch(UINT node, CANControlMode mode)
+{
+    return canCommandFrame(canCommandId(CAN_CMD_FUNC_CONTROL, node),
+                           0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, static_cast<BYTE>(mode), 0xFC);
+}
+
+constexpr VCI_CAN_OBJ canEncodeStart(UINT node)
+{
+    return canCommandFrame(canCommandId(CAN_CMD_FUNC_CONTROL, node),
+                           0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFC);
+}
+
+constexpr VCI_CAN_OBJ canEncodeStop(UINT node)
+{
+    return canCommandFrame(canCommandId(CAN_CMD_FUNC_CONTROL, node),
+                           0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD);
+}
+
+// forward为true时正转点动(01)，否则反转点动(02)
+constexpr VCI_CAN_OBJ canEncodeJog(UINT node, bool forward)
+{
+    return canCommandFrame(canCommandId(CAN_CMD_FUNC_CONTROL, node),
+                           forward ? 0x01 : 0x02, 0, 0, 0, 0, 0, 0, 0);
+}
+
+// SDO上传请求 0x600+n: 40 idxL idxH sub 00 00 00 00
+constexpr VCI_CAN_OBJ canEncodeSdoRead(UINT node, uint16_t index, uint8_t subindex)
+{
+    return canCommandFrame(0x600 + node, 0x40,
+                           static_cast<BYTE>(index & 0xFF), static_cast<BYTE>((index >> 8) & 0xFF),
+                           subindex, 0, 0, 0, 0);
+}
+
+// 同步帧：无数据，成组命令末尾可选追加。电机固件是否按同步帧执行设定值尚未确认，
+// 所以没有默认COB-ID（CAN_SYNC_COB_ID_NONE即不追加），需按固件配置；
+// 注意CANopen常用的0x080在本协议里是节点0的位置命令
+#define CAN_SYNC_COB_ID_NONE 0
+
+constexpr VCI_CAN_OBJ canEncodeSync(UINT cobId)
+{
+    return VCI_CAN_OBJ{ cobId, 0, 0, 0, 0, 0, 0, { 0, 0, 0, 0, 0, 0, 0, 0 }, { 0, 0, 0 } };
+}
+
+// 同步帧COB-ID是否与本协议已用的ID冲突：命令/状态0x000-0x1FF、数据上抛和SDO 0x500-0x67F、心跳0x700-0x77F
+constexpr bool canSyncCobIdCollides(UINT cobId)
+{
+    return cobId < 0x200 || (cobId >= 0x500 && cobId <= 0x67F) || (cobId >= 0x700 && cobId <= 0x77F);
+}
+
+// 编译期检查编码结果与协议一致
+static_assert(canEncodeModeSwitch(5, CAN_MODE_SPEED).ID == 0x005 &&
+              canEncodeModeSwitch(5, CAN_MODE_SPEED).Data[6] == 0x02 &&
+              canEncodeModeSwitch(5, CAN_MODE_SPEED).Data[7] == 0xFC, "模式切换帧编码错误");
+static_assert(canEncodeStop(1).Data[7] == 0xFD && canEncodeJog(1, false).Data[0] == 0x02, "启停/点动帧编码错误");
+static_assert(canCommandId(CAN_CMD_FUNC_SPEED, 0x85) == 0x105, "命令帧ID编码错误");
+static_assert(canEncodeSdoRead(3, 0x6064, 0x01).ID == 0x603 &&
+              canEncodeSdoRead(3, 0x6064, 0x01).Data[1] == 0x64 &&
+              canEncodeSdoRead(3, 0x6064, 0x01).Data[2] == 0x60, "SDO读帧编码错误");
+static_assert(canEncodeSync(0x280).ID == 0x280 && canEncodeSync(0x280).DataLen == 0, "同步帧编码错误");
+static_assert(canSyncCobIdCollides(0x080) && !canSyncCobIdCollides(0x280), "同步帧COB-ID冲突检查错误");
+
+// 小端写入32位数
+inline void canPutU32LE(BYTE *out, uint32_t value)
+{
+    out[0] = static_cast<BYTE>(value & 0xFF);
+    out[1] = static_cast<BYTE>((value >> 8) & 0xFF);
+    out[2] = static_cast<BYTE>((value >> 16) & 0xFF);
+    out[3] = static_cast<BYTE>((value >> 24) & 0xFF);
+}
+
+// 两个float（IEEE754，小端）组成的8字节命令：位置/速度/电流
+inline VCI_CAN_OBJ canEncodeFloatPair(UINT function, UINT node, float first, float second)
+{
+    VCI_CAN_OBJ frame = canCommandFrame(canCommandId(function, node), 0, 0, 0, 0, 0, 0, 0, 0);
+    uint32_t bits;
+    memcpy(&bits, &first, sizeof(float));
+    canPutU32LE(&frame.Data[0], bits);
+    memcpy(&bits, &second, sizeof(float));
+    canPutU32LE(&frame.Data[4], bits);
+    return frame;
+}
+
+inline VCI_CAN_OBJ canEncodeSpeed(UINT node, float targetSpeed, float outputLimit)
+{
+    return canEncodeFloatPair(CAN_CMD_FUNC_SPEED, node, targetSpeed, outputLimit);
+}
+
+inline VCI_CAN_OBJ canEncodePosition(UINT node, float targetPosition, float maxSpeed)
+{
+    return canEncodeFloatPair(CAN_CMD_FUNC_POSITION, node, targetPosition, maxSpeed);
+}
+
+inline VCI_CAN_OBJ canEncodeCurrent(UINT node, float iq, float id)
+{
+    return canEncodeFloatPair(CAN_CMD_FUNC_CURRENT, node, iq, id);
+}
+
+// 运控(MIT)命令量化后的原始值
+struct CANMotionRaw {
+    uint16_t position;  // 16位：-12.57 ~ 12.57 rad
+    uint16_t velocity;  // 12位：-50 ~ 50 rad/s
+    uint16_t kp;        // 12位：0 ~ 5000
+    uint16_t kd;        // 12位：0 ~ 100
+    uint16_t torque;    // 12位：-36 ~ 36 N·m
+};
+
+// 线性量化到[0, maxRaw]，超出范围的输入先限幅（不对负数做无符号转换）
+inline uint16_t canQuantize(float value, float minValue, float span, float scale, int maxRaw)
+{
+    float raw = (value - minValue) / span * scale;
+    if (!(raw > 0.0f))
+        return 0;
+    if (raw >= static_cast<float>(maxRaw))
+        return static_cast<uint16_t>(maxRaw);
+    return static_cast<uint16_t>(raw);
+}
+
+inline CANMotionRaw canQuantizeMotion(float kp, float kd, float position, float velocity, float torque)
+{
+    CANMotionRaw raw;
+    raw.position = canQuantize(position, -12.57f, 25.14f, 65535.0f, 65535);
+    raw.velocity = canQuantize(velocity, -50.0f, 100.0f, 4096.0f, 4095);
+    raw.kp = canQuantize(kp, 0.0f, 5000.0f, 4096.0f, 4095);
+    raw.kd = canQuantize(kd, 0.0f, 100.0f, 4096.0f, 4095);
+    raw.torque = canQuantize(torque, -36.0f, 72.0f, 4096.0f, 4095);
+    return raw;
+}
+
+// MIT协议格式：pos[16] vel[12] kp[12] kd[12] torque[12]，大端位序
+constexpr VCI_CAN_OBJ canEncodeMotion(UINT node, CANMotionRaw raw)
+{
+    return canCommandFrame(canCommandId(CAN_CMD_FUNC_CONTROL, node),
+                           static_cast<BYTE>((raw.position >> 8) & 0xFF),
+                           static_cast<BYTE>(raw.position & 0xFF),
+                           static_cast<BYTE>((raw.velocity >> 4) & 0xFF),
+                           static_cast<BYTE>(((raw.velocity & 0x0F) << 4) | ((raw.kp >> 8) & 0x0F)),
+                           static_cast<BYTE>(raw.kp & 0xFF),
+                           static_cast<BYTE>((raw.kd >> 4) & 0xFF),
+                           static_cast<BYTE>(((raw.kd & 0x0F) << 4) | ((raw.torque >> 8) & 0x0F)),
+                           static_cast<BYTE>(raw.torque & 0xFF));
+}
+
+// SDO快速下载 0x600+n：1/2/4字节分别用2F/2B/23，其它长度按原协议用22并截取前4字节
+inline VCI_CAN_OBJ canEncodeSdoWrite(UINT node, uint16_t index, uint8_t subindex, const void *data, int size)
+{
+    BYTE specifier = 0x22;
+    if (size == 1) {
+        specifier = 0x2F;
+    } else if (size == 2) {
+        specifier = 0x2B;
+    } else if (size == 4) {
+        specifier = 0x23;
+    }
+    VCI_CAN_OBJ frame = canCommandFrame(0x600 + node, specifier,
+                                        static_cast<BYTE>(index & 0xFF), static_cast<BYTE>((index >> 8) & 0xFF),
+                                        subindex, 0, 0, 0, 0);
+    if (size > 0)
+        memcpy(&frame.Data[4], data, size < 4 ? size : 4);
+    return frame;
+}
+
+// 数据上抛单参数读（cobId由调用方按命令类型和节点计算）：idxH idxL sub 00，4字节
+constexpr VCI_CAN_OBJ canEncodeUpdateRead(UINT cobId, uint16_t index, uint8_t subindex)
+{
+    return VCI_CAN_OBJ{ cobId, 0, 0, 0, 0, 0, 4,
+                        { static_cast<BYTE>((index >> 8) & 0xFF), static_cast<BYTE>(index & 0xFF), subindex, 0,
+                          0, 0, 0, 0 },
+                        { 0, 0, 0 } };
+}
+
+// 数据上抛双参数读：idx1H idx1L sub1 idx2H idx2L sub2 00 00
+constexpr VCI_CAN_OBJ canEncodeUpdateReadMulti(UINT cobId, uint16_t index1, uint8_t subindex1,
+                                               uint16_t index2, uint8_t subindex2)
+{
+    return canCommandFrame(cobId,
+                           static_cast<BYTE>((index1 >> 8) & 0xFF), static_cast<BYTE>(index1 & 0xFF), subindex1,
+                           static_cast<BYTE>((index2 >> 8) & 0xFF), static_cast<BYTE>(index2 & 0xFF), subindex2,
+                           0, 0);
+}
+
+#endif // CAN_COMMAND_CODEC_H
@@ -12,28 +12,14 @@ CANCommunicationThread::CANCommunicationThread(QObject *parent)
     , m_receiveCount(0)
     , m_sendFrequency(0.0)
     , m_receiveFrequency(0.0)
-    , m_sendInterval(1) // 默认1ms间隔
-    , m_sendTimer(nullptr)
-    , m_statsTimer(nullptr)
 {
-    // 定时器将在run()函数中创建，避免线程问题
     m_lastStatsTime = QTime::currentTime();
 }
 
 CANCommunicationThread::~CANCommunicationThread()
 {
     stopCommunication();
-    quit();
     wait();
-    
-    if (m_sendTimer) {
-        delete m_sendTimer;
-        m_sendTimer = nullptr;
-    }
-    if (m_statsTimer) {
-        delete m_statsTimer;
-        m_statsTimer = nullptr;
-    }
 }
 
 void CANCommunicationThread::setCANTxRx(CANTxRx* canTxRx)
@@ -41,16 +27,29 @@ void CANCommunicationThread::setCANTxRx(CANTxRx* canTxRx)
     m_canTxRx = canTxRx;
 }
 
-void CANCommunicationThread::sendCANFrame(uint32_t id, const QByteArray& data)
+bool CANCommunicationThread::sendCANFrame(uint32_t id, const QByteArray& data)
 {
-    if (!m_communicationActive) {
-        return;
+    if (!m_communicationActive || !m_canTxRx) {
+        return false;
     }
-    
-    CANFrame frame(id, data);
-    
-    QMutexLocker locker(&m_sendMutex);
-    m_sendQueue.enqueue(frame);
+
+    // 直接入队到通道发送线程，按帧内容分优先级（停止命令优先），不在本线程逐帧定时发送
+    if (!m_canTxRx->sendCANFrame(id, data)) {
+        qDebug() << "❌ CAN发送失败 - ID:0x" << QString::number(id, 16);
+        return false;
+    }
+
+    int count = m_sendCount.fetchAndAddRelaxed(1) + 1;
+    emit canFrameSent(id, data);
+
+    // 调试输出（每100次输出一次）
+    if (count % 100 == 0) {
+        qDebug() << QString("📤 CAN发送成功 - ID:0x%1 数据:%2 (总计:%3次)")
+                    .arg(id, 0, 16)
+                    .arg(QString(data.toHex(' ').toUpper()))
+                    .arg(count);
+    }
+    return true;
 }
 
 void CANCommunicationThread::startCommunication()
@@ -65,109 +64,48 @@ void CANCommunicationThread::startCommunication()
 
 void CANCommunicationThread::stopCommunication()
 {
+    QMutexLocker locker(&m_mutex);
     m_communicationActive = false;
     m_running = false;
-    
-    if (m_sendTimer && m_sendTimer->isActive()) {
-        m_sendTimer->stop();
-    }
-    if (m_statsTimer && m_statsTimer->isActive()) {
-        m_statsTimer->stop();
-    }
-}
-
-void CANCommunicationThread::setSendInterval(int intervalMs)
-{
-    m_sendInterval = qMax(1, intervalMs);
-    if (m_sendTimer && m_sendTimer->isActive()) {
-        m_sendTimer->setInterval(m_sendInterval);
-    }
+    m_condition.wakeAll();
 }
 
 void CANCommunicationThread::run()
 {
-    // 在线程中创建定时器
-    m_sendTimer = new QTimer();
-    m_statsTimer = new QTimer();
-    
-    // 连接定时器信号
-    connect(m_sendTimer, &QTimer::timeout, this, &CANCommunicationThread::processSendQueue);
-    connect(m_statsTimer, &QTimer::timeout, this, &CANCommunicationThread::updateStatistics);
+    qDebug() << "🚀 CAN通信线程已启动";
     
-    // 设置统计更新间隔
-    m_statsTimer->setInterval(1000); // 每秒更新一次统计
-    
-    // 启动定时器
-    m_sendTimer->start(m_sendInterval);
-    m_statsTimer->start(1000);
-    
-    qDebug() << "🚀 CAN通信线程已启动，发送间隔:" << m_sendInterval << "ms";
-    
-    // 主循环
+    // 主循环：run()中没有事件循环，用条件变量定时唤醒统计，停止时立即唤醒
+    QMutexLocker locker(&m_mutex);
     while (m_running) {
-        // 处理接收数据
+        m_condition.wait(&m_mutex, 1000);
+        if (!m_running) {
+            break;
+        }
+
+        locker.unlock();
         processReceivedFrames();
-        
-        // 短暂休眠，避免CPU占用过高
-        msleep(1);
-    }
-    
-    // 停止定时器
-    if (m_sendTimer) {
-        m_sendTimer->stop();
-    }
-    if (m_statsTimer) {
-        m_statsTimer->stop();
+        updateStatistics();
+        locker.relock();
     }
     
     qDebug() << "🛑 CAN通信线程已停止";
 }
 
-void CANCommunicationThread::processSendQueue()
-{
-    if (!m_communicationActive || !m_canTxRx) {
-        return;
-    }
-    
-    QMutexLocker locker(&m_sendMutex);
-    
-    if (!m_sendQueue.isEmpty()) {
-        CANFrame frame = m_sendQueue.dequeue();
-        
-        // 发送CAN帧
-        if (m_canTxRx->sendCANFrame(frame.id, frame.data)) {
-            m_sendCount++;
-            
-            // 发送成功信号
-            emit canFrameSent(frame.id, frame.data);
-            
-            // 调试输出（每100次输出一次）
-            if (m_sendCount % 100 == 0) {
-                qDebug() << QString("📤 CAN发送成功 - ID:0x%1 数据:%2 (总计:%3次)")
-                            .arg(frame.id, 0, 16)
-                            .arg(QString(frame.data.toHex(' ').toUpper()))
-                            .arg(m_sendCount);
-            }
-        } else {
-            qDebug() << "❌ CAN发送失败 - ID:0x" << QString::number(frame.id, 16);
-        }
-    }
-}
-
 void CANCommunicationThread::updateStatistics()
 {
     QTime currentTime = QTime::currentTime();
     int elapsed = m_lastStatsTime.msecsTo(currentTime);
     
     if (elapsed > 0) {
-        m_sendFrequency = m_sendCount * 1000.0 / elapsed;
+        // 取出并清零发送计数
+        int sendCount = m_sendCount.fetchAndStoreOrdered(0);
+        m_sendFrequency = sendCount * 1000.0 / elapsed;
         m_receiveFrequency = m_receiveCount * 1000.0 / elapsed;
         
         // 发送统计信息信号
-        emit statisticsUpdated(m_sendCount, m_receiveCount, m_sendFrequency, m_receiveFrequency);
+        emit statisticsUpdated(sendCount, m_receiveCount, m_sendFrequency, m_receiveFrequency);
         
         // 重置计数器和时间
-        m_sendCount = 0;
         m_receiveCount = 0;
         m_lastStatsTime = currentTime;
     }
@@ -3,8 +3,9 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInteger>
 #include <QQueue>
-#include <QTimer>
 #include <QByteArray>
 #include <QTime>
 
@@ -22,6 +23,8 @@ struct CANFrame {
 };
 
 // CAN通信线程类
+// 发送不再经过本线程排队：帧直接交给CANTxRx，由通道的发送线程（CANTxBatcher）按优先级调度，
+// 停止命令不会排在示波器轮询等低优先级帧之后；本线程只负责每秒统计一次收发频率
 class CANCommunicationThread : public QThread
 {
     Q_OBJECT
@@ -33,18 +36,15 @@ public:
     // 设置CAN组件
     void setCANTxRx(CANTxRx* canTxRx);
     
-    // 发送CAN帧（非阻塞）
-    void sendCANFrame(uint32_t id, const QByteArray& data);
+    // 发送CAN帧（非阻塞，入队到发送线程）
+    bool sendCANFrame(uint32_t id, const QByteArray& data);
     
     // 启动/停止通信
     void startCommunication();
     void stopCommunication();
     
-    // 设置发送频率
-    void setSendInterval(int intervalMs);
-    
     // 获取统计信息
-    int getSendCount() const { return m_sendCount; }
+    int getSendCount() const { return m_sendCount.load(); }
     int getReceiveCount() const { return m_receiveCount; }
     double getSendFrequency() const { return m_sendFrequency; }
     double getReceiveFrequency() const { return m_receiveFrequency; }
@@ -53,7 +53,7 @@ signals:
     // 接收到CAN帧信号
     void canFrameReceived(const CANFrame& frame);
     
-    // 发送完成信号
+    // 发送入队成功信号（在调用sendCANFrame的线程中发出）
     void canFrameSent(uint32_t id, const QByteArray& data);
     
     // 统计信息更新信号
@@ -62,16 +62,14 @@ signals:
 protected:
     void run() override;
 
-private slots:
-    void processSendQueue();
+private:
     void updateStatistics();
 
-private:
     CANTxRx* m_canTxRx;
     
-    // 发送队列
-    QQueue<CANFrame> m_sendQueue;
-    QMutex m_sendMutex;
+    // 统计线程休眠/唤醒
+    QMutex m_mutex;
+    QWaitCondition m_condition;
     
     // 接收队列
     QQueue<CANFrame> m_receiveQueue;
@@ -81,20 +79,13 @@ private:
     volatile bool m_running;
     volatile bool m_communicationActive;
     
-    // 定时器
-    QTimer* m_sendTimer;
-    QTimer* m_statsTimer;
-    
-    // 统计信息
-    int m_sendCount;
+    // 统计信息（m_sendCount由调用sendCANFrame的线程累加）
+    QAtomicInt m_sendCount;
     int m_receiveCount;
     QTime m_lastStatsTime;
     double m_sendFrequency;
     double m_receiveFrequency;
     
-    // 发送间隔
-    int m_sendInterval;
-    
     // 处理接收数据
     void processReceivedFrames();
 };
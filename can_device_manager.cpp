@@ -0,0 +1,242 @@
+#include "can_device_manager.h"
+#include "canthread.h"
+#include "can_tx_batcher.h"
+#include "can_status_sample.h"
+#include <QDebug>
+#include <cstring>
+
+const int CANDeviceManager::MAX_DEVICES;
+const int CANDeviceManager::CHANNELS_PER_DEVICE;
+const int CANDeviceManager::MAX_CHANNELS;
+
+static_assert(CANDeviceManager::MAX_CHANNELS <= CAN_STATUS_MAX_CHANNELS, "节点键容纳不下全部通道");
+
+CANDeviceManager::CANDeviceManager(QObject *parent)
+    : QObject(parent)
+    , m_latencyTracer(nullptr)
+{
+    for (int slot = 0; slot < MAX_DEVICES; slot++) {
+        m_devices[slot].thread = nullptr;
+        m_devices[slot].owned = false;
+    }
+}
+
+CANDeviceManager::~CANDeviceManager()
+{
+    closeAll();
+}
+
+int CANDeviceManager::addDevice(CANThread *canThread, bool takeOwnership)
+{
+    if (!canThread)
+        return -1;
+
+    int slot = -1;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < MAX_DEVICES; i++) {
+            if (m_devices[i].thread == canThread)
+                return i;
+            if (slot < 0 && !m_devices[i].thread)
+                slot = i;
+        }
+        if (slot < 0) {
+            qWarning() << "CAN适配器数量已达上限" << MAX_DEVICES;
+            return -1;
+        }
+
+        // 接收帧的通道标记改为全局通道号
+        canThread->setChannelTagBase(globalChannel(slot, 0));
+
+        Device &device = m_devices[slot];
+        device.thread = canThread;
+        device.owned = takeOwnership;
+        device.txBatchers.clear();
+        for (int ch = 0; ch < canThread->channelCount(); ch++) {
+            CANTxBatcher *batcher = new CANTxBatcher(this);
+            batcher->setCANThread(canThread);
+            batcher->setChannel(static_cast<UINT>(ch));
+            batcher->setLatencyTracer(m_latencyTracer);
+            connect(batcher, &CANTxBatcher::batchSent, this, &CANDeviceManager::batchSent);
+            batcher->start(QThread::HighPriority);
+            device.txBatchers.append(batcher);
+        }
+    }
+
+    qDebug() << "CAN适配器接入槽位" << slot << "后端:" << canThread->backend()->name()
+             << "设备索引:" << canThread->m_debicIndex;
+    emit deviceAdded(slot);
+    return slot;
+}
+
+int CANDeviceManager::openDevice(CANBackend::Type backendType, UINT deviceType, UINT deviceIndex, UINT baudRate)
+{
+    CANThread *canThread = new CANThread();
+    if (canThread->backend()->type() != backendType)
+        canThread->setBackend(CANBackend::create(backendType));
+
+    if (!canThread->openDevice(deviceType, deviceIndex, baudRate)) {
+        qWarning() << "CAN适配器" << deviceIndex << "打开失败";
+        delete canThread;
+        return -1;
+    }
+    if (!(canThread->initCAN() && canThread->startCAN())) {
+        qWarning() << "CAN适配器" << deviceIndex << "通道初始化/启动失败";
+        canThread->closeDevice();
+        delete canThread;
+        return -1;
+    }
+
+    int slot = addDevice(canThread, true);
+    if (slot < 0) {
+        canThread->closeDevice();
+        delete canThread;
+    }
+    return slot;
+}
+
+void CANDeviceManager::releaseDevice(Device &device)
+{
+    for (CANTxBatcher *batcher : device.txBatchers) {
+        batcher->stop();
+        delete batcher;
+    }
+    device.txBatchers.clear();
+
+    if (device.owned) {
+        device.thread->stop();
+        device.thread->wait();
+        device.thread->closeDevice();
+        delete device.thread;
+    }
+    device.thread = nullptr;
+    device.owned = false;
+}
+
+void CANDeviceManager::removeDevice(int slot)
+{
+    if (slot < 0 || slot >= MAX_DEVICES || !device(slot))
+        return;
+    emit deviceAboutToBeRemoved(slot);
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_devices[slot].thread)
+            return;
+        releaseDevice(m_devices[slot]);
+    }
+    emit deviceRemoved(slot);
+}
+
+void CANDeviceManager::closeAll()
+{
+    for (int slot = 0; slot < MAX_DEVICES; slot++)
+        removeDevice(slot);
+}
+
+int CANDeviceManager::deviceCount() const
+{
+    // 槽位按顺序分配，取最高的已用槽位，保证全局通道号连续
+    QMutexLocker locker(&m_mutex);
+    int count = 0;
+    for (int slot = 0; slot < MAX_DEVICES; slot++) {
+        if (m_devices[slot].thread)
+            count = slot + 1;
+    }
+    return count;
+}
+
+CANThread *CANDeviceManager::device(int slot) const
+{
+    if (slot < 0 || slot >= MAX_DEVICES)
+        return nullptr;
+    QMutexLocker locker(&m_mutex);
+    return m_devices[slot].thread;
+}
+
+QList<CANFrameRing*> CANDeviceManager::rxRings(int slot) const
+{
+    QList<CANFrameRing*> rings;
+    CANThread *canThread = device(slot);
+    if (canThread) {
+        for (int ch = 0; ch < canThread->channelCount(); ch++)
+            rings.append(canThread->rxRing(ch));
+    }
+    return rings;
+}
+
+CANRxWorker::Statistics CANDeviceManager::channelStatistics(UINT globalChannel) const
+{
+    CANThread *canThread = device(slotOf(globalChannel));
+    UINT channel = localChannel(globalChannel);
+    if (canThread && static_cast<int>(channel) < canThread->channelCount())
+        return canThread->channelStatistics(static_cast<int>(channel));
+
+    CANRxWorker::Statistics empty;
+    memset(&empty, 0, sizeof(empty));
+    return empty;
+}
+
+void CANDeviceManager::startAll()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int slot = 0; slot < MAX_DEVICES; slot++) {
+        CANThread *canThread = m_devices[slot].thread;
+        if (canThread && !canThread->isRunning())
+            canThread->start();
+    }
+}
+
+void CANDeviceManager::stopAll()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int slot = 0; slot < MAX_DEVICES; slot++) {
+        CANThread *canThread = m_devices[slot].thread;
+        if (canThread && canThread->isRunning()) {
+            canThread->stop();
+            canThread->wait();
+        }
+    }
+}
+
+bool CANDeviceManager::sendFrame(UINT globalChannel, const VCI_CAN_OBJ &frame)
+{
+    QMutexLocker locker(&m_mutex);
+    CANTxBatcher *batcher = txBatcher(globalChannel);
+    return batcher && batcher->enqueue(frame);
+}
+
+int CANDeviceManager::sendFrames(UINT globalChannel, const VCI_CAN_OBJ *frames, int count)
+{
+    QMutexLocker locker(&m_mutex);
+    CANTxBatcher *batcher = txBatcher(globalChannel);
+    return batcher ? batcher->enqueueBurst(frames, count) : 0;
+}
+
+bool CANDeviceManager::sendGroup(UINT globalChannel, const VCI_CAN_OBJ *frames, int count)
+{
+    QMutexLocker locker(&m_mutex);
+    CANTxBatcher *batcher = txBatcher(globalChannel);
+    return batcher ? batcher->enqueueGroup(frames, count) : false;
+}
+
+CANTxBatcher *CANDeviceManager::txBatcher(UINT globalChannel) const
+{
+    int slot = slotOf(globalChannel);
+    if (slot >= MAX_DEVICES)
+        return nullptr;
+    const Device &device = m_devices[slot];
+    UINT channel = localChannel(globalChannel);
+    if (!device.thread || static_cast<int>(channel) >= device.txBatchers.size())
+        return nullptr;
+    return device.txBatchers.at(static_cast<int>(channel));
+}
+
+void CANDeviceManager::setLatencyTracer(CANLatencyTracer *tracer)
+{
+    QMutexLocker locker(&m_mutex);
+    m_latencyTracer = tracer;
+    for (const Device &device : m_devices) {
+        for (CANTxBatcher *batcher : device.txBatchers)
+            batcher->setLatencyTracer(tracer);
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef CAN_DEVICE_MANAGER_H
+#define CAN_DEVICE_MANAGER_H
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+#include <QMutex>
+#include "ControlCAN.h"
+#include "can_backend.h"
+#include "can_rx_worker.h"
+
+class CANThread;
+class CANTxBatcher;
+class CANFrameRing;
+class CANLatencyTracer;
+
+// 多适配器管理：同时打开多个CAN适配器，每个适配器独立的接收/发送线程
+// 对上层统一为全局通道号 = 设备槽位*2 + 设备内通道（与can_types.h中的帧通道标记一致）
+// 接收：各通道的环形缓冲都接入CANReceiver，帧中带全局通道号
+// 发送：按全局通道号路由到对应适配器通道的批量发送线程
+class CANDeviceManager : public QObject
+{
+    Q_OBJECT
+public:
+    static const int MAX_DEVICES = 4;
+    static const int CHANNELS_PER_DEVICE = 2;
+    static const int MAX_CHANNELS = MAX_DEVICES * CHANNELS_PER_DEVICE;
+
+    explicit CANDeviceManager(QObject *parent = nullptr);
+    ~CANDeviceManager();
+
+    // 接入已打开并启动的CANThread，返回分配的槽位，失败返回-1
+    int addDevice(CANThread *canThread, bool takeOwnership = false);
+    // 按后端类型打开一个适配器并初始化、启动所有通道，返回槽位，失败返回-1
+    int openDevice(CANBackend::Type backendType, UINT deviceType, UINT deviceIndex, UINT baudRate);
+    void removeDevice(int slot);
+    void closeAll();
+
+    int deviceCount() const;
+    int channelCount() const { return deviceCount() * CHANNELS_PER_DEVICE; }
+    CANThread *device(int slot) const;
+    QList<CANFrameRing*> rxRings(int slot) const;
+    CANRxWorker::Statistics channelStatistics(UINT globalChannel) const;
+
+    static UINT globalChannel(int slot, UINT channel) { return static_cast<UINT>(slot) * CHANNELS_PER_DEVICE + channel; }
+    static int slotOf(UINT globalChannel) { return static_cast<int>(globalChannel / CHANNELS_PER_DEVICE); }
+    static UINT localChannel(UINT globalChannel) { return globalChannel % CHANNELS_PER_DEVICE; }
+
+    // 启动/停止所有适配器的接收线程
+    void startAll();
+    void stopAll();
+
+    // 发送（按全局通道号路由），帧先进入该通道的批量发送线程
+    bool sendFrame(UINT globalChannel, const VCI_CAN_OBJ &frame);
+    int sendFrames(UINT globalChannel, const VCI_CAN_OBJ *frames, int count);
+    // 成组发送，整组不拆分（见CANTxBatcher::enqueueGroup）
+    bool sendGroup(UINT globalChannel, const VCI_CAN_OBJ *frames, int count);
+    // 返回的指针在设备移除前有效
+    CANTxBatcher *txBatcher(UINT globalChannel) const;
+    // 所有通道（含之后接入的适配器）的发送线程使用同一个延迟跟踪器
+    void setLatencyTracer(CANLatencyTracer *tracer);
+
+signals:
+    void deviceAdded(int slot);
+    // 设备释放前发出（直接连接），使用者需在此时移除对其环形缓冲的引用
+    void deviceAboutToBeRemoved(int slot);
+    void deviceRemoved(int slot);
+    // 任一通道一批发送完成
+    void batchSent(int requested, int sent);
+
+private:
+    struct Device {
+        CANThread *thread;
+        bool owned;
+        QVector<CANTxBatcher*> txBatchers;   // 每通道一个
+    };
+
+    void releaseDevice(Device &device);
+
+    mutable QMutex m_mutex;
+    Device m_devices[MAX_DEVICES];
+    CANLatencyTracer *m_latencyTracer;
+};
+
+#endif // CAN_DEVICE_MANAGER_H
@@ -0,0 +1,249 @@
+#include "can_dispatcher.h"
+#include <QMap>
+#include <QThread>
+#include <QMetaObject>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+    const UINT STD_ID_MASK = 0x7FF;
+    const UINT EXT_ID_MASK = 0x1FFFFFFF;
+}
+
+const int CANDispatcher::STD_ID_COUNT;
+
+CANDispatcher::CANDispatcher(QObject *parent)
+    : QObject(parent)
+    , m_table(new Table)
+    , m_nextHandle(1)
+    , m_changed(1)
+    , m_hasPending(false)
+    , m_deliverMutex(QMutex::Recursive)
+{
+}
+
+CANDispatcher::~CANDispatcher()
+{
+}
+
+int CANDispatcher::subscribe(UINT id, QObject *context, CANFrameHandler handler,
+                             Qt::ConnectionType type, bool extended)
+{
+    return subscribeRange(id, id, context, handler, type, extended);
+}
+
+int CANDispatcher::subscribeRange(UINT first, UINT last, QObject *context, CANFrameHandler handler,
+                                  Qt::ConnectionType type, bool extended)
+{
+    if (!context || !handler) {
+        qWarning() << "CAN分发订阅缺少context或处理函数";
+        return -1;
+    }
+    if (first > last)
+        std::swap(first, last);
+    UINT idMask = extended ? EXT_ID_MASK : STD_ID_MASK;
+    if (first > idMask)
+        return -1;
+
+    Subscription subscription;
+    subscription.first = first;
+    subscription.last = qMin(last, idMask);
+    subscription.extended = extended;
+    subscription.context = context;
+    subscription.handler = handler;
+    subscription.type = type;
+    subscription.alive = QSharedPointer<QAtomicInt>(new QAtomicInt(1));
+
+    {
+        QMutexLocker locker(&m_mutex);
+        subscription.handle = m_nextHandle++;
+        m_subscriptions.append(subscription);
+        rebuild();
+    }
+    emit subscriptionsChanged();
+
+    // context销毁前自动退订（直接连接，在销毁它的线程中执行）
+    connect(context, &QObject::destroyed, this, [this](QObject *object) {
+        unsubscribe(object);
+    }, Qt::DirectConnection);
+
+    return subscription.handle;
+}
+
+void CANDispatcher::unsubscribe(int handle)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        bool removed = false;
+        for (int i = m_subscriptions.size() - 1; i >= 0; i--) {
+            if (m_subscriptions.at(i).handle == handle) {
+                m_subscriptions.at(i).alive->storeRelease(0);
+                m_subscriptions.removeAt(i);
+                removed = true;
+            }
+        }
+        if (!removed)
+            return;
+        rebuild();
+    }
+    emit subscriptionsChanged();
+    // 等待正在进行的投递结束
+    QMutexLocker deliverLocker(&m_deliverMutex);
+}
+
+void CANDispatcher::unsubscribe(QObject *context)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        bool removed = false;
+        for (int i = m_subscriptions.size() - 1; i >= 0; i--) {
+            if (m_subscriptions.at(i).context == context) {
+                m_subscriptions.at(i).alive->storeRelease(0);
+                m_subscriptions.removeAt(i);
+                removed = true;
+            }
+        }
+        if (!removed)
+            return;
+        rebuild();
+    }
+    disconnect(context, nullptr, this, nullptr);
+    emit subscriptionsChanged();
+    QMutexLocker deliverLocker(&m_deliverMutex);
+}
+
+int CANDispatcher::subscriptionCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_subscriptions.size();
+}
+
+CANAcceptanceFilter CANDispatcher::acceptanceFilter() const
+{
+    QMutexLocker locker(&m_mutex);
+    CANAcceptanceFilter filter;
+    for (const Subscription &subscription : m_subscriptions)
+        filter.addRange(subscription.first, subscription.last, subscription.extended);
+    return filter;
+}
+
+void CANDispatcher::rebuild()
+{
+    // 调用方持有m_mutex
+    Table *table = new Table;
+    table->subscriptions = m_subscriptions;
+    table->standard.fill(0, STD_ID_COUNT);
+
+    // 覆盖同一ID的订阅者组合相同时共用一个列表
+    QMap<QVector<int>, int> listIndex;
+    QVector<int> covering;
+    for (int id = 0; id < STD_ID_COUNT; id++) {
+        covering.clear();
+        for (int i = 0; i < m_subscriptions.size(); i++) {
+            const Subscription &subscription = m_subscriptions.at(i);
+            if (!subscription.extended &&
+                static_cast<UINT>(id) >= subscription.first &&
+                static_cast<UINT>(id) <= subscription.last) {
+                covering.append(i);
+            }
+        }
+        if (covering.isEmpty())
+            continue;
+
+        auto it = listIndex.constFind(covering);
+        int index;
+        if (it == listIndex.constEnd()) {
+            index = table->targets.size();
+            table->targets.append(covering);
+            listIndex.insert(covering, index);
+        } else {
+            index = it.value();
+        }
+        table->standard[id] = static_cast<quint16>(index + 1);
+    }
+
+    for (int i = 0; i < m_subscriptions.size(); i++) {
+        if (m_subscriptions.at(i).extended)
+            table->extended.append(i);
+    }
+
+    m_table = QSharedPointer<const Table>(table);
+    m_changed.storeRelease(1);
+}
+
+void CANDispatcher::dispatch(const VCI_CAN_OBJ *frames, int count)
+{
+    if (m_changed.loadAcquire()) {
+        // 订阅变化：先按旧表投递已归类的帧，再换用新表
+        flush();
+        m_changed.storeRelease(0);
+        QMutexLocker locker(&m_mutex);
+        m_current = m_table;
+        m_pending.clear();
+        m_pending.resize(m_current->subscriptions.size());
+    }
+
+    const Table &table = *m_current;
+    if (table.subscriptions.isEmpty())
+        return;
+
+    const quint16 *standard = table.standard.constData();
+    for (int i = 0; i < count; i++) {
+        const VCI_CAN_OBJ &frame = frames[i];
+        if (!frame.ExternFlag) {
+            if (frame.ID > STD_ID_MASK)
+                continue;
+            quint16 entry = standard[frame.ID];
+            if (entry == 0)
+                continue;
+            const QVector<int> &targets = table.targets.at(entry - 1);
+            for (int index : targets)
+                m_pending[index].append(frame);
+            m_hasPending = true;
+        } else {
+            for (int index : table.extended) {
+                const Subscription &subscription = table.subscriptions.at(index);
+                if (frame.ID >= subscription.first && frame.ID <= subscription.last) {
+                    m_pending[index].append(frame);
+                    m_hasPending = true;
+                }
+            }
+        }
+    }
+}
+
+void CANDispatcher::flush()
+{
+    if (!m_hasPending || !m_current)
+        return;
+
+    QMutexLocker deliverLocker(&m_deliverMutex);
+    const Table &table = *m_current;
+    for (int i = 0; i < m_pending.size(); i++) {
+        if (m_pending.at(i).isEmpty())
+            continue;
+        QVector<VCI_CAN_OBJ> batch;
+        batch.swap(m_pending[i]);
+        const Subscription &subscription = table.subscriptions.at(i);
+        if (subscription.alive->loadAcquire())
+            deliver(subscription, batch);
+    }
+    m_hasPending = false;
+}
+
+void CANDispatcher::deliver(const Subscription &subscription, const QVector<VCI_CAN_OBJ> &frames)
+{
+    if (subscription.type == Qt::DirectConnection ||
+        (subscription.type == Qt::AutoConnection && subscription.context->thread() == QThread::currentThread())) {
+        subscription.handler(frames);
+        return;
+    }
+
+    // 投递到context所在线程；执行时再检查一次，退订后已排队的批次不再处理
+    CANFrameHandler handler = subscription.handler;
+    QSharedPointer<QAtomicInt> alive = subscription.alive;
+    QMetaObject::invokeMethod(subscription.context, [handler, alive, frames]() {
+        if (alive->loadAcquire())
+            handler(frames);
+    }, Qt::QueuedConnection);
+}
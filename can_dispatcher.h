@@ -0,0 +1,86 @@
+#ifndef CAN_DISPATCHER_H
+#define CAN_DISPATCHER_H
+
+#include <QObject>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicInteger>
+#include <QSharedPointer>
+#include <functional>
+#include "ControlCAN.h"
+#include "can_types.h"
+#include "can_acceptance_filter.h"
+
+// 处理函数：每次收到一批匹配的帧（按到达顺序）
+typedef std::function<void(const CANFrameBatch &frames)> CANFrameHandler;
+
+// 按COB-ID查表分发接收帧，替代每个监听者各自对全部帧做范围判断
+// 标准帧用2048项的稠密表直接索引，扩展帧按区间匹配
+// 处理函数只收到自己订阅的帧，按批次投递到context所在线程（DirectConnection时在接收线程直接调用）
+// dispatch()/flush()只由接收线程调用；订阅/退订可在任意线程进行，退订返回后不会再投递新批次
+class CANDispatcher : public QObject
+{
+    Q_OBJECT
+public:
+    static const int STD_ID_COUNT = 2048;
+
+    explicit CANDispatcher(QObject *parent = nullptr);
+    ~CANDispatcher();
+
+    // 订阅单个ID或ID区间，返回订阅句柄；context销毁时自动退订
+    int subscribe(UINT id, QObject *context, CANFrameHandler handler,
+                  Qt::ConnectionType type = Qt::AutoConnection, bool extended = false);
+    int subscribeRange(UINT first, UINT last, QObject *context, CANFrameHandler handler,
+                       Qt::ConnectionType type = Qt::AutoConnection, bool extended = false);
+    void unsubscribe(int handle);
+    void unsubscribe(QObject *context);
+    int subscriptionCount() const;
+    // 当前所有订阅的ID区间并集，用作硬件接收过滤
+    CANAcceptanceFilter acceptanceFilter() const;
+
+    // 接收线程：把帧按ID归入各订阅者的待投递批次
+    void dispatch(const VCI_CAN_OBJ *frames, int count);
+    // 接收线程：投递所有待投递批次
+    void flush();
+
+signals:
+    // 订阅/退订后发出（在调用订阅接口的线程中）
+    void subscriptionsChanged();
+
+private:
+    struct Subscription {
+        int handle;
+        UINT first;
+        UINT last;
+        bool extended;
+        QObject *context;
+        CANFrameHandler handler;
+        Qt::ConnectionType type;
+        QSharedPointer<QAtomicInt> alive;   // 退订时清零，投递前检查
+    };
+
+    // 订阅变化时整体重建，接收线程持有快照，查表不加锁
+    struct Table {
+        QVector<Subscription> subscriptions;
+        QVector<quint16> standard;              // ID -> targets下标+1，0表示无人订阅
+        QVector<QVector<int>> targets;          // 订阅同一组ID的订阅者下标列表
+        QVector<int> extended;                  // 扩展帧订阅者下标
+    };
+
+    void rebuild();
+    void deliver(const Subscription &subscription, const QVector<VCI_CAN_OBJ> &frames);
+
+    mutable QMutex m_mutex;                     // 保护m_subscriptions/m_table
+    QVector<Subscription> m_subscriptions;
+    QSharedPointer<const Table> m_table;
+    int m_nextHandle;
+    QAtomicInt m_changed;
+
+    // 以下只由接收线程访问
+    QSharedPointer<const Table> m_current;
+    QVector<QVector<VCI_CAN_OBJ>> m_pending;
+    bool m_hasPending;
+    QMutex m_deliverMutex;                      // 投递期间持有，退订借此等待投递结束
+};
+
+#endif // CAN_DISPATCHER_H
@@ -0,0 +1,234 @@
+#include <QtGlobal>
+#if defined(Q_OS_WIN)
+// 需在ControlCAN.h之前包含，后者把DWORD等类型定义为宏
+#include <qt_windows.h>
+#endif
+#include "can_frame_ring.h"
+#include <QMutexLocker>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <sys/eventfd.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+CANRxNotifier::CANRxNotifier()
+    : m_pending(0)
+    , m_sleeping(0)
+{
+#if defined(Q_OS_LINUX)
+    m_eventFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+#elif defined(Q_OS_WIN)
+    m_event = ::CreateEventW(nullptr, FALSE, FALSE, nullptr);
+#endif
+}
+
+CANRxNotifier::~CANRxNotifier()
+{
+#if defined(Q_OS_LINUX)
+    if (m_eventFd >= 0)
+        ::close(m_eventFd);
+#elif defined(Q_OS_WIN)
+    if (m_event)
+        ::CloseHandle(m_event);
+#endif
+}
+
+void CANRxNotifier::notify()
+{
+    // 已有未处理的通知，消费者醒来后会看到所有已提交的数据
+    if (m_pending.fetchAndStoreOrdered(1) != 0)
+        return;
+    if (m_sleeping.loadAcquire())
+        signal();
+}
+
+bool CANRxNotifier::wait(unsigned long timeoutMs)
+{
+    if (m_pending.fetchAndStoreOrdered(0) != 0)
+        return true;
+
+    // 先声明要休眠再复查通知，与notify()的顺序相反，保证不会丢失唤醒
+    m_sleeping.fetchAndStoreOrdered(1);
+    if (m_pending.fetchAndStoreOrdered(0) != 0) {
+        m_sleeping.storeRelease(0);
+        return true;
+    }
+    block(timeoutMs);
+    m_sleeping.storeRelease(0);
+    return m_pending.fetchAndStoreOrdered(0) != 0;
+}
+
+void CANRxNotifier::signal()
+{
+#if defined(Q_OS_LINUX)
+    quint64 one = 1;
+    ssize_t written = ::write(m_eventFd, &one, sizeof(one));
+    Q_UNUSED(written);
+#elif defined(Q_OS_WIN)
+    ::SetEvent(m_event);
+#else
+    QMutexLocker locker(&m_mutex);
+    m_condition.wakeOne();
+#endif
+}
+
+void CANRxNotifier::block(unsigned long timeoutMs)
+{
+#if defined(Q_OS_LINUX)
+    struct pollfd pfd;
+    pfd.fd = m_eventFd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (::poll(&pfd, 1, static_cast<int>(timeoutMs)) > 0) {
+        quint64 counter;
+        ssize_t got = ::read(m_eventFd, &counter, sizeof(counter));
+        Q_UNUSED(got);
+    }
+#elif defined(Q_OS_WIN)
+    ::WaitForSingleObject(m_event, timeoutMs);
+#else
+    QMutexLocker locker(&m_mutex);
+    if (!m_pending.loadAcquire())
+        m_condition.wait(&m_mutex, timeoutMs);
+#endif
+}
+
+// 容量向上取整到2的幂，便于用掩码取模
+static int roundUpPow2(int value)
+{
+    int capacity = 1;
+    while (capacity < value && capacity < (1 << 30)) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+CANFrameRing::CANFrameRing(int capacity)
+    : m_storage(roundUpPow2(qMax(capacity, 2)))
+    , m_frames(m_storage.data())
+    , m_capacity(m_storage.size())
+    , m_mask(static_cast<quint32>(m_storage.size() - 1))
+    , m_head(0)
+    , m_cachedTail(0)
+    , m_written(0)
+    , m_tail(0)
+    , m_cachedHead(0)
+    , m_overflow(0)
+    , m_notifier(nullptr)
+{
+    memset(m_frames, 0, sizeof(VCI_CAN_OBJ) * m_capacity);
+}
+
+int CANFrameRing::size() const
+{
+    quint32 tail = m_tail.loadAcquire();
+    quint32 head = m_head.loadAcquire();
+    int used = static_cast<int>(head - tail);
+    return qBound(0, used, m_capacity);
+}
+
+int CANFrameRing::freeSpace() const
+{
+    return m_capacity - size();
+}
+
+int CANFrameRing::beginWrite(VCI_CAN_OBJ **frames, int maxFrames)
+{
+    quint32 head = m_head.load();
+    int space = m_capacity - static_cast<int>(head - m_cachedTail);
+    if (space < maxFrames) {
+        // 缓存的读位置不够用时才读取消费者的下标
+        m_cachedTail = m_tail.loadAcquire();
+        space = m_capacity - static_cast<int>(head - m_cachedTail);
+    }
+
+    // 只返回到缓冲末尾为止的连续空间，回绕部分留给下一次写入
+    int offset = static_cast<int>(head & m_mask);
+    int contiguous = qMin(space, m_capacity - offset);
+    *frames = m_frames + offset;
+    return qMin(contiguous, maxFrames);
+}
+
+void CANFrameRing::commitWrite(int count)
+{
+    if (count <= 0) return;
+
+    // release：帧数据写入先于下标对消费者可见
+    m_head.storeRelease(m_head.load() + static_cast<quint32>(count));
+    m_written.fetchAndAddRelaxed(static_cast<quint64>(count));
+
+    CANRxNotifier *notifier = m_notifier.loadAcquire();
+    if (notifier) {
+        notifier->notify();
+    }
+}
+
+int CANFrameRing::push(const VCI_CAN_OBJ *frames, int count)
+{
+    int written = 0;
+    while (written < count) {
+        VCI_CAN_OBJ *dst = nullptr;
+        int space = beginWrite(&dst, count - written);
+        if (space <= 0) break;
+        memcpy(dst, frames + written, sizeof(VCI_CAN_OBJ) * space);
+        commitWrite(space);
+        written += space;
+    }
+
+    if (written < count) {
+        noteOverflow(count - written);
+    }
+    return written;
+}
+
+void CANFrameRing::noteOverflow(int count)
+{
+    if (count <= 0) return;
+    m_overflow.fetchAndAddRelaxed(static_cast<quint64>(count));
+}
+
+int CANFrameRing::beginRead(const VCI_CAN_OBJ **frames, int maxFrames) const
+{
+    quint32 tail = m_tail.load();
+    int available = static_cast<int>(m_cachedHead - tail);
+    if (available < maxFrames) {
+        // acquire：看到新下标时对应的帧数据也已可见
+        m_cachedHead = m_head.loadAcquire();
+        available = static_cast<int>(m_cachedHead - tail);
+    }
+
+    int offset = static_cast<int>(tail & m_mask);
+    int contiguous = qMin(available, m_capacity - offset);
+    *frames = m_frames + offset;
+    return qMin(contiguous, maxFrames);
+}
+
+void CANFrameRing::commitRead(int count)
+{
+    if (count <= 0) return;
+    // release：帧读取完成后才把空间交还给生产者
+    m_tail.storeRelease(m_tail.load() + static_cast<quint32>(count));
+}
+
+quint64 CANFrameRing::overflowCount() const
+{
+    return m_overflow.load();
+}
+
+quint64 CANFrameRing::totalWritten() const
+{
+    return m_written.load();
+}
+
+void CANFrameRing::clear()
+{
+    m_cachedHead = m_head.loadAcquire();
+    m_tail.storeRelease(m_cachedHead);
+}
+
+void CANFrameRing::setNotifier(CANRxNotifier *notifier)
+{
+    m_notifier.storeRelease(notifier);
+}
@@ -0,0 +1,94 @@
+#ifndef CAN_FRAME_RING_H
+#define CAN_FRAME_RING_H
+
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <climits>
+#include "ControlCAN.h"
+
+// 接收唤醒器：多个环形缓冲可共用一个，生产者提交数据后唤醒消费线程
+// 只有消费者确实在休眠时才发起系统调用（Linux eventfd / Windows事件对象），
+// 高负载下生产者的notify()只是一次原子交换
+class CANRxNotifier
+{
+public:
+    CANRxNotifier();
+    ~CANRxNotifier();
+
+    void notify();
+    // 等待数据到达或超时，返回是否被唤醒
+    bool wait(unsigned long timeoutMs);
+
+private:
+    void signal();
+    void block(unsigned long timeoutMs);
+
+    QAtomicInt m_pending;     // 有未处理的通知
+    QAtomicInt m_sleeping;    // 消费者正在（或即将）休眠
+#if defined(Q_OS_LINUX)
+    int m_eventFd;
+#elif defined(Q_OS_WIN)
+    void *m_event;
+#else
+    QMutex m_mutex;
+    QWaitCondition m_condition;
+#endif
+};
+
+// 预分配定长CAN帧环形缓冲（单生产者/单消费者，无锁）
+// 生产者：beginWrite取得连续可写区 -> VCI_Receive直接写入 -> commitWrite
+// 消费者：beginRead取得连续可读区 -> 原地解析 -> commitRead
+// 读写区间互不重叠，下标用acquire/release原子操作发布，帧数据本身不做任何拷贝
+// size()/overflowCount()等统计可在任意线程调用，不会与收发线程争用
+class CANFrameRing
+{
+public:
+    static const int DEFAULT_CAPACITY = 32768;
+
+    explicit CANFrameRing(int capacity = DEFAULT_CAPACITY);
+
+    int capacity() const { return m_capacity; }
+    int size() const;
+    int freeSpace() const;
+
+    // 生产者接口
+    int beginWrite(VCI_CAN_OBJ **frames, int maxFrames = INT_MAX);
+    void commitWrite(int count);
+    // 拷贝写入（软件注入帧用），空间不足时写入能放下的部分，其余计入溢出
+    int push(const VCI_CAN_OBJ *frames, int count);
+    void noteOverflow(int count);
+
+    // 消费者接口
+    int beginRead(const VCI_CAN_OBJ **frames, int maxFrames = INT_MAX) const;
+    void commitRead(int count);
+    // 丢弃所有未读帧（消费者调用）
+    void clear();
+
+    quint64 overflowCount() const;
+    quint64 totalWritten() const;
+
+    void setNotifier(CANRxNotifier *notifier);
+
+private:
+    QVector<VCI_CAN_OBJ> m_storage;
+    VCI_CAN_OBJ *m_frames;
+    int m_capacity;
+    quint32 m_mask;
+
+    // 生产者和消费者各自修改的下标分在不同缓存行，避免伪共享
+    char m_pad0[64];
+    QAtomicInteger<quint32> m_head;      // 写位置（只由生产者推进）
+    quint32 m_cachedTail;                // 生产者缓存的读位置，空间不足时才重新读取
+    QAtomicInteger<quint64> m_written;
+    char m_pad1[64];
+    QAtomicInteger<quint32> m_tail;      // 读位置（只由消费者推进）
+    mutable quint32 m_cachedHead;        // 消费者缓存的写位置
+    char m_pad2[64];
+    QAtomicInteger<quint64> m_overflow;
+    QAtomicPointer<CANRxNotifier> m_notifier;
+};
+
+#endif // CAN_FRAME_RING_H
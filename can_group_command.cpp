@@ -0,0 +1,65 @@
+#include "can_group_command.h"
+
+CANGroupCommand::CANGroupCommand()
+    : m_count(0)
+    , m_syncCobId(CAN_SYNC_COB_ID_NONE)
+{
+    m_frames[0] = canEncodeSync(m_syncCobId);
+}
+
+void CANGroupCommand::clear()
+{
+    m_count = 0;
+    m_frames[0] = canEncodeSync(m_syncCobId);
+}
+
+void CANGroupCommand::setSyncCobId(UINT cobId)
+{
+    m_syncCobId = cobId;
+    m_frames[m_count] = canEncodeSync(m_syncCobId);
+}
+
+bool CANGroupCommand::addFrame(const VCI_CAN_OBJ &frame)
+{
+    if (m_count >= MAX_FRAMES)
+        return false;
+    m_frames[m_count++] = frame;
+    // 同步帧始终紧跟在最后一个轴的帧之后
+    m_frames[m_count] = canEncodeSync(m_syncCobId);
+    return true;
+}
+
+bool CANGroupCommand::addMotion(uint8_t node, float kp, float kd, float position, float velocity, float torque)
+{
+    return addFrame(canEncodeMotion(node, canQuantizeMotion(kp, kd, position, velocity, torque)));
+}
+
+bool CANGroupCommand::addSpeed(uint8_t node, float targetSpeed, float outputLimit)
+{
+    return addFrame(canEncodeSpeed(node, targetSpeed, outputLimit));
+}
+
+bool CANGroupCommand::addPosition(uint8_t node, float targetPosition, float maxSpeed)
+{
+    return addFrame(canEncodePosition(node, targetPosition, maxSpeed));
+}
+
+bool CANGroupCommand::addCurrent(uint8_t node, float iq, float id)
+{
+    return addFrame(canEncodeCurrent(node, iq, id));
+}
+
+bool CANGroupCommand::addModeSwitch(uint8_t node, CANControlMode mode)
+{
+    return addFrame(canEncodeModeSwitch(node, mode));
+}
+
+bool CANGroupCommand::addStart(uint8_t node)
+{
+    return addFrame(canEncodeStart(node));
+}
+
+bool CANGroupCommand::addStop(uint8_t node)
+{
+    return addFrame(canEncodeStop(node));
+}
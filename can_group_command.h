@@ -0,0 +1,46 @@
+#ifndef CAN_GROUP_COMMAND_H
+#define CAN_GROUP_COMMAND_H
+
+#include <cstdint>
+#include "ControlCAN.h"
+#include "can_command_codec.h"
+
+// 多轴成组命令：为一组节点编码设定值，经CANTxRx::sendGroupCommand()作为一组连续的帧一次提交，
+// 各轴的帧在同一次VCI_Transmit、同一次总线突发中发出；可在末尾追加同步帧（COB-ID需配置，默认不追加）
+// 帧存放在对象内的定长数组中，可放在栈上反复使用，不分配内存
+class CANGroupCommand
+{
+public:
+    static const int MAX_FRAMES = 128;  // 不含同步帧
+
+    CANGroupCommand();
+
+    void clear();
+    // 末尾追加同步帧，CAN_SYNC_COB_ID_NONE为不追加（默认）
+    void setSyncCobId(UINT cobId);
+    UINT syncCobId() const { return m_syncCobId; }
+    bool hasSync() const { return m_syncCobId != CAN_SYNC_COB_ID_NONE; }
+
+    // 已满时返回false
+    bool addFrame(const VCI_CAN_OBJ &frame);
+    bool addMotion(uint8_t node, float kp, float kd, float position, float velocity, float torque);
+    bool addSpeed(uint8_t node, float targetSpeed, float outputLimit);
+    bool addPosition(uint8_t node, float targetPosition, float maxSpeed);
+    bool addCurrent(uint8_t node, float iq, float id);
+    bool addModeSwitch(uint8_t node, CANControlMode mode);
+    bool addStart(uint8_t node);
+    bool addStop(uint8_t node);
+
+    // 发送用的连续帧（含同步帧）
+    const VCI_CAN_OBJ *frames() const { return m_frames; }
+    int count() const { return m_count + (hasSync() ? 1 : 0); }
+    int axisFrameCount() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+
+private:
+    VCI_CAN_OBJ m_frames[MAX_FRAMES + 1];
+    int m_count;
+    UINT m_syncCobId;
+};
+
+#endif // CAN_GROUP_COMMAND_H
@@ -5,6 +5,7 @@
 
 CANInit::CANInit(QWidget *parent)
     : QWidget(parent)
+    , backendCombo(nullptr)
     , deviceIndexCombo(nullptr)
     , baudRateCombo(nullptr)
     , canIdEdit(nullptr)
@@ -13,11 +14,13 @@ CANInit::CANInit(QWidget *parent)
     , refreshButton(nullptr)
     , statusLabel(nullptr)
     , canThread(nullptr)
+    , deviceManager(nullptr)
     , deviceCheckTimer(nullptr)
     , isCheckingDevice(false)
 {
     // 初始化CAN线程
     canThread = new CANThread();
+    deviceManager = new CANDeviceManager(this);
 
     setupUI();
     scanCANDevices();
@@ -92,6 +95,15 @@ void CANInit::setupUI()
     formLayout->setHorizontalSpacing(20);
     formLayout->setLabelAlignment(Qt::AlignRight);
 
+    // 通信后端（USBCAN / SocketCAN / 仿真总线）
+    QLabel *backendLabel = new QLabel("通信方式:");
+    backendCombo = new QComboBox();
+    for (CANBackend::Type type : CANBackend::availableTypes()) {
+        backendCombo->addItem(CANBackend::typeName(type), static_cast<int>(type));
+    }
+    int backendIndex = backendCombo->findData(static_cast<int>(canThread->backend()->type()));
+    backendCombo->setCurrentIndex(backendIndex >= 0 ? backendIndex : 0);
+
     // 设备索引
     QLabel *deviceLabel = new QLabel("CAN设备:");
     QWidget *deviceWidget = new QWidget();
@@ -152,6 +164,7 @@ void CANInit::setupUI()
     statusLabel->setAlignment(Qt::AlignCenter);
 
     // 添加到表单
+    formLayout->addRow(backendLabel, backendCombo);
     formLayout->addRow(deviceLabel, deviceWidget);
     formLayout->addRow(baudRateLabel, baudRateCombo);
     formLayout->addRow(canIdLabel, canIdEdit);
@@ -212,6 +225,19 @@ void CANInit::setupUI()
     connect(cancelButton, &QPushButton::clicked, this, &CANInit::onCancelButtonClicked);
     connect(refreshButton, &QPushButton::clicked, this, &CANInit::onRefreshDevices);
     connect(deviceCheckTimer, &QTimer::timeout, this, &CANInit::onDeviceCheckTimeout);
+    connect(backendCombo, QOverload<int>::of(&QComboBox::currentIndexChanged),
+            this, &CANInit::onBackendChanged);
+}
+
+void CANInit::onBackendChanged(int index)
+{
+    if (index < 0) return;
+
+    CANBackend::Type type = static_cast<CANBackend::Type>(backendCombo->itemData(index).toInt());
+    if (canThread->backend()->type() != type) {
+        canThread->setBackend(CANBackend::create(type));
+    }
+    scanCANDevices();
 }
 
 void CANInit::scanCANDevices()
@@ -224,12 +250,13 @@ void CANInit::scanCANDevices()
     QList<QString> deviceNames;
     QList<int> deviceIndices;
 
-    // 使用CANThread来检测设备
-    for (int i = 0; i < 4; i++) {
+    // 使用CANThread来检测设备（仿真总线只有一个设备）
+    int maxDevices = (canThread->backend()->type() == CANBackend::LoopbackType) ? 1 : 4;
+    for (int i = 0; i < maxDevices; i++) {
         bool deviceExists = testDeviceConnection(i, 1000);
 
         if (deviceExists) {
-            QString deviceName = QString("CAN设备 %1").arg(i);
+            QString deviceName = QString("%1 %2").arg(canThread->backend()->name()).arg(i);
             deviceNames.append(deviceName);
             deviceIndices.append(i);
             qDebug() << "发现CAN设备:" << deviceName << "索引:" << i;
@@ -240,6 +267,10 @@ void CANInit::scanCANDevices()
     for (int i = 0; i < deviceNames.size(); i++) {
         deviceIndexCombo->addItem(deviceNames[i], deviceIndices[i]);
     }
+    // 多个适配器时可同时打开，吞吐随适配器数量增加
+    if (deviceNames.size() > 1) {
+        deviceIndexCombo->addItem(QString("全部设备 (%1个)").arg(deviceNames.size()), -1);
+    }
 
     if (deviceNames.isEmpty()) {
         statusLabel->setText("未发现CAN设备，请检查设备连接");
@@ -294,6 +325,17 @@ void CANInit::onLoginButtonClicked()
     int baudRate = getBaudRate();
     int canId = getCANID();
 
+    // 选择全部设备时，第一个由canThread打开，其余由设备管理器打开
+    QList<int> extraDevices;
+    if (deviceIndex < 0) {
+        for (int i = 0; i < deviceIndexCombo->count(); i++) {
+            int index = deviceIndexCombo->itemData(i).toInt();
+            if (index >= 0)
+                extraDevices.append(index);
+        }
+        deviceIndex = extraDevices.takeFirst();
+    }
+
     statusLabel->setText("正在连接设备...");
     statusLabel->setStyleSheet("QLabel { color: #ff9800; background-color: #333333; }");
     loginButton->setEnabled(false);
@@ -307,18 +349,32 @@ void CANInit::onLoginButtonClicked()
     DWORD deviceType = 4; // USBCAN-2A/U
     bool connected = canThread->openDevice(deviceType, deviceIndex, baudRate);
 
+    // 打开后初始化并启动两个通道，否则设备不会收发数据
+    if (connected && !(canThread->initCAN() && canThread->startCAN())) {
+        qWarning() << "CAN通道初始化/启动失败";
+        canThread->closeDevice();
+        connected = false;
+    }
+
     if (connected) {
         deviceCheckTimer->stop();
         isCheckingDevice = false;
 
+        deviceManager->addDevice(canThread);
+        for (int index : extraDevices) {
+            if (deviceManager->openDevice(canThread->backend()->type(), deviceType, index, baudRate) < 0)
+                qWarning() << "CAN设备" << index << "打开失败，跳过";
+        }
+
         statusLabel->setText("设备连接成功！");
         statusLabel->setStyleSheet("QLabel { color: #4caf50; background-color: #333333; }");
 
         QMessageBox::information(this, "连接成功",
-            QString("CAN设备连接成功！\n设备: %1\n波特率: %2 Kbps\nCAN ID: 0x%3")
+            QString("CAN设备连接成功！\n设备: %1 (已连接%4个适配器)\n波特率: %2 Kbps\nCAN ID: 0x%3")
                 .arg(deviceIndexCombo->currentText())
                 .arg(baudRate)
-                .arg(QString::number(canId, 16).toUpper()));
+                .arg(QString::number(canId, 16).toUpper())
+                .arg(deviceManager->deviceCount()));
 
         // 发射登录成功信号，传递CAN线程实例
         emit loginSuccess(deviceIndex, baudRate, canId, canThread);
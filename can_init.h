@@ -12,6 +12,7 @@
 #include <QMessageBox>
 #include <QTimer>
 #include "canthread.h"
+#include "can_device_manager.h"
 
 class CANInit : public QWidget
 {
@@ -28,6 +29,8 @@ public:
     
     // 获取CAN线程实例
     CANThread* getCANThread() const { return canThread; }
+    // 已连接的全部适配器（槽位0为canThread）
+    CANDeviceManager* getDeviceManager() const { return deviceManager; }
 
 signals:
     void loginSuccess(int deviceIndex, int baudRate, int canId, CANThread* canThread);
@@ -37,6 +40,7 @@ private slots:
     void onCancelButtonClicked();
     void onRefreshDevices();
     void onDeviceCheckTimeout();
+    void onBackendChanged(int index);
 
 private:
     void setupUI();
@@ -45,6 +49,7 @@ private:
     bool testDeviceConnection(int deviceIndex, int baudRate);
     QString getDeviceInfo(int deviceIndex);  // 添加这个声明
 
+    QComboBox *backendCombo;
     QComboBox *deviceIndexCombo;
     QComboBox *baudRateCombo;
     QLineEdit *canIdEdit;
@@ -54,6 +59,7 @@ private:
     QLabel *statusLabel;
 
     CANThread *canThread;
+    CANDeviceManager *deviceManager;
     QTimer *deviceCheckTimer;
     bool isCheckingDevice;
 };
@@ -0,0 +1,422 @@
+#include "can_latency_tracer.h"
+#include <QFile>
+#include <QTextStream>
+#include <QtAlgorithms>
+#include <cmath>
+#include <cstring>
+#include "acquisition_engine.h"
+#include "can_timestamp.h"
+
+namespace {
+    const qint64 EXPIRE_INTERVAL_US = 100000;   // 入队时最多每100ms清理一次超时请求
+}
+
+const int CANLatencyHistogram::SUB_BUCKETS;
+const int CANLatencyHistogram::BUCKET_COUNT;
+const qint64 CANLatencyTracer::DEFAULT_TIMEOUT_US;
+
+QString canLatencyTypeName(CANLatencyType type)
+{
+    switch (type) {
+    case CANLatencySdoRead:        return "SDO读";
+    case CANLatencySdoWrite:       return "SDO写";
+    case CANLatencyScopeRead:      return "数据上抛单读";
+    case CANLatencyScopeReadMulti: return "数据上抛双读";
+    default:                       break;
+    }
+    return QString();
+}
+
+// ==================== CANLatencyHistogram ====================
+
+CANLatencyHistogram::CANLatencyHistogram()
+{
+    reset();
+}
+
+void CANLatencyHistogram::reset()
+{
+    memset(m_buckets, 0, sizeof(m_buckets));
+    m_count = 0;
+    m_sum = 0;
+    m_min = 0;
+    m_max = 0;
+}
+
+int CANLatencyHistogram::bucketOf(qint64 us)
+{
+    if (us < 2 * SUB_BUCKETS)
+        return us < 0 ? 0 : static_cast<int>(us);
+
+    // 最高位e（e>=5），桶内按次高4位细分
+    int e = 63 - qCountLeadingZeroBits(static_cast<quint64>(us));
+    int bucket = (e - 4) * SUB_BUCKETS + static_cast<int>(us >> (e - 4));
+    return qMin(bucket, BUCKET_COUNT - 1);
+}
+
+qint64 CANLatencyHistogram::bucketUpperUs(int bucket)
+{
+    if (bucket < 2 * SUB_BUCKETS)
+        return bucket;
+    int e = bucket / SUB_BUCKETS + 3;
+    qint64 mantissa = bucket % SUB_BUCKETS + SUB_BUCKETS;
+    return ((mantissa + 1) << (e - 4)) - 1;
+}
+
+void CANLatencyHistogram::record(qint64 us)
+{
+    us = qMax<qint64>(0, us);
+    m_buckets[bucketOf(us)]++;
+    if (m_count == 0 || us < m_min)
+        m_min = us;
+    if (us > m_max)
+        m_max = us;
+    m_sum += us;
+    m_count++;
+}
+
+qint64 CANLatencyHistogram::percentile(double p) const
+{
+    if (m_count == 0)
+        return 0;
+    quint64 target = static_cast<quint64>(std::ceil(qBound(0.0, p, 1.0) * m_count));
+    target = qMax<quint64>(1, target);
+    quint64 seen = 0;
+    for (int bucket = 0; bucket < BUCKET_COUNT; bucket++) {
+        seen += m_buckets[bucket];
+        if (seen >= target)
+            return qMin(bucketUpperUs(bucket), m_max);
+    }
+    return m_max;
+}
+
+// ==================== CANLatencyTracer ====================
+
+CANLatencyTracer::Entry::Entry()
+    : timeouts(0)
+    , staged(0)
+    , queueSum(0.0)
+    , usbTxSum(0.0)
+    , deviceSum(0.0)
+    , rxSum(0.0)
+{
+}
+
+CANLatencyTracer::CANLatencyTracer()
+    : m_enabled(1)
+    , m_pendingCount(0)
+    , m_timeoutUs(DEFAULT_TIMEOUT_US)
+    , m_lastExpireUs(0)
+{
+}
+
+CANLatencyTracer::~CANLatencyTracer()
+{
+    qDeleteAll(m_entries);
+}
+
+void CANLatencyTracer::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled.store(enabled ? 1 : 0);
+    if (!enabled) {
+        m_pending.clear();
+        m_pendingCount.store(0);
+    }
+}
+
+void CANLatencyTracer::setTimeoutUs(qint64 timeoutUs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_timeoutUs = qMax<qint64>(1000, timeoutUs);
+}
+
+quint64 CANLatencyTracer::pendingKey(CANLatencyType type, int node, quint32 key)
+{
+    return (static_cast<quint64>(type) << 40) | (static_cast<quint64>(node & 0xFF) << 32) | key;
+}
+
+bool CANLatencyTracer::classifyRequest(const VCI_CAN_OBJ &frame, CANLatencyType *type, int *node, quint32 *key)
+{
+    if (frame.ExternFlag || frame.RemoteFlag)
+        return false;
+
+    // SDO请求：索引小端在Data[1..2]，子索引Data[3]
+    if (frame.ID >= 0x600 && frame.ID <= 0x67F && frame.DataLen >= 4) {
+        BYTE command = frame.Data[0];
+        if (command == 0x40) {
+            *type = CANLatencySdoRead;
+        } else if ((command & 0xF0) == 0x20) {
+            *type = CANLatencySdoWrite;
+        } else {
+            return false;
+        }
+        *node = static_cast<int>(frame.ID - 0x600);
+        *key = (static_cast<quint32>(frame.Data[2]) << 16) | (static_cast<quint32>(frame.Data[1]) << 8) | frame.Data[3];
+        return true;
+    }
+
+    // 数据上抛请求：COB-ID = 0x500 + (命令<<4) + 节点低4位，索引大端在Data[0..1]，子索引Data[2]
+    if (frame.ID >= UPDATE_COB_ID_BASE && frame.ID <= UPDATE_COB_ID_BASE + 0xFF && frame.DataLen >= 3) {
+        UINT command = (frame.ID >> 4) & 0x0F;
+        *node = static_cast<int>(frame.ID & 0x0F);
+        if (command == UPDATE_CMD_READ_SINGLE) {
+            *type = CANLatencyScopeRead;
+            *key = (static_cast<quint32>(frame.Data[0]) << 16) | (static_cast<quint32>(frame.Data[1]) << 8) | frame.Data[2];
+            return true;
+        }
+        if (command == UPDATE_CMD_READ_MULTI) {
+            *type = CANLatencyScopeReadMulti;
+            *key = 0;
+            return true;
+        }
+    }
+    return false;
+}
+
+void CANLatencyTracer::onQueued(const VCI_CAN_OBJ *frames, int count)
+{
+    if (!isEnabled())
+        return;
+
+    qint64 nowUs = 0;
+    for (int i = 0; i < count; i++) {
+        CANLatencyType type;
+        int node;
+        quint32 key;
+        if (!classifyRequest(frames[i], &type, &node, &key))
+            continue;
+
+        if (nowUs == 0)
+            nowUs = canMonotonicUs();
+        QMutexLocker locker(&m_mutex);
+        if (nowUs - m_lastExpireUs >= EXPIRE_INTERVAL_US)
+            expire(nowUs);
+
+        // 同一请求未应答又再次发出：旧请求按超时计
+        Pending pending = { nowUs, 0, 0 };
+        auto it = m_pending.find(pendingKey(type, node, key));
+        if (it != m_pending.end()) {
+            entry(type, node)->timeouts++;
+            *it = pending;
+        } else {
+            m_pending.insert(pendingKey(type, node, key), pending);
+        }
+        m_pendingCount.store(m_pending.size());
+    }
+}
+
+void CANLatencyTracer::onTransmitted(const VCI_CAN_OBJ *frames, int count, qint64 startUs, qint64 doneUs)
+{
+    if (m_pendingCount.load() == 0)
+        return;
+
+    for (int i = 0; i < count; i++) {
+        CANLatencyType type;
+        int node;
+        quint32 key;
+        if (!classifyRequest(frames[i], &type, &node, &key))
+            continue;
+
+        QMutexLocker locker(&m_mutex);
+        auto it = m_pending.find(pendingKey(type, node, key));
+        if (it != m_pending.end() && it->txStartUs == 0) {
+            it->txStartUs = startUs;
+            it->txDoneUs = doneUs;
+        }
+    }
+}
+
+void CANLatencyTracer::onReceived(const VCI_CAN_OBJ *frames, int count, qint64 nowUs)
+{
+    if (m_pendingCount.load() == 0)
+        return;
+
+    const UINT scopeResponse = UPDATE_COB_ID_BASE + (UPDATE_CMD_RESPONSE << 4);
+    for (int i = 0; i < count; i++) {
+        const VCI_CAN_OBJ &frame = frames[i];
+        // 应答只可能是0x550-0x55F（数据上抛）或0x580-0x5FF（SDO，含节点0）
+        if (frame.ID < scopeResponse || frame.ID > 0x5FF || frame.ExternFlag)
+            continue;
+        if (frame.ID > scopeResponse + 0x0F && frame.ID < 0x580)
+            continue;
+
+        QMutexLocker locker(&m_mutex);
+        matchResponse(frame, nowUs);
+        m_pendingCount.store(m_pending.size());
+    }
+}
+
+bool CANLatencyTracer::matchResponse(const VCI_CAN_OBJ &frame, qint64 nowUs)
+{
+    qint64 busUs = canFrameTimeUs(frame, nowUs);
+
+    if (frame.ID >= 0x580) {
+        if (frame.DataLen < 4)
+            return false;
+        int node = static_cast<int>(frame.ID - 0x580);
+        quint32 key = (static_cast<quint32>(frame.Data[2]) << 16) | (static_cast<quint32>(frame.Data[1]) << 8) | frame.Data[3];
+        BYTE command = frame.Data[0];
+        // 0x80为中止应答，可能对应读或写
+        CANLatencyType candidates[2] = { CANLatencySdoRead, CANLatencySdoWrite };
+        int first = 0;
+        int last = 1;
+        if (command == 0x60) {
+            first = 1;
+        } else if ((command & 0xE0) == 0x40) {
+            last = 0;
+        } else if (command != 0x80) {
+            return false;
+        }
+        for (int c = first; c <= last; c++) {
+            auto it = m_pending.find(pendingKey(candidates[c], node, key));
+            if (it != m_pending.end()) {
+                complete(candidates[c], node, *it, busUs, nowUs);
+                m_pending.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 数据上抛应答：单参数读带索引，找不到时按双参数读匹配
+    int node = static_cast<int>(frame.ID & 0x0F);
+    if (frame.DataLen >= 3) {
+        quint32 key = (static_cast<quint32>(frame.Data[0]) << 16) | (static_cast<quint32>(frame.Data[1]) << 8) | frame.Data[2];
+        auto it = m_pending.find(pendingKey(CANLatencyScopeRead, node, key));
+        if (it != m_pending.end()) {
+            complete(CANLatencyScopeRead, node, *it, busUs, nowUs);
+            m_pending.erase(it);
+            return true;
+        }
+    }
+    auto it = m_pending.find(pendingKey(CANLatencyScopeReadMulti, node, 0));
+    if (it != m_pending.end()) {
+        complete(CANLatencyScopeReadMulti, node, *it, busUs, nowUs);
+        m_pending.erase(it);
+        return true;
+    }
+    return false;
+}
+
+void CANLatencyTracer::complete(CANLatencyType type, int node, const Pending &pending, qint64 busUs, qint64 nowUs)
+{
+    Entry *e = entry(type, node);
+    e->total.record(nowUs - pending.queuedUs);
+
+    // 未经过批量发送线程的请求没有发送时间，只计总时间
+    if (pending.txStartUs > 0) {
+        e->staged++;
+        e->queueSum += qMax<qint64>(0, pending.txStartUs - pending.queuedUs);
+        e->usbTxSum += qMax<qint64>(0, pending.txDoneUs - pending.txStartUs);
+        e->deviceSum += qMax<qint64>(0, busUs - pending.txDoneUs);
+        e->rxSum += qMax<qint64>(0, nowUs - busUs);
+    }
+}
+
+CANLatencyTracer::Entry *CANLatencyTracer::entry(CANLatencyType type, int node)
+{
+    int id = (static_cast<int>(type) << 8) | (node & 0xFF);
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+        it = m_entries.insert(id, new Entry());
+    return it.value();
+}
+
+void CANLatencyTracer::expire(qint64 nowUs)
+{
+    m_lastExpireUs = nowUs;
+    for (auto it = m_pending.begin(); it != m_pending.end(); ) {
+        if (nowUs - it->queuedUs > m_timeoutUs) {
+            CANLatencyType type = static_cast<CANLatencyType>(it.key() >> 40);
+            int node = static_cast<int>((it.key() >> 32) & 0xFF);
+            entry(type, node)->timeouts++;
+            it = m_pending.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    m_pendingCount.store(m_pending.size());
+}
+
+QVector<CANLatencyTracer::Stats> CANLatencyTracer::statistics()
+{
+    QMutexLocker locker(&m_mutex);
+    expire(canMonotonicUs());
+
+    QVector<Stats> result;
+    result.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        const Entry *e = it.value();
+        Stats stats;
+        stats.type = static_cast<CANLatencyType>(it.key() >> 8);
+        stats.node = it.key() & 0xFF;
+        stats.count = e->total.count();
+        stats.timeouts = e->timeouts;
+        stats.meanUs = e->total.mean();
+        stats.p50Us = e->total.percentile(0.50);
+        stats.p90Us = e->total.percentile(0.90);
+        stats.p99Us = e->total.percentile(0.99);
+        stats.maxUs = e->total.max();
+        double staged = e->staged ? static_cast<double>(e->staged) : 1.0;
+        stats.queueUs = e->queueSum / staged;
+        stats.usbTxUs = e->usbTxSum / staged;
+        stats.deviceUs = e->deviceSum / staged;
+        stats.rxUs = e->rxSum / staged;
+        stats.histogram = e->total;
+        result.append(stats);
+    }
+    return result;
+}
+
+void CANLatencyTracer::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    qDeleteAll(m_entries);
+    m_entries.clear();
+    m_pending.clear();
+    m_pendingCount.store(0);
+}
+
+bool CANLatencyTracer::dumpToFile(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        if (error)
+            *error = QString("无法创建文件 %1: %2").arg(path).arg(file.errorString());
+        return false;
+    }
+
+    QVector<Stats> all = statistics();
+    QTextStream out(&file);
+    out << "# CAN请求/应答往返延迟，单位微秒；各段为平均值：排队=入队到开始发送，USB=VCI_Transmit耗时，"
+           "设备=发送完成到应答上总线，接收=应答上总线到接收线程读出\n";
+    out << "type,node,count,timeouts,mean_us,p50_us,p90_us,p99_us,max_us,queue_us,usb_tx_us,device_us,rx_us\n";
+    for (const Stats &stats : all) {
+        out << canLatencyTypeName(stats.type) << ',' << stats.node << ',' << stats.count << ',' << stats.timeouts << ','
+            << QString::number(stats.meanUs, 'f', 1) << ',' << stats.p50Us << ',' << stats.p90Us << ','
+            << stats.p99Us << ',' << stats.maxUs << ',' << QString::number(stats.queueUs, 'f', 1) << ','
+            << QString::number(stats.usbTxUs, 'f', 1) << ',' << QString::number(stats.deviceUs, 'f', 1) << ','
+            << QString::number(stats.rxUs, 'f', 1) << '\n';
+    }
+
+    out << "\n# 直方图（只列非空桶，bucket_upper_us为桶上界）\n";
+    out << "type,node,bucket_upper_us,count\n";
+    for (const Stats &stats : all) {
+        for (int bucket = 0; bucket < CANLatencyHistogram::BUCKET_COUNT; bucket++) {
+            quint32 n = stats.histogram.bucketCount(bucket);
+            if (n == 0)
+                continue;
+            out << canLatencyTypeName(stats.type) << ',' << stats.node << ','
+                << CANLatencyHistogram::bucketUpperUs(bucket) << ',' << n << '\n';
+        }
+    }
+
+    out.flush();
+    if (file.error() != QFileDevice::NoError) {
+        if (error)
+            *error = QString("写入文件失败 %1: %2").arg(path).arg(file.errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,140 @@
+#ifndef CAN_LATENCY_TRACER_H
+#define CAN_LATENCY_TRACER_H
+
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <QAtomicInt>
+#include "ControlCAN.h"
+
+// 请求/应答类型
+enum CANLatencyType {
+    CANLatencySdoRead = 0,      // SDO读 0x600+n(0x40) -> 0x580+n
+    CANLatencySdoWrite,         // SDO快速写 0x600+n(0x2x) -> 0x580+n(0x60)
+    CANLatencyScopeRead,        // 数据上抛单参数读 UPDATE_CMD_READ_SINGLE -> UPDATE_CMD_RESPONSE
+    CANLatencyScopeReadMulti,   // 数据上抛双参数读 UPDATE_CMD_READ_MULTI -> UPDATE_CMD_RESPONSE
+    CANLatencyTypeCount
+};
+
+QString canLatencyTypeName(CANLatencyType type);
+
+// 对数分桶直方图（微秒）：32us以内每1us一个桶，之后每个2的幂区间16个桶（相对误差<6.25%），上限约134秒
+class CANLatencyHistogram
+{
+public:
+    static const int SUB_BUCKETS = 16;
+    static const int BUCKET_COUNT = 384;
+
+    CANLatencyHistogram();
+
+    void record(qint64 us);
+    void reset();
+
+    quint64 count() const { return m_count; }
+    qint64 min() const { return m_count ? m_min : 0; }
+    qint64 max() const { return m_max; }
+    double mean() const { return m_count ? static_cast<double>(m_sum) / m_count : 0.0; }
+    // p取0-1，返回所在桶的上界（不超过最大值）
+    qint64 percentile(double p) const;
+
+    quint32 bucketCount(int bucket) const { return m_buckets[bucket]; }
+    static int bucketOf(qint64 us);
+    static qint64 bucketUpperUs(int bucket);
+
+private:
+    quint32 m_buckets[BUCKET_COUNT];
+    quint64 m_count;
+    qint64 m_sum;
+    qint64 m_min;
+    qint64 m_max;
+};
+
+// 请求/应答往返延迟跟踪：在发送队列入队、VCI_Transmit前后和接收线程读出时按帧内容关联请求与应答
+//   SDO按节点+索引+子索引关联，数据上抛单参数读按节点+索引+子索引，双参数读按节点（应答中无索引）
+// 往返时间分为四段，用于区分延迟来自哪里：
+//   排队   入队 -> 批量发送线程开始发送（本程序发送队列和合并窗口）
+//   USB    VCI_Transmit耗时
+//   设备   发送完成 -> 应答到达总线（适配器、总线和固件处理）
+//   接收   应答到达总线 -> 接收线程读出（USB接收轮询和接收环形缓冲）
+// 钩子在发送调用线程、批量发送线程和接收线程中调用，内部加锁；没有未应答请求时接收钩子只做一次原子读
+class CANLatencyTracer
+{
+public:
+    static const qint64 DEFAULT_TIMEOUT_US = 1000000;
+
+    struct Stats {
+        CANLatencyType type;
+        int node;
+        quint64 count;              // 已应答的请求数
+        quint64 timeouts;           // 超时或被同一请求覆盖的未应答请求数
+        double meanUs;
+        qint64 p50Us;
+        qint64 p90Us;
+        qint64 p99Us;
+        qint64 maxUs;
+        // 各段平均值（微秒），只统计经过批量发送线程的请求
+        double queueUs;
+        double usbTxUs;
+        double deviceUs;
+        double rxUs;
+        CANLatencyHistogram histogram;
+    };
+
+    CANLatencyTracer();
+    ~CANLatencyTracer();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_enabled.load() != 0; }
+    void setTimeoutUs(qint64 timeoutUs);
+
+    // 发送队列入队（调用发送的线程）
+    void onQueued(const VCI_CAN_OBJ *frames, int count);
+    // 一批帧发送完成（批量发送线程），startUs/doneUs为VCI_Transmit前后的canMonotonicUs()
+    void onTransmitted(const VCI_CAN_OBJ *frames, int count, qint64 startUs, qint64 doneUs);
+    // 接收线程读出一段帧，nowUs为读出时刻
+    void onReceived(const VCI_CAN_OBJ *frames, int count, qint64 nowUs);
+
+    // 按类型、节点排序的统计（同时清理超时的请求）
+    QVector<Stats> statistics();
+    void reset();
+    // 导出CSV：汇总表和各直方图的非空桶
+    bool dumpToFile(const QString &path, QString *error = nullptr);
+
+private:
+    struct Pending {
+        qint64 queuedUs;
+        qint64 txStartUs;
+        qint64 txDoneUs;
+    };
+
+    struct Entry {
+        Entry();
+
+        CANLatencyHistogram total;
+        quint64 timeouts;
+        quint64 staged;
+        double queueSum;
+        double usbTxSum;
+        double deviceSum;
+        double rxSum;
+    };
+
+    static bool classifyRequest(const VCI_CAN_OBJ &frame, CANLatencyType *type, int *node, quint32 *key);
+    static quint64 pendingKey(CANLatencyType type, int node, quint32 key);
+    bool matchResponse(const VCI_CAN_OBJ &frame, qint64 nowUs);
+    void complete(CANLatencyType type, int node, const Pending &pending, qint64 busUs, qint64 nowUs);
+    Entry *entry(CANLatencyType type, int node);
+    void expire(qint64 nowUs);
+
+    QAtomicInt m_enabled;
+    QAtomicInt m_pendingCount;
+    QMutex m_mutex;
+    qint64 m_timeoutUs;
+    qint64 m_lastExpireUs;
+    QHash<quint64, Pending> m_pending;
+    QMap<int, Entry *> m_entries;   // 键：类型<<8 | 节点
+};
+
+#endif // CAN_LATENCY_TRACER_H
@@ -0,0 +1,141 @@
+#include "can_node_registry.h"
+
+const int CANNodeRegistry::MAX_KEYS;
+const qint64 CANNodeRegistry::DEFAULT_OFFLINE_TIMEOUT_US;
+
+namespace {
+    const qint64 INTERVAL_LIMIT_US = 60000000;  // 超过1分钟的间隔按重新上线处理，不计入平均
+    const int INTERVAL_SHIFT = 3;               // 平均间隔按1/8系数低通滤波
+}
+
+CANNodeRegistry::NodeState::NodeState()
+    : samples(0)
+    , firstSeenUs(0)
+    , lastSeenUs(0)
+    , meanIntervalUs(0)
+    , maxIntervalUs(0)
+{
+}
+
+CANNodeRegistry::CANNodeRegistry()
+    : m_offlineTimeoutUs(DEFAULT_OFFLINE_TIMEOUT_US)
+{
+}
+
+void CANNodeRegistry::update(const CANStatusSample *samples, int count)
+{
+    for (int i = 0; i < count; i++) {
+        const CANStatusSample &sample = samples[i];
+        int key = canNodeKey(sample);
+        if (sample.node > 0x7F || key >= MAX_KEYS)
+            continue;
+        NodeState &state = m_nodes[key];
+
+        // 单写者：各字段直接读改写，最后发布样本数
+        quint64 seen = state.samples.load();
+        if (seen == 0) {
+            state.firstSeenUs.store(sample.timeUs);
+        } else {
+            qint64 interval = qMax<qint64>(0, sample.timeUs - state.lastSeenUs.load());
+            if (interval < INTERVAL_LIMIT_US) {
+                qint64 mean = state.meanIntervalUs.load();
+                mean = (mean == 0) ? interval : mean + ((interval - mean) >> INTERVAL_SHIFT);
+                state.meanIntervalUs.store(mean);
+
+                // 读者会把最大值清零，用比较交换避免覆盖清零
+                qint64 peak = state.maxIntervalUs.load();
+                while (interval > peak && !state.maxIntervalUs.testAndSetRelaxed(peak, interval)) {
+                    peak = state.maxIntervalUs.load();
+                }
+            }
+        }
+        state.lastSeenUs.store(qMax(sample.timeUs, state.lastSeenUs.load()));
+        state.samples.storeRelease(seen + 1);
+    }
+}
+
+bool CANNodeRegistry::isKnown(int key) const
+{
+    return key >= 0 && key < MAX_KEYS && m_nodes[key].samples.loadAcquire() > 0;
+}
+
+QVector<int> CANNodeRegistry::knownNodes() const
+{
+    QVector<int> nodes;
+    for (int i = 0; i < MAX_KEYS; i++) {
+        if (m_nodes[i].samples.loadAcquire() > 0)
+            nodes.append(i);
+    }
+    return nodes;
+}
+
+bool CANNodeRegistry::isOnline(const NodeState &state, qint64 nowUs) const
+{
+    return state.samples.loadAcquire() > 0 &&
+           nowUs - state.lastSeenUs.load() <= m_offlineTimeoutUs.load();
+}
+
+CANNodeRegistry::NodeInfo CANNodeRegistry::info(int key, qint64 nowUs, bool resetMaxInterval)
+{
+    NodeInfo info;
+    info.key = key;
+    info.node = canNodeKeyNode(key);
+    info.channel = canNodeKeyChannel(key);
+    info.samples = 0;
+    info.firstSeenUs = 0;
+    info.lastSeenUs = 0;
+    info.meanIntervalUs = 0;
+    info.maxIntervalUs = 0;
+    info.online = false;
+    if (key < 0 || key >= MAX_KEYS)
+        return info;
+
+    NodeState &state = m_nodes[key];
+    info.samples = state.samples.loadAcquire();
+    if (info.samples > 0) {
+        info.firstSeenUs = state.firstSeenUs.load();
+        info.lastSeenUs = state.lastSeenUs.load();
+        info.meanIntervalUs = state.meanIntervalUs.load();
+        info.maxIntervalUs = resetMaxInterval ? state.maxIntervalUs.fetchAndStoreRelaxed(0)
+                                              : state.maxIntervalUs.load();
+        info.online = isOnline(state, nowUs);
+    }
+    info.name = nodeName(key);
+    return info;
+}
+
+int CANNodeRegistry::onlineCount(qint64 nowUs) const
+{
+    int count = 0;
+    for (int i = 0; i < MAX_KEYS; i++) {
+        if (isOnline(m_nodes[i], nowUs))
+            count++;
+    }
+    return count;
+}
+
+void CANNodeRegistry::setOfflineTimeoutUs(qint64 timeoutUs)
+{
+    m_offlineTimeoutUs.store(qMax<qint64>(1000, timeoutUs));
+}
+
+qint64 CANNodeRegistry::offlineTimeoutUs() const
+{
+    return m_offlineTimeoutUs.load();
+}
+
+void CANNodeRegistry::setNodeName(int key, const QString &name)
+{
+    if (key < 0 || key >= MAX_KEYS)
+        return;
+    QMutexLocker locker(&m_nameMutex);
+    m_names[key] = name;
+}
+
+QString CANNodeRegistry::nodeName(int key) const
+{
+    if (key < 0 || key >= MAX_KEYS)
+        return QString();
+    QMutexLocker locker(&m_nameMutex);
+    return m_names[key];
+}
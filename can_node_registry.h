@@ -0,0 +1,70 @@
+#ifndef CAN_NODE_REGISTRY_H
+#define CAN_NODE_REGISTRY_H
+
+#include <QVector>
+#include <QString>
+#include <QMutex>
+#include <QAtomicInteger>
+#include "can_status_sample.h"
+
+// 总线上的节点登记（节点号即状态帧ID 0-127）
+// 按节点键（全局通道号, 节点号，见can_status_sample.h）分别登记，不同总线上的同号节点各占一项；
+// 接收解码线程按状态样本更新每个节点的首次/最近出现时间、样本数和帧间隔，
+// 界面等任意线程无锁读取；节点名称由界面设置，单独加锁
+class CANNodeRegistry
+{
+public:
+    static const int MAX_KEYS = CAN_STATUS_MAX_KEYS;
+    static const qint64 DEFAULT_OFFLINE_TIMEOUT_US = 500000;
+
+    struct NodeInfo {
+        int key;                    // 节点键
+        int node;
+        int channel;                // 全局通道号
+        quint64 samples;            // 累计样本数
+        qint64 firstSeenUs;         // 主机单调时间（见can_timestamp.h）
+        qint64 lastSeenUs;
+        qint64 meanIntervalUs;      // 样本间隔滑动平均
+        qint64 maxIntervalUs;       // 上次takeMaxInterval以来的最大间隔
+        bool online;                // 超时内收到过样本
+        QString name;
+    };
+
+    CANNodeRegistry();
+
+    // 写入（仅解码线程）
+    void update(const CANStatusSample *samples, int count);
+
+    // 读取（任意线程），参数均为节点键
+    bool isKnown(int key) const;
+    QVector<int> knownNodes() const;
+    // nowUs为当前canMonotonicUs()；resetMaxInterval为true时读取后清零最大间隔（按刷新周期统计）
+    NodeInfo info(int key, qint64 nowUs, bool resetMaxInterval = false);
+    int onlineCount(qint64 nowUs) const;
+
+    void setOfflineTimeoutUs(qint64 timeoutUs);
+    qint64 offlineTimeoutUs() const;
+
+    void setNodeName(int key, const QString &name);
+    QString nodeName(int key) const;
+
+private:
+    struct NodeState {
+        NodeState();
+
+        QAtomicInteger<quint64> samples;    // release发布，读者先读它再读其他字段
+        QAtomicInteger<qint64> firstSeenUs;
+        QAtomicInteger<qint64> lastSeenUs;
+        QAtomicInteger<qint64> meanIntervalUs;
+        QAtomicInteger<qint64> maxIntervalUs;
+    };
+
+    bool isOnline(const NodeState &state, qint64 nowUs) const;
+
+    NodeState m_nodes[MAX_KEYS];
+    QAtomicInteger<qint64> m_offlineTimeoutUs;
+    mutable QMutex m_nameMutex;
+    QString m_names[MAX_KEYS];
+};
+
+#endif // CAN_NODE_REGISTRY_H
@@ -0,0 +1,471 @@
+#include "can_overflow_policy.h"
+#include "can_frame_ring.h"
+#include <QDir>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QThread>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+    const char *const CLASS_NAMES[CANClassCount] = { "status", "scope", "sdo", "other" };
+    const char *const ACTION_NAMES[] = { "drop-newest", "drop-oldest", "block", "spill" };
+    const int SPILL_READ_CHUNK = 512;
+}
+
+CANTrafficClass canTrafficClass(const VCI_CAN_OBJ &frame)
+{
+    if (frame.ExternFlag)
+        return CANClassOther;
+
+    UINT id = frame.ID;
+    if (id < 0x080)
+        return CANClassStatus;                 // 状态反馈 ID=节点号（含节点0）
+    if (id >= 0x500 && id <= 0x57F)
+        return CANClassScope;                  // 数据上抛协议
+    if (id >= 0x580 && id <= 0x5FF)
+        return CANClassSdo;                    // SDO应答
+    return CANClassOther;                      // 0x080-0x1FF为其他主机发出的命令帧
+}
+
+QString canTrafficClassName(CANTrafficClass cls)
+{
+    if (cls < 0 || cls >= CANClassCount)
+        return QString();
+    return QString::fromLatin1(CLASS_NAMES[cls]);
+}
+
+CANOverflowPolicy::CANOverflowPolicy()
+{
+    setAction(CANClassStatus, CANDropOldest);
+    setAction(CANClassScope, CANDropOldest);
+    setAction(CANClassSdo, CANBlockProducer);
+    setAction(CANClassOther, CANDropNewest);
+    resetCounters();
+}
+
+static bool configureFromEnvironment(CANOverflowPolicy &policy)
+{
+    QByteArray env = qgetenv("MOTOR_CAN_OVERFLOW");
+    if (!env.isEmpty() && !policy.parse(QString::fromLatin1(env.constData()))) {
+        qWarning() << "MOTOR_CAN_OVERFLOW 配置无法完全识别:" << env;
+        return false;
+    }
+    return true;
+}
+
+CANOverflowPolicy &CANOverflowPolicy::instance()
+{
+    // 局部静态变量的初始化是线程安全的，各接收线程首次使用时只读取一次环境变量
+    static CANOverflowPolicy policy;
+    static const bool configured = configureFromEnvironment(policy);
+    Q_UNUSED(configured);
+    return policy;
+}
+
+void CANOverflowPolicy::setAction(CANTrafficClass cls, CANOverflowAction action)
+{
+    if (cls < 0 || cls >= CANClassCount)
+        return;
+    m_actions[cls].storeRelease(action);
+}
+
+CANOverflowAction CANOverflowPolicy::action(CANTrafficClass cls) const
+{
+    if (cls < 0 || cls >= CANClassCount)
+        return CANDropNewest;
+    return static_cast<CANOverflowAction>(m_actions[cls].loadAcquire());
+}
+
+bool CANOverflowPolicy::parse(const QString &spec)
+{
+    bool ok = true;
+    const QStringList items = spec.split(QLatin1Char(','), QString::SkipEmptyParts);
+    for (const QString &item : items) {
+        QStringList pair = item.split(QLatin1Char('='));
+        if (pair.size() != 2) {
+            ok = false;
+            continue;
+        }
+        QString className = pair.at(0).trimmed().toLower();
+        QString actionName = pair.at(1).trimmed().toLower();
+
+        int cls = -1;
+        for (int i = 0; i < CANClassCount; i++) {
+            if (className == QLatin1String(CLASS_NAMES[i]))
+                cls = i;
+        }
+        int action = -1;
+        for (int i = 0; i < 4; i++) {
+            if (actionName == QLatin1String(ACTION_NAMES[i]))
+                action = i;
+        }
+        if (cls < 0 || action < 0) {
+            ok = false;
+            continue;
+        }
+        setAction(static_cast<CANTrafficClass>(cls), static_cast<CANOverflowAction>(action));
+    }
+    return ok;
+}
+
+void CANOverflowPolicy::noteDropped(CANTrafficClass cls, int count)
+{
+    if (count > 0)
+        m_dropped[cls].fetchAndAddRelaxed(static_cast<quint64>(count));
+}
+
+void CANOverflowPolicy::noteSpilled(CANTrafficClass cls, int count)
+{
+    if (count > 0)
+        m_spilled[cls].fetchAndAddRelaxed(static_cast<quint64>(count));
+}
+
+void CANOverflowPolicy::noteBlocked(CANTrafficClass cls)
+{
+    m_blocked[cls].fetchAndAddRelaxed(1);
+}
+
+quint64 CANOverflowPolicy::dropped(CANTrafficClass cls) const
+{
+    return m_dropped[cls].load();
+}
+
+quint64 CANOverflowPolicy::spilled(CANTrafficClass cls) const
+{
+    return m_spilled[cls].load();
+}
+
+quint64 CANOverflowPolicy::blocked(CANTrafficClass cls) const
+{
+    return m_blocked[cls].load();
+}
+
+quint64 CANOverflowPolicy::totalDropped() const
+{
+    quint64 total = 0;
+    for (int cls = 0; cls < CANClassCount; cls++)
+        total += m_dropped[cls].load();
+    return total;
+}
+
+void CANOverflowPolicy::resetCounters()
+{
+    for (int cls = 0; cls < CANClassCount; cls++) {
+        m_dropped[cls].store(0);
+        m_spilled[cls].store(0);
+        m_blocked[cls].store(0);
+    }
+}
+
+const int CANOverflowBuffer::BLOCK_STALL_MS;
+
+CANOverflowBuffer::CANOverflowBuffer(CANFrameRing *ring, const QString &spillName, int stagingCapacity)
+    : m_ring(ring)
+    , m_policy(CANOverflowPolicy::instance())
+    , m_stagingCapacity(qMax(16, stagingCapacity))
+    , m_stagingCount(0)
+    , m_nextSeq(0)
+    , m_stopped(nullptr)
+    , m_blockingAllowed(true)
+    , m_spillName(spillName)
+    , m_spillReadPos(0)
+    , m_spillPending(0)
+{
+    for (int cls = 0; cls < CANClassCount; cls++) {
+        m_queues[cls].head = 0;
+        m_queues[cls].count = 0;
+        m_spillPendingByClass[cls] = 0;
+    }
+}
+
+CANOverflowBuffer::~CANOverflowBuffer()
+{
+    if (m_spillFile.isOpen()) {
+        m_spillFile.close();
+        m_spillFile.remove();
+    }
+}
+
+void CANOverflowBuffer::write(const VCI_CAN_OBJ *frames, int count)
+{
+    if (count <= 0) return;
+
+    if (!isEmpty())
+        drain();
+
+    int index = 0;
+    if (isEmpty()) {
+        // 没有积压时直接写入环形缓冲
+        while (index < count) {
+            VCI_CAN_OBJ *dst = nullptr;
+            int space = m_ring->beginWrite(&dst, count - index);
+            if (space <= 0) break;
+            memcpy(dst, frames + index, sizeof(VCI_CAN_OBJ) * space);
+            m_ring->commitWrite(space);
+            index += space;
+        }
+    }
+
+    for (; index < count; index++)
+        handle(frames[index]);
+
+    flushSpill();
+}
+
+void CANOverflowBuffer::handle(const VCI_CAN_OBJ &frame)
+{
+    CANTrafficClass cls = canTrafficClass(frame);
+    CANOverflowAction action = m_policy.action(cls);
+
+    // 已有溢写积压时同类帧继续溢写，保持顺序
+    if (action == CANSpillToDisk && m_spillPending > 0 && spill(frame, cls))
+        return;
+
+    if (m_stagingCount < m_stagingCapacity) {
+        stage(frame, cls);
+        return;
+    }
+
+    switch (action) {
+    case CANDropOldest: {
+        ClassQueue &queue = m_queues[cls];
+        if (queue.count > 0) {
+            // 挤掉同类最旧的一帧，新帧排到队尾
+            queue.head = (queue.head + 1) % queue.frames.size();
+            queue.count--;
+            m_stagingCount--;
+            drop(cls, 1);
+            stage(frame, cls);
+        } else {
+            drop(cls, 1);
+        }
+        break;
+    }
+    case CANBlockProducer:
+        if (blockUntilRoom(cls)) {
+            stage(frame, cls);
+        } else {
+            drop(cls, 1);
+        }
+        break;
+    case CANSpillToDisk:
+        if (spill(frame, cls))
+            break;
+        // 溢写文件不可用时退化为阻塞，不丢帧
+        if (blockUntilRoom(cls)) {
+            stage(frame, cls);
+        } else {
+            drop(cls, 1);
+        }
+        break;
+    case CANDropNewest:
+    default:
+        drop(cls, 1);
+        break;
+    }
+}
+
+void CANOverflowBuffer::stage(const VCI_CAN_OBJ &frame, CANTrafficClass cls)
+{
+    ClassQueue &queue = m_queues[cls];
+    if (queue.frames.isEmpty()) {
+        // 首次溢出时才分配该类别的暂存空间
+        queue.frames.resize(m_stagingCapacity);
+        queue.seq.resize(m_stagingCapacity);
+    }
+    int slot = (queue.head + queue.count) % queue.frames.size();
+    queue.frames[slot] = frame;
+    queue.seq[slot] = m_nextSeq++;
+    queue.count++;
+    m_stagingCount++;
+}
+
+void CANOverflowBuffer::drop(CANTrafficClass cls, int count)
+{
+    m_policy.noteDropped(cls, count);
+    m_ring->noteOverflow(count);
+}
+
+bool CANOverflowBuffer::evictOldestLossy()
+{
+    // 在丢最旧类别中找序号最小（最早到达）的一帧
+    int oldest = -1;
+    quint64 oldestSeq = 0;
+    for (int cls = 0; cls < CANClassCount; cls++) {
+        const ClassQueue &queue = m_queues[cls];
+        if (queue.count == 0 || m_policy.action(static_cast<CANTrafficClass>(cls)) != CANDropOldest)
+            continue;
+        quint64 seq = queue.seq.at(queue.head);
+        if (oldest < 0 || seq < oldestSeq) {
+            oldest = cls;
+            oldestSeq = seq;
+        }
+    }
+    if (oldest < 0)
+        return false;
+
+    ClassQueue &queue = m_queues[oldest];
+    queue.head = (queue.head + 1) % queue.frames.size();
+    queue.count--;
+    m_stagingCount--;
+    drop(static_cast<CANTrafficClass>(oldest), 1);
+    return true;
+}
+
+bool CANOverflowBuffer::blockUntilRoom(CANTrafficClass cls)
+{
+    // 暂存区被可丢的状态/示波器帧占满时先挤掉一帧，不为它们阻塞接收线程（否则适配器缓冲溢出，丢的正是要保护的SDO应答）
+    if (drain() > 0 || evictOldestLossy())
+        return true;
+
+    if (!m_blockingAllowed)
+        return false;
+
+    m_policy.noteBlocked(cls);
+
+    // 不再读取新帧，等消费者腾出环形缓冲空间；期间由适配器自身缓冲承担背压
+    QElapsedTimer stall;
+    stall.start();
+    while (m_stagingCount >= m_stagingCapacity) {
+        if (m_stopped && *m_stopped)
+            return false;
+        if (drain() > 0) {
+            stall.restart();
+            continue;
+        }
+        if (stall.elapsed() >= BLOCK_STALL_MS) {
+            qWarning() << "CAN接收端持续无进展，放弃阻塞等待，类别:" << canTrafficClassName(cls);
+            return false;
+        }
+        QThread::usleep(100);
+    }
+    return true;
+}
+
+bool CANOverflowBuffer::spill(const VCI_CAN_OBJ &frame, CANTrafficClass cls)
+{
+    if (!m_spillFile.isOpen()) {
+        m_spillFile.setFileName(QDir::temp().filePath(QString("motor_can_spill_%1.bin").arg(m_spillName)));
+        if (!m_spillFile.open(QIODevice::ReadWrite | QIODevice::Truncate)) {
+            qWarning() << "CAN溢写文件打开失败:" << m_spillFile.fileName() << m_spillFile.errorString();
+            return false;
+        }
+        qDebug() << "CAN接收溢写到磁盘:" << m_spillFile.fileName();
+        resetSpill();
+    }
+
+    m_spillBuffer.append(frame);
+    m_spillPending++;
+    m_spillPendingByClass[cls]++;
+    m_policy.noteSpilled(cls, 1);
+    return true;
+}
+
+bool CANOverflowBuffer::flushSpill()
+{
+    if (m_spillBuffer.isEmpty())
+        return true;
+
+    qint64 bytes = static_cast<qint64>(sizeof(VCI_CAN_OBJ)) * m_spillBuffer.size();
+    if (!m_spillFile.seek(m_spillFile.size()) ||
+        m_spillFile.write(reinterpret_cast<const char *>(m_spillBuffer.constData()), bytes) != bytes) {
+        qWarning() << "CAN溢写文件写入失败:" << m_spillFile.errorString();
+        // 写入失败的帧只能丢弃，按类别计入
+        for (const VCI_CAN_OBJ &frame : m_spillBuffer) {
+            CANTrafficClass cls = canTrafficClass(frame);
+            m_spillPendingByClass[cls]--;
+            drop(cls, 1);
+        }
+        m_spillPending -= m_spillBuffer.size();
+        m_spillBuffer.clear();
+        return false;
+    }
+    m_spillBuffer.clear();
+    return true;
+}
+
+int CANOverflowBuffer::drain()
+{
+    int moved = 0;
+    while (m_stagingCount > 0) {
+        VCI_CAN_OBJ *dst = nullptr;
+        int space = m_ring->beginWrite(&dst, m_stagingCount);
+        if (space <= 0) break;
+
+        // 按序号合并各类别队列，恢复到达顺序
+        for (int i = 0; i < space; i++) {
+            int best = -1;
+            quint64 bestSeq = 0;
+            for (int cls = 0; cls < CANClassCount; cls++) {
+                const ClassQueue &queue = m_queues[cls];
+                if (queue.count == 0) continue;
+                quint64 seq = queue.seq.at(queue.head);
+                if (best < 0 || seq < bestSeq) {
+                    best = cls;
+                    bestSeq = seq;
+                }
+            }
+            ClassQueue &queue = m_queues[best];
+            dst[i] = queue.frames.at(queue.head);
+            queue.head = (queue.head + 1) % queue.frames.size();
+            queue.count--;
+        }
+        m_stagingCount -= space;
+        m_ring->commitWrite(space);
+        moved += space;
+    }
+
+    if (m_stagingCount == 0) {
+        m_nextSeq = 0;
+        if (m_spillPending > 0)
+            moved += drainSpill();
+    }
+    return moved;
+}
+
+int CANOverflowBuffer::drainSpill()
+{
+    if (!flushSpill())
+        return 0;
+
+    int moved = 0;
+    while (m_spillPending > 0) {
+        VCI_CAN_OBJ *dst = nullptr;
+        int space = m_ring->beginWrite(&dst, static_cast<int>(qMin<qint64>(m_spillPending, SPILL_READ_CHUNK)));
+        if (space <= 0) break;
+
+        qint64 bytes = static_cast<qint64>(sizeof(VCI_CAN_OBJ)) * space;
+        if (!m_spillFile.seek(m_spillReadPos) ||
+            m_spillFile.read(reinterpret_cast<char *>(dst), bytes) != bytes) {
+            qWarning() << "CAN溢写文件读取失败:" << m_spillFile.errorString();
+            // 未回放的帧按溢写时记录的类别计入丢失
+            for (int cls = 0; cls < CANClassCount; cls++)
+                drop(static_cast<CANTrafficClass>(cls), static_cast<int>(m_spillPendingByClass[cls]));
+            m_spillPending = 0;
+            break;
+        }
+        for (int i = 0; i < space; i++)
+            m_spillPendingByClass[canTrafficClass(dst[i])]--;
+        m_spillReadPos += bytes;
+        m_spillPending -= space;
+        m_ring->commitWrite(space);
+        moved += space;
+    }
+
+    if (m_spillPending == 0)
+        resetSpill();
+    return moved;
+}
+
+void CANOverflowBuffer::resetSpill()
+{
+    // 积压回放完后截断文件，避免长时间运行时无限增长
+    m_spillReadPos = 0;
+    m_spillPending = 0;
+    for (int cls = 0; cls < CANClassCount; cls++)
+        m_spillPendingByClass[cls] = 0;
+    m_spillBuffer.clear();
+    if (m_spillFile.isOpen())
+        m_spillFile.resize(0);
+}
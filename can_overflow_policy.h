@@ -0,0 +1,128 @@
+#ifndef CAN_OVERFLOW_POLICY_H
+#define CAN_OVERFLOW_POLICY_H
+
+#include <QAtomicInteger>
+#include <QString>
+#include <QVector>
+#include <QFile>
+#include "ControlCAN.h"
+
+class CANFrameRing;
+
+// 接收帧的业务分类（按本协议的ID分配，不是CANopen：0x080-0x1FF为位置/速度/电流命令，没有NMT/心跳/紧急报文），
+// 溢出时按类别采用不同策略
+enum CANTrafficClass {
+    CANClassStatus = 0,    // 状态反馈 0x000-0x07F（ID=节点号），可丢
+    CANClassScope,         // 数据上抛/示波器 0x500-0x57F，可丢
+    CANClassSdo,           // SDO应答 0x580-0x5FF，不可丢
+    CANClassOther,         // 其他主机发出的命令帧、扩展帧等
+    CANClassCount
+};
+
+CANTrafficClass canTrafficClass(const VCI_CAN_OBJ &frame);
+QString canTrafficClassName(CANTrafficClass cls);
+
+// 接收环形缓冲满时的处理方式
+enum CANOverflowAction {
+    CANDropNewest = 0,     // 丢弃新到的帧
+    CANDropOldest,         // 挤掉暂存区中同类最旧的帧
+    CANBlockProducer,      // 接收线程等待消费者腾出空间（适配器缓冲承担背压）
+    CANSpillToDisk         // 写入临时文件，空闲后按序回放
+};
+
+// 各类别的溢出策略和精确到帧的丢失计数（进程内共用）
+// 默认：状态/示波器丢最旧，SDO阻塞，其他丢最新
+// 可通过环境变量覆盖，如 MOTOR_CAN_OVERFLOW=status=drop-newest,scope=spill,other=drop-oldest
+class CANOverflowPolicy
+{
+public:
+    CANOverflowPolicy();
+
+    static CANOverflowPolicy &instance();
+
+    void setAction(CANTrafficClass cls, CANOverflowAction action);
+    CANOverflowAction action(CANTrafficClass cls) const;
+    // 解析 "类别=策略,..." 形式的配置，返回是否全部识别
+    bool parse(const QString &spec);
+
+    void noteDropped(CANTrafficClass cls, int count);
+    void noteSpilled(CANTrafficClass cls, int count);
+    void noteBlocked(CANTrafficClass cls);
+
+    quint64 dropped(CANTrafficClass cls) const;
+    quint64 spilled(CANTrafficClass cls) const;
+    quint64 blocked(CANTrafficClass cls) const;
+    quint64 totalDropped() const;
+    void resetCounters();
+
+private:
+    QAtomicInt m_actions[CANClassCount];
+    QAtomicInteger<quint64> m_dropped[CANClassCount];
+    QAtomicInteger<quint64> m_spilled[CANClassCount];
+    QAtomicInteger<quint64> m_blocked[CANClassCount];
+};
+
+// 单生产者的溢出处理：环形缓冲有空间时直接写入，放不下的帧按类别进入暂存队列，
+// 暂存区满时按类别策略处理。暂存帧带序号，搬回环形缓冲时按到达顺序合并，
+// 溢写文件中的帧在暂存区清空后回放（同类帧之间顺序不变，帧时间戳不受影响）
+// 暂存区满时，阻塞前先挤掉暂存区中最旧的一帧丢最旧类别的帧（状态/示波器），不让可丢的帧占着位置阻塞SDO；
+// 阻塞策略只在消费者持续无进展超过BLOCK_STALL_MS时放弃（接收端已停止），此时计入丢失
+class CANOverflowBuffer
+{
+public:
+    static const int BLOCK_STALL_MS = 2000;
+
+    CANOverflowBuffer(CANFrameRing *ring, const QString &spillName, int stagingCapacity = 8192);
+    ~CANOverflowBuffer();
+
+    // 阻塞等待时检查该标志，置位后立即放弃等待（线程停止）
+    void setAbortFlag(const volatile bool *stopped) { m_stopped = stopped; }
+    // 生产者不允许阻塞（如在界面线程写入）时，阻塞策略改为暂存区满即丢弃并计数
+    void setBlockingAllowed(bool allowed) { m_blockingAllowed = allowed; }
+    // 溢写文件名后缀，需在首次溢写前设置
+    void setSpillName(const QString &name) { m_spillName = name; }
+
+    bool isEmpty() const { return m_stagingCount == 0 && m_spillPending == 0; }
+    int pendingCount() const { return m_stagingCount + static_cast<int>(m_spillPending); }
+
+    // 写入一批帧（已打好通道标记和时间戳）
+    void write(const VCI_CAN_OBJ *frames, int count);
+    // 把暂存区和溢写文件中的帧搬回环形缓冲，返回搬回帧数
+    int drain();
+
+private:
+    struct ClassQueue {
+        QVector<VCI_CAN_OBJ> frames;
+        QVector<quint64> seq;
+        int head;
+        int count;
+    };
+
+    void handle(const VCI_CAN_OBJ &frame);
+    void stage(const VCI_CAN_OBJ &frame, CANTrafficClass cls);
+    bool blockUntilRoom(CANTrafficClass cls);
+    bool evictOldestLossy();
+    bool spill(const VCI_CAN_OBJ &frame, CANTrafficClass cls);
+    void drop(CANTrafficClass cls, int count);
+    bool flushSpill();
+    int drainSpill();
+    void resetSpill();
+
+    CANFrameRing *m_ring;
+    CANOverflowPolicy &m_policy;
+    ClassQueue m_queues[CANClassCount];
+    int m_stagingCapacity;
+    int m_stagingCount;
+    quint64 m_nextSeq;
+    const volatile bool *m_stopped;
+    bool m_blockingAllowed;
+
+    QString m_spillName;
+    QFile m_spillFile;
+    QVector<VCI_CAN_OBJ> m_spillBuffer;   // 待写入溢写文件的帧，每批写入一次
+    qint64 m_spillReadPos;
+    qint64 m_spillPending;                // 溢写（含待写入）未回放的帧数
+    qint64 m_spillPendingByClass[CANClassCount];  // 按类别，读取失败时按类别计入丢失
+};
+
+#endif // CAN_OVERFLOW_POLICY_H
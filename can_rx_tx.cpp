@@ -5,11 +5,14 @@
 #include <cmath>
 #include "global_vars.h"
 #include <QThread>
-#include "data_acquisition.h"
-#include "control_param.h"
 #include <QElapsedTimer>
 #include <QDateTime>
+#include <QMetaMethod>
+#include <QPointer>
+#include <QTimer>
 #include "can_types.h"
+#include "can_status_decoder.h"
+#include "can_command_codec.h"
 #include "canthread.h"
 
 // 定义全局CAN收发对象
@@ -17,6 +20,9 @@ CANTxRx *g_canTxRx = nullptr;
 
 // 静态类型注册
 namespace {
+    // 回放结束后检查回放缓冲是否已被接收线程读空的间隔
+    const int REPLAY_DETACH_RETRY_MS = 5;
+
     void registerTypesOnce() {
         static bool registered = false;
         if (!registered) {
@@ -29,9 +35,21 @@ namespace {
 // CAN接收线程实现
 CANReceiver::CANReceiver(QObject *parent)
     : QThread(parent)
+    , m_injectRing(4096)
+    , m_injectOverflow(&m_injectRing, QStringLiteral("inject"))
+    , m_dispatcher(nullptr)
+    , m_telemetryStore(nullptr)
+    , m_nodeRegistry(nullptr)
+    , m_captureWriter(nullptr)
+    , m_latencyTracer(nullptr)
+    , m_forwardFrames(0)
     , m_running(false)
     , m_highSpeedMode(false)
+    , m_lastOverflow(0)
 {
+    addSource(&m_injectRing);
+    // 注入来自界面线程，环形缓冲满时不能等待接收线程
+    m_injectOverflow.setBlockingAllowed(false);
 }
 
 CANReceiver::~CANReceiver()
@@ -42,7 +60,7 @@ CANReceiver::~CANReceiver()
 void CANReceiver::stop()
 {
     m_running = false;
-    m_queueCondition.wakeAll();
+    m_notifier.notify();
     if (!wait(1000)) {
         terminate();
         wait();
@@ -54,28 +72,86 @@ void CANReceiver::setHighSpeedMode(bool enabled)
     m_highSpeedMode = enabled;
 }
 
-int CANReceiver::getQueueSize() const
+void CANReceiver::setDispatcher(CANDispatcher *dispatcher)
 {
-    QMutexLocker locker(&m_queueMutex);
-    return m_frameQueue.size();
+    m_dispatcher = dispatcher;
 }
 
-void CANReceiver::pushFrames(const QList<VCI_CAN_OBJ> &frames)
+void CANReceiver::setTelemetryStore(CANTelemetryStore *store)
 {
-    if (frames.isEmpty()) return;
+    m_telemetryStore = store;
+}
+
+void CANReceiver::setNodeRegistry(CANNodeRegistry *registry)
+{
+    m_nodeRegistry = registry;
+}
+
+void CANReceiver::setCaptureWriter(CANCaptureWriter *writer)
+{
+    m_captureWriter.storeRelease(writer);
+    // 等待正在进行的一轮读取结束，之后接收线程只会看到新的写线程
+    QMutexLocker passLocker(&m_passMutex);
+}
 
-    QMutexLocker locker(&m_queueMutex);
+void CANReceiver::setLatencyTracer(CANLatencyTracer *tracer)
+{
+    m_latencyTracer = tracer;
+}
 
-    if (m_frameQueue.size() >= MAX_QUEUE_SIZE) {
-        if (!m_frameQueue.isEmpty()) {
-            m_frameQueue.dequeue();
+void CANReceiver::setForwardFrames(bool enabled)
+{
+    m_forwardFrames.storeRelease(enabled ? 1 : 0);
+}
+
+void CANReceiver::addSource(CANFrameRing *ring)
+{
+    if (!ring) return;
+
+    QMutexLocker locker(&m_sourceMutex);
+    if (!m_sources.contains(ring)) {
+        ring->setNotifier(&m_notifier);
+        m_sources.append(ring);
+        m_sourcesChanged.storeRelease(1);
+        m_notifier.notify();
+    }
+}
+
+void CANReceiver::removeSource(CANFrameRing *ring)
+{
+    {
+        QMutexLocker locker(&m_sourceMutex);
+        if (!m_sources.removeOne(ring)) {
+            return;
         }
-        emit queueOverflow();
-        return;
+        ring->setNotifier(nullptr);
+        m_sourcesChanged.storeRelease(1);
     }
+    // 等待正在进行的一轮读取结束
+    QMutexLocker passLocker(&m_passMutex);
+}
 
-    m_frameQueue.enqueue(frames);
-    m_queueCondition.wakeOne();
+int CANReceiver::getQueueSize() const
+{
+    QMutexLocker locker(&m_sourceMutex);
+    int pending = 0;
+    for (CANFrameRing *ring : m_sources) {
+        pending += ring->size();
+    }
+    return pending;
+}
+
+void CANReceiver::pushFrames(const QList<VCI_CAN_OBJ> &frames)
+{
+    if (frames.isEmpty()) return;
+
+    m_injectScratch.resize(frames.size());
+    for (int i = 0; i < frames.size(); i++) {
+        m_injectScratch[i] = frames.at(i);
+    }
+    m_injectMapper.stamp(m_injectScratch.data(), m_injectScratch.size(), canMonotonicUs());
+    // 放不下的帧先进暂存区，暂存区也满时丢弃并按类别计数（调用方是界面线程，不阻塞）
+    m_injectOverflow.write(m_injectScratch.constData(), m_injectScratch.size());
 }
 
 void CANReceiver::run()
@@ -84,81 +160,139 @@ void CANReceiver::run()
 
     const int BATCH_SIZE = m_highSpeedMode ? 50 : 10;
     const int BATCH_TIMEOUT_MS = m_highSpeedMode ? 10 : 50;
+    const int IDLE_WAIT_MS = 500;
 
-    QList<VCI_CAN_OBJ> currentBatch;
-    QVector<QPair<DWORD, QVector<float>>> statusBatch;
+    CANFrameBatch currentBatch;          // 只在有全量监听者时填充
+    int batchFrames = 0;
+    CANStatusBatch statusBatch;
+    currentBatch.reserve(BATCH_SIZE);
     QElapsedTimer batchTimer;
     batchTimer.start();
 
-    while (m_running) {
-        QList<VCI_CAN_OBJ> frames;
-        {
-            QMutexLocker locker(&m_queueMutex);
-            if (m_frameQueue.isEmpty()) {
-                m_queueCondition.wait(&m_queueMutex, BATCH_TIMEOUT_MS);
-            }
+    auto flushBatch = [&]() {
+        if (m_dispatcher) {
+            m_dispatcher->flush();
+        }
 
-            if (!m_frameQueue.isEmpty()) {
-                frames = m_frameQueue.dequeue();
-            }
+        if (batchFrames > 0) {
+            emit framesCounted(batchFrames);
+            batchFrames = 0;
         }
 
-        for (const auto &frame : frames) {
-            currentBatch.append(frame);
+        if (!currentBatch.isEmpty()) {
+            emit framesProcessed(currentBatch);
+            currentBatch.clear();
+        }
 
-            if (frame.ID < 0x80 && frame.DataLen == 8) {
-                int16_t speed_int, current_int;
-                int32_t position_int;
+        if (!statusBatch.isEmpty()) {
+            emit statusSamplesReceived(statusBatch);
+            // 已发出的批次由接收方共享，换一个新数组（每批一次分配）
+            statusBatch = CANStatusBatch();
+            statusBatch.reserve(BATCH_SIZE);
+        }
 
-                memcpy(&speed_int, &frame.Data[0], 2);
-                memcpy(&position_int, &frame.Data[2], 4);
-                memcpy(&current_int, &frame.Data[6], 2);
+        batchTimer.restart();
+    };
 
-                float speed = speed_int / 10.0f;
-                float position = position_int / 1000.0f;
-                float current = current_int / 1000.0f;
+    QList<CANFrameRing*> sources;
+    m_sourcesChanged.storeRelease(1);
 
-                if (!std::isnan(speed) && !std::isinf(speed) &&
-                    !std::isnan(position) && !std::isinf(position) &&
-                    !std::isnan(current) && !std::isinf(current)) {
+    while (m_running) {
+        QMutexLocker passLocker(&m_passMutex);
+        // 源列表很少变化，只在变化后重新复制，平时不碰m_sourceMutex
+        if (m_sourcesChanged.fetchAndStoreOrdered(0)) {
+            QMutexLocker locker(&m_sourceMutex);
+            sources = m_sources;
+        }
 
-                    QVector<float> statusData = {speed, position, current};
-                    statusBatch.append(qMakePair(frame.ID, statusData));
+        int consumed = 0;
+        quint64 overflow = 0;
+        CANCaptureWriter *capture = m_captureWriter.loadAcquire();
+        for (CANFrameRing *ring : sources) {
+            const VCI_CAN_OBJ *frames = nullptr;
+            int count;
+            // 在环形缓冲中原地解析，处理完再释放空间
+            while ((count = ring->beginRead(&frames)) > 0) {
+                if (capture) {
+                    capture->capture(frames, count);
+                }
+                // 按COB-ID查表归入各订阅者的批次，随批次一起投递
+                if (m_dispatcher) {
+                    m_dispatcher->dispatch(frames, count);
+                }
+                bool forwardFrames = m_forwardFrames.loadAcquire() != 0;
+                qint64 nowUs = canMonotonicUs();
+                if (m_latencyTracer) {
+                    m_latencyTracer->onReceived(frames, count, nowUs);
                 }
+                // 按批次剩余空间分段，每段状态帧一次批量解码，直接写入状态批次末尾
+                for (int first = 0; first < count; ) {
+                    int n = qMin(count - first, BATCH_SIZE - batchFrames);
+                    const VCI_CAN_OBJ *segment = frames + first;
+                    if (forwardFrames) {
+                        for (int i = 0; i < n; i++) {
+                            currentBatch.append(segment[i]);
+                        }
+                    }
+
+                    int oldSize = statusBatch.size();
+                    statusBatch.resize(oldSize + n);
+                    int decoded = decodeCanStatusSamples(segment, n, statusBatch.data() + oldSize, nowUs);
+                    statusBatch.resize(oldSize + decoded);
+                    if (m_telemetryStore) {
+                        for (int i = oldSize; i < statusBatch.size(); i++) {
+                            m_telemetryStore->append(statusBatch.at(i));
+                        }
+                    }
+                    if (m_nodeRegistry) {
+                        m_nodeRegistry->update(statusBatch.constData() + oldSize, decoded);
+                    }
+
+                    first += n;
+                    batchFrames += n;
+                    if (batchFrames >= BATCH_SIZE ||
+                        batchTimer.elapsed() >= BATCH_TIMEOUT_MS) {
+                        flushBatch();
+                    }
+                }
+                ring->commitRead(count);
+                consumed += count;
             }
+            overflow += ring->overflowCount();
+        }
 
-            if (currentBatch.size() >= BATCH_SIZE ||
-                batchTimer.elapsed() >= BATCH_TIMEOUT_MS) {
+        passLocker.unlock();
 
-                if (!currentBatch.isEmpty()) {
-                    emit framesProcessed(currentBatch);
-                    currentBatch.clear();
-                }
-
-                if (!statusBatch.isEmpty()) {
-                    emit statusDataBatchReceived(statusBatch);
-                    statusBatch.clear();
-                }
+        if (overflow != m_lastOverflow) {
+            m_lastOverflow = overflow;
+            emit queueOverflow();
+        }
 
-                batchTimer.restart();
-            }
+        // 没有新数据时等待唤醒；有未满的批次时按批次超时等待，超时后发出避免滞留，
+        // 完全空闲时长时间挂起，由生产者唤醒
+        if (consumed == 0) {
+            bool hasPartial = batchFrames > 0 || !statusBatch.isEmpty();
+            m_notifier.wait(hasPartial ? BATCH_TIMEOUT_MS : IDLE_WAIT_MS);
+        }
+        if (batchTimer.elapsed() >= BATCH_TIMEOUT_MS) {
+            flushBatch();
         }
     }
 
-    if (!currentBatch.isEmpty()) {
-        emit framesProcessed(currentBatch);
-    }
-    if (!statusBatch.isEmpty()) {
-        emit statusDataBatchReceived(statusBatch);
-    }
+    flushBatch();
 }
 
 // CANTxRx 构造函数
 CANTxRx::CANTxRx(QObject *parent)
     : QObject(parent)
-    , m_dataAcquisition(nullptr)
     , m_receiver(new CANReceiver(this))
+    , m_dispatcher(new CANDispatcher(this))
+    , m_txBatcher(new CANTxBatcher(this))
+    , m_setpointStreamer(new CANSetpointStreamer(this, this))
+    , m_captureWriter(nullptr)
+    , m_replayer(nullptr)
     , m_canThread(nullptr)
+    , m_deviceManager(nullptr)
     , m_deviceType(4)
     , m_deviceIndex(0)
     , m_canIndex(0)
@@ -177,28 +311,35 @@ CANTxRx::CANTxRx(QObject *parent)
     // 确保类型注册
     registerTypesOnce();
 
-    m_receiveTimer = new QTimer(this);
-    m_receiveTimer->setTimerType(Qt::PreciseTimer);
-
-    // 连接信号槽 - 使用队列连接
-    connect(m_receiveTimer, &QTimer::timeout, this, &CANTxRx::onReceiveTimeout, Qt::QueuedConnection);
-
     // 检查类型是否已注册
     bool typesOk = true;
-    if (QMetaType::type("QList<VCI_CAN_OBJ>") == QMetaType::UnknownType) {
-        qWarning() << "QList<VCI_CAN_OBJ> not registered!";
+    if (QMetaType::type("CANFrameBatch") == QMetaType::UnknownType) {
+        qWarning() << "CANFrameBatch not registered!";
         typesOk = false;
     }
-    if (QMetaType::type("QVector<QPair<DWORD,QVector<float>>>") == QMetaType::UnknownType) {
-        qWarning() << "QVector<QPair<DWORD,QVector<float>>> not registered!";
+    if (QMetaType::type("CANStatusBatch") == QMetaType::UnknownType) {
+        qWarning() << "CANStatusBatch not registered!";
         typesOk = false;
     }
 
+    // 接收线程查表分发：状态帧由接收线程直接解码后经statusSamplesReceived整批发出（硬件过滤见updateAcceptanceFilter），
+    // 数据上抛/SDO应答由各使用者自行订阅
+    m_receiver->setDispatcher(m_dispatcher);
+    m_receiver->setTelemetryStore(&m_telemetryStore);
+    m_receiver->setNodeRegistry(&m_nodeRegistry);
+    m_receiver->setLatencyTracer(&m_latencyTracer);
+    m_txBatcher->setLatencyTracer(&m_latencyTracer);
+    // 订阅可在任意线程变化，回到本对象线程重设硬件过滤
+    connect(m_dispatcher, &CANDispatcher::subscriptionsChanged,
+            this, &CANTxRx::updateAcceptanceFilter, Qt::QueuedConnection);
+
     if (typesOk) {
         // 类型注册成功，使用队列连接
         connect(m_receiver, &CANReceiver::framesProcessed,
                 this, &CANTxRx::onFramesProcessed, Qt::QueuedConnection);
-        connect(m_receiver, &CANReceiver::statusDataBatchReceived,
+        connect(m_receiver, &CANReceiver::framesCounted,
+                this, &CANTxRx::onFramesCounted, Qt::QueuedConnection);
+        connect(m_receiver, &CANReceiver::statusSamplesReceived,
                 this, &CANTxRx::onStatusBatchReceived, Qt::QueuedConnection);
         connect(m_receiver, &CANReceiver::queueOverflow,
                 this, &CANTxRx::onQueueOverflow, Qt::QueuedConnection);
@@ -208,46 +349,84 @@ CANTxRx::CANTxRx(QObject *parent)
         qWarning() << "Using direct connections due to type registration failure";
         connect(m_receiver, &CANReceiver::framesProcessed,
                 this, &CANTxRx::onFramesProcessed, Qt::DirectConnection);
-        connect(m_receiver, &CANReceiver::statusDataBatchReceived,
+        connect(m_receiver, &CANReceiver::framesCounted,
+                this, &CANTxRx::onFramesCounted, Qt::DirectConnection);
+        connect(m_receiver, &CANReceiver::statusSamplesReceived,
                 this, &CANTxRx::onStatusBatchReceived, Qt::DirectConnection);
         connect(m_receiver, &CANReceiver::queueOverflow,
                 this, &CANTxRx::onQueueOverflow, Qt::DirectConnection);
     }
 
+    // 批量发送结果回到主线程统计
+    connect(m_txBatcher, &CANTxBatcher::batchSent,
+            this, &CANTxRx::onBatchSent, Qt::QueuedConnection);
+
     m_performanceTimer.start();
 }
 
 CANTxRx::~CANTxRx()
 {
+    stopReplay();
+    stopCapture();
     stopReceiving();
+    m_setpointStreamer->stop();
+    if (m_deviceManager) {
+        m_deviceManager->setLatencyTracer(nullptr);
+    }
+    m_txBatcher->stop();
     m_receiver->stop();
 }
 
-void CANTxRx::onFramesProcessed(const QList<VCI_CAN_OBJ> &frames)
+void CANTxRx::onFramesProcessed(const CANFrameBatch &frames)
 {
-    for (const auto &frame : frames) {
-        parseAndLogCANFrame(frame);
-        emit frameReceived(frame);
+    // 协议解析已由分发器按ID投递，这里只服务全量监听者
+    emit framesReceived(frames);
+    if (isSignalConnected(QMetaMethod::fromSignal(&CANTxRx::frameReceived))) {
+        for (const auto &frame : frames) {
+            emit frameReceived(frame);
+        }
     }
+}
 
-    m_framesReceived += frames.size();
+void CANTxRx::onFramesCounted(int count)
+{
+    m_framesReceived += count;
+    m_receiveCount += count;
     updatePerformanceStats();
 }
 
-void CANTxRx::onStatusBatchReceived(const QVector<QPair<DWORD, QVector<float>>> &batchData)
+void CANTxRx::connectNotify(const QMetaMethod &signal)
 {
-    for (const auto &item : batchData) {
-        DWORD canId = item.first;
-        const QVector<float> &data = item.second;
-        if (data.size() >= 3) {
-            emit statusDataReceived(canId, data[0], data[1], data[2]);
-            emit motorStatusReceived(data[0], data[1], data[2]);
-        }
+    if (signal == QMetaMethod::fromSignal(&CANTxRx::framesReceived) ||
+        signal == QMetaMethod::fromSignal(&CANTxRx::frameReceived)) {
+        m_receiver->setForwardFrames(true);
+        QMetaObject::invokeMethod(this, "updateAcceptanceFilter", Qt::QueuedConnection);
+    }
+    QObject::connectNotify(signal);
+}
+
+void CANTxRx::disconnectNotify(const QMetaMethod &signal)
+{
+    if (!isSignalConnected(QMetaMethod::fromSignal(&CANTxRx::framesReceived)) &&
+        !isSignalConnected(QMetaMethod::fromSignal(&CANTxRx::frameReceived))) {
+        m_receiver->setForwardFrames(false);
+        QMetaObject::invokeMethod(this, "updateAcceptanceFilter", Qt::QueuedConnection);
+    }
+    QObject::disconnectNotify(signal);
+}
+
+void CANTxRx::onStatusBatchReceived(const CANStatusBatch &samples)
+{
+    for (const CANStatusSample &sample : samples) {
+        emit statusDataReceived(sample.node, sample.speed, sample.position, sample.current);
+        emit motorStatusReceived(sample.speed, sample.position, sample.current);
     }
+    emit statusSamplesReceived(samples);
 
+    // 普通模式下每50批抽样打印一条
     static int batchLogCounter = 0;
-    if (!m_highSpeedMode && ++batchLogCounter % 50 == 0) {
-        qDebug() << "批量处理状态数据:" << batchData.size() << "条";
+    if (!m_highSpeedMode && !samples.isEmpty() && ++batchLogCounter % 50 == 0) {
+        logStatusSample(samples.last(), samples.size());
         batchLogCounter = 0;
     }
 }
@@ -271,12 +450,19 @@ void CANTxRx::setCANParams(DWORD deviceType, DWORD deviceIndex, DWORD canIndex)
     m_deviceIndex = deviceIndex;
     m_canIndex = canIndex;
     m_isReady = true;
+    m_txBatcher->setChannel(m_canIndex);
 
     qDebug() << "CAN参数设置 - 设备类型:" << m_deviceType
              << ", 设备索引:" << m_deviceIndex
              << ", CAN通道:" << m_canIndex;
 }
 
+UINT CANTxRx::commandChannel() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_canIndex;
+}
+
 bool CANTxRx::sendCANFrame(DWORD canId, const QByteArray &data, bool extendedFrame)
 {
     VCI_CAN_OBJ frame = createCANFrame(canId, data, extendedFrame);
@@ -285,6 +471,9 @@ bool CANTxRx::sendCANFrame(DWORD canId, const QByteArray &data, bool extendedFra
 
 bool CANTxRx::sendCANFrame(const VCI_CAN_OBJ &frame)
 {
+    if (m_deviceManager) {
+        return sendCANFrameTo(m_canIndex, frame);
+    }
     if (!m_canThread) {
         m_lastError = "CAN线程未设置，请先设置CAN线程";
         qDebug() << m_lastError;
@@ -292,25 +481,160 @@ bool CANTxRx::sendCANFrame(const VCI_CAN_OBJ &frame)
         return false;
     }
 
-    // 使用CANThread发送数据
-    bool success = m_canThread->sendData(m_canIndex, frame.ID, frame.RemoteFlag, 
-                                        frame.ExternFlag, frame.Data, frame.DataLen);
+    // 交给批量发送线程，短时间内的多帧合并为一次VCI_Transmit
+    // 发送结果在onBatchSent中统计
+    if (!m_txBatcher->enqueue(frame)) {
+        m_lastError = "CAN发送队列已满";
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    return true;
+}
+
+int CANTxRx::sendCANFrames(const QVector<VCI_CAN_OBJ> &frames)
+{
+    return sendCANFrames(frames.constData(), frames.size());
+}
+
+int CANTxRx::sendCANFrames(const VCI_CAN_OBJ *frames, int count)
+{
+    if (m_deviceManager) {
+        return sendCANFramesTo(m_canIndex, frames, count);
+    }
+    if (!m_canThread) {
+        m_lastError = "CAN线程未设置，请先设置CAN线程";
+        qDebug() << m_lastError;
+        emit errorOccurred(m_lastError);
+        return 0;
+    }
+    if (count <= 0) {
+        return 0;
+    }
+
+    int queued = m_txBatcher->enqueueBurst(frames, count);
+    if (queued < count) {
+        m_lastError = QString("CAN发送队列已满，丢弃%1帧").arg(count - queued);
+        emit errorOccurred(m_lastError);
+    }
+    return queued;
+}
+
+int CANTxRx::trySendCANFrames(const VCI_CAN_OBJ *frames, int count)
+{
+    if (count <= 0) {
+        return 0;
+    }
+    // 设备管理器/CAN线程/通道号由界面线程修改，在m_mutex下读取并入队（入队不阻塞）
+    QMutexLocker locker(&m_mutex);
+    if (m_deviceManager) {
+        // 通道不存在时sendFrames返回0，整批计为丢弃
+        return count - m_deviceManager->sendFrames(m_canIndex, frames, count);
+    }
+    if (!m_canThread || !m_isReady) {
+        return count;
+    }
+    return count - m_txBatcher->enqueueBurst(frames, count);
+}
+
+bool CANTxRx::sendCANFrameTo(UINT channel, const VCI_CAN_OBJ &frame)
+{
+    if (!m_deviceManager || !m_deviceManager->txBatcher(channel)) {
+        m_lastError = QString("CAN通道%1不存在").arg(channel);
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    if (!m_deviceManager->sendFrame(channel, frame)) {
+        m_lastError = QString("CAN通道%1发送队列已满").arg(channel);
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    return true;
+}
+
+int CANTxRx::sendCANFramesTo(UINT channel, const QVector<VCI_CAN_OBJ> &frames)
+{
+    return sendCANFramesTo(channel, frames.constData(), frames.size());
+}
 
-//    if (success) {
-//        updateStatistics(false);
-////        if (!m_highSpeedMode) {
-////            qDebug() << "CAN帧发送成功 - ID: 0x" << QString::number(frame.ID, 16).toUpper()
-////                     << "数据:" << QByteArray((char*)frame.Data, frame.DataLen).toHex(' ').toUpper();
-////        }
-//        emit frameSent(true, frame);
-//    } else {
-//        m_lastError = "CAN帧发送失败";
-//        qDebug() << m_lastError;
-//        emit frameSent(false, frame);
-//        emit errorOccurred(m_lastError);
-//    }
+int CANTxRx::sendCANFramesTo(UINT channel, const VCI_CAN_OBJ *frames, int count)
+{
+    if (!m_deviceManager || !m_deviceManager->txBatcher(channel)) {
+        m_lastError = QString("CAN通道%1不存在").arg(channel);
+        emit errorOccurred(m_lastError);
+        return 0;
+    }
+    if (count <= 0) {
+        return 0;
+    }
 
-    return success;
+    int queued = m_deviceManager->sendFrames(channel, frames, count);
+    if (queued < count) {
+        m_lastError = QString("CAN通道%1发送队列已满，丢弃%2帧").arg(channel).arg(count - queued);
+        emit errorOccurred(m_lastError);
+    }
+    return queued;
+}
+
+bool CANTxRx::sendGroupCommand(const CANGroupCommand &group)
+{
+    if (m_deviceManager) {
+        return sendGroupCommandTo(m_canIndex, group);
+    }
+    if (!m_canThread) {
+        m_lastError = "CAN线程未设置，请先设置CAN线程";
+        qDebug() << m_lastError;
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    if (group.isEmpty()) {
+        return false;
+    }
+
+    if (!m_txBatcher->enqueueGroup(group.frames(), group.count())) {
+        m_lastError = QString("CAN发送队列已满，丢弃成组命令%1帧").arg(group.count());
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    if (!m_highSpeedMode) {
+        qDebug() << "发送成组命令 -" << group.axisFrameCount() << "轴" << (group.hasSync() ? "+ 同步帧" : "");
+    }
+    return true;
+}
+
+bool CANTxRx::sendGroupCommandTo(UINT channel, const CANGroupCommand &group)
+{
+    if (!m_deviceManager || !m_deviceManager->txBatcher(channel)) {
+        m_lastError = QString("CAN通道%1不存在").arg(channel);
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    if (group.isEmpty()) {
+        return false;
+    }
+
+    if (!m_deviceManager->sendGroup(channel, group.frames(), group.count())) {
+        m_lastError = QString("CAN通道%1发送队列已满，丢弃成组命令%2帧").arg(channel).arg(group.count());
+        emit errorOccurred(m_lastError);
+        return false;
+    }
+    if (!m_highSpeedMode) {
+        qDebug() << "发送成组命令 - 通道" << channel << group.axisFrameCount() << "轴" << (group.hasSync() ? "+ 同步帧" : "");
+    }
+    return true;
+}
+
+void CANTxRx::onBatchSent(int requested, int sent)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_framesSent += sent;
+    }
+
+    if (sent < requested) {
+        m_lastError = QString("CAN帧发送失败: %1/%2帧未发出").arg(requested - sent).arg(requested);
+        qDebug() << m_lastError;
+        emit errorOccurred(m_lastError);
+    }
 }
 
 VCI_CAN_OBJ CANTxRx::createCANFrame(DWORD canId, const QByteArray &data, bool extendedFrame)
@@ -345,108 +669,135 @@ QList<VCI_CAN_OBJ> CANTxRx::receiveCANFrames(int maxFrames)
     return frames;
 }
 
-void CANTxRx::processReceivedFrames(const QList<VCI_CAN_OBJ> &frames)
+void CANTxRx::setCANThread(CANThread* canThread)
 {
-    if (!frames.isEmpty()) {
-        m_receiver->pushFrames(frames);
+    if (m_canThread && m_canThread != canThread) {
+        for (int ch = 0; ch < m_canThread->channelCount(); ch++)
+            m_receiver->removeSource(m_canThread->rxRing(ch));
+    }
+    {
+        QMutexLocker locker(&m_mutex);
+        m_canThread = canThread;
+    }
+    m_txBatcher->setCANThread(m_canThread);
+    if (m_canThread) {
+        // 每个通道一个环形缓冲，帧中带通道标记（canFrameChannel）
+        for (int ch = 0; ch < m_canThread->channelCount(); ch++)
+            m_receiver->addSource(m_canThread->rxRing(ch));
+        if (!m_txBatcher->isRunning()) {
+            m_txBatcher->start(QThread::HighPriority);
+        }
+        updateAcceptanceFilter();
     }
 }
 
-void CANTxRx::parseAndLogCANFrame(const VCI_CAN_OBJ &frame)
+void CANTxRx::setDeviceManager(CANDeviceManager *manager)
 {
-    // 添加总的数据接收计数
-    static int totalFrameCount = 0;
-    totalFrameCount++;
-    
-    // 🆕 数据上抛协议处理 (0x500-0x5FF) - 最高优先级
-    if (frame.ID >= 0x500 && frame.ID <= 0x5FF) {
-        QString dataHex = QByteArray((char*)frame.Data, frame.DataLen).toHex(' ').toUpper();
-//        qDebug() << QString("📊 数据上抛协议帧 - ID:0x%1 长度:%2 数据:%3")
-//                    .arg(frame.ID, 0, 16)
-//                    .arg(frame.DataLen)
-//                    .arg(dataHex);
-        
-        // 只有在示波器采集状态下才解析示波器数据
-        if (m_dataAcquisition && g_oscilloscopeAcquiring == 1) {
-            qDebug() << "✅ 数据采集组件存在，正在解析数据上抛协议";
-            m_dataAcquisition->parseUpdateProtocol(frame);
-        } else if (!m_dataAcquisition) {
-            qDebug() << "❌ 数据采集组件为空，无法处理数据上抛协议";
-        } else {
-            qDebug() << "⏸️ 示波器未采集，跳过数据解析";
-        }
-
-        // 额外分发一份给UI：让控制参数页也能收到0x580-0x5FF的SDO响应
-        // 这样即使当前不在数据采集页，也能更新"当前值"文本框
-       // emit frameReceived(frame);
-        if ( frame.ID >= 0x580 && frame.ID <= 0x5FF) {
-            // 检查m_controlParam是否为空，避免空指针访问导致死机
-            if (m_controlParam) {
-                qDebug() << "✅ 处理当前值";
-                // 使用QMetaObject::invokeMethod确保UI操作在主线程中执行，避免跨线程UI访问导致死机
-                QMetaObject::invokeMethod(m_controlParam, "onSdoReadResponse", 
-                                          Qt::QueuedConnection,
-                                          Q_ARG(VCI_CAN_OBJ, frame));
-            } else {
-                qDebug() << "⚠️ m_controlParam为空，跳过SDO响应处理";
-            }
+    if (m_deviceManager == manager) {
+        return;
+    }
+    if (m_deviceManager) {
+        disconnect(m_deviceManager, nullptr, this, nullptr);
+        m_deviceManager->setLatencyTracer(nullptr);
+        for (int slot = 0; slot < m_deviceManager->deviceCount(); slot++) {
+            for (CANFrameRing *ring : m_deviceManager->rxRings(slot))
+                m_receiver->removeSource(ring);
         }
+    }
+    // 不再使用单设备的发送/接收路径
+    setCANThread(nullptr);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_deviceManager = manager;
+        m_canThread = manager ? manager->device(0) : nullptr;
+    }
+    if (!m_deviceManager) {
         return;
     }
 
-    // 状态反馈处理 (0x000-0x07F)
-    if (frame.ID < 0x80) { 
-        
-        parseStatusFeedback(frame);
+    m_deviceManager->setLatencyTracer(&m_latencyTracer);
+    for (int slot = 0; slot < m_deviceManager->deviceCount(); slot++) {
+        for (CANFrameRing *ring : m_deviceManager->rxRings(slot))
+            m_receiver->addSource(ring);
+    }
 
+    // 环形缓冲的增删必须在设备释放前完成，使用直接连接
+    connect(m_deviceManager, &CANDeviceManager::deviceAdded, this, [this](int slot) {
+        for (CANFrameRing *ring : m_deviceManager->rxRings(slot))
+            m_receiver->addSource(ring);
+        if (slot == 0) {
+            QMutexLocker locker(&m_mutex);
+            m_canThread = m_deviceManager->device(0);
+        }
+        if (m_isReceiving)
+            m_deviceManager->startAll();
+        QMetaObject::invokeMethod(this, "updateAcceptanceFilter", Qt::QueuedConnection);
+    }, Qt::DirectConnection);
+    connect(m_deviceManager, &CANDeviceManager::deviceAboutToBeRemoved, this, [this](int slot) {
+        for (CANFrameRing *ring : m_deviceManager->rxRings(slot))
+            m_receiver->removeSource(ring);
+        if (slot == 0) {
+            QMutexLocker locker(&m_mutex);
+            m_canThread = nullptr;
+        }
+    }, Qt::DirectConnection);
+    connect(m_deviceManager, &CANDeviceManager::batchSent,
+            this, &CANTxRx::onBatchSent, Qt::QueuedConnection);
 
-    }
+    qDebug() << "CAN设备管理器接入:" << m_deviceManager->deviceCount() << "个适配器,"
+             << m_deviceManager->channelCount() << "个通道";
+    updateAcceptanceFilter();
 }
 
-void CANTxRx::logStatusFrame(const VCI_CAN_OBJ &frame)
+void CANTxRx::updateAcceptanceFilter()
 {
-    QString dataHex = QByteArray((char*)frame.Data, frame.DataLen).toHex(' ').toUpper();
-    QString frameInfo = QString("CAN状态帧 - ID:0x%1 数据:%2")
-                       .arg(frame.ID, 0, 16)
-                       .arg(dataHex);
+    // 状态帧由接收线程直接解码，不经分发器订阅，始终接收；
+    // 录制抓包或有人监听全部帧时接收总线上的所有帧
+    CANAcceptanceFilter filter = m_dispatcher->acceptanceFilter();
+    filter.addRange(0x000, 0x07F);
+    if (CANAcceptanceFilter::acceptAllRequested() || m_captureWriter ||
+        isSignalConnected(QMetaMethod::fromSignal(&CANTxRx::framesReceived)) ||
+        isSignalConnected(QMetaMethod::fromSignal(&CANTxRx::frameReceived))) {
+        filter = CANAcceptanceFilter::acceptAll();
+    }
 
-    qDebug().noquote() << frameInfo;
-    emit canDataReceived(frameInfo);
+    QList<CANThread*> threads;
+    if (m_deviceManager) {
+        for (int slot = 0; slot < m_deviceManager->deviceCount(); slot++)
+            threads.append(m_deviceManager->device(slot));
+    } else if (m_canThread) {
+        threads.append(m_canThread);
+    }
+    for (CANThread *thread : threads) {
+        if (thread && thread->acceptanceFilter() != filter) {
+            thread->setAcceptanceFilter(filter);
+            qDebug() << "接收过滤更新:" << filter.toString();
+        }
+    }
 }
 
-void CANTxRx::parseStatusFeedback(const VCI_CAN_OBJ &frame)
+// 软件注入的帧（数据回放等），硬件接收帧直接经由CANThread的环形缓冲进入接收线程
+void CANTxRx::processReceivedFrames(const QList<VCI_CAN_OBJ> &frames)
 {
-    // 这个函数现在主要在接收线程中处理
-    // 保留用于单帧处理的情况
-    if (frame.DataLen == 8) {
-        int16_t speed_int;
-        int32_t position_int;
-        int16_t current_int;
-
-        memcpy(&speed_int, &frame.Data[0], 2);
-        memcpy(&position_int, &frame.Data[2], 4);
-        memcpy(&current_int, &frame.Data[6], 2);
-
-        float speed = speed_int / 10.0f;
-        float position = position_int / 1000.0f;
-        float current = current_int / 1000.0f;
-
-        // 数据有效性检查
-        if (isValidFloat(speed) && isValidFloat(position) && isValidFloat(current)) {
-            // 打印速度、位置和电流数据
-            qDebug() << QString("状态反馈 - ID:0x%1 速度:%2 位置:%3 电流:%4")
-                        .arg(frame.ID, 0, 16)
-                        .arg(speed, 0, 'f', 2)
-                        .arg(position, 0, 'f', 3)
-                        .arg(current, 0, 'f', 3);
-            
-            // 单帧情况下仍然发射信号
-            emit statusDataReceived(frame.ID, speed, position, current);
-        }
+    if (!frames.isEmpty()) {
+        m_receiver->pushFrames(frames);
     }
 }
 
-void CANTxRx::startReceiving(int intervalMs, bool highSpeedMode)
+void CANTxRx::logStatusSample(const CANStatusSample &sample, int batchSize)
+{
+    QString info = QString("CAN状态 - 节点:%1 速度:%2 rad/s 位置:%3 rad 电流:%4 A（本批%5条）")
+                   .arg(sample.node)
+                   .arg(sample.speed, 0, 'f', 3)
+                   .arg(sample.position, 0, 'f', 3)
+                   .arg(sample.current, 0, 'f', 3)
+                   .arg(batchSize);
+
+    qDebug().noquote() << info;
+    emit canDataReceived(info);
+}
+
+void CANTxRx::startReceiving(bool highSpeedMode)
 {
     if (!m_canThread) {
         m_lastError = "CAN线程未设置，无法启动接收";
@@ -454,8 +805,10 @@ void CANTxRx::startReceiving(int intervalMs, bool highSpeedMode)
         return;
     }
     
-    // 确保CANThread已启动
-    if (!m_canThread->isRunning()) {
+    // 确保CANThread已启动（多适配器时启动所有设备）
+    if (m_deviceManager) {
+        m_deviceManager->startAll();
+    } else if (!m_canThread->isRunning()) {
         m_canThread->start();
     }
 
@@ -467,15 +820,8 @@ void CANTxRx::startReceiving(int intervalMs, bool highSpeedMode)
             m_receiver->start();
         }
 
-        if (m_highSpeedMode) {
-            m_receiveTimer->setInterval(1);
-            qDebug() << "启动高速CAN接收模式，间隔: 1ms";
-        } else {
-            m_receiveTimer->setInterval(intervalMs);
-            qDebug() << "启动CAN接收，间隔:" << intervalMs << "ms";
-        }
-
-        m_receiveTimer->start();
+        // 接收由各通道接收线程自适应调度，不再需要Qt定时器轮询
+        qDebug() << (m_highSpeedMode ? "启动高速CAN接收模式" : "启动CAN接收");
         m_isReceiving = true;
 
         // 重置性能统计
@@ -487,9 +833,9 @@ void CANTxRx::startReceiving(int intervalMs, bool highSpeedMode)
         emit receptionStarted();
 
         if (m_highSpeedMode) {
-            emit canDataReceived("高速CAN接收模式已启动 (1ms间隔)");
+            emit canDataReceived("高速CAN接收模式已启动");
         } else {
-            emit canDataReceived(QString("CAN接收已启动 (%1ms间隔)").arg(intervalMs));
+            emit canDataReceived("CAN接收已启动");
         }
     }
 }
@@ -497,7 +843,6 @@ void CANTxRx::startReceiving(int intervalMs, bool highSpeedMode)
 void CANTxRx::stopReceiving()
 {
     if (m_isReceiving) {
-        m_receiveTimer->stop();
         m_isReceiving = false;
         m_highSpeedMode = false;
         qDebug() << "CAN接收停止";
@@ -506,11 +851,123 @@ void CANTxRx::stopReceiving()
     }
 }
 
-void CANTxRx::onReceiveTimeout()
+bool CANTxRx::startCapture(const QString &path)
 {
-    // 接收数据现在由CANThread的run()方法处理
-    // 通过CANThread的getProtocolData信号传递数据
-    // 这里不需要主动接收数据
+    if (m_captureWriter) {
+        m_lastError = "CAN抓包录制已在进行";
+        qWarning() << m_lastError;
+        return false;
+    }
+
+    CANCaptureWriter *writer = new CANCaptureWriter(this);
+    if (!writer->open(path)) {
+        m_lastError = writer->errorString();
+        qWarning() << m_lastError;
+        delete writer;
+        return false;
+    }
+    connect(writer, &CANCaptureWriter::writeError, this, [this](const QString &message) {
+        m_lastError = message;
+        emit errorOccurred(message);
+    }, Qt::QueuedConnection);
+
+    writer->start(QThread::LowPriority);
+    m_captureWriter = writer;
+    m_receiver->setCaptureWriter(writer);
+    updateAcceptanceFilter();
+    emit canDataReceived(QString("CAN抓包录制开始: %1").arg(path));
+    return true;
+}
+
+void CANTxRx::stopCapture()
+{
+    if (!m_captureWriter) return;
+
+    CANCaptureWriter *writer = m_captureWriter;
+    m_captureWriter = nullptr;
+    // 先从接收线程摘下，再让写线程写完剩余帧并回写文件头
+    m_receiver->setCaptureWriter(nullptr);
+    writer->stop();
+
+    QString path = writer->fileName();
+    quint64 written = writer->framesWritten();
+    quint64 dropped = writer->framesDropped();
+    delete writer;
+    updateAcceptanceFilter();
+
+    emit canDataReceived(QString("CAN抓包录制结束: %1帧，丢弃%2帧").arg(written).arg(dropped));
+    emit captureStopped(path, written, dropped);
+}
+
+bool CANTxRx::startReplay(const QString &path, double speed)
+{
+    if (m_replayer) {
+        m_lastError = "CAN抓包回放已在进行";
+        qWarning() << m_lastError;
+        return false;
+    }
+
+    CANCaptureReplayer *replayer = new CANCaptureReplayer(this);
+    replayer->setFileName(path);
+    replayer->setSpeed(speed);
+    connect(replayer, &CANCaptureReplayer::replayError, this, [this](const QString &message) {
+        m_lastError = message;
+        emit errorOccurred(message);
+    }, Qt::QueuedConnection);
+    connect(replayer, &CANCaptureReplayer::replayFinished,
+            this, &CANTxRx::onReplayFinished, Qt::QueuedConnection);
+
+    m_replayer = replayer;
+    m_receiver->addSource(replayer->ring());
+    // 离线回放不需要CAN设备，接收线程未运行时单独启动
+    if (!m_receiver->isRunning()) {
+        m_receiver->start();
+    }
+    replayer->startReplay();
+    emit canDataReceived(QString("CAN抓包回放开始: %1").arg(path));
+    return true;
+}
+
+void CANTxRx::stopReplay()
+{
+    if (!m_replayer) return;
+
+    CANCaptureReplayer *replayer = m_replayer;
+    m_replayer = nullptr;
+    disconnect(replayer, nullptr, this, nullptr);
+    replayer->stop();
+    m_receiver->removeSource(replayer->ring());
+    delete replayer;
+}
+
+void CANTxRx::onReplayFinished(quint64 frames, qint64 elapsedUs)
+{
+    CANCaptureReplayer *replayer = qobject_cast<CANCaptureReplayer*>(sender());
+    if (!replayer || replayer != m_replayer) return;
+
+    m_replayer = nullptr;
+    replayer->wait();
+    detachReplayer(replayer, frames, elapsedUs);
+}
+
+void CANTxRx::detachReplayer(CANCaptureReplayer *replayer, quint64 frames, qint64 elapsedUs)
+{
+    // 回放缓冲中剩余的帧由接收线程读完后再摘下，removeSource之前不会丢帧；
+    // 不在界面线程忙等，未读空时用单次定时器稍后再检查
+    if (m_receiver->isRunning() && replayer->ring()->size() > 0) {
+        QPointer<CANCaptureReplayer> guard(replayer);
+        QTimer::singleShot(REPLAY_DETACH_RETRY_MS, this, [this, guard, frames, elapsedUs]() {
+            if (guard)
+                detachReplayer(guard, frames, elapsedUs);
+        });
+        return;
+    }
+    m_receiver->removeSource(replayer->ring());
+    replayer->deleteLater();
+
+    qDebug() << "CAN抓包回放结束:" << frames << "帧，耗时" << elapsedUs / 1000 << "ms";
+    emit canDataReceived(QString("CAN抓包回放结束: %1帧").arg(frames));
+    emit replayFinished(frames, elapsedUs);
 }
 
 bool CANTxRx::isReceiving() const
@@ -538,11 +995,6 @@ float CANTxRx::bytesToFloat(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3) cons
     return u.f;
 }
 
-bool CANTxRx::isValidFloat(float value) const
-{
-    return !std::isnan(value) && !std::isinf(value) && (fabs(value) < 1e10f);
-}
-
 bool CANTxRx::checkDataRange(float speed, float position, float current) const
 {
     // 合理的数据范围检查
@@ -569,6 +1021,28 @@ CANTxRx::CANStatistics CANTxRx::getStatistics() const
     stats.highSpeedMode = m_highSpeedMode;
     stats.queueSize = m_receiver->getQueueSize();
     stats.queueOverflows = m_queueOverflows;
+    stats.channelCount = m_deviceManager ? m_deviceManager->channelCount()
+                                         : (m_canThread ? m_canThread->channelCount() : 0);
+    stats.channelCount = qMin(stats.channelCount, static_cast<int>(CANDeviceManager::MAX_CHANNELS));
+    for (int ch = 0; ch < CANDeviceManager::MAX_CHANNELS; ch++) {
+        stats.channelFramesReceived[ch] = 0;
+        stats.channelFramesDropped[ch] = 0;
+        if (ch >= stats.channelCount) {
+            continue;
+        }
+        CANRxWorker::Statistics channelStats = m_deviceManager
+                ? m_deviceManager->channelStatistics(static_cast<UINT>(ch))
+                : m_canThread->channelStatistics(ch);
+        stats.channelFramesReceived[ch] = static_cast<int>(channelStats.framesReceived);
+        stats.channelFramesDropped[ch] = static_cast<int>(channelStats.framesDropped);
+    }
+    const CANOverflowPolicy &policy = CANOverflowPolicy::instance();
+    for (int cls = 0; cls < CANClassCount; cls++) {
+        CANTrafficClass trafficClass = static_cast<CANTrafficClass>(cls);
+        stats.classFramesDropped[cls] = policy.dropped(trafficClass);
+        stats.classFramesSpilled[cls] = policy.spilled(trafficClass);
+        stats.classBlockEvents[cls] = policy.blocked(trafficClass);
+    }
     return stats;
 }
 
@@ -601,6 +1075,14 @@ void CANTxRx::updatePerformanceStats()
                             .arg(m_currentFPS, 0, 'f', 1)
                             .arg(m_receiver->getQueueSize())
                             .arg(m_queueOverflows);
+            const CANOverflowPolicy &policy = CANOverflowPolicy::instance();
+            if (policy.totalDropped() > 0) {
+                qDebug() << QString("CAN按类别丢帧 - 状态: %1, 示波器: %2, SDO: %3, 其他: %4")
+                                .arg(policy.dropped(CANClassStatus))
+                                .arg(policy.dropped(CANClassScope))
+                                .arg(policy.dropped(CANClassSdo))
+                                .arg(policy.dropped(CANClassOther));
+            }
             performanceLogCounter = 0;
         }
 
@@ -608,328 +1090,118 @@ void CANTxRx::updatePerformanceStats()
     }
 }
 
-// 原有的发送命令函数保持不变
+// 命令帧由can_command_codec.h直接在栈上编码，发送路径不分配内存
 bool CANTxRx::sendSpeedCommand(float targetSpeed, float outputLimit)
 {
-    QByteArray data;
-    data.resize(8);
-
-    uint32_t speed_uint32;
-    uint32_t limit_uint32;
-
-    memcpy(&speed_uint32, &targetSpeed, sizeof(float));
-    memcpy(&limit_uint32, &outputLimit, sizeof(float));
-
     if (!m_highSpeedMode) {
         qDebug() << "发送速度指令 - 目标速度:" << targetSpeed
                  << ", 输出限制:" << outputLimit;
     }
 
-    data[0] = static_cast<char>(speed_uint32 & 0xFF);
-    data[1] = static_cast<char>((speed_uint32 >> 8) & 0xFF);
-    data[2] = static_cast<char>((speed_uint32 >> 16) & 0xFF);
-    data[3] = static_cast<char>((speed_uint32 >> 24) & 0xFF);
-    data[4] = static_cast<char>(limit_uint32 & 0xFF);
-    data[5] = static_cast<char>((limit_uint32 >> 8) & 0xFF);
-    data[6] = static_cast<char>((limit_uint32 >> 16) & 0xFF);
-    data[7] = static_cast<char>((limit_uint32 >> 24) & 0xFF);
-
-    DWORD can_id = (0x02 << 7) | (Can_id & 0x7F);
-    bool success = sendCANFrame(can_id, data, false);
-
-    return success;
+    return sendCANFrame(canEncodeSpeed(Can_id, targetSpeed, outputLimit));
 }
 
 bool CANTxRx::sendPositionCommand(float targetPosition, float maxSpeed)
 {
-    QByteArray data;
-    data.resize(8);
-
-    uint32_t position_uint32;
-    uint32_t speed_uint32;
-
-    memcpy(&position_uint32, &targetPosition, sizeof(float));
-    memcpy(&speed_uint32, &maxSpeed, sizeof(float));
-
     if (!m_highSpeedMode) {
         qDebug() << "发送位置指令 - 目标位置:" << targetPosition
                  << ", 最大转速:" << maxSpeed;
     }
 
-    data[0] = static_cast<char>(position_uint32 & 0xFF);
-    data[1] = static_cast<char>((position_uint32 >> 8) & 0xFF);
-    data[2] = static_cast<char>((position_uint32 >> 16) & 0xFF);
-    data[3] = static_cast<char>((position_uint32 >> 24) & 0xFF);
-    data[4] = static_cast<char>(speed_uint32 & 0xFF);
-    data[5] = static_cast<char>((speed_uint32 >> 8) & 0xFF);
-    data[6] = static_cast<char>((speed_uint32 >> 16) & 0xFF);
-    data[7] = static_cast<char>((speed_uint32 >> 24) & 0xFF);
-
-    DWORD can_id = (0x01 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodePosition(Can_id, targetPosition, maxSpeed));
 }
 
 // 模式切换命令
 bool CANTxRx::sendSpeedModeSwitch()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0x02));
-    data.append(static_cast<char>(0xFC));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeModeSwitch(Can_id, CAN_MODE_SPEED));
 }
 
 bool CANTxRx::sendPositionModeSwitch()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0x01));
-    data.append(static_cast<char>(0xFC));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeModeSwitch(Can_id, CAN_MODE_POSITION));
 }
 
 bool CANTxRx::sendStartCommand()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFC));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeStart(Can_id));
 }
 
 bool CANTxRx::sendStopCommand()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFD));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeStop(Can_id));
 }
 
 bool CANTxRx::sendTorqueModeSwitch()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0x03));
-    data.append(static_cast<char>(0xFC));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeModeSwitch(Can_id, CAN_MODE_TORQUE));
 }
 
 bool CANTxRx::sendMotionModeSwitch()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0xFF));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0xFC));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeModeSwitch(Can_id, CAN_MODE_MOTION));
 }
 
 bool CANTxRx::sendJogForwardCommand()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0x01));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeJog(Can_id, true));
 }
 
 bool CANTxRx::sendJogBackwardCommand()
 {
-    QByteArray data;
-    data.append(static_cast<char>(0x02));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeJog(Can_id, false));
 }
 
 bool CANTxRx::sendCurrentCommand(float iq, float id)
 {
-    QByteArray data;
-    data.resize(8);
-
-    uint32_t iq_uint32, id_uint32;
-    memcpy(&iq_uint32, &iq, sizeof(float));
-    memcpy(&id_uint32, &id, sizeof(float));
-
     if (!m_highSpeedMode) {
         qDebug() << "发送电流指令 - Iq电流:" << iq
                  << ", Id电流:" << id;
     }
 
-    data[0] = static_cast<char>(iq_uint32 & 0xFF);
-    data[1] = static_cast<char>((iq_uint32 >> 8) & 0xFF);
-    data[2] = static_cast<char>((iq_uint32 >> 16) & 0xFF);
-    data[3] = static_cast<char>((iq_uint32 >> 24) & 0xFF);
-    data[4] = static_cast<char>(id_uint32 & 0xFF);
-    data[5] = static_cast<char>((id_uint32 >> 8) & 0xFF);
-    data[6] = static_cast<char>((id_uint32 >> 16) & 0xFF);
-    data[7] = static_cast<char>((id_uint32 >> 24) & 0xFF);
-
-    DWORD can_id = (0x03 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeCurrent(Can_id, iq, id));
 }
 
 bool CANTxRx::sendMotionCommand(float kp, float kd, float position, float velocity, float current)
 {
-    QByteArray data;
-    data.resize(8);
-
-    // 位置转换：-12.57rad ~ 12.57rad -> 0-65535
-    uint16_t position_raw = static_cast<uint16_t>((position + 12.57f) / 25.14f * 65535.0f);
-    position_raw = qBound(0, static_cast<int>(position_raw), 65535);
-
-    // 速度转换：-50rad/s ~ 50rad/s -> 0-4096
-    uint16_t velocity_raw = static_cast<uint16_t>((velocity + 50.0f) / 100.0f * 4096.0f);
-    velocity_raw = qBound(0, static_cast<int>(velocity_raw), 4095);
-
-    // Kp转换：0-5000 -> 0-4096
-    uint16_t kp_raw = static_cast<uint16_t>(kp / 5000.0f * 4096.0f);
-    kp_raw = qBound(0, static_cast<int>(kp_raw), 4095);
-
-    // Kd转换：0-100 -> 0-4096
-    uint16_t kd_raw = static_cast<uint16_t>(kd / 100.0f * 4096.0f);
-    kd_raw = qBound(0, static_cast<int>(kd_raw), 4095);
-
-    // 力矩转换：-36N·m ~ 36N·m -> 0-4096
-    uint16_t torque_raw = static_cast<uint16_t>((current + 36.0f) / 72.0f * 4096.0f);
-    torque_raw = qBound(0, static_cast<int>(torque_raw), 4095);
+    // 位置-12.57~12.57rad、速度-50~50rad/s、Kp 0~5000、Kd 0~100、力矩-36~36N·m，量化规则见can_command_codec.h
+    CANMotionRaw raw = canQuantizeMotion(kp, kd, position, velocity, current);
 
     if (!m_highSpeedMode) {
-        qDebug() << "发送运控指令 - 位置:" << position << "rad ->" << position_raw
-                 << ", 速度:" << velocity << "rad/s ->" << velocity_raw
-                 << ", Kp:" << kp << "->" << kp_raw
-                 << ", Kd:" << kd << "->" << kd_raw
-                 << ", 力矩:" << current << "N·m ->" << torque_raw;
+        qDebug() << "发送运控指令 - 位置:" << position << "rad ->" << raw.position
+                 << ", 速度:" << velocity << "rad/s ->" << raw.velocity
+                 << ", Kp:" << kp << "->" << raw.kp
+                 << ", Kd:" << kd << "->" << raw.kd
+                 << ", 力矩:" << current << "N·m ->" << raw.torque;
     }
 
-    // MIT协议格式
-    data[0] = static_cast<char>((position_raw >> 8) & 0xFF);
-    data[1] = static_cast<char>(position_raw & 0xFF);
-    data[2] = static_cast<char>((velocity_raw >> 4) & 0xFF);
-    data[3] = static_cast<char>(((velocity_raw & 0x0F) << 4) | ((kp_raw >> 8) & 0x0F));
-    data[4] = static_cast<char>(kp_raw & 0xFF);
-    data[5] = static_cast<char>((kd_raw >> 4) & 0xFF);
-    data[6] = static_cast<char>(((kd_raw & 0x0F) << 4) | ((torque_raw >> 8) & 0x0F));
-    data[7] = static_cast<char>(torque_raw & 0xFF);
-
-    DWORD can_id = (0x00 << 7) | (Can_id & 0x7F);
-    return sendCANFrame(can_id, data, false);
+    return sendCANFrame(canEncodeMotion(Can_id, raw));
 }
 
 bool CANTxRx::sendParameterData(DWORD nodeId, uint16_t index, uint8_t subindex, const QByteArray& data)
 {
-    DWORD canId = 0x600 + nodeId;
-
-    QByteArray sdoData;
-    sdoData.resize(8);
-    sdoData.fill(0x00);
-
-    BYTE commandSpecifier = 0x22; // 默认：段下载（多段传输）
-
-    if (data.size() == 1) {
-        commandSpecifier = 0x2F;
-    } else if (data.size() == 2) {
-        commandSpecifier = 0x2B;
-    } else if (data.size() == 4) {
-        commandSpecifier = 0x23;
-    }
-
-    sdoData[0] = static_cast<char>(commandSpecifier);
-    sdoData[1] = static_cast<char>(index & 0xFF);
-    sdoData[2] = static_cast<char>((index >> 8) & 0xFF);
-    sdoData[3] = static_cast<char>(subindex);
-
-    for (int i = 0; i < data.size() && i < 4; i++) {
-        sdoData[4 + i] = data[i];
-    }
+    VCI_CAN_OBJ frame = canEncodeSdoWrite(nodeId, index, subindex, data.constData(), data.size());
 
     if (!m_highSpeedMode) {
         qDebug() << "发送参数设置 - NodeID:" << nodeId
                  << "索引: 0x" << QString::number(index, 16).toUpper()
                  << "子索引: 0x" << QString::number(subindex, 16).toUpper()
                  << "数据:" << data.toHex(' ').toUpper()
-                 << "命令:" << QString::number(commandSpecifier, 16).toUpper();
+                 << "命令:" << QString::number(frame.Data[0], 16).toUpper();
     }
 
-    return sendCANFrame(canId, sdoData, false);
+    return sendCANFrame(frame);
 }
 
 bool CANTxRx::sendParameterRead(DWORD nodeId, uint16_t index, uint8_t subindex)
 {
-    DWORD canId = 0x600 + nodeId;
-    QByteArray sdoData;
-    sdoData.resize(8);
-    sdoData.fill(0x00);
-
-    // SDO Upload Initiate: 0x40, index little-endian in payload
-    sdoData[0] = static_cast<char>(0x40);
-    sdoData[1] = static_cast<char>(index & 0xFF);
-    sdoData[2] = static_cast<char>((index >> 8) & 0xFF);
-    sdoData[3] = static_cast<char>(subindex);
-
     if (!m_highSpeedMode) {
         qDebug() << "发送参数读取 - NodeID:" << nodeId
                  << "索引: 0x" << QString::number(index, 16).toUpper()
                  << "子索引: 0x" << QString::number(subindex, 16).toUpper();
     }
 
-    return sendCANFrame(canId, sdoData, false);
+    return sendCANFrame(canEncodeSdoRead(nodeId, index, subindex));
 }
 
 bool CANTxRx::reinitializeCAN()
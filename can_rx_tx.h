@@ -10,9 +10,20 @@
 #include <QThread>
 #include <QWaitCondition>
 #include "ControlCAN.h"  // 包含原始头文件
-#include "data_acquisition.h"
-#include "control_param.h"
-class DataAcquisition;
+#include "can_frame_ring.h"
+#include "can_timestamp.h"
+#include "can_overflow_policy.h"
+#include "can_dispatcher.h"
+#include "can_status_sample.h"
+#include "can_telemetry_store.h"
+#include "can_node_registry.h"
+#include "can_capture.h"
+#include "can_capture_replay.h"
+#include "can_tx_batcher.h"
+#include "can_device_manager.h"
+#include "can_latency_tracer.h"
+#include "can_setpoint_streamer.h"
+#include "can_group_command.h"
 class CANThread;
 
 // CAN接收线程类
@@ -25,24 +36,55 @@ public:
 
     void stop();
     void setHighSpeedMode(bool enabled);
+    // 接收线程在环形缓冲中原地按COB-ID分发，批次随framesCounted一起发出（线程启动前设置）
+    void setDispatcher(CANDispatcher *dispatcher);
+    // 是否通过framesProcessed转发全部帧（有全量监听者时才开启）
+    void setForwardFrames(bool enabled);
+    // 状态样本同时写入遥测存储（接收线程是唯一写者，线程启动前设置）
+    void setTelemetryStore(CANTelemetryStore *store);
+    // 状态样本同时更新节点登记（接收线程是唯一写者，线程启动前设置）
+    void setNodeRegistry(CANNodeRegistry *registry);
+    // 录制：接收线程把读到的每批帧交给抓包写线程，可在运行中设置/清除
+    // 清除返回后接收线程不再访问原写线程，调用方可以停止并释放它
+    void setCaptureWriter(CANCaptureWriter *writer);
+    void setLatencyTracer(CANLatencyTracer *tracer);
     void pushFrames(const QList<VCI_CAN_OBJ> &frames);
+    // 添加接收源（如CANThread的接收环形缓冲），可在运行中增删
+    // removeSource返回后接收线程不再访问该缓冲，调用方可以释放它
+    void addSource(CANFrameRing *ring);
+    void removeSource(CANFrameRing *ring);
     int getQueueSize() const;
 
 protected:
     void run() override;
 
 signals:
-    void framesProcessed(const QList<VCI_CAN_OBJ> &frames);
-    void statusDataBatchReceived(const QVector<QPair<DWORD, QVector<float>>> &batchData);
+    void framesProcessed(const CANFrameBatch &frames);
+    // 一批帧已分发，count为帧数（用于统计，不携带帧数据）
+    void framesCounted(int count);
+    // 一批解码后的状态样本（样本中带帧到达总线的主机单调时间）
+    void statusSamplesReceived(const CANStatusBatch &samples);
     void queueOverflow();
 
 private:
-    QQueue<QList<VCI_CAN_OBJ>> m_frameQueue;
-    mutable QMutex m_queueMutex;
-    bool m_running;
+    CANRxNotifier m_notifier;
+    CANFrameRing m_injectRing;           // 软件注入帧（回放/测试）
+    CANTimestampMapper m_injectMapper;   // 注入帧的时间戳映射
+    CANOverflowBuffer m_injectOverflow;  // 注入环形缓冲满时按类别暂存/丢弃，不阻塞
+    QVector<VCI_CAN_OBJ> m_injectScratch;
+    QList<CANFrameRing*> m_sources;
+    mutable QMutex m_sourceMutex;        // 只在增删接收源和复制列表时持有
+    QAtomicInt m_sourcesChanged;         // 接收线程据此决定是否重新复制源列表
+    QMutex m_passMutex;                  // 一轮读取期间持有，removeSource借此等待读取结束
+    CANDispatcher *m_dispatcher;
+    CANTelemetryStore *m_telemetryStore;
+    CANNodeRegistry *m_nodeRegistry;
+    QAtomicPointer<CANCaptureWriter> m_captureWriter;
+    CANLatencyTracer *m_latencyTracer;
+    QAtomicInt m_forwardFrames;
+    volatile bool m_running;
     bool m_highSpeedMode;
-    QWaitCondition m_queueCondition;
-    const int MAX_QUEUE_SIZE = 1000;
+    quint64 m_lastOverflow;
 };
 
 class CANTxRx : public QObject
@@ -53,26 +95,58 @@ public:
     explicit CANTxRx(QObject *parent = nullptr);
     ~CANTxRx();
 
-    void setDataAcquisition(DataAcquisition *dataAcquisition) {
-        m_dataAcquisition = dataAcquisition;
-    }
-    
-    // 设置CAN线程实例
-    void setCANThread(CANThread* canThread) {
-        m_canThread = canThread;
-    }
+    // 设置CAN线程实例，并把它的接收环形缓冲接入接收线程
+    void setCANThread(CANThread* canThread);
+    // 多适配器：接入设备管理器的所有通道，发送按全局通道号路由（槽位0即原单设备接口）
+    void setDeviceManager(CANDeviceManager *manager);
+    CANDeviceManager *deviceManager() const { return m_deviceManager; }
 
     bool sendParameterData(DWORD nodeId, uint16_t index, uint8_t subindex, const QByteArray& data);
     bool sendParameterRead(DWORD nodeId, uint16_t index, uint8_t subindex);
     void setCANParams(DWORD deviceType, DWORD deviceIndex, DWORD canIndex);
+    // 命令发往的通道号（使用设备管理器时为全局通道号，与接收帧的通道标记一致，可与节点号组成节点键）
+    UINT commandChannel() const;
     bool sendCANFrame(DWORD canId, const QByteArray &data, bool extendedFrame = false);
     bool sendCANFrame(const VCI_CAN_OBJ &frame);
+    // 突发发送：一组帧合并为一次USB传输，返回入队帧数
+    int sendCANFrames(const QVector<VCI_CAN_OBJ> &frames);
+    int sendCANFrames(const VCI_CAN_OBJ *frames, int count);
+    // 指定全局通道号（设备槽位*2+通道）发送，需先设置设备管理器
+    bool sendCANFrameTo(UINT channel, const VCI_CAN_OBJ &frame);
+    int sendCANFramesTo(UINT channel, const QVector<VCI_CAN_OBJ> &frames);
+    int sendCANFramesTo(UINT channel, const VCI_CAN_OBJ *frames, int count);
+    // 周期发送线程用：不写m_lastError、不发errorOccurred（每个周期都可能调用），返回丢弃帧数，由调用方统计；
+    // 发送路由（设备管理器/CAN线程/通道号）在m_mutex下读取，可从任意线程调用
+    int trySendCANFrames(const VCI_CAN_OBJ *frames, int count);
+    // 多轴成组命令：整组帧一次提交，不与其它帧交错、不拆成多次USB传输，全部入队或全部丢弃
+    bool sendGroupCommand(const CANGroupCommand &group);
+    bool sendGroupCommandTo(UINT channel, const CANGroupCommand &group);
+    CANTxBatcher *txBatcher() const { return m_txBatcher; }
+    // 接收帧按COB-ID分发：订阅者只收到自己关心的ID，按批次投递到自己的线程
+    CANDispatcher *dispatcher() const { return m_dispatcher; }
+    // 按节点分列的状态遥测，任意线程无锁读取
+    const CANTelemetryStore *telemetryStore() const { return &m_telemetryStore; }
+    // 总线上各节点的在线状态、样本间隔等（节点名称可由界面设置）
+    CANNodeRegistry *nodeRegistry() { return &m_nodeRegistry; }
+    // SDO/数据上抛请求的往返延迟统计（默认开启）
+    CANLatencyTracer *latencyTracer() { return &m_latencyTracer; }
+    // 按节点周期发送运控/速度/位置/电流设定值（首次设定时启动发送线程）
+    CANSetpointStreamer *setpointStreamer() const { return m_setpointStreamer; }
     QList<VCI_CAN_OBJ> receiveCANFrames(int maxFrames = 100);
     
     // 处理从CANThread接收到的帧
     void processReceivedFrames(const QList<VCI_CAN_OBJ> &frames);
 
-    void startReceiving(int intervalMs = 10, bool highSpeedMode = false);
+    // 二进制抓包录制（格式见can_capture.h）：录制接收线程读到的全部帧
+    bool startCapture(const QString &path);
+    void stopCapture();
+    bool isCapturing() const { return m_captureWriter != nullptr; }
+    // 抓包回放：speed=1实时，>1加速，<=0不限速；回放帧与硬件接收帧走相同的解码/分发路径
+    bool startReplay(const QString &path, double speed = 1.0);
+    void stopReplay();
+    bool isReplaying() const { return m_replayer != nullptr; }
+
+    void startReceiving(bool highSpeedMode = false);
     void stopReceiving();
     bool isReceiving() const;
     bool isHighSpeedMode() const;
@@ -104,13 +178,26 @@ public:
         bool highSpeedMode;
         int queueSize;
         int queueOverflows;
+        int channelCount;               // 全局通道数（适配器数*2）
+        int channelFramesReceived[CANDeviceManager::MAX_CHANNELS];   // 各通道接收帧数
+        int channelFramesDropped[CANDeviceManager::MAX_CHANNELS];    // 各通道环形缓冲溢出帧数
+        quint64 classFramesDropped[CANClassCount];    // 各类别按溢出策略丢弃的帧数（精确计数）
+        quint64 classFramesSpilled[CANClassCount];    // 各类别溢写到磁盘的帧数
+        quint64 classBlockEvents[CANClassCount];      // 各类别触发阻塞等待的次数
     };
     CANStatistics getStatistics() const;
 
     float bytesToFloat(uint8_t b0, uint8_t b1, uint8_t b2, uint8_t b3) const;
-    bool isValidFloat(float value) const;
+
+protected:
+    // 只有监听framesReceived/frameReceived时才让接收线程转发全部帧
+    void connectNotify(const QMetaMethod &signal) override;
+    void disconnectNotify(const QMetaMethod &signal) override;
 
 signals:
+    // 全部接收帧，每批一个事件；只关心部分ID时应通过dispatcher()订阅
+    void framesReceived(const CANFrameBatch &frames);
+    // 逐帧信号（兼容旧代码），高帧率下每帧一个排队事件，不建议使用
     void frameReceived(const VCI_CAN_OBJ &frame);
     void frameSent(bool success, const VCI_CAN_OBJ &frame);
     void errorOccurred(const QString &errorMessage);
@@ -118,33 +205,48 @@ signals:
     void motorSpeedReceived(float speed, float current);
     void motorPositionReceived(float position);
     void motorTorqueReceived(float torque);
+    // 逐样本信号（1kHz/节点量级）；界面显示应通过CANStatusSampler按刷新率从telemetryStore()取快照
     void motorStatusReceived(float speed, float position, float current);
     void statusDataReceived(DWORD canId, float speed, float position, float current);
-    void statusDataBatchReceived(const QVector<QPair<DWORD, QVector<float>>> &batchData);
+    void statusSamplesReceived(const CANStatusBatch &samples);
     void receptionStarted();
     void receptionStopped();
     void performanceStatsUpdated(const CANStatistics &stats);
     void queueOverflowDetected();
+    void captureStopped(const QString &path, quint64 framesWritten, quint64 framesDropped);
+    void replayFinished(quint64 frames, qint64 elapsedUs);
 
 private slots:
-    void onReceiveTimeout();
-    void onFramesProcessed(const QList<VCI_CAN_OBJ> &frames);
-    void onStatusBatchReceived(const QVector<QPair<DWORD, QVector<float>>> &batchData);
+    void onFramesProcessed(const CANFrameBatch &frames);
+    void onFramesCounted(int count);
+    void onStatusBatchReceived(const CANStatusBatch &samples);
     void onQueueOverflow();
+    void onBatchSent(int requested, int sent);
+    void onReplayFinished(quint64 frames, qint64 elapsedUs);
+    // 按分发器的订阅表重建硬件接收过滤并下发到各适配器
+    void updateAcceptanceFilter();
 
 private:
     VCI_CAN_OBJ createCANFrame(DWORD canId, const QByteArray &data, bool extendedFrame = false);
-    void parseAndLogCANFrame(const VCI_CAN_OBJ &frame);
-    void parseStatusFeedback(const VCI_CAN_OBJ &frame);
-    void logStatusFrame(const VCI_CAN_OBJ &frame);
+    void logStatusSample(const CANStatusSample &sample, int batchSize);
     bool checkDataRange(float speed, float position, float current) const;
     bool validateCANFrame(const VCI_CAN_OBJ &frame) const;
+    // 回放缓冲读空后从接收线程摘下并释放，未读空时稍后重试
+    void detachReplayer(CANCaptureReplayer *replayer, quint64 frames, qint64 elapsedUs);
     void updateStatistics(bool isReceived, bool isError = false);
     void updatePerformanceStats();
 
-    DataAcquisition *m_dataAcquisition;
     CANReceiver *m_receiver;
+    CANDispatcher *m_dispatcher;
+    CANTelemetryStore m_telemetryStore;
+    CANNodeRegistry m_nodeRegistry;
+    CANLatencyTracer m_latencyTracer;
+    CANCaptureWriter *m_captureWriter;
+    CANCaptureReplayer *m_replayer;
+    CANTxBatcher *m_txBatcher;
+    CANSetpointStreamer *m_setpointStreamer;
     CANThread *m_canThread;
+    CANDeviceManager *m_deviceManager;
     DWORD m_deviceType;
     DWORD m_deviceIndex;
     DWORD m_canIndex;
@@ -153,7 +255,6 @@ private:
     bool m_highSpeedMode;
     QString m_lastError;
 
-    QTimer *m_receiveTimer;
     mutable QMutex m_mutex;
 
     int m_framesReceived;
@@ -166,12 +267,6 @@ private:
     int m_receiveCount;
     qint64 m_lastLogTime;
     double m_currentFPS;
-
-    // 直接通知控制参数界面的指针，由上层在MainWindow中设置
-public:
-    void setControlParam(class ControlParam* ctrl) { m_controlParam = ctrl; }
-private:
-    class ControlParam* m_controlParam { nullptr };
 };
 
 extern CANTxRx *g_canTxRx;
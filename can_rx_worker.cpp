@@ -0,0 +1,195 @@
+#include "can_rx_worker.h"
+#include "can_backend.h"
+#include "can_types.h"
+#include <QDebug>
+
+const int CANRxWorker::BLOCKING_MAX_WAIT_US;
+
+CANRxWorker::CANRxWorker(UINT channel, UINT channelTag, QObject *parent)
+    : QThread(parent)
+    , m_channel(channel)
+    , m_channelTag(channelTag)
+    , m_backend(nullptr)
+    , m_scratch(RX_READ_MAX)
+    , m_overflow(&m_ring, QString("ch%1").arg(channelTag))
+    , m_stopped(false)
+    , m_minWaitUs(200)
+    , m_maxWaitUs(2000)
+    , m_waitUs(200)
+{
+    m_overflow.setAbortFlag(&m_stopped);
+    resetStatistics();
+}
+
+CANRxWorker::~CANRxWorker()
+{
+    stop();
+}
+
+void CANRxWorker::setBackend(CANBackend *backend)
+{
+    m_backend = backend;
+}
+
+void CANRxWorker::setChannelTag(UINT channelTag)
+{
+    m_channelTag = channelTag;
+    m_overflow.setSpillName(QString("ch%1").arg(channelTag));
+}
+
+void CANRxWorker::setIdleWaitRange(int minUs, int maxUs)
+{
+    m_minWaitUs = qMax(50, minUs);
+    m_maxWaitUs = qMax(m_minWaitUs, maxUs);
+    m_waitUs = m_minWaitUs;
+}
+
+void CANRxWorker::stop()
+{
+    m_stopped = true;
+    wait();
+}
+
+CANRxWorker::Statistics CANRxWorker::statistics() const
+{
+    Statistics stats;
+    stats.framesReceived = m_framesReceived.load();
+    stats.framesDropped = m_ring.overflowCount();
+    stats.reads = m_reads.load();
+    stats.errors = m_errors.load();
+    stats.maxBatch = m_maxBatch.load();
+    stats.polls = m_polls.load();
+    stats.idlePolls = m_idlePolls.load();
+    stats.currentWaitUs = m_waitUs;
+    stats.clockSkewPpm = m_clockSkewPpb.load() / 1000.0;
+    return stats;
+}
+
+void CANRxWorker::resetStatistics()
+{
+    m_framesReceived.store(0);
+    m_reads.store(0);
+    m_errors.store(0);
+    m_maxBatch.store(0);
+    m_polls.store(0);
+    m_idlePolls.store(0);
+    m_clockSkewPpb.store(0);
+}
+
+void CANRxWorker::run()
+{
+    m_stopped = false;
+    m_waitUs = m_minWaitUs;
+    m_timeMapper.reset();
+    bool blocking = m_backend && m_backend->supportsBlockingReceive();
+    qDebug() << "CAN通道" << m_channel << "接收线程启动" << (blocking ? "(阻塞接收)" : "(自适应轮询)");
+
+    while (!m_stopped) {
+        if (!m_backend) {
+            idleWait();
+            continue;
+        }
+
+        if (blocking) {
+            // 后端能真正阻塞等待：数据到达立即返回，空闲时线程挂起，不消耗CPU
+            int waitMs = qMax(1, m_waitUs / 1000);
+            if (receiveOnce(waitMs, RX_READ_MAX) > 0) {
+                m_waitUs = m_minWaitUs;
+            } else {
+                m_waitUs = qMin(m_waitUs * 2, qMax(m_maxWaitUs, BLOCKING_MAX_WAIT_US));
+            }
+            continue;
+        }
+
+        // USBCAN的WaitTime无效：先查询待接收帧数，再按数量读取
+        int pending = m_backend->pendingCount(m_channel);
+        if (pending == 0) {
+            notePoll(true);
+            // 总线空闲时继续回放积压帧
+            if (!m_overflow.isEmpty() && m_overflow.drain() > 0) {
+                continue;
+            }
+            idleWait();
+            continue;
+        }
+
+        int received = receiveOnce(0, pending > 0 ? pending : RX_READ_MAX);
+        if (received <= 0) {
+            idleWait();
+            continue;
+        }
+
+        // 有数据：收紧等待时间；一次没读完或突发流量时不休眠，立即继续读
+        m_waitUs = m_minWaitUs;
+        if (pending < 0 || received >= pending) {
+            if (received < RX_READ_MAX / 4) {
+                QThread::usleep(static_cast<unsigned long>(m_minWaitUs));
+            }
+        }
+    }
+
+    qDebug() << "CAN通道" << m_channel << "接收线程停止";
+}
+
+void CANRxWorker::notePoll(bool idle)
+{
+    m_polls.fetchAndAddRelaxed(1);
+    if (idle) {
+        m_idlePolls.fetchAndAddRelaxed(1);
+    }
+}
+
+void CANRxWorker::idleWait()
+{
+    QThread::usleep(static_cast<unsigned long>(m_waitUs));
+    // 总线安静：等待时间按倍数退避，降低空闲时的唤醒次数
+    m_waitUs = qMin(m_waitUs * 2, m_maxWaitUs);
+}
+
+int CANRxWorker::receiveOnce(int waitMs, int maxFrames)
+{
+    // 先把上次积压的帧搬回环形缓冲，积压清空前新帧不能越过它们直接写入
+    if (!m_overflow.isEmpty()) {
+        m_overflow.drain();
+    }
+
+    VCI_CAN_OBJ *dst = nullptr;
+    int space = 0;
+    if (m_overflow.isEmpty()) {
+        space = m_ring.beginWrite(&dst, qMin(maxFrames, RX_READ_MAX));
+    }
+    bool direct = (space > 0);
+    if (!direct) {
+        // 环形缓冲已满或有积压：仍然读出设备缓冲，交给溢出策略按类别处理
+        dst = m_scratch.data();
+        space = qMin(maxFrames, m_scratch.size());
+    }
+
+    int received = m_backend->receive(m_channel, dst, space, waitMs);
+    qint64 hostUs = canMonotonicUs();
+    notePoll(received == 0);
+    if (received < 0) {
+        m_errors.fetchAndAddRelaxed(1);
+    }
+    if (received <= 0) {
+        return 0;
+    }
+
+    for (int i = 0; i < received; i++) {
+        setCanFrameChannel(dst[i], m_channelTag);
+    }
+    m_timeMapper.stamp(dst, received, hostUs);
+    if (direct) {
+        m_ring.commitWrite(received);
+    } else {
+        m_overflow.write(dst, received);
+    }
+
+    m_framesReceived.fetchAndAddRelaxed(static_cast<quint64>(received));
+    m_reads.fetchAndAddRelaxed(1);
+    if (received > m_maxBatch.load()) {
+        m_maxBatch.store(received);
+    }
+    m_clockSkewPpb.store(static_cast<int>(m_timeMapper.skewPpm() * 1000.0));
+    return received;
+}
@@ -0,0 +1,86 @@
+#ifndef CAN_RX_WORKER_H
+#define CAN_RX_WORKER_H
+
+#include <QThread>
+#include <QAtomicInteger>
+#include <QVector>
+#include "ControlCAN.h"
+#include "can_frame_ring.h"
+#include "can_timestamp.h"
+#include "can_overflow_policy.h"
+
+class CANBackend;
+
+// 单通道接收线程：每个CAN通道一个，互不阻塞
+// 接收到的帧直接写入本通道的环形缓冲，并在帧中标记通道号（见can_types.h）
+// 适配器硬件时间戳在这里映射为主机单调时间（见can_timestamp.h）
+// 自适应调度：按待接收帧数决定读取量，有数据时不休眠，总线空闲时等待时间逐步加长
+// 环形缓冲满时按帧类别的溢出策略处理（见can_overflow_policy.h），SDO应答不丢弃
+class CANRxWorker : public QThread
+{
+    Q_OBJECT
+public:
+    struct Statistics {
+        quint64 framesReceived;   // 接收帧数
+        quint64 framesDropped;    // 按溢出策略丢弃的帧数
+        quint64 reads;            // 有数据的接收调用次数
+        quint64 errors;           // 接收出错次数
+        int maxBatch;             // 单次接收最大帧数
+        quint64 polls;            // 轮询次数
+        quint64 idlePolls;        // 空轮询次数
+        int currentWaitUs;        // 当前空闲等待时间
+        double clockSkewPpm;      // 适配器时钟相对主机的频偏估计
+    };
+
+    CANRxWorker(UINT channel, UINT channelTag, QObject *parent = nullptr);
+    ~CANRxWorker();
+
+    void setBackend(CANBackend *backend);
+    UINT channel() const { return m_channel; }
+    // 帧的通道标记（全局通道号），线程启动前设置
+    void setChannelTag(UINT channelTag);
+    UINT channelTag() const { return m_channelTag; }
+    CANFrameRing *ring() { return &m_ring; }
+
+    // 空闲等待范围（微秒），总线安静时从最小值按倍数退避到最大值
+    // 轮询方式下安静后第一帧最多晚一个等待时间才被读到（直接计入SDO往返延迟），默认上限2ms
+    void setIdleWaitRange(int minUs, int maxUs);
+
+    void stop();
+    Statistics statistics() const;
+    void resetStatistics();
+
+protected:
+    void run() override;
+
+private:
+    int receiveOnce(int waitMs, int maxFrames);
+    void idleWait();
+    void notePoll(bool idle);
+
+    static const int RX_READ_MAX = 2500;   // 单次接收最大帧数
+    static const int BLOCKING_MAX_WAIT_US = 20000;  // 阻塞接收数据到达即返回，等待上限不影响延迟
+
+    UINT m_channel;
+    UINT m_channelTag;
+    CANBackend *m_backend;
+    CANFrameRing m_ring;
+    CANTimestampMapper m_timeMapper;
+    QVector<VCI_CAN_OBJ> m_scratch;        // 环形缓冲满或有积压时的接收区（预分配）
+    CANOverflowBuffer m_overflow;
+    volatile bool m_stopped;
+    int m_minWaitUs;
+    int m_maxWaitUs;
+    int m_waitUs;
+
+    // 统计计数只由本线程写入，原子变量供统计轮询无锁读取
+    QAtomicInteger<quint64> m_framesReceived;
+    QAtomicInteger<quint64> m_reads;
+    QAtomicInteger<quint64> m_errors;
+    QAtomicInteger<quint64> m_polls;
+    QAtomicInteger<quint64> m_idlePolls;
+    QAtomicInt m_maxBatch;
+    QAtomicInt m_clockSkewPpb;             // 频偏估计（十亿分之一）
+};
+
+#endif // CAN_RX_WORKER_H
@@ -0,0 +1,382 @@
+#include <QtGlobal>
+#if defined(Q_OS_WIN)
+// 需在ControlCAN.h之前包含，后者把DWORD等类型定义为宏
+#include <qt_windows.h>
+#endif
+#include "can_setpoint_streamer.h"
+#include "can_rx_tx.h"
+#include "can_command_codec.h"
+#include "can_timestamp.h"
+#include <QDebug>
+#include <cstring>
+
+#if defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <cerrno>
+#endif
+
+namespace {
+    // 粗休眠提前醒来的余量，余下时间忙等到截止时间
+#if defined(Q_OS_LINUX)
+    const qint64 SPIN_US = 50;
+#elif defined(Q_OS_WIN)
+    const qint64 SPIN_US = 200;             // 高精度可等待定时器
+    const qint64 SPIN_US_LEGACY = 1500;     // Windows 10 1803之前只有系统时钟节拍精度
+#else
+    const qint64 SPIN_US = 1000;
+#endif
+}
+
+#if defined(Q_OS_WIN) && !defined(CREATE_WAITABLE_TIMER_HIGH_RESOLUTION)
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+CANSetpointStreamer::CANSetpointStreamer(CANTxRx *canTxRx, QObject *parent)
+    : QThread(parent)
+    , m_canTxRx(canTxRx)
+    , m_activeCount(0)
+    , m_defaultRateHz(DEFAULT_RATE_HZ)
+    , m_sleepDeadlineUs(0)
+    , m_running(false)
+{
+    for (int i = 0; i < MAX_NODES; i++) {
+        m_slots[i].active = false;
+        memset(&m_slots[i].frame, 0, sizeof(VCI_CAN_OBJ));
+        m_slots[i].source = nullptr;
+        m_slots[i].periodUs = 0;
+        m_slots[i].nextDeadlineUs = 0;
+    }
+    resetStatistics();
+
+#if defined(Q_OS_WIN)
+    m_timer = ::CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+    m_highResolutionTimer = (m_timer != nullptr);
+    if (!m_timer) {
+        m_timer = ::CreateWaitableTimerW(nullptr, TRUE, nullptr);
+    }
+#endif
+}
+
+CANSetpointStreamer::~CANSetpointStreamer()
+{
+    stop();
+#if defined(Q_OS_WIN)
+    if (m_timer)
+        ::CloseHandle(m_timer);
+#endif
+}
+
+qint64 CANSetpointStreamer::periodForRate(int hz)
+{
+    return 1000000 / qBound(MIN_RATE_HZ, hz, MAX_RATE_HZ);
+}
+
+void CANSetpointStreamer::setDefaultRateHz(int hz)
+{
+    QMutexLocker locker(&m_mutex);
+    m_defaultRateHz = qBound(MIN_RATE_HZ, hz, MAX_RATE_HZ);
+}
+
+int CANSetpointStreamer::defaultRateHz() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_defaultRateHz;
+}
+
+void CANSetpointStreamer::setNodeRateHz(uint8_t node, int hz)
+{
+    QMutexLocker locker(&m_mutex);
+    Slot &slot = m_slots[node & 0x7F];
+    slot.periodUs = periodForRate(hz);
+    if (slot.active) {
+        alignDeadline(&slot);
+    }
+}
+
+void CANSetpointStreamer::alignDeadline(Slot *slot) const
+{
+    // 同频率节点对齐到同一时间网格，同一周期的帧合并为一次突发发送；
+    // 发送线程正在休眠时，第一个截止时间不早于它的唤醒时刻，避免新节点一开始就计入丢失周期
+    qint64 earliest = qMax(canMonotonicUs() + 1, m_sleepDeadlineUs);
+    slot->nextDeadlineUs = (earliest + slot->periodUs - 1) / slot->periodUs * slot->periodUs;
+}
+
+void CANSetpointStreamer::setMotionSetpoint(uint8_t node, float kp, float kd, float position, float velocity, float torque)
+{
+    setFrame(node, canEncodeMotion(node & 0x7F, canQuantizeMotion(kp, kd, position, velocity, torque)));
+}
+
+void CANSetpointStreamer::setSpeedSetpoint(uint8_t node, float targetSpeed, float outputLimit)
+{
+    setFrame(node, canEncodeSpeed(node & 0x7F, targetSpeed, outputLimit));
+}
+
+void CANSetpointStreamer::setPositionSetpoint(uint8_t node, float targetPosition, float maxSpeed)
+{
+    setFrame(node, canEncodePosition(node & 0x7F, targetPosition, maxSpeed));
+}
+
+void CANSetpointStreamer::setCurrentSetpoint(uint8_t node, float iq, float id)
+{
+    setFrame(node, canEncodeCurrent(node & 0x7F, iq, id));
+}
+
+bool CANSetpointStreamer::activate(Slot *slot, uint8_t node)
+{
+    if (!slot->active) {
+        if (slot->periodUs <= 0) {
+            slot->periodUs = periodForRate(m_defaultRateHz);
+        }
+        alignDeadline(slot);
+        slot->active = true;
+        m_activeCount++;
+        m_condition.wakeOne();
+        qDebug() << "周期设定值发送 - 节点" << (node & 0x7F) << "开始，周期" << slot->periodUs << "us";
+    }
+    if (isRunning()) {
+        return false;
+    }
+    // 在start()之前置位，start()之后紧接着的stop()不会被run()开头覆盖
+    m_running = true;
+    return true;
+}
+
+void CANSetpointStreamer::setFrame(uint8_t node, const VCI_CAN_OBJ &frame)
+{
+    bool startThread = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        Slot &slot = m_slots[node & 0x7F];
+        slot.frame = frame;
+        slot.source = nullptr;
+        startThread = activate(&slot, node);
+    }
+    if (startThread) {
+        start(QThread::TimeCriticalPriority);
+    }
+}
+
+void CANSetpointStreamer::setSource(uint8_t node, CANSetpointSource *source)
+{
+    if (!source)
+        return;
+    bool startThread = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        Slot &slot = m_slots[node & 0x7F];
+        if (slot.source != source) {
+            slot.source = source;
+            // 先取当前时刻的帧，来源暂时没有数据时不发送旧的固定设定值
+            if (!source->frameAt(node & 0x7F, canMonotonicUs(), &slot.frame) && !slot.active) {
+                slot.source = nullptr;
+                return;
+            }
+        }
+        startThread = activate(&slot, node);
+    }
+    if (startThread) {
+        start(QThread::TimeCriticalPriority);
+    }
+}
+
+void CANSetpointStreamer::removeSource(CANSetpointSource *source)
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < MAX_NODES; i++) {
+        Slot &slot = m_slots[i];
+        if (slot.source != source)
+            continue;
+        slot.source = nullptr;
+        if (slot.active) {
+            slot.active = false;
+            m_activeCount--;
+        }
+    }
+}
+
+void CANSetpointStreamer::removeNode(uint8_t node)
+{
+    QMutexLocker locker(&m_mutex);
+    Slot &slot = m_slots[node & 0x7F];
+    slot.source = nullptr;
+    if (slot.active) {
+        slot.active = false;
+        m_activeCount--;
+        qDebug() << "周期设定值发送 - 节点" << (node & 0x7F) << "停止";
+    }
+}
+
+void CANSetpointStreamer::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    for (int i = 0; i < MAX_NODES; i++) {
+        m_slots[i].active = false;
+        m_slots[i].source = nullptr;
+    }
+    m_activeCount = 0;
+}
+
+bool CANSetpointStreamer::isStreaming(uint8_t node) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_slots[node & 0x7F].active;
+}
+
+void CANSetpointStreamer::stop()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running = false;
+        m_condition.wakeAll();
+    }
+    if (!wait(1000)) {
+        terminate();
+        wait();
+    }
+}
+
+CANSetpointStreamer::Statistics CANSetpointStreamer::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    Statistics stats;
+    stats.cycles = m_cycles;
+    stats.framesSent = m_framesSent;
+    stats.framesDropped = m_framesDropped;
+    stats.missedDeadlines = m_missedDeadlines;
+    stats.activeNodes = m_activeCount;
+    stats.meanJitterUs = m_jitter.mean();
+    stats.p50JitterUs = m_jitter.percentile(0.50);
+    stats.p99JitterUs = m_jitter.percentile(0.99);
+    stats.maxJitterUs = m_jitter.max();
+    return stats;
+}
+
+void CANSetpointStreamer::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cycles = 0;
+    m_framesSent = 0;
+    m_framesDropped = 0;
+    m_missedDeadlines = 0;
+    m_jitter.reset();
+}
+
+void CANSetpointStreamer::raisePriority()
+{
+#if defined(Q_OS_LINUX)
+    // QThread::TimeCriticalPriority在SCHED_OTHER下不起作用，尝试实时调度
+    struct sched_param param;
+    param.sched_priority = sched_get_priority_max(SCHED_FIFO) - 10;
+    int result = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (result != 0) {
+        qDebug() << "周期设定值发送线程无法切换到SCHED_FIFO（错误" << result << "），使用普通调度";
+    }
+#endif
+}
+
+void CANSetpointStreamer::sleepUntil(qint64 deadlineUs)
+{
+#if defined(Q_OS_WIN)
+    const qint64 spinUs = m_highResolutionTimer ? SPIN_US : SPIN_US_LEGACY;
+#else
+    const qint64 spinUs = SPIN_US;
+#endif
+
+    qint64 remainingUs = deadlineUs - canMonotonicUs();
+    if (remainingUs > spinUs) {
+#if defined(Q_OS_LINUX)
+        // canMonotonicUs()基于steady_clock，即CLOCK_MONOTONIC，可直接按绝对时间休眠
+        qint64 wakeUs = deadlineUs - spinUs;
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(wakeUs / 1000000);
+        ts.tv_nsec = static_cast<long>((wakeUs % 1000000) * 1000);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+        }
+#elif defined(Q_OS_WIN)
+        if (m_timer) {
+            // 相对时间以100ns为单位、取负值；每次按截止时间重新计算，误差不累积
+            LARGE_INTEGER due;
+            due.QuadPart = -(remainingUs - spinUs) * 10;
+            if (::SetWaitableTimer(m_timer, &due, 0, nullptr, nullptr, FALSE)) {
+                ::WaitForSingleObject(m_timer, INFINITE);
+            }
+        } else {
+            QThread::usleep(static_cast<unsigned long>(remainingUs - spinUs));
+        }
+#else
+        QThread::usleep(static_cast<unsigned long>(remainingUs - spinUs));
+#endif
+    }
+
+    // 最后一段忙等，醒来时刻不受调度器节拍影响
+    while (canMonotonicUs() < deadlineUs) {
+    }
+}
+
+void CANSetpointStreamer::run()
+{
+    raisePriority();
+
+    VCI_CAN_OBJ frames[MAX_NODES];
+
+    QMutexLocker locker(&m_mutex);
+    while (m_running) {
+        if (m_activeCount == 0) {
+            m_condition.wait(&m_mutex);
+            continue;
+        }
+
+        qint64 deadlineUs = 0;
+        bool first = true;
+        for (int i = 0; i < MAX_NODES; i++) {
+            if (m_slots[i].active && (first || m_slots[i].nextDeadlineUs < deadlineUs)) {
+                deadlineUs = m_slots[i].nextDeadlineUs;
+                first = false;
+            }
+        }
+
+        m_sleepDeadlineUs = deadlineUs;
+        locker.unlock();
+        sleepUntil(deadlineUs);
+        qint64 nowUs = canMonotonicUs();
+        locker.relock();
+        m_sleepDeadlineUs = 0;
+        if (!m_running) {
+            break;
+        }
+
+        // 取出所有已到期节点的当前设定值；错过的周期直接跳过，不补发旧设定值
+        int count = 0;
+        quint64 missed = 0;
+        for (int i = 0; i < MAX_NODES; i++) {
+            Slot &slot = m_slots[i];
+            if (!slot.active || slot.nextDeadlineUs > nowUs) {
+                continue;
+            }
+            // 轨迹等来源按本周期的截止时间生成设定值，与实际醒来的抖动无关
+            if (slot.source) {
+                slot.source->frameAt(static_cast<uint8_t>(i), slot.nextDeadlineUs, &slot.frame);
+            }
+            frames[count++] = slot.frame;
+            qint64 skipped = (nowUs - slot.nextDeadlineUs) / slot.periodUs;
+            missed += static_cast<quint64>(skipped);
+            slot.nextDeadlineUs += (skipped + 1) * slot.periodUs;
+        }
+        if (count == 0) {
+            continue;   // 休眠期间节点被移除或改了频率
+        }
+        m_cycles++;
+        m_missedDeadlines += missed;
+        m_jitter.record(nowUs - deadlineUs);
+
+        // 入队不阻塞，持锁发送：removeNode()/clear()返回时本周期的帧已经入队，
+        // 之后发出的停止命令一定排在它们后面并能取代它们
+        // 发送队列满等情况只计入丢帧统计，不在发送线程里写错误信息、发信号
+        // 设备未就绪时trySendCANFrames整批计为丢弃
+        int dropped = m_canTxRx ? m_canTxRx->trySendCANFrames(frames, count) : count;
+        m_framesSent += static_cast<quint64>(count - dropped);
+        m_framesDropped += static_cast<quint64>(dropped);
+    }
+}
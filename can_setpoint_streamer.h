@@ -0,0 +1,118 @@
+#ifndef CAN_SETPOINT_STREAMER_H
+#define CAN_SETPOINT_STREAMER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <cstdint>
+#include "ControlCAN.h"
+#include "can_latency_tracer.h"
+
+class CANTxRx;
+
+// 设定值来源：每个发送周期由发送线程调用，按截止时间生成该节点要发送的帧（如轨迹规划器）
+// 在发送线程持有streamer锁时调用，须快速返回、不得调用streamer的接口；返回false时沿用上一帧
+class CANSetpointSource
+{
+public:
+    virtual ~CANSetpointSource() {}
+    virtual bool frameAt(uint8_t node, qint64 timeUs, VCI_CAN_OBJ *frame) = 0;
+};
+
+// 周期设定值发送线程：按节点以固定频率（100Hz-2kHz）重复发送最近一次设定的运控/速度/位置/电流命令
+// - 每个节点一个已编码好的命令帧（can_command_codec.h），更新设定值只替换帧内容，发送路径不分配内存
+// - 按绝对截止时间休眠，不累积漂移；同频率的节点对齐到同一时间网格，同一周期的帧一次突发发送
+// - 醒来时刻相对截止时间的延迟记入直方图作为抖动；晚于下一个周期时跳过错过的周期并计为丢失截止时间
+// - 线程以TimeCriticalPriority运行，Linux下尝试SCHED_FIFO（需要权限，失败时保持普通调度）
+class CANSetpointStreamer : public QThread
+{
+    Q_OBJECT
+public:
+    static const int MIN_RATE_HZ = 100;
+    static const int MAX_RATE_HZ = 2000;
+    static const int DEFAULT_RATE_HZ = 1000;
+    static const int MAX_NODES = 128;
+
+    struct Statistics {
+        quint64 cycles;             // 唤醒发送次数
+        quint64 framesSent;         // 入队成功帧数
+        quint64 framesDropped;      // 发送队列满丢弃帧数
+        quint64 missedDeadlines;    // 跳过的周期数（所有节点合计）
+        int activeNodes;
+        double meanJitterUs;        // 唤醒延迟（醒来时刻 - 截止时间）
+        qint64 p50JitterUs;
+        qint64 p99JitterUs;
+        qint64 maxJitterUs;
+    };
+
+    explicit CANSetpointStreamer(CANTxRx *canTxRx, QObject *parent = nullptr);
+    ~CANSetpointStreamer();
+
+    // 新加入节点的默认频率
+    void setDefaultRateHz(int hz);
+    int defaultRateHz() const;
+    // 单个节点的频率，节点未在发送时只记录，下次设定值生效
+    void setNodeRateHz(uint8_t node, int hz);
+
+    // 更新节点设定值，节点未在发送时开始周期发送（线程未启动时自动启动）
+    void setMotionSetpoint(uint8_t node, float kp, float kd, float position, float velocity, float torque);
+    void setSpeedSetpoint(uint8_t node, float targetSpeed, float outputLimit);
+    void setPositionSetpoint(uint8_t node, float targetPosition, float maxSpeed);
+    void setCurrentSetpoint(uint8_t node, float iq, float id);
+    // 由来源按周期生成设定值（替换固定设定值），节点未在发送时开始周期发送
+    void setSource(uint8_t node, CANSetpointSource *source);
+    // 移除使用该来源的所有节点，返回后发送线程不会再调用它
+    void removeSource(CANSetpointSource *source);
+    // 停止某个节点/全部节点的周期发送（线程保留，空闲时阻塞等待）
+    // 返回后发送队列里不会再新增这些节点的设定值，随后发出的停止命令能取代已排队的部分
+    void removeNode(uint8_t node);
+    void clear();
+    bool isStreaming(uint8_t node) const;
+
+    void stop();
+    Statistics statistics() const;
+    void resetStatistics();
+
+protected:
+    void run() override;
+
+private:
+    struct Slot {
+        bool active;
+        VCI_CAN_OBJ frame;
+        CANSetpointSource *source;
+        qint64 periodUs;
+        qint64 nextDeadlineUs;
+    };
+
+    static qint64 periodForRate(int hz);
+    void setFrame(uint8_t node, const VCI_CAN_OBJ &frame);
+    // 已持有m_mutex；返回是否需要启动线程（需要时已置位m_running）
+    bool activate(Slot *slot, uint8_t node);
+    void alignDeadline(Slot *slot) const;
+    void sleepUntil(qint64 deadlineUs);
+    void raisePriority();
+
+    CANTxRx *m_canTxRx;
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    Slot m_slots[MAX_NODES];
+    int m_activeCount;
+    int m_defaultRateHz;
+    qint64 m_sleepDeadlineUs;   // 发送线程当前休眠到的截止时间，0表示未休眠
+    volatile bool m_running;
+
+    // 统计（m_mutex保护）
+    quint64 m_cycles;
+    quint64 m_framesSent;
+    quint64 m_framesDropped;
+    quint64 m_missedDeadlines;
+    CANLatencyHistogram m_jitter;
+
+#if defined(Q_OS_WIN)
+    void *m_timer;
+    bool m_highResolutionTimer;
+#endif
+};
+
+#endif // CAN_SETPOINT_STREAMER_H
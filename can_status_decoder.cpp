@@ -0,0 +1,396 @@
+#include "can_status_decoder.h"
+#include "can_types.h"
+#include <cstddef>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CAN_DECODE_HAVE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+// AVX2只用GCC/Clang按函数开启（target属性），构建选项不变，运行时检测CPU
+// MinGW的64位栈只保证16字节对齐，GCC溢出到栈上的256位寄存器可能非对齐访问而崩溃，因此MinGW下不启用
+#if (defined(__GNUC__) || defined(__clang__)) && !defined(__MINGW32__) && \
+    (defined(__x86_64__) || defined(__i386__))
+#define CAN_DECODE_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+    // 按字节偏移取帧中的32位字（小端）：
+    //   偏移0:  ID
+    //   偏移4:  TimeStamp
+    //   偏移8:  TimeFlag, ...                          -> 低8位为时间戳类型
+    //   偏移11: ExternFlag, DataLen, Data[0], Data[1]  -> 低16位为帧格式，高16位为速度
+    //   偏移15: Data[2..5]                             -> 位置
+    //   偏移17: Data[4..7]                             -> 高16位为电流
+    //   偏移20: Data[7], Reserved[0..2]                -> 8-15位为通道号
+    const int OFFSET_ID = offsetof(VCI_CAN_OBJ, ID);
+    const int OFFSET_TIME_STAMP = offsetof(VCI_CAN_OBJ, TimeStamp);
+    const int OFFSET_TIME_FLAG = offsetof(VCI_CAN_OBJ, TimeFlag);
+    const int OFFSET_FORMAT = offsetof(VCI_CAN_OBJ, ExternFlag);
+    const int OFFSET_POSITION = offsetof(VCI_CAN_OBJ, Data) + 2;
+    const int OFFSET_CURRENT = offsetof(VCI_CAN_OBJ, Data) + 4;
+    const int OFFSET_CHANNEL = offsetof(VCI_CAN_OBJ, Reserved) - 1;
+    const quint32 STATUS_FORMAT = 0x0800;   // 标准帧（ExternFlag=0）且DataLen=8
+    const quint32 STATUS_ID_MASK = 0xFFFFFF80u;
+
+    const int SAMPLE_CHUNK = 256;           // 样本数组输出时经栈上列缓冲分段
+
+    typedef int (*DecodeFunc)(const VCI_CAN_OBJ *, int, const CANStatusColumnArrays &, qint64);
+
+    inline void storeSample(const CANStatusColumnArrays &out, int n, const VCI_CAN_OBJ &frame,
+                            float speed, float position, float current, qint64 nowUs)
+    {
+        out.timeUs[n] = canFrameTimeUs(frame, nowUs);
+        out.speed[n] = speed;
+        out.position[n] = position;
+        out.current[n] = current;
+        out.node[n] = static_cast<quint8>(frame.ID);
+        out.channel[n] = static_cast<quint8>(canFrameChannel(frame));
+    }
+
+    // 从frames[first]开始逐帧解码，返回新的样本数
+    int decodeScalarRange(const VCI_CAN_OBJ *frames, int first, int count,
+                          const CANStatusColumnArrays &out, int n, qint64 nowUs)
+    {
+        for (int i = first; i < count; i++) {
+            const VCI_CAN_OBJ &frame = frames[i];
+            if (!isCanStatusFrame(frame))
+                continue;
+            qint16 speedRaw, currentRaw;
+            qint32 positionRaw;
+            memcpy(&speedRaw, &frame.Data[0], 2);
+            memcpy(&positionRaw, &frame.Data[2], 4);
+            memcpy(&currentRaw, &frame.Data[6], 2);
+            storeSample(out, n++, frame, speedRaw / 10.0f, positionRaw / 1000.0f,
+                        currentRaw / 1000.0f, nowUs);
+        }
+        return n;
+    }
+
+    int decodeScalar(const VCI_CAN_OBJ *frames, int count, const CANStatusColumnArrays &out, qint64 nowUs)
+    {
+        return decodeScalarRange(frames, 0, count, out, 0, nowUs);
+    }
+
+    // 一组帧各列的计算结果（部分帧不是状态帧时先写到这里再压缩）
+    template <int LANES>
+    struct GroupLanes {
+        qint64 timeUs[LANES];
+        float speed[LANES];
+        float position[LANES];
+        float current[LANES];
+        quint8 node[LANES];
+        quint8 channel[LANES];
+    };
+
+    // 按bits压缩写出：每个lane都写到当前位置，是状态帧才前移，避免逐lane分支
+    // 写位置不超过该帧在输入中的下标，不会越过输出容量
+    template <int LANES>
+    inline int compactGroup(const GroupLanes<LANES> &lanes, int bits, const CANStatusColumnArrays &out, int n)
+    {
+        for (int lane = 0; lane < LANES; lane++) {
+            out.timeUs[n] = lanes.timeUs[lane];
+            out.speed[n] = lanes.speed[lane];
+            out.position[n] = lanes.position[lane];
+            out.current[n] = lanes.current[lane];
+            out.node[n] = lanes.node[lane];
+            out.channel[n] = lanes.channel[lane];
+            n += (bits >> lane) & 1;
+        }
+        return n;
+    }
+
+#ifdef CAN_DECODE_HAVE_SSE2
+    inline quint32 loadWord(const VCI_CAN_OBJ *frame, int offset)
+    {
+        quint32 value;
+        memcpy(&value, reinterpret_cast<const char *>(frame) + offset, 4);
+        return value;
+    }
+
+    inline __m128i gatherWords(const VCI_CAN_OBJ *group, int offset)
+    {
+        return _mm_set_epi32(static_cast<int>(loadWord(group + 3, offset)),
+                             static_cast<int>(loadWord(group + 2, offset)),
+                             static_cast<int>(loadWord(group + 1, offset)),
+                             static_cast<int>(loadWord(group + 0, offset)));
+    }
+
+    // 4个0-255的int32压成4字节写出
+    inline void storeBytes4(quint8 *dst, __m128i value)
+    {
+        __m128i packed = _mm_packus_epi16(_mm_packs_epi32(value, value), _mm_setzero_si128());
+        int bytes = _mm_cvtsi128_si32(packed);
+        memcpy(dst, &bytes, 4);
+    }
+
+    // 时间 = now - 帧年龄（int32有符号扩展为int64）
+    inline void storeTimes4(qint64 *dst, __m128i now, __m128i age)
+    {
+        __m128i sign = _mm_srai_epi32(age, 31);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_sub_epi64(now, _mm_unpacklo_epi32(age, sign)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 2), _mm_sub_epi64(now, _mm_unpackhi_epi32(age, sign)));
+    }
+
+    int decodeSse2(const VCI_CAN_OBJ *frames, int count, const CANStatusColumnArrays &out, qint64 nowUs)
+    {
+        const __m128i idMask = _mm_set1_epi32(static_cast<int>(STATUS_ID_MASK));
+        const __m128i wordMask = _mm_set1_epi32(0xFFFF);
+        const __m128i byteMask = _mm_set1_epi32(0xFF);
+        const __m128i statusFormat = _mm_set1_epi32(STATUS_FORMAT);
+        const __m128i hostTime = _mm_set1_epi32(CAN_TIME_HOST_US);
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i now64 = _mm_set1_epi64x(nowUs);
+        const __m128i now32 = _mm_set1_epi32(static_cast<int>(static_cast<quint32>(nowUs)));
+        const __m128 speedScale = _mm_set1_ps(10.0f);
+        const __m128 milliScale = _mm_set1_ps(1000.0f);
+
+        int n = 0;
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const VCI_CAN_OBJ *group = frames + i;
+            __m128i ids = gatherWords(group, OFFSET_ID);
+            __m128i format = gatherWords(group, OFFSET_FORMAT);
+
+            __m128i isStatus = _mm_and_si128(
+                _mm_cmpeq_epi32(_mm_and_si128(ids, idMask), zero),
+                _mm_cmpeq_epi32(_mm_and_si128(format, wordMask), statusFormat));
+            int bits = _mm_movemask_ps(_mm_castsi128_ps(isStatus));
+            if (bits == 0)
+                continue;
+
+            __m128 speed = _mm_div_ps(_mm_cvtepi32_ps(_mm_srai_epi32(format, 16)), speedScale);
+            __m128 position = _mm_div_ps(_mm_cvtepi32_ps(gatherWords(group, OFFSET_POSITION)), milliScale);
+            __m128 current = _mm_div_ps(
+                _mm_cvtepi32_ps(_mm_srai_epi32(gatherWords(group, OFFSET_CURRENT), 16)), milliScale);
+            // 只有已映射为主机时间的帧按时间戳还原，其余取当前时间（年龄为0）
+            __m128i isHostTime = _mm_cmpeq_epi32(_mm_and_si128(gatherWords(group, OFFSET_TIME_FLAG), byteMask), hostTime);
+            __m128i age = _mm_and_si128(_mm_sub_epi32(now32, gatherWords(group, OFFSET_TIME_STAMP)), isHostTime);
+            __m128i node = _mm_and_si128(ids, byteMask);
+            __m128i channel = _mm_and_si128(_mm_srli_epi32(gatherWords(group, OFFSET_CHANNEL), 8), byteMask);
+
+            // 全部为状态帧时整组直接写入输出列
+            if (bits == 0xF) {
+                storeTimes4(out.timeUs + n, now64, age);
+                _mm_storeu_ps(out.speed + n, speed);
+                _mm_storeu_ps(out.position + n, position);
+                _mm_storeu_ps(out.current + n, current);
+                storeBytes4(out.node + n, node);
+                storeBytes4(out.channel + n, channel);
+                n += 4;
+                continue;
+            }
+
+            GroupLanes<4> lanes;
+            storeTimes4(lanes.timeUs, now64, age);
+            _mm_storeu_ps(lanes.speed, speed);
+            _mm_storeu_ps(lanes.position, position);
+            _mm_storeu_ps(lanes.current, current);
+            storeBytes4(lanes.node, node);
+            storeBytes4(lanes.channel, channel);
+            n = compactGroup(lanes, bits, out, n);
+        }
+        return decodeScalarRange(frames, i, count, out, n, nowUs);
+    }
+#endif
+
+#ifdef CAN_DECODE_HAVE_AVX2
+    __attribute__((target("avx2")))
+    inline void storeBytes8(quint8 *dst, __m256i value)
+    {
+        // 打包在两个128位半区内各自进行，每半区低4字节为对应的4个值
+        __m256i packed = _mm256_packus_epi16(_mm256_packs_epi32(value, value), _mm256_setzero_si256());
+        int low = _mm_cvtsi128_si32(_mm256_castsi256_si128(packed));
+        int high = _mm_cvtsi128_si32(_mm256_extracti128_si256(packed, 1));
+        memcpy(dst, &low, 4);
+        memcpy(dst + 4, &high, 4);
+    }
+
+    __attribute__((target("avx2")))
+    inline void storeTimes8(qint64 *dst, __m256i now, __m256i age)
+    {
+        __m256i low = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(age));
+        __m256i high = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(age, 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst), _mm256_sub_epi64(now, low));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + 4), _mm256_sub_epi64(now, high));
+    }
+
+    __attribute__((target("avx2")))
+    int decodeAvx2(const VCI_CAN_OBJ *frames, int count, const CANStatusColumnArrays &out, qint64 nowUs)
+    {
+        const int stride = static_cast<int>(sizeof(VCI_CAN_OBJ));
+        const __m256i frameOffsets = _mm256_setr_epi32(0, stride, 2 * stride, 3 * stride,
+                                                       4 * stride, 5 * stride, 6 * stride, 7 * stride);
+        const __m256i timeStampOffsets = _mm256_add_epi32(frameOffsets, _mm256_set1_epi32(OFFSET_TIME_STAMP));
+        const __m256i timeFlagOffsets = _mm256_add_epi32(frameOffsets, _mm256_set1_epi32(OFFSET_TIME_FLAG));
+        const __m256i formatOffsets = _mm256_add_epi32(frameOffsets, _mm256_set1_epi32(OFFSET_FORMAT));
+        const __m256i positionOffsets = _mm256_add_epi32(frameOffsets, _mm256_set1_epi32(OFFSET_POSITION));
+        const __m256i currentOffsets = _mm256_add_epi32(frameOffsets, _mm256_set1_epi32(OFFSET_CURRENT));
+        const __m256i channelOffsets = _mm256_add_epi32(frameOffsets, _mm256_set1_epi32(OFFSET_CHANNEL));
+        const __m256i idMask = _mm256_set1_epi32(static_cast<int>(STATUS_ID_MASK));
+        const __m256i wordMask = _mm256_set1_epi32(0xFFFF);
+        const __m256i byteMask = _mm256_set1_epi32(0xFF);
+        const __m256i statusFormat = _mm256_set1_epi32(STATUS_FORMAT);
+        const __m256i hostTime = _mm256_set1_epi32(CAN_TIME_HOST_US);
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i now64 = _mm256_set1_epi64x(nowUs);
+        const __m256i now32 = _mm256_set1_epi32(static_cast<int>(static_cast<quint32>(nowUs)));
+        const __m256 speedScale = _mm256_set1_ps(10.0f);
+        const __m256 milliScale = _mm256_set1_ps(1000.0f);
+
+        int n = 0;
+        int i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const int *base = reinterpret_cast<const int *>(frames + i);
+            __m256i ids = _mm256_i32gather_epi32(base, frameOffsets, 1);
+            __m256i format = _mm256_i32gather_epi32(base, formatOffsets, 1);
+
+            __m256i isStatus = _mm256_and_si256(
+                _mm256_cmpeq_epi32(_mm256_and_si256(ids, idMask), zero),
+                _mm256_cmpeq_epi32(_mm256_and_si256(format, wordMask), statusFormat));
+            int bits = _mm256_movemask_ps(_mm256_castsi256_ps(isStatus));
+            if (bits == 0)
+                continue;
+
+            __m256 speed = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_srai_epi32(format, 16)), speedScale);
+            __m256 position = _mm256_div_ps(
+                _mm256_cvtepi32_ps(_mm256_i32gather_epi32(base, positionOffsets, 1)), milliScale);
+            __m256 current = _mm256_div_ps(
+                _mm256_cvtepi32_ps(_mm256_srai_epi32(_mm256_i32gather_epi32(base, currentOffsets, 1), 16)),
+                milliScale);
+            __m256i isHostTime = _mm256_cmpeq_epi32(
+                _mm256_and_si256(_mm256_i32gather_epi32(base, timeFlagOffsets, 1), byteMask), hostTime);
+            __m256i age = _mm256_and_si256(
+                _mm256_sub_epi32(now32, _mm256_i32gather_epi32(base, timeStampOffsets, 1)), isHostTime);
+            __m256i node = _mm256_and_si256(ids, byteMask);
+            __m256i channel = _mm256_and_si256(
+                _mm256_srli_epi32(_mm256_i32gather_epi32(base, channelOffsets, 1), 8), byteMask);
+
+            if (bits == 0xFF) {
+                storeTimes8(out.timeUs + n, now64, age);
+                _mm256_storeu_ps(out.speed + n, speed);
+                _mm256_storeu_ps(out.position + n, position);
+                _mm256_storeu_ps(out.current + n, current);
+                storeBytes8(out.node + n, node);
+                storeBytes8(out.channel + n, channel);
+                n += 8;
+                continue;
+            }
+
+            GroupLanes<8> lanes;
+            storeTimes8(lanes.timeUs, now64, age);
+            _mm256_storeu_ps(lanes.speed, speed);
+            _mm256_storeu_ps(lanes.position, position);
+            _mm256_storeu_ps(lanes.current, current);
+            storeBytes8(lanes.node, node);
+            storeBytes8(lanes.channel, channel);
+            n = compactGroup(lanes, bits, out, n);
+        }
+        return decodeScalarRange(frames, i, count, out, n, nowUs);
+    }
+#endif
+
+    DecodeFunc decodeFunc(CANStatusDecodeIsa isa)
+    {
+        switch (isa) {
+#ifdef CAN_DECODE_HAVE_AVX2
+        case CANDecodeAvx2:
+            return decodeAvx2;
+#endif
+#ifdef CAN_DECODE_HAVE_SSE2
+        case CANDecodeSse2:
+            return decodeSse2;
+#endif
+        default:
+            return decodeScalar;
+        }
+    }
+
+    CANStatusDecodeIsa detectIsa()
+    {
+#ifdef CAN_DECODE_HAVE_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return CANDecodeAvx2;
+#endif
+#ifdef CAN_DECODE_HAVE_SSE2
+        return CANDecodeSse2;
+#else
+        return CANDecodeScalar;
+#endif
+    }
+}
+
+// 换算依赖VCI_CAN_OBJ的字节布局（ControlCAN.h，24字节，数据区从偏移13开始）
+static_assert(sizeof(VCI_CAN_OBJ) == 24, "VCI_CAN_OBJ布局与状态帧批量解码不符");
+static_assert(offsetof(VCI_CAN_OBJ, TimeFlag) == 8 && offsetof(VCI_CAN_OBJ, ExternFlag) == 11 &&
+              offsetof(VCI_CAN_OBJ, DataLen) == 12 && offsetof(VCI_CAN_OBJ, Data) == 13 &&
+              offsetof(VCI_CAN_OBJ, Reserved) == 21, "VCI_CAN_OBJ布局与状态帧批量解码不符");
+
+CANStatusDecodeIsa canStatusDecoderIsa()
+{
+    static const CANStatusDecodeIsa isa = detectIsa();
+    return isa;
+}
+
+bool canStatusDecoderSupports(CANStatusDecodeIsa isa)
+{
+    return isa <= canStatusDecoderIsa();
+}
+
+const char *canStatusDecoderIsaName(CANStatusDecodeIsa isa)
+{
+    switch (isa) {
+    case CANDecodeAvx2:
+        return "AVX2";
+    case CANDecodeSse2:
+        return "SSE2";
+    default:
+        return "scalar";
+    }
+}
+
+int decodeCanStatusColumnsWith(CANStatusDecodeIsa isa, const VCI_CAN_OBJ *frames, int count,
+                               const CANStatusColumnArrays &out, qint64 nowUs)
+{
+    if (!canStatusDecoderSupports(isa))
+        isa = canStatusDecoderIsa();
+    return decodeFunc(isa)(frames, count, out, nowUs);
+}
+
+int decodeCanStatusColumns(const VCI_CAN_OBJ *frames, int count,
+                           const CANStatusColumnArrays &out, qint64 nowUs)
+{
+    static const DecodeFunc func = decodeFunc(canStatusDecoderIsa());
+    return func(frames, count, out, nowUs);
+}
+
+int decodeCanStatusSamples(const VCI_CAN_OBJ *frames, int count,
+                           CANStatusSample *out, qint64 nowUs)
+{
+    qint64 timeUs[SAMPLE_CHUNK];
+    float speed[SAMPLE_CHUNK];
+    float position[SAMPLE_CHUNK];
+    float current[SAMPLE_CHUNK];
+    quint8 node[SAMPLE_CHUNK];
+    quint8 channel[SAMPLE_CHUNK];
+    const CANStatusColumnArrays columns = { timeUs, speed, position, current, node, channel };
+
+    int total = 0;
+    for (int first = 0; first < count; first += SAMPLE_CHUNK) {
+        int n = decodeCanStatusColumns(frames + first, qMin(SAMPLE_CHUNK, count - first), columns, nowUs);
+        for (int i = 0; i < n; i++) {
+            CANStatusSample &sample = out[total++];
+            sample.timeUs = timeUs[i];
+            sample.speed = speed[i];
+            sample.position = position[i];
+            sample.current = current[i];
+            sample.node = node[i];
+            sample.channel = channel[i];
+            sample.reserved = 0;
+        }
+    }
+    return total;
+}
@@ -0,0 +1,44 @@
+#ifndef CAN_STATUS_DECODER_H
+#define CAN_STATUS_DECODER_H
+
+#include <QtGlobal>
+#include "ControlCAN.h"
+#include "can_status_sample.h"
+
+// 状态反馈帧批量解码：一次遍历VCI_CAN_OBJ数组，筛出状态帧（见isCanStatusFrame）并写出换算后的列
+// 换算结果与decodeCanStatus逐位一致（同样先转float再除以10/1000），整批只取一次时钟
+// int16/int32转float不会产生NaN/Inf，批量路径不再逐帧做有效性检查
+// 按CPU能力选择实现：AVX2（8帧一组）/ SSE2（4帧一组）/ 标量
+
+enum CANStatusDecodeIsa {
+    CANDecodeScalar = 0,
+    CANDecodeSse2,
+    CANDecodeAvx2
+};
+
+// 输出列，每列容量不小于输入帧数
+struct CANStatusColumnArrays {
+    qint64 *timeUs;
+    float *speed;
+    float *position;
+    float *current;
+    quint8 *node;
+    quint8 *channel;
+};
+
+// 返回写出的样本数，nowUs用于还原帧时间（见canFrameTimeUs）
+int decodeCanStatusColumns(const VCI_CAN_OBJ *frames, int count,
+                           const CANStatusColumnArrays &out, qint64 nowUs);
+// 同上，输出为样本数组（接收线程、遥测存储使用）
+int decodeCanStatusSamples(const VCI_CAN_OBJ *frames, int count,
+                           CANStatusSample *out, qint64 nowUs);
+
+// 指定实现（基准测试和对照验证用），CPU不支持时退回可用的最高实现
+int decodeCanStatusColumnsWith(CANStatusDecodeIsa isa, const VCI_CAN_OBJ *frames, int count,
+                               const CANStatusColumnArrays &out, qint64 nowUs);
+
+CANStatusDecodeIsa canStatusDecoderIsa();
+bool canStatusDecoderSupports(CANStatusDecodeIsa isa);
+const char *canStatusDecoderIsaName(CANStatusDecodeIsa isa);
+
+#endif // CAN_STATUS_DECODER_H
@@ -0,0 +1,82 @@
+#ifndef CAN_STATUS_SAMPLE_H
+#define CAN_STATUS_SAMPLE_H
+
+#include <QVector>
+#include <QMetaType>
+#include <cstring>
+#include <cmath>
+#include "ControlCAN.h"
+#include "can_types.h"
+#include "can_timestamp.h"
+
+// 状态反馈帧（ID=节点号 0x00-0x7F，8字节）解码后的定长样本
+// Data[0..1] int16 速度*10，Data[2..5] int32 位置*1000，Data[6..7] int16 电流*1000
+struct CANStatusSample
+{
+    qint64 timeUs;      // 帧到达总线的主机单调时间（微秒，见can_timestamp.h）
+    float speed;
+    float position;
+    float current;
+    quint8 node;
+    quint8 channel;     // 全局通道号（见can_types.h）
+    quint16 reserved;
+};
+Q_DECLARE_TYPEINFO(CANStatusSample, Q_PRIMITIVE_TYPE);
+
+// 一批状态样本，跨线程投递时整批一个事件
+typedef QVector<CANStatusSample> CANStatusBatch;
+
+// 节点键：多适配器时不同总线上可以有相同的节点号，节点登记和遥测按(全局通道号, 节点号)区分
+// 键 = 通道号*128 + 节点号，通道0上的键就是节点号
+const int CAN_STATUS_MAX_CHANNELS = 8;     // 不少于CANDeviceManager::MAX_CHANNELS
+const int CAN_STATUS_MAX_KEYS = CAN_STATUS_MAX_CHANNELS * 128;
+
+inline int canNodeKey(int channel, int node)
+{
+    return (channel << 7) | (node & 0x7F);
+}
+
+inline int canNodeKey(const CANStatusSample &sample)
+{
+    return canNodeKey(sample.channel, sample.node);
+}
+
+inline int canNodeKeyChannel(int key)
+{
+    return key >> 7;
+}
+
+inline int canNodeKeyNode(int key)
+{
+    return key & 0x7F;
+}
+
+inline bool isCanStatusFrame(const VCI_CAN_OBJ &frame)
+{
+    return !frame.ExternFlag && frame.ID < 0x80 && frame.DataLen == 8;
+}
+
+// 解码状态帧，非状态帧或数值无效时返回false
+inline bool decodeCanStatus(const VCI_CAN_OBJ &frame, CANStatusSample *sample)
+{
+    if (!isCanStatusFrame(frame))
+        return false;
+
+    qint16 speedRaw, currentRaw;
+    qint32 positionRaw;
+    memcpy(&speedRaw, &frame.Data[0], 2);
+    memcpy(&positionRaw, &frame.Data[2], 4);
+    memcpy(&currentRaw, &frame.Data[6], 2);
+
+    sample->timeUs = canFrameTimeUs(frame);
+    sample->speed = speedRaw / 10.0f;
+    sample->position = positionRaw / 1000.0f;
+    sample->current = currentRaw / 1000.0f;
+    sample->node = static_cast<quint8>(frame.ID);
+    sample->channel = static_cast<quint8>(canFrameChannel(frame));
+    sample->reserved = 0;
+
+    return std::isfinite(sample->speed) && std::isfinite(sample->position) && std::isfinite(sample->current);
+}
+
+#endif // CAN_STATUS_SAMPLE_H
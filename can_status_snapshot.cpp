@@ -0,0 +1,68 @@
+#include "can_status_snapshot.h"
+#include <cstring>
+
+CANStatusSampler::CANStatusSampler(const CANTelemetryStore *store)
+    : m_store(nullptr)
+{
+    setStore(store);
+}
+
+void CANStatusSampler::setStore(const CANTelemetryStore *store)
+{
+    m_store = store;
+    memset(m_cursors, 0, sizeof(m_cursors));
+}
+
+bool CANStatusSampler::take(int key, CANStatusSnapshot *snapshot)
+{
+    if (!m_store || !snapshot || key < 0 || key >= CANTelemetryStore::MAX_KEYS)
+        return false;
+
+    m_columns.clear();
+    m_cursors[key] = m_store->read(key, m_cursors[key], &m_columns);
+    int count = m_columns.size();
+    if (count == 0)
+        return false;
+
+    const float *speed = m_columns.speed.constData();
+    const float *position = m_columns.position.constData();
+    const float *current = m_columns.current.constData();
+    float speedMin = speed[0], speedMax = speed[0];
+    float positionMin = position[0], positionMax = position[0];
+    float currentMin = current[0], currentMax = current[0];
+    for (int i = 1; i < count; i++) {
+        speedMin = qMin(speedMin, speed[i]);
+        speedMax = qMax(speedMax, speed[i]);
+        positionMin = qMin(positionMin, position[i]);
+        positionMax = qMax(positionMax, position[i]);
+        currentMin = qMin(currentMin, current[i]);
+        currentMax = qMax(currentMax, current[i]);
+    }
+
+    // 节点号和通道号由节点键得出
+    CANStatusSample latest;
+    latest.node = static_cast<quint8>(canNodeKeyNode(key));
+    latest.channel = static_cast<quint8>(canNodeKeyChannel(key));
+    latest.reserved = 0;
+    latest.timeUs = m_columns.timeUs.at(count - 1);
+    latest.speed = speed[count - 1];
+    latest.position = position[count - 1];
+    latest.current = current[count - 1];
+
+    snapshot->latest = latest;
+    snapshot->speedMin = speedMin;
+    snapshot->speedMax = speedMax;
+    snapshot->positionMin = positionMin;
+    snapshot->positionMax = positionMax;
+    snapshot->currentMin = currentMin;
+    snapshot->currentMax = currentMax;
+    snapshot->sampleCount = count;
+    return true;
+}
+
+void CANStatusSampler::skip(int key)
+{
+    if (!m_store || key < 0 || key >= CANTelemetryStore::MAX_KEYS)
+        return;
+    m_cursors[key] = m_store->cursor(key);
+}
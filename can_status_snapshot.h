@@ -0,0 +1,41 @@
+#ifndef CAN_STATUS_SNAPSHOT_H
+#define CAN_STATUS_SNAPSHOT_H
+
+#include <QtGlobal>
+#include "can_status_sample.h"
+#include "can_telemetry_store.h"
+
+// 界面刷新用的节点状态快照：最新值，以及自上次取快照以来各量的最小/最大值
+struct CANStatusSnapshot
+{
+    CANStatusSample latest;
+    float speedMin;
+    float speedMax;
+    float positionMin;
+    float positionMax;
+    float currentMin;
+    float currentMax;
+    int sampleCount;    // 本区间内的样本数
+};
+
+// 按显示刷新节奏从遥测存储取快照，代替逐样本的信号/界面更新
+// 每个节点记一个读取游标，取快照时只读取新增样本；只在一个线程中使用（通常是GUI线程）
+class CANStatusSampler
+{
+public:
+    explicit CANStatusSampler(const CANTelemetryStore *store = nullptr);
+
+    void setStore(const CANTelemetryStore *store);
+
+    // 取节点（节点键，见can_status_sample.h）自上次调用以来的快照，没有新样本时返回false且不修改snapshot
+    bool take(int key, CANStatusSnapshot *snapshot);
+    // 丢弃节点已积累的样本（如切换显示的节点后），下次只统计此后的样本
+    void skip(int key);
+
+private:
+    const CANTelemetryStore *m_store;
+    quint64 m_cursors[CANTelemetryStore::MAX_KEYS];
+    CANTelemetryStore::Columns m_columns;
+};
+
+#endif // CAN_STATUS_SNAPSHOT_H
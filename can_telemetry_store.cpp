@@ -0,0 +1,175 @@
+#include "can_telemetry_store.h"
+#include <cstring>
+
+const int CANTelemetryStore::MAX_KEYS;
+const int CANTelemetryStore::DEFAULT_CAPACITY;
+
+void CANTelemetryStore::Columns::clear()
+{
+    timeUs.clear();
+    speed.clear();
+    position.clear();
+    current.clear();
+}
+
+CANTelemetryStore::NodeColumns::NodeColumns(int capacity)
+    : timeUs(capacity)
+    , speed(capacity)
+    , position(capacity)
+    , current(capacity)
+    , head(0)
+{
+}
+
+// 容量向上取整到2的幂，便于用掩码取模
+static int roundUpPow2(int value)
+{
+    int capacity = 1;
+    while (capacity < value && capacity < (1 << 24)) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+CANTelemetryStore::CANTelemetryStore(int capacityPerNode)
+    : m_capacity(roundUpPow2(qMax(capacityPerNode, 16)))
+    , m_mask(static_cast<quint32>(m_capacity - 1))
+{
+    for (int i = 0; i < MAX_KEYS; i++) {
+        m_nodes[i].storeRelease(nullptr);
+    }
+}
+
+CANTelemetryStore::~CANTelemetryStore()
+{
+    for (int i = 0; i < MAX_KEYS; i++) {
+        delete m_nodes[i].loadAcquire();
+    }
+}
+
+CANTelemetryStore::NodeColumns *CANTelemetryStore::node(int key) const
+{
+    if (key < 0 || key >= MAX_KEYS)
+        return nullptr;
+    return m_nodes[key].loadAcquire();
+}
+
+void CANTelemetryStore::append(const CANStatusSample &sample)
+{
+    int index = canNodeKey(sample);
+    if (sample.node > 0x7F || index >= MAX_KEYS)
+        return;
+
+    NodeColumns *columns = m_nodes[index].loadAcquire();
+    if (!columns) {
+        // 列数据写完初始化后才发布指针
+        columns = new NodeColumns(m_capacity);
+        m_nodes[index].storeRelease(columns);
+    }
+
+    quint64 head = columns->head.load();
+    int slot = static_cast<int>(head & m_mask);
+    columns->timeUs[slot] = sample.timeUs;
+    columns->speed[slot] = sample.speed;
+    columns->position[slot] = sample.position;
+    columns->current[slot] = sample.current;
+    // release：样本数据写入先于新的写位置对读者可见
+    columns->head.storeRelease(head + 1);
+}
+
+quint64 CANTelemetryStore::cursor(int key) const
+{
+    const NodeColumns *columns = node(key);
+    return columns ? columns->head.loadAcquire() : 0;
+}
+
+quint64 CANTelemetryStore::copyRange(const NodeColumns *columns, quint64 from, quint64 to, Columns *out) const
+{
+    int count = static_cast<int>(to - from);
+    int base = out->size();
+    out->timeUs.resize(base + count);
+    out->speed.resize(base + count);
+    out->position.resize(base + count);
+    out->current.resize(base + count);
+
+    // 环形回绕时分两段拷贝
+    int done = 0;
+    while (done < count) {
+        int slot = static_cast<int>((from + done) & m_mask);
+        int chunk = qMin(count - done, m_capacity - slot);
+        memcpy(out->timeUs.data() + base + done, columns->timeUs.constData() + slot, sizeof(qint64) * chunk);
+        memcpy(out->speed.data() + base + done, columns->speed.constData() + slot, sizeof(float) * chunk);
+        memcpy(out->position.data() + base + done, columns->position.constData() + slot, sizeof(float) * chunk);
+        memcpy(out->current.data() + base + done, columns->current.constData() + slot, sizeof(float) * chunk);
+        done += chunk;
+    }
+
+    // 拷贝期间写者可能已覆盖最旧的样本：正在写入的下标为newHead，会覆盖newHead-capacity
+    quint64 newHead = columns->head.loadAcquire();
+    quint64 validFrom = (newHead + 1 > static_cast<quint64>(m_capacity)) ? newHead + 1 - m_capacity : 0;
+    if (validFrom > from) {
+        int stale = static_cast<int>(qMin<quint64>(validFrom - from, static_cast<quint64>(count)));
+        out->timeUs.remove(base, stale);
+        out->speed.remove(base, stale);
+        out->position.remove(base, stale);
+        out->current.remove(base, stale);
+    }
+    return to;
+}
+
+quint64 CANTelemetryStore::read(int key, quint64 fromCursor, Columns *columns) const
+{
+    const NodeColumns *data = node(key);
+    if (!data || !columns)
+        return fromCursor;
+
+    quint64 head = data->head.loadAcquire();
+    if (fromCursor >= head)
+        return head;
+    quint64 oldest = head > static_cast<quint64>(m_capacity) ? head - m_capacity : 0;
+    quint64 from = qMax(fromCursor, oldest);
+    return copyRange(data, from, head, columns);
+}
+
+int CANTelemetryStore::readLatest(int key, int maxSamples, Columns *columns) const
+{
+    const NodeColumns *data = node(key);
+    if (!data || !columns || maxSamples <= 0)
+        return 0;
+
+    quint64 head = data->head.loadAcquire();
+    quint64 span = static_cast<quint64>(qMin(maxSamples, m_capacity));
+    quint64 from = head > span ? head - span : 0;
+    int before = columns->size();
+    copyRange(data, from, head, columns);
+    return columns->size() - before;
+}
+
+bool CANTelemetryStore::latest(int key, CANStatusSample *sample) const
+{
+    if (!sample)
+        return false;
+
+    Columns columns;
+    if (readLatest(key, 1, &columns) != 1)
+        return false;
+    sample->timeUs = columns.timeUs.at(0);
+    sample->speed = columns.speed.at(0);
+    sample->position = columns.position.at(0);
+    sample->current = columns.current.at(0);
+    sample->node = static_cast<quint8>(canNodeKeyNode(key));
+    sample->channel = static_cast<quint8>(canNodeKeyChannel(key));
+    sample->reserved = 0;
+    return true;
+}
+
+QVector<int> CANTelemetryStore::activeNodes() const
+{
+    QVector<int> nodes;
+    for (int i = 0; i < MAX_KEYS; i++) {
+        const NodeColumns *data = m_nodes[i].loadAcquire();
+        if (data && data->head.loadAcquire() > 0)
+            nodes.append(i);
+    }
+    return nodes;
+}
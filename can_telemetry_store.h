@@ -0,0 +1,69 @@
+#ifndef CAN_TELEMETRY_STORE_H
+#define CAN_TELEMETRY_STORE_H
+
+#include <QVector>
+#include <QAtomicInteger>
+#include <QAtomicPointer>
+#include "can_status_sample.h"
+
+// 按节点分列存储的状态遥测（时间/速度/位置/电流各一列，定长环形，写满后覆盖最旧数据）
+// 节点按节点键（全局通道号, 节点号，见can_status_sample.h）区分，不同总线上的同号节点各存一份
+// 单写者：只由接收解码线程append；多读者：界面和分析代码任意线程无锁读取
+// 读取按游标（累计写入样本数）增量进行，拷贝后再校验写位置，拷贝期间被覆盖的样本丢掉不返回
+class CANTelemetryStore
+{
+public:
+    static const int MAX_KEYS = CAN_STATUS_MAX_KEYS;
+    static const int DEFAULT_CAPACITY = 8192;
+
+    // 一段连续样本的列数据，调用方可反复使用以避免重复分配
+    struct Columns {
+        QVector<qint64> timeUs;
+        QVector<float> speed;
+        QVector<float> position;
+        QVector<float> current;
+
+        int size() const { return timeUs.size(); }
+        void clear();
+    };
+
+    explicit CANTelemetryStore(int capacityPerNode = DEFAULT_CAPACITY);
+    ~CANTelemetryStore();
+
+    int capacity() const { return m_capacity; }
+
+    // 写入（仅解码线程）
+    void append(const CANStatusSample &sample);
+
+    // 读取（任意线程），参数均为节点键
+    // 节点累计写入样本数，可作为下次read的起始游标
+    quint64 cursor(int key) const;
+    // 读取游标之后的样本追加到columns，返回新游标；已被覆盖的样本跳过
+    quint64 read(int key, quint64 fromCursor, Columns *columns) const;
+    // 最近maxSamples个样本（按时间顺序）
+    int readLatest(int key, int maxSamples, Columns *columns) const;
+    bool latest(int key, CANStatusSample *sample) const;
+    // 有数据的节点键
+    QVector<int> activeNodes() const;
+
+private:
+    struct NodeColumns {
+        explicit NodeColumns(int capacity);
+
+        QVector<qint64> timeUs;
+        QVector<float> speed;
+        QVector<float> position;
+        QVector<float> current;
+        QAtomicInteger<quint64> head;   // 累计写入数，release发布
+    };
+
+    NodeColumns *node(int key) const;
+    quint64 copyRange(const NodeColumns *columns, quint64 from, quint64 to, Columns *out) const;
+
+    int m_capacity;
+    quint32 m_mask;
+    // 节点首次出现时由写线程分配，之后不再释放（析构时统一释放）
+    QAtomicPointer<NodeColumns> m_nodes[MAX_KEYS];
+};
+
+#endif // CAN_TELEMETRY_STORE_H
@@ -0,0 +1,162 @@
+#include "can_timestamp.h"
+#include <QtGlobal>
+#include <chrono>
+
+namespace {
+    const qint64 WINDOW_US = 2000000;           // 频偏估计窗口
+    const qint64 JUMP_LIMIT_US = 1000000;       // 超过此偏差视为设备复位/时间跳变
+    const qint32 BACKWARD_LIMIT_TICKS = 10000;  // 计数倒退超过1s视为设备复位
+    const double MAX_SKEW = 500e-6;             // 频偏限幅 ±500ppm
+    const double SKEW_GAIN = 0.25;              // 频偏低通滤波系数
+}
+
+qint64 canMonotonicUs()
+{
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+qint64 canFrameTimeUs(const VCI_CAN_OBJ &frame)
+{
+    return canFrameTimeUs(frame, canMonotonicUs());
+}
+
+CANTimestampMapper::CANTimestampMapper()
+    : m_lastMappedUs(0)
+    , m_reanchors(0)
+{
+    reset();
+}
+
+void CANTimestampMapper::reset()
+{
+    m_valid = false;
+    m_lastTicks = 0;
+    m_ticks = 0;
+    m_anchorHwUs = 0;
+    m_anchorHostUs = 0;
+    m_skew = 0.0;
+    m_windowStartHwUs = 0;
+    m_windowMinOffset = 0;
+    m_windowMinHwUs = 0;
+    m_havePrevWindow = false;
+    m_prevMinOffset = 0;
+    m_prevMinHwUs = 0;
+}
+
+void CANTimestampMapper::stamp(VCI_CAN_OBJ *frames, int count, qint64 hostUs)
+{
+    for (int i = 0; i < count; i++) {
+        VCI_CAN_OBJ &frame = frames[i];
+        qint64 mapped;
+        if (frame.TimeFlag == CAN_TIME_HOST_US) {
+            continue;   // 已是主机时间（回放/转发的帧）
+        } else if (frame.TimeFlag == CAN_TIME_HARDWARE) {
+            mapped = map(frame.TimeStamp, hostUs);
+        } else {
+            mapped = finish(hostUs);
+        }
+        frame.TimeStamp = static_cast<UINT>(static_cast<quint32>(mapped));
+        frame.TimeFlag = CAN_TIME_HOST_US;
+    }
+}
+
+qint64 CANTimestampMapper::map(UINT ticks, qint64 hostUs)
+{
+    if (!m_valid) {
+        restart(ticks, hostUs);
+        return finish(hostUs);
+    }
+
+    qint32 delta = static_cast<qint32>(static_cast<quint32>(ticks) - static_cast<quint32>(m_lastTicks));
+    if (delta < -BACKWARD_LIMIT_TICKS) {
+        // 计数倒退：适配器复位，重新建立映射
+        restart(ticks, hostUs);
+        return finish(hostUs);
+    }
+    m_lastTicks = ticks;
+    m_ticks += delta;
+
+    qint64 hwUs = m_ticks * 100;
+    qint64 predicted = predict(hwUs);
+    qint64 error = hostUs - predicted;   // 正常情况下为非负的接收延迟
+
+    if (error < -JUMP_LIMIT_US) {
+        // 硬件时间向前跳变，频偏估计失效
+        restart(ticks, hostUs);
+        return finish(hostUs);
+    }
+    if (error < 0) {
+        // 接收时刻早于预测：下包络下移
+        m_anchorHwUs = hwUs;
+        m_anchorHostUs = hostUs;
+        m_reanchors++;
+        predicted = hostUs;
+    }
+
+    updateSkew(hwUs, hostUs - hwUs);
+    return finish(qMin(predicted, hostUs));
+}
+
+void CANTimestampMapper::restart(UINT ticks, qint64 hostUs)
+{
+    bool wasValid = m_valid;
+    reset();
+    m_valid = true;
+    m_lastTicks = ticks;
+    m_ticks = ticks;
+    m_anchorHwUs = m_ticks * 100;
+    m_anchorHostUs = hostUs;
+    m_windowStartHwUs = m_anchorHwUs;
+    m_windowMinHwUs = m_anchorHwUs;
+    m_windowMinOffset = hostUs - m_anchorHwUs;
+    if (wasValid) {
+        m_reanchors++;
+    }
+}
+
+qint64 CANTimestampMapper::predict(qint64 hwUs) const
+{
+    qint64 elapsed = hwUs - m_anchorHwUs;
+    return m_anchorHostUs + elapsed + static_cast<qint64>(elapsed * m_skew);
+}
+
+void CANTimestampMapper::updateSkew(qint64 hwUs, qint64 rawOffset)
+{
+    if (rawOffset < m_windowMinOffset) {
+        m_windowMinOffset = rawOffset;
+        m_windowMinHwUs = hwUs;
+    }
+    if (hwUs - m_windowStartHwUs < WINDOW_US) {
+        return;
+    }
+
+    // 相邻窗口下包络的斜率即主机时钟相对硬件时钟的频偏
+    if (m_havePrevWindow) {
+        qint64 span = m_windowMinHwUs - m_prevMinHwUs;
+        if (span >= WINDOW_US / 2) {
+            double estimate = static_cast<double>(m_windowMinOffset - m_prevMinOffset) / span;
+            m_skew += SKEW_GAIN * (estimate - m_skew);
+            m_skew = qBound(-MAX_SKEW, m_skew, MAX_SKEW);
+            // 频偏更新后以本窗口的最小延迟点重新锚定，避免远离锚点处的映射跳变
+            m_anchorHwUs = m_windowMinHwUs;
+            m_anchorHostUs = m_windowMinHwUs + m_windowMinOffset;
+        }
+    }
+
+    m_havePrevWindow = true;
+    m_prevMinOffset = m_windowMinOffset;
+    m_prevMinHwUs = m_windowMinHwUs;
+    m_windowStartHwUs = hwUs;
+    m_windowMinOffset = rawOffset;
+    m_windowMinHwUs = hwUs;
+}
+
+qint64 CANTimestampMapper::finish(qint64 mappedUs)
+{
+    if (mappedUs < m_lastMappedUs) {
+        mappedUs = m_lastMappedUs;
+    }
+    m_lastMappedUs = mappedUs;
+    return mappedUs;
+}
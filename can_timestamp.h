@@ -0,0 +1,89 @@
+#ifndef CAN_TIMESTAMP_H
+#define CAN_TIMESTAMP_H
+
+#include <QtGlobal>
+#include "ControlCAN.h"
+
+// 统一的单调时间基准（微秒），不受系统时间调整影响，所有线程共用
+qint64 canMonotonicUs();
+
+// VCI_CAN_OBJ::TimeFlag取值：
+// 0 - 无时间戳
+// 1 - TimeStamp为适配器硬件时间戳（0.1ms，32位回绕）
+// CAN_TIME_HOST_US - TimeStamp为已映射到canMonotonicUs()的主机时间低32位（微秒）
+// 接收线程完成映射后帧中只保存主机时间，后续各级队列和界面都按到达总线的时间处理样本
+enum {
+    CAN_TIME_NONE = 0,
+    CAN_TIME_HARDWARE = 1,
+    CAN_TIME_HOST_US = 2
+};
+
+// 取帧的主机单调时间（微秒）；未映射的帧返回当前时间
+// 低32位按当前时间展开，帧的滞留时间不超过约35分钟即可正确还原
+qint64 canFrameTimeUs(const VCI_CAN_OBJ &frame);
+
+// 同上，使用调用方给出的当前时间（批量处理时整批只取一次时钟）
+inline qint64 canFrameTimeUs(const VCI_CAN_OBJ &frame, qint64 nowUs)
+{
+    if (frame.TimeFlag != CAN_TIME_HOST_US) {
+        return nowUs;
+    }
+    // 帧中只有低32位，按与当前时间的差值还原
+    qint32 age = static_cast<qint32>(static_cast<quint32>(nowUs) - static_cast<quint32>(frame.TimeStamp));
+    return nowUs - age;
+}
+
+inline double canFrameTimeSec(const VCI_CAN_OBJ &frame)
+{
+    return canFrameTimeUs(frame) / 1000000.0;
+}
+
+// 硬件时间戳 -> 主机单调时间映射（每个接收通道一个，非线程安全）
+// - 展开32位0.1ms计数的回绕
+// - 偏移量取下包络：主机接收时间 = 到达时间 + 非负的传输/调度延迟，
+//   观测到比预测更早的接收时间时立即重新锚定
+// - 按窗口比较下包络估计两个时钟的频偏并低通滤波，限幅±500ppm
+// - 映射结果不晚于接收时刻，且单调不减
+class CANTimestampMapper
+{
+public:
+    CANTimestampMapper();
+
+    void reset();
+
+    // 将一批刚接收到的帧映射为主机时间，hostUs为这批帧的接收时刻
+    void stamp(VCI_CAN_OBJ *frames, int count, qint64 hostUs);
+    // 单个硬件时间戳映射，返回主机单调时间（微秒）
+    qint64 map(UINT ticks, qint64 hostUs);
+
+    double skewPpm() const { return m_skew * 1e6; }
+    quint64 reanchorCount() const { return m_reanchors; }
+
+private:
+    void restart(UINT ticks, qint64 hostUs);
+    qint64 predict(qint64 hwUs) const;
+    void updateSkew(qint64 hwUs, qint64 rawOffset);
+    qint64 finish(qint64 mappedUs);
+
+    bool m_valid;
+    UINT m_lastTicks;
+    qint64 m_ticks;            // 展开后的硬件计数
+
+    // 映射锚点：hostUs = m_anchorHostUs + (hwUs - m_anchorHwUs) * (1 + m_skew)
+    qint64 m_anchorHwUs;
+    qint64 m_anchorHostUs;
+    double m_skew;
+
+    // 频偏估计：每个窗口内原始偏移(host - hw)的最小值
+    qint64 m_windowStartHwUs;
+    qint64 m_windowMinOffset;
+    qint64 m_windowMinHwUs;
+    bool m_havePrevWindow;
+    qint64 m_prevMinOffset;
+    qint64 m_prevMinHwUs;
+
+    qint64 m_lastMappedUs;
+    quint64 m_reanchors;
+};
+
+#endif // CAN_TIMESTAMP_H
@@ -0,0 +1,445 @@
+#include "can_tx_batcher.h"
+#include "canthread.h"
+#include "can_command_codec.h"
+#include "can_latency_tracer.h"
+#include "can_timestamp.h"
+#include <QDebug>
+
+namespace {
+    // 控制功能码下的命令帧：FF FF FF FF FF FF <模式/FF> FC|FD
+    bool isControlCommand(const VCI_CAN_OBJ &frame)
+    {
+        for (int i = 0; i < 6; i++) {
+            if (frame.Data[i] != 0xFF)
+                return false;
+        }
+        return true;
+    }
+
+    bool isCommandFrame(const VCI_CAN_OBJ &frame)
+    {
+        return !frame.ExternFlag && !frame.RemoteFlag && frame.DataLen == 8
+                && (frame.ID >> 7) <= CAN_CMD_FUNC_CURRENT;
+    }
+
+    bool isStopCommand(const VCI_CAN_OBJ &frame)
+    {
+        return isCommandFrame(frame) && (frame.ID >> 7) == CAN_CMD_FUNC_CONTROL
+                && isControlCommand(frame) && frame.Data[6] == 0xFF && frame.Data[7] == 0xFD;
+    }
+
+    // 发给该节点的命令帧：位置/速度/电流设定值，以及控制功能码下的运控(MIT)、点动、模式切换和启停
+    bool isNodeCommand(const VCI_CAN_OBJ &frame, UINT node)
+    {
+        return isCommandFrame(frame) && (frame.ID & 0x7F) == node;
+    }
+}
+
+CANTxPriority canTxPriority(const VCI_CAN_OBJ &frame)
+{
+    if (frame.ExternFlag)
+        return CANTxSetpoint;
+
+    // 本协议没有NMT，0x000是节点0的控制命令，只有停止命令走紧急队列
+    UINT id = frame.ID;
+    if (isStopCommand(frame))
+        return CANTxEmergency;                 // 停止
+    if (id >= 0x600 && id <= 0x67F)
+        return CANTxSdo;                       // SDO请求
+    if (id >= 0x500 && id <= 0x5FF)
+        return CANTxPoll;                      // 数据上抛请求
+    return CANTxSetpoint;
+}
+
+CANTxBatcher::CANTxBatcher(QObject *parent)
+    : QThread(parent)
+    , m_canThread(nullptr)
+    , m_channel(0)
+    , m_windowUs(200)
+    , m_maxBatch(48)
+    , m_latencyTracer(nullptr)
+    , m_pendingCount(0)
+    , m_firstQueuedNs(0)
+    , m_flushRequested(false)
+    , m_running(false)
+{
+    for (int i = 0; i < CANTxPriorityCount; i++) {
+        m_queues[i].frames.reserve(MAX_PENDING);
+        m_queues[i].groups.reserve(MAX_GROUPS);
+        m_queues[i].head = 0;
+        m_queues[i].groupHead = 0;
+    }
+    m_sending.reserve(MAX_PENDING);
+    m_clock.start();
+    resetStatistics();
+}
+
+CANTxBatcher::~CANTxBatcher()
+{
+    stop();
+}
+
+void CANTxBatcher::setCANThread(CANThread *canThread)
+{
+    QMutexLocker locker(&m_mutex);
+    m_canThread = canThread;
+}
+
+void CANTxBatcher::setChannel(UINT channel)
+{
+    QMutexLocker locker(&m_mutex);
+    m_channel = channel;
+}
+
+void CANTxBatcher::setBatchWindowUs(int windowUs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_windowUs = qMax(0, windowUs);
+}
+
+void CANTxBatcher::setMaxBatchSize(int maxFrames)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxBatch = qBound(1, maxFrames, MAX_PENDING);
+}
+
+void CANTxBatcher::setLatencyTracer(CANLatencyTracer *tracer)
+{
+    m_latencyTracer.storeRelease(tracer);
+}
+
+void CANTxBatcher::append(CANTxPriority priority, const VCI_CAN_OBJ &frame)
+{
+    if (m_pendingCount == 0) {
+        m_firstQueuedNs = m_clock.nsecsElapsed();
+    }
+    if (priority == CANTxEmergency) {
+        m_stats.framesSuperseded += static_cast<quint64>(supersedeNodeCommands(frame.ID & 0x7F));
+    }
+    m_queues[priority].frames.append(frame);
+    m_pendingCount++;
+}
+
+bool CANTxBatcher::enqueue(const VCI_CAN_OBJ &frame)
+{
+    // 先登记再入队，发送线程取走时一定能找到对应请求
+    if (CANLatencyTracer *tracer = m_latencyTracer.loadAcquire()) {
+        tracer->onQueued(&frame, 1);
+    }
+
+    CANTxPriority priority = canTxPriority(frame);
+    QMutexLocker locker(&m_mutex);
+    if (m_pendingCount >= MAX_PENDING) {
+        m_stats.framesDropped++;
+        return false;
+    }
+
+    append(priority, frame);
+    m_stats.framesQueued++;
+
+    // 首帧到达需要唤醒线程开始计时，达到单批上限或紧急帧时立即发送
+    if (priority == CANTxEmergency) {
+        m_flushRequested = true;
+        m_condition.wakeOne();
+    } else if (m_pendingCount == 1 || m_pendingCount >= m_maxBatch) {
+        m_condition.wakeOne();
+    }
+    return true;
+}
+
+int CANTxBatcher::enqueueBurst(const VCI_CAN_OBJ *frames, int count)
+{
+    if (CANLatencyTracer *tracer = m_latencyTracer.loadAcquire()) {
+        tracer->onQueued(frames, count);
+    }
+
+    QMutexLocker locker(&m_mutex);
+    int accepted = qMin(count, MAX_PENDING - m_pendingCount);
+    if (accepted <= 0) {
+        m_stats.framesDropped += static_cast<quint64>(qMax(0, count));
+        return 0;
+    }
+
+    for (int i = 0; i < accepted; i++) {
+        append(canTxPriority(frames[i]), frames[i]);
+    }
+    m_stats.framesQueued += static_cast<quint64>(accepted);
+    m_stats.framesDropped += static_cast<quint64>(count - accepted);
+    m_flushRequested = true;
+    m_condition.wakeOne();
+    return accepted;
+}
+
+bool CANTxBatcher::enqueueGroup(const VCI_CAN_OBJ *frames, int count)
+{
+    if (count <= 0) {
+        return false;
+    }
+
+    if (CANLatencyTracer *tracer = m_latencyTracer.loadAcquire()) {
+        tracer->onQueued(frames, count);
+    }
+
+    CANTxPriority priority = CANTxPriorityCount;
+    for (int i = 0; i < count; i++) {
+        priority = qMin(priority, canTxPriority(frames[i]));
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Queue &queue = m_queues[priority];
+    if (m_pendingCount + count > MAX_PENDING || queue.groups.size() - queue.groupHead >= MAX_GROUPS) {
+        m_stats.framesDropped += static_cast<quint64>(count);
+        return false;
+    }
+    // 组内的停止命令同样取代排在前面的同节点命令，组本身不受影响
+    for (int i = 0; i < count; i++) {
+        if (isStopCommand(frames[i])) {
+            m_stats.framesSuperseded += static_cast<quint64>(supersedeNodeCommands(frames[i].ID & 0x7F));
+        }
+    }
+    if (m_pendingCount == 0) {
+        m_firstQueuedNs = m_clock.nsecsElapsed();
+    }
+    Group group;
+    group.start = queue.frames.size();
+    group.count = count;
+    queue.groups.append(group);
+    for (int i = 0; i < count; i++) {
+        queue.frames.append(frames[i]);
+    }
+    m_pendingCount += count;
+    m_stats.framesQueued += static_cast<quint64>(count);
+    m_flushRequested = true;
+    m_condition.wakeOne();
+    return true;
+}
+
+int CANTxBatcher::supersedeNodeCommands(UINT node)
+{
+    // 停止命令走紧急队列会排到设定值队列之前，这里排着的同节点帧（包括启动、模式切换和成组命令中的帧）
+    // 如果照常发出，会在停止之后重新使能或驱动电机，所以全部丢弃
+    Queue &queue = m_queues[CANTxSetpoint];
+    int read = queue.head;
+    int write = queue.head;
+    int groupWrite = queue.groupHead;
+    int removed = 0;
+
+    auto filterUntil = [&](int end) {
+        for (; read < end; read++) {
+            if (isNodeCommand(queue.frames[read], node)) {
+                removed++;
+                continue;
+            }
+            queue.frames[write++] = queue.frames[read];
+        }
+    };
+    // 组内的帧同样过滤，剩下的帧仍作为一组发送，过滤空的组直接去掉
+    for (int i = queue.groupHead; i < queue.groups.size(); i++) {
+        Group group = queue.groups.at(i);
+        int end = group.start + group.count;
+        filterUntil(qMax(group.start, read));
+        int removedBefore = removed;
+        group.start -= read - write;
+        filterUntil(end);
+        group.count -= removed - removedBefore;
+        if (group.count > 0) {
+            queue.groups[groupWrite++] = group;
+        }
+    }
+    filterUntil(queue.frames.size());
+
+    if (removed > 0) {
+        queue.frames.resize(write);
+        queue.groups.resize(groupWrite);
+        m_pendingCount -= removed;
+        if (queue.head == queue.frames.size()) {
+            queue.frames.clear();
+            queue.groups.clear();
+            queue.head = 0;
+            queue.groupHead = 0;
+        }
+    }
+    return removed;
+}
+
+int CANTxBatcher::takeBatch(int maxBatch)
+{
+    int priority = 0;
+    while (priority < CANTxPriorityCount
+           && m_queues[priority].head == m_queues[priority].frames.size()) {
+        priority++;
+    }
+    if (priority == CANTxPriorityCount) {
+        return 0;
+    }
+
+    Queue &queue = m_queues[priority];
+    int offset = queue.head;
+    int count = qMin(maxBatch, queue.frames.size() - offset);
+    // 不把一组帧拆到两次传输中：组会跨过本批末尾时，本批在组起点截止
+    for (int i = queue.groupHead; i < queue.groups.size(); i++) {
+        const Group &group = queue.groups.at(i);
+        if (group.start >= offset + count) {
+            break;
+        }
+        if (group.start > offset && group.start + group.count > offset + count && group.count <= maxBatch) {
+            count = group.start - offset;
+            break;
+        }
+    }
+
+    m_sending.resize(count);
+    for (int i = 0; i < count; i++) {
+        m_sending[i] = queue.frames.at(offset + i);
+    }
+    queue.head += count;
+    m_pendingCount -= count;
+
+    while (queue.groupHead < queue.groups.size()) {
+        const Group &group = queue.groups.at(queue.groupHead);
+        if (group.start + group.count > queue.head) {
+            break;
+        }
+        queue.groupHead++;
+    }
+    if (queue.head == queue.frames.size()) {
+        queue.frames.clear();
+        queue.groups.clear();
+        queue.head = 0;
+        queue.groupHead = 0;
+    } else if (queue.head >= MAX_PENDING) {
+        // 持续有帧入队时队列一直不空，已取走的部分积累到一定量后前移
+        queue.frames.remove(0, queue.head);
+        queue.groups.remove(0, queue.groupHead);
+        for (Group &group : queue.groups) {
+            group.start -= queue.head;
+        }
+        queue.head = 0;
+        queue.groupHead = 0;
+    }
+    return count;
+}
+
+void CANTxBatcher::flush()
+{
+    QMutexLocker locker(&m_mutex);
+    m_flushRequested = true;
+    m_condition.wakeOne();
+}
+
+void CANTxBatcher::stop()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_running = false;
+        m_condition.wakeAll();
+    }
+    if (!wait(1000)) {
+        terminate();
+        wait();
+    }
+}
+
+int CANTxBatcher::pendingCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pendingCount;
+}
+
+int CANTxBatcher::pendingCount(CANTxPriority priority) const
+{
+    QMutexLocker locker(&m_mutex);
+    if (priority < 0 || priority >= CANTxPriorityCount)
+        return 0;
+    return m_queues[priority].frames.size() - m_queues[priority].head;
+}
+
+CANTxBatcher::Statistics CANTxBatcher::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    Statistics stats = m_stats;
+    stats.averageBatchSize = stats.batches > 0
+            ? static_cast<double>(stats.framesSent + stats.framesFailed) / stats.batches : 0.0;
+    return stats;
+}
+
+void CANTxBatcher::resetStatistics()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stats.framesQueued = 0;
+    m_stats.framesSent = 0;
+    m_stats.framesFailed = 0;
+    m_stats.framesDropped = 0;
+    m_stats.framesSuperseded = 0;
+    m_stats.batches = 0;
+    m_stats.maxBatchSize = 0;
+    m_stats.averageBatchSize = 0.0;
+}
+
+void CANTxBatcher::run()
+{
+    m_running = true;
+    bool draining = false;  // 本次唤醒的帧还没发完，后续批次不再等待合并窗口
+
+    while (true) {
+        CANThread *canThread;
+        UINT channel;
+        int count;
+        {
+            QMutexLocker locker(&m_mutex);
+            if (!draining) {
+                while (m_running && m_pendingCount == 0) {
+                    m_condition.wait(&m_mutex);
+                }
+                if (!m_running && m_pendingCount == 0) {
+                    break;
+                }
+
+                // 合并窗口：等待更多帧，直到窗口结束、达到单批上限、有紧急帧或被要求立即发送
+                qint64 deadlineNs = m_firstQueuedNs + static_cast<qint64>(m_windowUs) * 1000;
+                const Queue &emergency = m_queues[CANTxEmergency];
+                while (m_running && !m_flushRequested && m_pendingCount < m_maxBatch
+                       && emergency.head == emergency.frames.size()) {
+                    qint64 remainingNs = deadlineNs - m_clock.nsecsElapsed();
+                    if (remainingNs <= 0) {
+                        break;
+                    }
+                    if (remainingNs >= 1000000) {
+                        m_condition.wait(&m_mutex, static_cast<unsigned long>(remainingNs / 1000000));
+                    } else {
+                        // 亚毫秒窗口：释放锁短暂休眠
+                        locker.unlock();
+                        QThread::usleep(static_cast<unsigned long>(remainingNs / 1000) + 1);
+                        locker.relock();
+                    }
+                }
+                m_flushRequested = false;
+            }
+
+            // 每批只取最高优先级队列的帧，发送期间新到的高优先级帧在下一批先发
+            count = takeBatch(m_maxBatch);
+            draining = m_pendingCount > 0;
+            canThread = m_canThread;
+            channel = m_channel;
+        }
+        if (count == 0) {
+            continue;
+        }
+
+        CANLatencyTracer *tracer = m_latencyTracer.loadAcquire();
+        qint64 startUs = tracer ? canMonotonicUs() : 0;
+        int sent = canThread ? canThread->sendFrames(channel, m_sending.constData(), count) : 0;
+        if (tracer && sent > 0) {
+            tracer->onTransmitted(m_sending.constData(), sent, startUs, canMonotonicUs());
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            m_stats.batches++;
+            m_stats.framesSent += static_cast<quint64>(sent);
+            m_stats.framesFailed += static_cast<quint64>(count - sent);
+            m_stats.maxBatchSize = qMax(m_stats.maxBatchSize, count);
+        }
+        emit batchSent(count, sent);
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef CAN_TX_BATCHER_H
+#define CAN_TX_BATCHER_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+#include <QVector>
+#include <QAtomicPointer>
+#include "ControlCAN.h"
+
+class CANThread;
+class CANLatencyTracer;
+
+// 发送优先级，数值越小越优先；入队时按帧内容自动分类
+enum CANTxPriority {
+    CANTxEmergency = 0,    // 停止命令（FF..FF FD，含节点0），插到所有队列之前且不等合并窗口
+    CANTxSetpoint,         // 控制/运控/位置/速度/电流命令、同步帧及其他
+    CANTxSdo,              // SDO请求 0x600-0x67F
+    CANTxPoll,             // 数据上抛/示波器轮询 0x500-0x5FF
+    CANTxPriorityCount
+};
+
+CANTxPriority canTxPriority(const VCI_CAN_OBJ &frame);
+
+// CAN批量发送线程（每通道一个，是该通道唯一调用VCI_Transmit的线程）
+// 把短时间窗口内排队的帧合并成一次VCI_Transmit(Len>1)调用，
+// 多轴设定值、参数扫描等突发发送只占用一次USB传输
+// 每个优先级一个FIFO队列，每批只取当前最高优先级的帧，一次唤醒连续发完所有已排队的帧；
+// 高优先级帧在下一批开始前发出（正在进行的VCI_Transmit不会被打断，最多等待一批）
+// 停止命令入队时丢弃同节点尚未发出的所有命令帧（设定值、启动、模式切换，含成组命令中的），
+// 避免停止插队发出后又执行排在后面的旧命令
+class CANTxBatcher : public QThread
+{
+    Q_OBJECT
+public:
+    struct Statistics {
+        quint64 framesQueued;     // 入队帧数
+        quint64 framesSent;       // 发送成功帧数
+        quint64 framesFailed;     // 发送失败帧数
+        quint64 framesDropped;    // 队列满丢弃帧数
+        quint64 framesSuperseded; // 被停止命令取代而丢弃的同节点命令帧数
+        quint64 batches;          // 发送批次数
+        int maxBatchSize;         // 最大单批帧数
+        double averageBatchSize;  // 平均单批帧数
+    };
+
+    explicit CANTxBatcher(QObject *parent = nullptr);
+    ~CANTxBatcher();
+
+    void setCANThread(CANThread *canThread);
+    void setChannel(UINT channel);
+    // 合并窗口（微秒），首帧入队后最多等待这么久再发送；0表示只合并发送期间排队的帧
+    void setBatchWindowUs(int windowUs);
+    // 单次VCI_Transmit最大帧数
+    void setMaxBatchSize(int maxFrames);
+    // 请求/应答延迟跟踪：入队和VCI_Transmit前后打点，nullptr关闭
+    void setLatencyTracer(CANLatencyTracer *tracer);
+
+    // 排队发送单帧
+    bool enqueue(const VCI_CAN_OBJ &frame);
+    // 突发发送：整组帧一起入队并立即发送，不等待合并窗口，返回入队帧数
+    // 各帧按自身优先级入队，同一优先级内保持顺序
+    int enqueueBurst(const VCI_CAN_OBJ *frames, int count);
+    // 成组发送：整组全部入队或全部丢弃，立即发送，且不被拆到两次VCI_Transmit中（组大小不超过单批上限时）
+    // 多轴同步命令靠这一点保证各轴的帧在同一次总线突发中到达；整组按组内最高的优先级排队
+    bool enqueueGroup(const VCI_CAN_OBJ *frames, int count);
+    // 立即发送已排队的帧
+    void flush();
+
+    void stop();
+    int pendingCount() const;
+    int pendingCount(CANTxPriority priority) const;
+    Statistics statistics() const;
+    void resetStatistics();
+
+signals:
+    // 每批发送完成：请求帧数 / 实际成功帧数
+    void batchSent(int requested, int sent);
+
+protected:
+    void run() override;
+
+private:
+    static const int MAX_PENDING = 4096;
+    static const int MAX_GROUPS = 256;
+
+    // 待发送队列中一组帧的位置
+    struct Group {
+        int start;
+        int count;
+    };
+
+    // 单个优先级的待发送队列，head之前的帧已取走，队列发空时整体清空（保留容量）
+    struct Queue {
+        QVector<VCI_CAN_OBJ> frames;
+        QVector<Group> groups;
+        int head;
+        int groupHead;
+    };
+
+    // 以下已持有m_mutex
+    void append(CANTxPriority priority, const VCI_CAN_OBJ &frame);
+    int supersedeNodeCommands(UINT node);
+    int takeBatch(int maxBatch);
+
+    CANThread *m_canThread;
+    UINT m_channel;
+    int m_windowUs;
+    int m_maxBatch;
+    QAtomicPointer<CANLatencyTracer> m_latencyTracer;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_condition;
+    Queue m_queues[CANTxPriorityCount];
+    int m_pendingCount;                 // 各队列未取走的帧数合计
+    QVector<VCI_CAN_OBJ> m_sending;     // 发送线程正在发送的一批
+    QElapsedTimer m_clock;
+    qint64 m_firstQueuedNs;
+    bool m_flushRequested;
+    volatile bool m_running;
+
+    Statistics m_stats;
+};
+
+#endif // CAN_TX_BATCHER_H
@@ -1,4 +1,5 @@
 #include "can_types.h"
+#include "can_status_sample.h"
 #include <QMetaType>
 #include <QVector>
 #include <QPair>
@@ -24,6 +25,18 @@ void registerCanTypes()
         qDebug() << "Registered QList<VCI_CAN_OBJ>";
     }
 
+    if (QMetaType::type("CANFrameBatch") == QMetaType::UnknownType) {
+        qRegisterMetaType<CANFrameBatch>("CANFrameBatch");
+        qRegisterMetaType<QVector<VCI_CAN_OBJ>>("QVector<VCI_CAN_OBJ>");
+        qDebug() << "Registered CANFrameBatch";
+    }
+
+    if (QMetaType::type("CANStatusBatch") == QMetaType::UnknownType) {
+        qRegisterMetaType<CANStatusSample>("CANStatusSample");
+        qRegisterMetaType<CANStatusBatch>("CANStatusBatch");
+        qDebug() << "Registered CANStatusBatch";
+    }
+
     if (QMetaType::type("QVector<float>") == QMetaType::UnknownType) {
         qRegisterMetaType<QVector<float>>("QVector<float>");
         qDebug() << "Registered QVector<float>";
@@ -39,6 +52,11 @@ void registerCanTypes()
         qDebug() << "Registered QVector<QPair<unsigned int,QVector<float>>>";
     }
 
+    if (QMetaType::type("QVector<qint64>") == QMetaType::UnknownType) {
+        qRegisterMetaType<QVector<qint64>>("QVector<qint64>");
+        qDebug() << "Registered QVector<qint64>";
+    }
+
     registered = true;
     qDebug() << "All CAN types registered successfully";
 }
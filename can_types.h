@@ -2,10 +2,26 @@
 #define CAN_TYPES_H
 
 #include <QMetaType>
+#include <QVector>
 #include "ControlCAN.h"  // 包含原始定义
 
 // 不再重新定义 VCI_CAN_OBJ，直接使用 ControlCAN.h 中的定义
 
+// 接收帧的通道标记：VCI_CAN_OBJ::Reserved[0]保存通道号（设备槽位*2 + 设备内通道）
+// 发送时该字段由驱动忽略，接收时由CANRxWorker写入
+inline UINT canFrameChannel(const VCI_CAN_OBJ &frame)
+{
+    return frame.Reserved[0];
+}
+
+inline void setCanFrameChannel(VCI_CAN_OBJ &frame, UINT channel)
+{
+    frame.Reserved[0] = static_cast<BYTE>(channel);
+}
+
+// 一批接收帧：跨线程投递时整批作为一个事件，避免每帧一个排队事件
+typedef QVector<VCI_CAN_OBJ> CANFrameBatch;
+
 // 注册函数声明
 void registerCanTypes();
 
@@ -6,15 +6,73 @@
 #include <string.h>
 
 CANThread::CANThread()
+    : m_deviceType(VCI_USBCAN2)
+    , m_debicIndex(0)
+    , m_baundRate(1000)
+    , m_debicCom(0)
+    , m_backend(CANBackend::create(CANBackend::defaultType()))
+    , m_acceptanceFilter(CANAcceptanceFilter::acceptAll())
 {
     stopped = false;
+    qDebug() << "CAN后端:" << m_backend->name();
+
+    // 每个通道一个接收线程，通道号同时作为帧的通道标记
+    for (UINT channel = 0; channel < 2; channel++) {
+        CANRxWorker *worker = new CANRxWorker(channel, channel, this);
+        worker->setBackend(m_backend);
+        m_rxWorkers.append(worker);
+    }
     //qRegisterMetaType<VCI_CAN_OBJ>("VCI_CAN_OBJ");
     //qRegisterMetaType<unsigned int>("DWORD");
 }
 
+CANThread::~CANThread()
+{
+    stop();
+    wait();
+    qDeleteAll(m_rxWorkers);
+    m_rxWorkers.clear();
+    delete m_backend;
+}
+
+void CANThread::setBackend(CANBackend *backend)
+{
+    if (!backend || backend == m_backend)
+        return;
+    if (isRunning()) {
+        qWarning() << "CAN线程运行中，不能切换后端";
+        delete backend;
+        return;
+    }
+    delete m_backend;
+    m_backend = backend;
+    for (CANRxWorker *worker : m_rxWorkers)
+        worker->setBackend(m_backend);
+    qDebug() << "CAN后端切换为:" << m_backend->name();
+}
+
+void CANThread::setAcceptanceFilter(const CANAcceptanceFilter &filter)
+{
+    m_acceptanceFilter = filter;
+    if (!m_backend->setAcceptanceFilter(m_acceptanceFilter))
+        qDebug() << "当前后端不支持硬件过滤，接收全部帧";
+}
+
+void CANThread::setChannelTagBase(UINT base)
+{
+    if (isRunning()) {
+        qWarning() << "CAN线程运行中，不能修改通道标记";
+        return;
+    }
+    for (CANRxWorker *worker : m_rxWorkers)
+        worker->setChannelTag(base + worker->channel());
+}
+
 void CANThread::stop()
 {
+    QMutexLocker locker(&m_stopMutex);
     stopped = true;
+    m_stopCondition.wakeAll();
 }
 
 
@@ -24,9 +82,7 @@ bool CANThread::openDevice(UINT deviceType,UINT debicIndex,UINT baundRate)
     m_deviceType = deviceType;/* USBCAN-2A或USBCAN-2C或CANalyst-II */
     m_debicIndex = debicIndex;/* 第1个设备 */
     m_baundRate = baundRate;
-    unsigned int dwRel;
-    dwRel = VCI_OpenDevice(m_deviceType, m_debicIndex, 0);
-    if(dwRel != 1)
+    if(!m_backend->open(m_deviceType, m_debicIndex))
         return false;
     else
         qDebug()<<"open success";
@@ -36,97 +92,16 @@ bool CANThread::openDevice(UINT deviceType,UINT debicIndex,UINT baundRate)
 //2.初始化CAN
 bool CANThread::initCAN()
 {
-    unsigned int dwRel = VCI_ClearBuffer(m_deviceType, m_debicIndex, 0);
-    dwRel = VCI_ClearBuffer(m_deviceType, m_debicIndex, 1);
-    VCI_INIT_CONFIG vic;
-    vic.AccCode=0x80000008;
-    vic.AccMask=0xFFFFFFFF;
-    vic.Filter=1;
-    vic.Mode=0;
-    switch (m_baundRate) {
-    case 10:
-        vic.Timing0=0x31;
-        vic.Timing1=0x1c;
-        break;
-    case 20:
-        vic.Timing0=0x18;
-        vic.Timing1=0x1c;
-        break;
-    case 40:
-        vic.Timing0=0x87;
-        vic.Timing1=0xff;
-        break;
-    case 50:
-        vic.Timing0=0x09;
-        vic.Timing1=0x1c;
-        break;
-    case 80:
-        vic.Timing0=0x83;
-        vic.Timing1=0xff;
-        break;
-    case 100:
-        vic.Timing0=0x04;
-        vic.Timing1=0x1c;
-        break;
-    case 125:
-        vic.Timing0=0x03;
-        vic.Timing1=0x1c;
-        break;
-    case 200:
-        vic.Timing0=0x81;
-        vic.Timing1=0xfa;
-        break;
-    case 250:
-        vic.Timing0=0x01;
-        vic.Timing1=0x1c;
-        break;
-    case 400:
-        vic.Timing0=0x80;
-        vic.Timing1=0xfa;
-        break;
-    case 500:
-        vic.Timing0=0x00;
-        vic.Timing1=0x1c;
-        break;
-    case 666:
-        vic.Timing0=0x80;
-        vic.Timing1=0xb6;
-        break;
-    case 800:
-        vic.Timing0=0x00;
-        vic.Timing1=0x16;
-        break;
-    case 1000:
-        vic.Timing0=0x00;
-        vic.Timing1=0x14;
-        break;
-    case 33:
-        vic.Timing0=0x09;
-        vic.Timing1=0x6f;
-        break;
-    case 66:
-        vic.Timing0=0x04;
-        vic.Timing1=0x6f;
-        break;
-    case 83:
-        vic.Timing0=0x03;
-        vic.Timing1=0x6f;
-        break;
-    default:
-        break;
-    }
-    dwRel = VCI_InitCAN(m_deviceType, m_debicIndex, 0, &vic);
-    dwRel = VCI_InitCAN(m_deviceType, m_debicIndex, 1, &vic);
-    if(dwRel !=1)
+    // 订阅的COB-ID区间下发到适配器，不需要的帧不经过USB传输
+    if(m_backend->setAcceptanceFilter(m_acceptanceFilter))
+        qDebug()<<"acceptance filter:"<<m_acceptanceFilter.toString();
+    if(!m_backend->configure(m_baundRate))
         return false;
     else
         qDebug()<<"init success";
 
     VCI_BOARD_INFO vbi;
-    dwRel = VCI_ReadBoardInfo(m_deviceType, m_debicIndex, &vbi);
-    if(dwRel != 1)
-        return false;
-    else
+    if(m_backend->readBoardInfo(&vbi))
         emit boardInfo(vbi);
     return true;
 }
@@ -134,89 +109,55 @@ bool CANThread::initCAN()
 //3.启动CAN
 bool CANThread::startCAN()
 {
-    if(VCI_StartCAN(m_deviceType, m_debicIndex, 0) !=1)
-    {
-        qDebug()<<"start 0 fail.";
-        return false;
-    }
-    else
-        qDebug()<<"start 0 success.";
-    if(VCI_StartCAN(m_deviceType, m_debicIndex, 1) !=1)
-    {
-        qDebug()<<"start 1 fail.";
-        return false;
-    }
-    else
-        qDebug()<<"start 1 success.";
-    return true;
+    return m_backend->start();
 }
 
 //4.发送数据
 bool CANThread::sendData(UINT channel,UINT ID,BYTE remoteFlag,BYTE externFlag,const unsigned char *data,BYTE len)
 {
-    unsigned int dwRel;
     VCI_CAN_OBJ vco;
+    memset(&vco, 0, sizeof(vco));
     vco.ID = ID ;
     vco.RemoteFlag = remoteFlag;
     vco.ExternFlag = externFlag;
     vco.DataLen = len;
-    for(UINT j = 0;j < len;j++)
+    for(UINT j = 0;j < len && j < 8;j++)
         vco.Data[j] = data[j];
-    dwRel = VCI_Transmit(m_deviceType, m_debicIndex, channel,&vco,1);
-    if(dwRel>0)
-        return true;
-    else
-        return false;
+    return sendFrames(channel, &vco, 1) > 0;
+}
 
+int CANThread::sendFrames(UINT channel,const VCI_CAN_OBJ *frames,int count)
+{
+    int sent = m_backend->transmit(channel, frames, count);
+    return sent > 0 ? sent : 0;
 }
 
 //5.关闭设备
 void CANThread::closeDevice()
 {
-    VCI_CloseDevice(m_deviceType, m_debicIndex);
+    m_backend->close();
 }
 
 //0.复位设备，  复位后回到3
 bool CANThread::reSetCAN()
 {
-    if(VCI_ResetCAN(m_deviceType, m_debicIndex, 0) !=1)
-    {
-        qDebug()<<"reset 0 fail.";
-        return false;
-    }
-    else
-        qDebug()<<"reset 0 success.";
-    if(VCI_ResetCAN(m_deviceType, m_debicIndex, 1) !=1)
-    {
-        qDebug()<<"reset 1 fail.";
-        return false;
-    }
-    else
-        qDebug()<<"reset 1 success.";
-    return true;
+    return m_backend->reset();
 }
 
 void CANThread::run()
 {
-    while(!stopped)
+    // 各通道由独立线程接收，互不等待；本线程只负责它们的启停
+    for (CANRxWorker *worker : m_rxWorkers)
+        worker->start(QThread::TimeCriticalPriority);
+
     {
-        unsigned int dwRel;
-        VCI_CAN_OBJ vco[2500];
-        
-        // 高频接收模式 - 非阻塞接收
-        dwRel = VCI_Receive(m_deviceType, m_debicIndex, 0, vco, 2500, 1); // 1ms超时
-        if(dwRel > 0)
-            emit getProtocolData(vco, dwRel, 0);
-            
-        dwRel = VCI_Receive(m_deviceType, m_debicIndex, 1, vco, 2500, 1); // 1ms超时
-        if(dwRel > 0)
-            emit getProtocolData(vco, dwRel, 1);
-            
-        // 高频模式 - 减少sleep时间到1ms
-        if (dwRel == 0) {
-            sleep(1); // 只有在没有数据时才sleep
-        }
+        QMutexLocker locker(&m_stopMutex);
+        while (!stopped)
+            m_stopCondition.wait(&m_stopMutex);
     }
+
+    for (CANRxWorker *worker : m_rxWorkers)
+        worker->stop();
     stopped = false;
 }
 
@@ -3,13 +3,29 @@
 
 #include <QThread>
 #include "ControlCAN.h"
+#include "can_frame_ring.h"
+#include "can_backend.h"
+#include "can_rx_worker.h"
 #include <QDebug>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
 
 class CANThread:public QThread
 {
     Q_OBJECT
 public:
     CANThread();
+    ~CANThread();
+
+    // 设置传输后端（接管所有权），需在打开设备前调用
+    void setBackend(CANBackend *backend);
+    CANBackend *backend() const { return m_backend; }
+
+    // 硬件接收过滤（订阅的COB-ID区间），默认全部接收，由CANTxRx按分发器的订阅表下发
+    // USBCAN-E-U滤波表/SocketCAN/仿真总线立即生效，其余USBCAN型号的验收码在下次initCAN时生效
+    void setAcceptanceFilter(const CANAcceptanceFilter &filter);
+    CANAcceptanceFilter acceptanceFilter() const { return m_acceptanceFilter; }
 
     void stop();
 
@@ -24,6 +40,8 @@ public:
 
     //4.发送数据
     bool sendData(UINT channel,UINT ID,BYTE remoteFlag,BYTE externFlag,const unsigned char *data,BYTE len);
+    // 批量发送，返回发送成功的帧数
+    int sendFrames(UINT channel,const VCI_CAN_OBJ *frames,int count);
 
     //5.关闭设备
     void closeDevice();
@@ -31,6 +49,14 @@ public:
     //0.复位设备，  复位后回到3
     bool reSetCAN();
 
+    // 多适配器时由CANDeviceManager设置：本设备通道的帧标记为 base + 通道号
+    void setChannelTagBase(UINT base);
+
+    // 每个通道独立的接收线程和环形缓冲，后端接收直接写入，消费者原地读取
+    int channelCount() const { return m_rxWorkers.size(); }
+    CANFrameRing *rxRing(int channel) { return m_rxWorkers.at(channel)->ring(); }
+    CANRxWorker::Statistics channelStatistics(int channel) const { return m_rxWorkers.at(channel)->statistics(); }
+
     UINT m_deviceType;
     UINT m_debicIndex;
     UINT m_baundRate;
@@ -39,13 +65,18 @@ public:
     bool stopped;
 
 signals:
-    void getProtocolData(VCI_CAN_OBJ *vci,unsigned int dwRel,unsigned int channel);
     void boardInfo(VCI_BOARD_INFO vbi);
 
 private:
     void run();
     void sleep(int msec);
 
+    CANBackend *m_backend;
+    CANAcceptanceFilter m_acceptanceFilter;
+    QVector<CANRxWorker*> m_rxWorkers;
+    QMutex m_stopMutex;
+    QWaitCondition m_stopCondition;
+
 };
 
 #endif // CANTHREAD_H
@@ -1125,6 +1125,29 @@ void ControlParam::onReadAllTick()
     m_readIndex++;
 }
 
+void ControlParam::setCANTxRx(CANTxRx *canTxRx)
+{
+    if (m_canTxRx) {
+        m_canTxRx->dispatcher()->unsubscribe(this);
+    }
+    m_canTxRx = canTxRx;
+    if (!m_canTxRx) {
+        return;
+    }
+
+    // SDO应答直接投递到本界面所在线程，不再经过逐帧信号
+    m_canTxRx->dispatcher()->subscribeRange(0x580, 0x5FF, this, [this](const CANFrameBatch &frames) {
+        onSdoReadResponses(frames);
+    });
+}
+
+void ControlParam::onSdoReadResponses(const CANFrameBatch &frames)
+{
+    for (const VCI_CAN_OBJ &frame : frames) {
+        onSdoReadResponse(frame);
+    }
+}
+
 void ControlParam::onSdoReadResponse(const VCI_CAN_OBJ &frame)
 {
     // 仅处理SDO上传响应: 0x580 + nodeId, 长度≥8
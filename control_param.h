@@ -35,6 +35,8 @@ public:
     void updateParameterValue(uint16_t index, uint8_t subindex, const QVariant& value);
     ODEntry getParam(uint16_t index, uint8_t subindex) const { return m_paramDict.getParameter(index, subindex); }
     uint8_t getCanId() const { return m_currentCanId; }
+    // 订阅SDO应答（0x580-0x5FF），在g_canTxRx创建后调用
+    void setCANTxRx(CANTxRx *canTxRx);
 
 signals:
     void sdoWriteRequest(uint8_t nodeId, uint16_t index, uint8_t subindex, const QByteArray& data);
@@ -42,6 +44,8 @@ signals:
 
 public slots:
     void onSdoReadResponse(const VCI_CAN_OBJ &frame);
+    // 一批SDO应答（由CANTxRx的分发器按批投递）
+    void onSdoReadResponses(const CANFrameBatch &frames);
 
 private slots:
     void onApplyParamsClicked();
@@ -88,6 +92,7 @@ private:
 
     uint8_t m_currentCanId;
     bool m_autoApply;
+    CANTxRx *m_canTxRx {nullptr};
 
     // 在 ControlParam 类的 protected 部分添加
     protected:
@@ -0,0 +1,10 @@
+# 核心静态库：只依赖QtCore，界面程序和无界面工具共用
+QT = core
+
+CONFIG += c++11 staticlib
+TEMPLATE = lib
+TARGET = motor_can_core
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../motor_can_core.pri)
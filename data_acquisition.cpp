@@ -28,6 +28,7 @@
 #include <limits>
 #include <iterator>
 #include "can_rx_tx.h"
+#include "can_timestamp.h"
 #include "global_vars.h"
 
 // 添加类型定义
@@ -1362,27 +1363,21 @@ void OscilloscopeWidget::createFitButton()
 // ==================== DataAcquisition 实现 ====================
 
 DataAcquisition::DataAcquisition(QWidget *parent) : QWidget(parent)
-    , m_isAcquiring(false)
-    , m_startTime(0)
+    , m_engine(nullptr)
+    , m_oscilloscope(nullptr)
+    , m_autoModeEnabled(false)
     , m_timeRange(10.0)
     , m_channelCount(1)
-    , m_paramDictionary(nullptr)
-    , m_canTxRx(nullptr)
-    , m_isRequesting(false)
-    , m_autoModeEnabled(false)
-    , m_pendingRequests(0)
     , m_maxDebugMessages(1000)
-    , m_requestCount(0)
-    , m_responseCount(0)
-    , m_currentChannelIndex(0)
-    , m_oscilloscope(nullptr)
 {
     qDebug() << "【数据采集】开始创建DataAcquisition";
     
     try {
-        // 初始化参数字典
-        m_paramDictionary = new ParamDictionary(this);
-        qDebug() << "【数据采集】参数字典创建完成";
+        // 采集引擎（含参数字典，setupUI填充参数列表时要用）
+        m_engine = new AcquisitionEngine(this);
+        connect(m_engine, &AcquisitionEngine::dataPointAdded,
+                this, &DataAcquisition::dataPointAdded);
+        qDebug() << "【数据采集】采集引擎创建完成";
 
         // 先创建示波器组件（在setupUI之前，因为setupUI会使用它）
         qDebug() << "【数据采集】准备创建示波器组件...";
@@ -1408,12 +1403,6 @@ DataAcquisition::DataAcquisition(QWidget *parent) : QWidget(parent)
     m_plotUpdateTimer = new QTimer(this);
     m_plotUpdateTimer->setInterval(25); // 40Hz更新频率
     connect(m_plotUpdateTimer, &QTimer::timeout, this, &DataAcquisition::updatePlot);
-    
-    // 初始化参数请求定时器
-    m_parameterRequestTimer = new QTimer(this);
-    m_parameterRequestTimer->setInterval(25); // 40Hz间隔
-    m_parameterRequestTimer->setTimerType(Qt::PreciseTimer);
-    connect(m_parameterRequestTimer, &QTimer::timeout, this, &DataAcquisition::requestParameters);
 }
 
 DataAcquisition::~DataAcquisition()
@@ -1425,9 +1414,6 @@ DataAcquisition::~DataAcquisition()
     if (m_plotUpdateTimer) {
         m_plotUpdateTimer->stop();
     }
-    if (m_parameterRequestTimer) {
-        m_parameterRequestTimer->stop();
-    }
     
     // 清理示波器数据
     if (m_oscilloscope) {
@@ -1619,7 +1605,9 @@ void DataAcquisition::setupControlPanel()
     qDebug() << "【控制面板】创建节点ID输入...";
     m_nodeIdSpinBox = new QSpinBox();
     m_nodeIdSpinBox->setRange(1, 127);
-    m_nodeIdSpinBox->setValue(5);
+    m_nodeIdSpinBox->setValue(m_engine->nodeId());
+    connect(m_nodeIdSpinBox, QOverload<int>::of(&QSpinBox::valueChanged),
+            this, [this](int nodeId) { m_engine->setNodeId(static_cast<uint8_t>(nodeId)); });
     qDebug() << "【控制面板】节点ID输入创建完成";
     
     // 自动缩放选项
@@ -1986,10 +1974,10 @@ void DataAcquisition::populateParameterComboBox(QComboBox *comboBox, int categor
 {
     comboBox->clear();
 
-    if (!m_paramDictionary) return;
+    ParamDictionary *dictionary = m_engine->paramDictionary();
     
     // 根据类别获取参数
-    QVector<ODEntry> parameters = m_paramDictionary->getParametersByCategory(category);
+    QVector<ODEntry> parameters = dictionary->getParametersByCategory(category);
 
     for (const ODEntry &entry : parameters) {
         QString displayText = QString("0x%1.%2 - %3 (%4)")
@@ -2006,7 +1994,7 @@ void DataAcquisition::populateParameterComboBox(QComboBox *comboBox, int categor
 
 void DataAcquisition::onStartStopClicked()
 {
-    if (!m_isAcquiring) {
+    if (!m_engine->isAcquiring()) {
         startAcquisition();
     } else {
         stopAcquisition();
@@ -2028,15 +2016,13 @@ void DataAcquisition::onChannelCountChanged(int count)
 
 void DataAcquisition::onParameterSelectionChanged(int channelIndex)
 {
-    if (channelIndex < m_channelConfigs.size()) {
+    if (channelIndex < m_parameterComboBoxes.size()) {
         QComboBox *paramComboBox = m_parameterComboBoxes[channelIndex];
         QVariant data = paramComboBox->currentData();
         
         if (data.isValid()) {
             QPair<uint16_t, uint8_t> param = data.value<QPair<uint16_t, uint8_t>>();
-            m_channelConfigs[channelIndex].parameterIndex = param.first;
-            m_channelConfigs[channelIndex].parameterSubindex = param.second;
-            m_channelConfigs[channelIndex].parameterName = getParameterName(param.first, param.second);
+            m_engine->setChannelParameter(channelIndex, param.first, param.second);
         }
     }
 }
@@ -2116,24 +2102,23 @@ void DataAcquisition::startAcquisition()
 {
     qDebug() << "【采集】startAcquisition被调用";
     
-    if (m_isAcquiring) {
+    if (m_engine->isAcquiring()) {
         qDebug() << "【采集】已经在采集中，忽略";
         return;
     }
 
-    m_isAcquiring = true;
-    
-    // 设置全局变量，允许示波器数据解析
-    g_oscilloscopeAcquiring = 1;
-    qDebug() << "【采集】全局变量g_oscilloscopeAcquiring已设置为1，允许示波器数据解析";
-    
-    // 只有在第一次采集或数据被清空后才设置起始时间
-    if (m_startTime <= 0) {
-        m_startTime = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
-        qDebug() << "【采集】设置新的startTime =" << m_startTime;
-    } else {
-        qDebug() << "【采集】使用现有的startTime =" << m_startTime << "，继续从上次位置采集";
+    qDebug() << "【采集】m_channelCount值:" << m_channelCount;
+    if (m_engine->channelConfigs().isEmpty()) {
+        qCritical() << "【采集】❌ 警告：通道配置为空！尝试重新初始化...";
+        // 尝试重新创建通道配置
+        if (m_channelCount > 0) {
+            updateChannelConfigVisibility();
+            qDebug() << "【采集】重新初始化后通道配置数量:" << m_engine->channelConfigs().size();
+        }
     }
+
+    // 请求定时、时间零点和应答解析都在采集引擎中
+    m_engine->start();
     
     // 更新UI
     m_startStopButton->setText("停止采集");
@@ -2161,64 +2146,20 @@ void DataAcquisition::startAcquisition()
         qDebug() << "【采集】绘图更新定时器已启动";
     }
     
-    if (m_parameterRequestTimer) {
-        m_parameterRequestTimer->start();
-        qDebug() << "【采集】参数请求定时器已启动";
-    }
-    
-    // 重置统计
-    m_requestCount = 0;
-    m_responseCount = 0;
-    m_testStartTime = QTime::currentTime();
-    
-    qDebug() << "【采集】通道配置数量:" << m_channelConfigs.size();
-    qDebug() << "【采集】m_channelCount值:" << m_channelCount;
-    
-    if (m_channelConfigs.size() == 0) {
-        qCritical() << "【采集】❌ 警告：通道配置为空！尝试重新初始化...";
-        // 尝试重新创建通道配置
-        if (m_channelCount > 0) {
-            updateChannelConfigVisibility();
-            qDebug() << "【采集】重新初始化后通道配置数量:" << m_channelConfigs.size();
-        }
-    }
-    
-    // 统计启用的通道数量
-    int enabledChannels = 0;
-    for (const auto& config : m_channelConfigs) {
-        if (config.enabled) {
-            enabledChannels++;
-        }
-    }
-    
-    qDebug() << "【采集】总通道数:" << m_channelConfigs.size() << "启用通道数:" << enabledChannels;
-    
-    if (enabledChannels > 0) {
-        qDebug() << "【采集】第一个启用通道: index=0x" << QString::number(m_channelConfigs[0].parameterIndex, 16)
-                 << " subindex=0x" << QString::number(m_channelConfigs[0].parameterSubindex, 16);
-    } else {
-        qCritical() << "【采集】❌ 错误：没有启用的通道，数据采集将无法工作！";
-    }
-
     addDebugMessage("数据采集已启动");
     qDebug() << "【采集】数据采集启动完成";
 }
 
 void DataAcquisition::stopAcquisition()
 {
-    if (!m_isAcquiring) {
+    if (!m_engine || !m_engine->isAcquiring()) {
         return;
     }
 
-        m_isAcquiring = false;
-    
-    // 设置全局变量，禁止示波器数据解析
-    g_oscilloscopeAcquiring = 0;
-    qDebug() << "【采集】全局变量g_oscilloscopeAcquiring已设置为0，禁止示波器数据解析";
+    m_engine->stop();
         
     // 停止定时器
     m_plotUpdateTimer->stop();
-    m_parameterRequestTimer->stop();
     
     // 更新UI
             m_startStopButton->setText("开始采集");
@@ -2252,7 +2193,7 @@ void DataAcquisition::clearData()
     m_oscilloscope->clearData();
     
     // 重置起始时间，下次采集会重新开始
-    m_startTime = -1.0;
+    m_engine->resetTimeBase();
     
     addDebugMessage("数据已清空");
 }
@@ -2260,531 +2201,16 @@ void DataAcquisition::clearData()
 void DataAcquisition::updatePlot()
 {
     // 定时更新显示
-    if (m_oscilloscope && m_isAcquiring) {
+    if (m_oscilloscope && m_engine->isAcquiring()) {
         // QGraphicsView会自动更新，这里可以添加额外的更新逻辑
     }
 }
 
-// ==================== CAN通信函数 ====================
-
-uint32_t DataAcquisition::buildUpdateCOBId(uint8_t cmdType, uint8_t nodeId)
-{
-    return UPDATE_COB_ID_BASE + (cmdType << 4) + (nodeId & 0x0F);
-}
-
-void DataAcquisition::sendCANFrame(uint32_t cobId, const QByteArray& data)
-{
-    VCI_CAN_OBJ frame;
-    memset(&frame, 0, sizeof(VCI_CAN_OBJ));
-
-    frame.ID = cobId;
-    frame.SendType = 0;
-    frame.RemoteFlag = 0;
-    frame.ExternFlag = 0;
-    frame.DataLen = data.size();
-    
-    for (int i = 0; i < data.size() && i < 8; i++) {
-        frame.Data[i] = static_cast<unsigned char>(data.at(i));
-    }
-    
-    // 详细打印发送的CAN数据
-    QString dataHex = "";
-    for (int i = 0; i < frame.DataLen; i++) {
-        dataHex += QString("%1 ").arg(frame.Data[i], 2, 16, QLatin1Char('0')).toUpper();
-    }
-    
-    qDebug() << QString("【CAN发送详情】ID:0x%1 Len:%2 Data:[%3]")
-                .arg(frame.ID, 0, 16)
-                .arg(frame.DataLen)
-                .arg(dataHex.trimmed());
-    
-    if (m_canTxRx) {
-        m_canTxRx->sendCANFrame(frame);
-        qDebug() << "【CAN发送】已调用m_canTxRx->sendCANFrame()";
-    } else {
-        qCritical() << "【CAN发送】❌ m_canTxRx为空，无法发送CAN帧！";
-    }
-}
-
-void DataAcquisition::sendParameterRead(uint8_t nodeId, uint16_t index, uint8_t subindex)
-{
-    QByteArray data;
-    data.append(static_cast<char>((index >> 8) & 0xFF));
-    data.append(static_cast<char>(index & 0xFF));
-    data.append(static_cast<char>(subindex));
-    data.append(static_cast<char>(0)); // 保留字节
-
-    uint32_t cobId = buildUpdateCOBId(UPDATE_CMD_READ_SINGLE, nodeId);
-    
-    // 每10次请求打印一次调试信息（减少打印频率）
-    static int debugCount = 0;
-    if (++debugCount % 10 == 0) {
-        qDebug() << QString("【CAN发送】NodeID:%1 Index:0x%2 SubIndex:0x%3 COB-ID:0x%4")
-                    .arg(nodeId)
-                    .arg(index, 4, 16, QLatin1Char('0'))
-                    .arg(subindex, 2, 16, QLatin1Char('0'))
-                    .arg(cobId, 0, 16);
-    }
-    
-    sendCANFrame(cobId, data);
-}
-
-void DataAcquisition::sendMultiParameterRead(uint8_t nodeId, uint16_t index1, uint8_t subindex1, uint16_t index2, uint8_t subindex2)
-{
-    QByteArray data;
-    // 前三个字节是示波器通道1的索引和子索引
-    data.append(static_cast<char>((index1 >> 8) & 0xFF));
-    data.append(static_cast<char>(index1 & 0xFF));
-    data.append(static_cast<char>(subindex1));
-    
-    // 第4到第6个字节是示波器通道2的索引和子索引
-    data.append(static_cast<char>((index2 >> 8) & 0xFF));
-    data.append(static_cast<char>(index2 & 0xFF));
-    data.append(static_cast<char>(subindex2));
-    
-    // 最后两个字节默认给00 00
-    data.append(static_cast<char>(0x00));
-    data.append(static_cast<char>(0x00));
-
-    uint32_t cobId = buildUpdateCOBId(UPDATE_CMD_READ_MULTI, nodeId);
-    
-    // 每10次请求打印一次调试信息（减少打印频率）
-    static int debugCount = 0;
-    if (++debugCount % 10 == 0) {
-        qDebug() << QString("【CAN多通道发送】NodeID:%1 Ch1:0x%2:0x%3 Ch2:0x%4:0x%5 COB-ID:0x%6")
-                    .arg(nodeId)
-                    .arg(index1, 4, 16, QLatin1Char('0'))
-                    .arg(subindex1, 2, 16, QLatin1Char('0'))
-                    .arg(index2, 4, 16, QLatin1Char('0'))
-                    .arg(subindex2, 2, 16, QLatin1Char('0'))
-                    .arg(cobId, 0, 16);
-    }
-    
-    sendCANFrame(cobId, data);
-}
-
-void DataAcquisition::onCANFrameReceived(const VCI_CAN_OBJ &frame)
-{
-    static int frameCount = 0;
-    frameCount++;
-    
-    // 详细打印接收的CAN数据
-    QString dataHex = "";
-    for (int i = 0; i < frame.DataLen; i++) {
-        dataHex += QString("%1 ").arg(frame.Data[i], 2, 16, QLatin1Char('0')).toUpper();
-    }
-    
-    qDebug() << QString("【CAN接收详情】ID:0x%1 Len:%2 Data:[%3]")
-                .arg(frame.ID, 0, 16)
-                .arg(frame.DataLen)
-                .arg(dataHex.trimmed());
-    
-    // 每10帧打印一次统计日志
-    if (frameCount % 10 == 0) {
-        qDebug() << "【CAN接收统计】已接收" << frameCount << "帧";
-    }
-    
-    // 更新接收计数
-    m_responseCount++;
-    
-    // 解析CAN帧并添加到示波器
-    parseCANFrameForOscilloscope(frame);
-}
-
-void DataAcquisition::parseCANFrameForOscilloscope(const VCI_CAN_OBJ &frame)
-{
-    // 添加基本安全检查
-    if (!frame.Data || frame.DataLen < 4 || frame.DataLen > 8) {
-        qDebug() << "【示波器】无效的CAN帧：DataLen=" << frame.DataLen;
-        return; // 无效的CAN帧
-    }
-    
-    // 检查示波器组件是否存在
-    if (!m_oscilloscope) {
-        qDebug() << "【示波器】示波器组件未初始化";
-        return; // 示波器组件未初始化
-    }
-    
-    if(frame.ID>0x5ff  || frame.ID <0x500)
-        return;
-    // 使用正确的COB-ID解析方式
-    uint8_t receivedNodeId = frame.ID & 0x0F;  // 低4位是NodeID
-    uint8_t cmdType = (frame.ID >> 4) & 0x0F; // 高4位是命令类型
-    uint8_t expectedNodeId = m_nodeIdSpinBox->value();
-    
-    qDebug() << QString("【COB-ID解析】ID:0x%1 NodeID:%2 CmdType:%3")
-                .arg(frame.ID, 0, 16)
-                .arg(receivedNodeId)
-                .arg(cmdType);
-    
-    // 只处理与当前请求匹配的响应数据
-    if (receivedNodeId != expectedNodeId) {
-        // 不是我们请求的节点，忽略
-        qDebug() << QString("【示波器过滤】忽略NodeID %1，期望 %2").arg(receivedNodeId).arg(expectedNodeId);
-        return;
-    }
-    
-    // 打印接收到的CAN帧信息
-    QString dataHex = "";
-    for (int i = 0; i < frame.DataLen; i++) {
-        dataHex += QString("%1 ").arg(frame.Data[i], 2, 16, QLatin1Char('0')).toUpper();
-    }
-    qDebug() << QString("【示波器解析】ID:0x%1 Len:%2 Data:[%3]")
-                .arg(frame.ID, 0, 16)
-                .arg(frame.DataLen)
-                .arg(dataHex.trimmed());
-    
-    // 根据当前启用的通道数量决定解析方式
-    try {
-        // 检查当前启用的通道数量
-        int enabledChannelCount = 0;
-        for (const auto& config : m_channelConfigs) {
-            if (config.enabled) {
-                enabledChannelCount++;
-            }
-        }
-        
-        // 如果启用的通道数量为2，解析为多通道数据
-        if (enabledChannelCount == 2 && cmdType == UPDATE_CMD_RESPONSE && frame.DataLen == 8) {
-            // 多通道响应：前4个字节是第一个通道的数据，后4个字节是第二个通道的数据
-            qDebug() << "【示波器解析】检测到多通道响应数据，通道数:" << enabledChannelCount;
-            
-            // 解析第一个通道的数据（前4个字节）
-            parseMultiChannelData(frame, 0, 4, receivedNodeId);
-            
-            // 解析第二个通道的数据（后4个字节）
-            parseMultiChannelData(frame, 4, 8, receivedNodeId);
-        } else {
-            // 单通道响应：解析参数数据（使用已解析的NodeID）
-            uint16_t parameterIndex = (frame.Data[0] << 8) | frame.Data[1];
-            uint8_t parameterSubindex = frame.Data[2];
-            
-            qDebug() << QString("【示波器解析】NodeID:%1 Index:0x%2 SubIndex:0x%3")
-                        .arg(receivedNodeId)
-                        .arg(parameterIndex, 4, 16, QLatin1Char('0'))
-                        .arg(parameterSubindex, 2, 16, QLatin1Char('0'));
-            
-            // 获取参数值（从第4字节开始）
-            if (frame.DataLen >= 8) {
-                // 根据参数字典解析数据
-                ODEntry paramEntry = m_paramDictionary->getParameter(parameterIndex, parameterSubindex);
-                
-                if (paramEntry.index != 0) { // 找到参数定义
-                    float floatValue = 0.0f;
-                    
-                    // 根据参数类型解析数据
-                    switch (paramEntry.type) {
-                        case OD_TYPE_FLOAT:
-                            memcpy(&floatValue, &frame.Data[4], 4);
-                            break;
-                        case OD_TYPE_INT32:
-                            {
-                                int32_t intValue;
-                                memcpy(&intValue, &frame.Data[4], 4);
-                                floatValue = static_cast<float>(intValue);
-                            }
-                            break;
-                        case OD_TYPE_UINT32:
-                            {
-                                uint32_t uintValue;
-                                memcpy(&uintValue, &frame.Data[4], 4);
-                                floatValue = static_cast<float>(uintValue);
-                            }
-                            break;
-                        case OD_TYPE_INT16:
-                            {
-                                int16_t intValue;
-                                memcpy(&intValue, &frame.Data[4], 2);
-                                floatValue = static_cast<float>(intValue);
-                            }
-                            break;
-                        case OD_TYPE_UINT16:
-                            {
-                                uint16_t uintValue;
-                                memcpy(&uintValue, &frame.Data[4], 2);
-                                floatValue = static_cast<float>(uintValue);
-                            }
-                            break;
-                        case OD_TYPE_INT8:
-                            {
-                                int8_t intValue;
-                                memcpy(&intValue, &frame.Data[4], 1);
-                                floatValue = static_cast<float>(intValue);
-                            }
-                            break;
-                        case OD_TYPE_UINT8:
-                            {
-                                uint8_t uintValue;
-                                memcpy(&uintValue, &frame.Data[4], 1);
-                                floatValue = static_cast<float>(uintValue);
-                            }
-                            break;
-                        default:
-                            // 默认按32位整数处理
-                            {
-                                int32_t intValue;
-                                memcpy(&intValue, &frame.Data[4], 4);
-                                floatValue = static_cast<float>(intValue);
-                            }
-                            break;
-                    }
-                    
-                    // 检查数据有效性
-                    if (!qIsNaN(floatValue) && !qIsInf(floatValue)) {
-                        // 获取当前时间戳
-                        double currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
-                        
-                        // 如果是第一次接收数据，设置起始时间
-                        if (m_startTime <= 0) {
-                            m_startTime = currentTime;
-                        }
-                        
-                        // 计算相对时间戳（相对于起始时间）
-                        double relativeTime = currentTime - m_startTime;
-
-                        // 根据通道配置确定通道名称
-                        QString channelName;
-                        QString displayName;
-                        
-                        // 查找匹配的通道配置
-                        bool foundMatchingChannel = false;
-                        for (const auto& config : m_channelConfigs) {
-                            if (config.enabled && 
-                                config.parameterIndex == parameterIndex && 
-                                config.parameterSubindex == parameterSubindex) {
-                                channelName = QString("CH%1_%2").arg(config.channelIndex + 1).arg(paramEntry.name);
-                                displayName = QString("通道%1: %2 (%3)").arg(config.channelIndex + 1).arg(paramEntry.name).arg(paramEntry.unit);
-                                foundMatchingChannel = true;
-                                break;
-                            }
-                        }
-                        
-                        // 如果没有找到匹配的通道配置，使用默认通道名称
-                        if (!foundMatchingChannel) {
-                            channelName = QString("CH%1_%2").arg(expectedNodeId).arg(paramEntry.name);
-                            displayName = QString("%1 (%2)").arg(paramEntry.name).arg(paramEntry.unit);
-                        }
-                            
-                        emit dataPointAdded(channelName, relativeTime, floatValue, displayName);
-                    }
-                } else {
-                    // 未找到参数定义，使用原始数据
-                    int32_t paramValue;
-                    memcpy(&paramValue, &frame.Data[4], 4);
-                    float floatValue = static_cast<float>(paramValue);
-                    
-                    qDebug() << QString("【示波器原始数据】参数值:0x%1 (%2)")
-                                .arg(paramValue, 8, 16, QLatin1Char('0'))
-                                .arg(floatValue, 0, 'f', 3);
-                    
-                    // 获取当前时间戳
-                    double currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
-                    
-                    // 如果是第一次接收数据，设置起始时间
-                    if (m_startTime <= 0) {
-                        m_startTime = currentTime;
-                    }
-                    
-                    // 计算相对时间戳（相对于起始时间）
-                    double relativeTime = currentTime - m_startTime;
-
-                    // 添加数据点到示波器
-                    QString paramName = QString("参数0x%1.%2").arg(parameterIndex, 4, 16, QLatin1Char('0')).arg(parameterSubindex, 2, 16, QLatin1Char('0'));
-                    QString channelName = QString("CH%1_%2").arg(expectedNodeId).arg(paramName);
-                    
-                    qDebug() << QString("【示波器原始数据】通道:%1 时间:%2 值:%3")
-                                .arg(channelName)
-                                .arg(relativeTime, 0, 'f', 3)
-                                .arg(floatValue, 0, 'f', 3);
-                    
-                    emit dataPointAdded(channelName, relativeTime, floatValue, paramName);
-                }
-            }
-        }
-    } catch (const std::exception &e) {
-        qDebug() << "解析CAN帧时发生异常:" << e.what();
-    } catch (...) {
-        qDebug() << "解析CAN帧时发生未知异常";
-    }
-}
-
-void DataAcquisition::parseMultiChannelData(const VCI_CAN_OBJ &frame, int startByte, int endByte, uint8_t nodeId)
-{
-    // 解析4字节数据
-    if (endByte - startByte != 4) {
-        qDebug() << "【多通道解析】数据长度错误，期望4字节，实际" << (endByte - startByte) << "字节";
-        return;
-    }
-    
-    // 根据通道索引确定通道配置
-    int channelIndex = (startByte == 0) ? 0 : 1; // 前4字节是通道1，后4字节是通道2
-    
-    // 查找匹配的通道配置
-    ChannelConfig* channelConfig = nullptr;
-    for (auto& config : m_channelConfigs) {
-        if (config.enabled && config.channelIndex == channelIndex) {
-            channelConfig = &config;
-            break;
-        }
-    }
-    
-    if (!channelConfig) {
-        qDebug() << QString("【多通道解析】未找到通道%1的配置").arg(channelIndex + 1);
-        return;
-    }
-    
-    // 获取当前时间戳
-    double currentTime = QDateTime::currentDateTime().toMSecsSinceEpoch() / 1000.0;
-    
-    // 如果是第一次接收数据，设置起始时间
-    if (m_startTime <= 0) {
-        m_startTime = currentTime;
-    }
-    
-    // 计算相对时间戳（相对于起始时间）
-    double relativeTime = currentTime - m_startTime;
-    
-    // 根据参数类型解析数据
-    float floatValue = 0.0f;
-    
-    // 获取参数定义
-    ODEntry paramEntry = m_paramDictionary->getParameter(channelConfig->parameterIndex, channelConfig->parameterSubindex);
-    
-    if (paramEntry.index != 0) { // 找到参数定义
-        // 根据参数类型解析数据
-        switch (paramEntry.type) {
-            case OD_TYPE_FLOAT:
-                memcpy(&floatValue, &frame.Data[startByte], 4);
-                break;
-            case OD_TYPE_INT32:
-                {
-                    int32_t intValue;
-                    memcpy(&intValue, &frame.Data[startByte], 4);
-                    floatValue = static_cast<float>(intValue);
-                }
-                break;
-            case OD_TYPE_UINT32:
-                {
-                    uint32_t uintValue;
-                    memcpy(&uintValue, &frame.Data[startByte], 4);
-                    floatValue = static_cast<float>(uintValue);
-                }
-                break;
-            case OD_TYPE_INT16:
-                {
-                    int16_t intValue;
-                    memcpy(&intValue, &frame.Data[startByte], 2);
-                    floatValue = static_cast<float>(intValue);
-                }
-                break;
-            case OD_TYPE_UINT16:
-                {
-                    uint16_t uintValue;
-                    memcpy(&uintValue, &frame.Data[startByte], 2);
-                    floatValue = static_cast<float>(uintValue);
-                }
-                break;
-            case OD_TYPE_INT8:
-                {
-                    int8_t intValue;
-                    memcpy(&intValue, &frame.Data[startByte], 1);
-                    floatValue = static_cast<float>(intValue);
-                }
-                break;
-            case OD_TYPE_UINT8:
-                {
-                    uint8_t uintValue;
-                    memcpy(&uintValue, &frame.Data[startByte], 1);
-                    floatValue = static_cast<float>(uintValue);
-                }
-                break;
-            default:
-                // 默认按32位整数处理
-                {
-                    int32_t intValue;
-                    memcpy(&intValue, &frame.Data[startByte], 4);
-                    floatValue = static_cast<float>(intValue);
-                }
-                break;
-        }
-    } else {
-        // 未找到参数定义，使用原始数据
-        int32_t paramValue;
-        memcpy(&paramValue, &frame.Data[startByte], 4);
-        floatValue = static_cast<float>(paramValue);
-    }
-    
-    // 检查数据有效性
-    if (qIsNaN(floatValue) || qIsInf(floatValue)) {
-        qDebug() << "【多通道解析】无效数据值:" << floatValue;
-        return;
-    }
-    
-    // 生成通道名称和显示名称
-    QString channelName = QString("CH%1_%2").arg(channelIndex + 1).arg(channelConfig->parameterName);
-    QString displayName = QString("通道%1: %2").arg(channelIndex + 1).arg(channelConfig->parameterName);
-    
-    qDebug() << QString("【多通道解析】通道%1 时间:%2 值:%3 参数:%4")
-                .arg(channelIndex + 1)
-                .arg(relativeTime, 0, 'f', 3)
-                .arg(floatValue, 0, 'f', 3)
-                .arg(channelConfig->parameterName);
-    
-    // 发送数据点到示波器
-    emit dataPointAdded(channelName, relativeTime, floatValue, displayName);
-}
-
-void DataAcquisition::parseUpdateProtocol(const VCI_CAN_OBJ &frame)
-{
-    try {
-        // 简化逻辑：只处理参数响应帧
-        if (frame.DataLen >= 4) {
-            uint8_t cmdType = (frame.ID >> 4) & 0x0F;
-            if (cmdType == UPDATE_CMD_RESPONSE) {
-                m_responseCount++;
-            }
-        }
-    } catch (const std::exception &e) {
-        qDebug() << "解析更新协议时发生异常:" << e.what();
-    }
-}
-
-void DataAcquisition::parseParameterResponse(const VCI_CAN_OBJ &frame)
-{
-    // 简化逻辑：只计数回复，不解析内容
-    try {
-        if (frame.DataLen >= 4) {
-            m_responseCount++;
-        }
-    } catch (const std::exception &e) {
-        qDebug() << "解析参数响应时发生异常:" << e.what();
-    }
-}
-
 void DataAcquisition::setCANTxRx(CANTxRx* canTxRx)
 {
-    m_canTxRx = canTxRx;
-    
-    // 连接CAN通信信号
-    if (m_canTxRx) {
-        qDebug() << "【数据采集】连接CAN通信信号...";
-        
-        // 连接CAN帧接收信号
-        bool connected = connect(m_canTxRx, &CANTxRx::frameReceived,
-                this, &DataAcquisition::onCANFrameReceived,
-                Qt::QueuedConnection);
-        
-        if (connected) {
-            qDebug() << "【数据采集】✅ CAN通信信号连接成功";
-        } else {
-            qCritical() << "【数据采集】❌ CAN通信信号连接失败！";
-        }
-        
-        // 测试：直接订阅所有CAN帧（不仅仅是数据上抛协议）
-        qDebug() << "【数据采集】尝试连接所有CAN信号...";
-    } else {
-        qWarning() << "【数据采集】CANTxRx为空，无法连接信号";
-    }
+    // 数据上抛协议帧由采集引擎订阅和解析
+    qDebug() << "【数据采集】连接CAN通信信号...";
+    m_engine->setCANTxRx(canTxRx);
 }
 
 void DataAcquisition::onCANFrameSent(uint32_t id, const QByteArray& data)
@@ -2796,66 +2222,6 @@ void DataAcquisition::onCANFrameSent(uint32_t id, const QByteArray& data)
                    .arg(hexData));
 }
 
-void DataAcquisition::requestParameters()
-{
-    static int callCount = 0;
-    static QTime lastSecondTime = QTime::currentTime();
-    static qint64 lastSendTimeMs = 0;
-    
-    callCount++;
-    
-    // 每秒统计
-    QTime currentTime = QTime::currentTime();
-    if (lastSecondTime.msecsTo(currentTime) >= 1000) {
-        qDebug() << QString("📊 每秒统计 - 发送:%1次 接收:%2次")
-                    .arg(m_requestCount)
-                    .arg(m_responseCount);
-        
-        m_requestCount = 0;
-        m_responseCount = 0;
-        lastSecondTime = currentTime;
-    }
-    
-    // 检查是否正在请求中
-    if (m_isRequesting) {
-        return;
-    }
-    
-    // 使用QElapsedTimer进行精确的时间控制
-    qint64 currentTimeMs = QDateTime::currentDateTime().toMSecsSinceEpoch();
-    if (currentTimeMs - lastSendTimeMs < 5) { // 5ms间隔
-        return;
-    }
-    
-    // 异步发送，避免阻塞定时器
-    QMetaObject::invokeMethod(this, [this]() {
-        // 在下一个事件循环中发送，不阻塞当前定时器
-        // 检查启用的通道数量
-        QVector<ChannelConfig> enabledChannels;
-        for (const auto& config : m_channelConfigs) {
-            if (config.enabled) {
-                enabledChannels.append(config);
-            }
-        }
-        
-        // 如果启用的通道数量为2，使用多通道读取命令
-        if (enabledChannels.size() == 2) {
-            sendMultiParameterRead(m_nodeIdSpinBox->value(), 
-                                 enabledChannels[0].parameterIndex, enabledChannels[0].parameterSubindex,
-                                 enabledChannels[1].parameterIndex, enabledChannels[1].parameterSubindex);
-            m_requestCount++;
-        } else {
-            // 其他情况使用单通道读取命令
-            for (const auto& config : enabledChannels) {
-                sendParameterRead(m_nodeIdSpinBox->value(), config.parameterIndex, config.parameterSubindex);
-                m_requestCount++;
-            }
-        }
-    }, Qt::QueuedConnection);
-    
-    lastSendTimeMs = currentTimeMs;
-}
-
 void DataAcquisition::updateChannelConfigVisibility()
 {
     qDebug() << "【通道配置】开始更新通道配置可见性，通道数量:" << m_channelCount;
@@ -2879,7 +2245,7 @@ void DataAcquisition::updateChannelConfigVisibility()
     m_categoryComboBoxes.clear();
     m_parameterComboBoxes.clear();
     m_channelLabels.clear();
-    m_channelConfigs.clear();
+    QVector<ChannelConfig> configs;
     qDebug() << "【通道配置】配置列表已清空";
     
     // 创建4个通道配置（都显示，但根据通道数量启用）
@@ -2920,7 +2286,9 @@ void DataAcquisition::updateChannelConfigVisibility()
             break;
         }
         
-        m_channelConfigs.append(config);
+        // 控件创建时会按下拉框选择回写通道参数，先交给引擎
+        configs.append(config);
+        m_engine->setChannelConfigs(configs);
         qDebug() << "【通道配置】通道" << i << "ChannelConfig已创建，启用状态:" << config.enabled 
                  << "参数:" << QString("0x%1:0x%2").arg(config.parameterIndex, 4, 16, QLatin1Char('0')).arg(config.parameterSubindex, 2, 16, QLatin1Char('0'));
         
@@ -2950,8 +2318,9 @@ void DataAcquisition::updateChannelConfigVisibility()
 void DataAcquisition::ensureAllChannelsHaveValidParameters()
 {
     // 只处理启用的通道
-    for (int i = 0; i < m_channelConfigs.size() && i < m_parameterComboBoxes.size(); i++) {
-        if (m_channelConfigs[i].enabled) {
+    const QVector<ChannelConfig> &configs = m_engine->channelConfigs();
+    for (int i = 0; i < configs.size() && i < m_parameterComboBoxes.size(); i++) {
+        if (configs[i].enabled) {
             QComboBox *paramComboBox = m_parameterComboBoxes[i];
             if (paramComboBox->count() == 0) {
                 // 如果没有参数，添加默认参数
@@ -2991,19 +2360,7 @@ void DataAcquisition::addParameterDefinition(uint16_t index, uint8_t subindex, c
 
 QString DataAcquisition::getParameterName(uint16_t index, uint8_t subindex) const
 {
-    if (m_paramDictionary) {
-        ODEntry param = m_paramDictionary->getParameter(index, subindex);
-        if (param.index != 0) {
-            return param.name;
-        }
-    }
-    return QString("参数0x%1.%2").arg(index, 4, 16, QLatin1Char('0')).arg(subindex, 2, 16, QLatin1Char('0'));
-}
-
-void DataAcquisition::parseParameterResponseThreadSafe(const VCI_CAN_OBJ &frame)
-{
-    // 线程安全版本
-    parseParameterResponse(frame);
+    return m_engine->getParameterName(index, subindex);
 }
 
 void DataAcquisition::onCANStatisticsUpdated(int sendCount, int receiveCount, double sendFreq, double receiveFreq)
@@ -3034,32 +2391,3 @@ int DataAcquisition::findParameterIndex(QComboBox *comboBox, uint16_t index, uin
     }
     return -1;
 }
-
-void DataAcquisition::updateStreamingParameters()
-{
-    // 更新流式参数
-}
-
-void DataAcquisition::parseStreamData(const VCI_CAN_OBJ &frame)
-{
-    // 解析流式数据
-}
-
-double DataAcquisition::convertParameterValue(uint16_t index, uint8_t subindex, const QByteArray& data) const
-{
-    // 转换参数值
-    return 0.0;
-}
-
-void DataAcquisition::startStreaming(uint8_t nodeId, const QVector<QPair<uint16_t, uint8_t>>& parameters)
-{
-    // 开始流式传输
-}
-
-void DataAcquisition::stopStreaming(uint8_t nodeId)
-{
-    // 停止流式传输
-}
-
-
-
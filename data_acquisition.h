@@ -27,7 +27,8 @@
 #include <QMutexLocker>
 #include "param_dictionary.h"
 #include "ControlCAN.h"
-#include "can_communication_thread.h"
+#include "can_types.h"
+#include "acquisition_engine.h"
 #include <QGraphicsView>
 #include <QGraphicsScene>
 #include <QGraphicsLineItem>
@@ -41,44 +42,6 @@
 #include <QPointF>
 #include <QRectF>
 
-// 数据上抛命令类型定义
-#define UPDATE_CMD_READ_SINGLE     0x01
-#define UPDATE_CMD_READ_MULTI      0x02
-#define UPDATE_CMD_WRITE_SINGLE    0x03
-#define UPDATE_CMD_WRITE_MULTI     0x04
-#define UPDATE_CMD_RESPONSE        0x05
-#define UPDATE_CMD_STREAM_START    0x06
-#define UPDATE_CMD_STREAM_STOP     0x07
-#define UPDATE_CMD_STREAM_DATA     0x08
-
-// 数据上抛基础ID
-#define UPDATE_COB_ID_BASE 0x500
-
-// 参数信息结构体
-struct ParameterInfo {
-    uint16_t index;
-    uint8_t subindex;
-    QString name;
-    QString unit;
-    double scale;
-};
-
-// 数据点结构体
-struct DataPoint {
-    double timestamp;
-    double value;
-    QString parameterName;
-};
-
-// 通道配置结构体
-struct ChannelConfig {
-    int channelIndex;
-    uint16_t parameterIndex;
-    uint8_t parameterSubindex;
-    QString parameterName;
-    bool enabled;
-};
-
 // 使用QGraphicsView的示波器控件
 class OscilloscopeWidget : public QGraphicsView
 {
@@ -188,6 +151,8 @@ private:
     QGraphicsLineItem *m_selectionV2;  // 框选垂直线2
 };
 
+// 示波器界面：采集逻辑（请求定时、应答解析、时间基准）在AcquisitionEngine中，
+// 本类只负责通道配置界面和波形显示
 class DataAcquisition : public QWidget
 {
     Q_OBJECT
@@ -207,8 +172,8 @@ public:
     QString getParameterName(uint16_t index, uint8_t subindex) const;
 
     // CAN通信接口
-    void parseUpdateProtocol(const VCI_CAN_OBJ &frame);
     void setCANTxRx(CANTxRx* canTxRx);
+    AcquisitionEngine *engine() const { return m_engine; }
 
 public slots:
     void onStartStopClicked();
@@ -220,16 +185,11 @@ public slots:
     void onAutoModeToggled(bool enabled);
     void onValueRangeChanged();
     void updatePlot();
-    void requestParameters();
-    void addDebugMessage(const QString &message);  // 请求参数值
-    void parseParameterResponseThreadSafe(const VCI_CAN_OBJ &frame); // 线程安全版本
+    void addDebugMessage(const QString &message);
     
     // CAN通信线程槽函数
     void onCANFrameSent(uint32_t id, const QByteArray& data);
     void onCANStatisticsUpdated(int sendCount, int receiveCount, double sendFreq, double receiveFreq);
-    
-    // 示波器相关函数
-    void onCANFrameReceived(const VCI_CAN_OBJ &frame);
 
 private:
     void setupUI();
@@ -238,21 +198,6 @@ private:
     QWidget* createChannelConfigWidget(int channelIndex);
     void populateParameterComboBox(QComboBox *comboBox, int category);
     void updateChannelConfigVisibility();
-    void updateStreamingParameters();
-
-    // CAN通信函数
-    uint32_t buildUpdateCOBId(uint8_t cmdType, uint8_t nodeId);
-    void sendCANFrame(uint32_t cobId, const QByteArray& data);
-    void sendParameterRead(uint8_t nodeId, uint16_t index, uint8_t subindex);
-    void sendMultiParameterRead(uint8_t nodeId, uint16_t index1, uint8_t subindex1, uint16_t index2, uint8_t subindex2);
-    void startStreaming(uint8_t nodeId, const QVector<QPair<uint16_t, uint8_t>>& parameters);
-    void stopStreaming(uint8_t nodeId);
-
-    // 数据解析函数
-    void parseParameterResponse(const VCI_CAN_OBJ &frame);
-    void parseStreamData(const VCI_CAN_OBJ &frame);
-    void parseMultiChannelData(const VCI_CAN_OBJ &frame, int startByte, int endByte, uint8_t nodeId);
-    double convertParameterValue(uint16_t index, uint8_t subindex, const QByteArray& data) const;
 
     // 数据管理 - addDataPoint函数已删除
     void updateChannelWidgetAppearance(QWidget *channelWidget, bool enabled);
@@ -260,11 +205,11 @@ private:
     // 辅助函数
     int findParameterIndex(QComboBox *comboBox, uint16_t index, uint8_t subindex);
     void ensureAllChannelsHaveValidParameters();
-    
-    // 示波器相关函数
-    void parseCANFrameForOscilloscope(const VCI_CAN_OBJ &frame);
 
 private:
+    // 采集引擎
+    AcquisitionEngine *m_engine;
+
     // UI组件
     OscilloscopeWidget *m_oscilloscope;
     QPushButton *m_startStopButton;
@@ -291,51 +236,17 @@ private:
     QWidget *m_channelConfigContainer;
     QVBoxLayout *m_channelConfigLayout;
 
-    // 数据存储
-    QMap<QString, ParameterInfo> m_parameterDefinitions;
-    QMap<uint8_t, bool> m_streamingStatus;
-    QVector<ChannelConfig> m_channelConfigs;
-
-    // 参数字典
-    ParamDictionary *m_paramDictionary;
-
     // 控制变量
-    bool m_isAcquiring;
-    double m_startTime;
     double m_timeRange;
     int m_channelCount;
 
     // 定时器
     QTimer *m_plotUpdateTimer;
-    QTimer *m_parameterRequestTimer;  // 参数请求定时器
-    
-    // CAN通信线程
-    CANCommunicationThread *m_canCommThread;
-    
-    // CAN通信组件
-    CANTxRx *m_canTxRx;
-    
-    // 请求状态管理
-    bool m_isRequesting;              // 是否正在请求参数
-    QTime m_lastRequestTime;          // 上次请求时间
-    int m_pendingRequests;            // 待处理请求数量
-    
-    // 线程同步
-    QMutex m_dataMutex;               // 数据缓冲区互斥锁
-    QMutex m_stateMutex;              // 状态变量互斥锁
     
     // 队列显示
     QTextEdit *m_debugQueue;
     QStringList m_debugMessages;
     int m_maxDebugMessages;
-    
-    // 频率统计（测试用）
-    int m_requestCount;                  // 请求计数
-    int m_responseCount;                 // 响应计数
-    QTime m_testStartTime;               // 测试开始时间
-    
-    // 通道轮询管理
-    int m_currentChannelIndex;           // 当前请求的通道索引
 
     // 分类定义 - 与参数字典保持一致
     enum ParameterCategory {
@@ -7,7 +7,4 @@
 extern CANTxRx *g_canTxRx;
 extern uint8_t Can_id;
 
-// 声明全局示波器采集状态变量（0:未采集，1:采集中）
-extern int g_oscilloscopeAcquiring;
-
 #endif // GLOBAL_VARS_H
@@ -0,0 +1,56 @@
+# 界面程序：只包含界面代码，CAN通信和采集逻辑链接核心库
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets printsupport
+
+CONFIG += c++11 moc
+TARGET = MOTOR_CAN
+TEMPLATE = app
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../motor_can_core_link.pri)
+
+SOURCES += \
+    $$PWD/../can_init.cpp \
+    $$PWD/../control_param.cpp \
+    $$PWD/../data_acquisition.cpp \
+    $$PWD/../latency_monitor.cpp \
+    $$PWD/../main.cpp \
+    $$PWD/../mainwindow.cpp \
+    $$PWD/../motion_contr_current.cpp \
+    $$PWD/../motion_contr_mentionctr.cpp \
+    $$PWD/../motion_contr_position.cpp \
+    $$PWD/../motion_contr_speed.cpp \
+    $$PWD/../motion_control.cpp \
+    $$PWD/../motor_debug.cpp \
+    $$PWD/../motor_param.cpp \
+    $$PWD/../motor_status.cpp \
+    $$PWD/../node_dashboard.cpp
+
+HEADERS += \
+    $$PWD/../can_init.h \
+    $$PWD/../control_param.h \
+    $$PWD/../data_acquisition.h \
+    $$PWD/../latency_monitor.h \
+    $$PWD/../mainwindow.h \
+    $$PWD/../motion_contr_current.h \
+    $$PWD/../motion_contr_mentionctr.h \
+    $$PWD/../motion_contr_speed.h \
+    $$PWD/../motion_control.h \
+    $$PWD/../motor_contr_position.h \
+    $$PWD/../motor_debug.h \
+    $$PWD/../motor_param.h \
+    $$PWD/../motor_status.h \
+    $$PWD/../node_dashboard.h
+
+FORMS += \
+    $$PWD/../mainwindow.ui
+
+RESOURCES += \
+    $$PWD/../pic.qrc
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,191 @@
+#include "latency_monitor.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QDateTime>
+#include <QDebug>
+#include "can_rx_tx.h"
+
+namespace {
+    const int REFRESH_INTERVAL_MS = 500;   // 分位数按2Hz刷新
+
+    QString formatMs(double us)
+    {
+        return QString::number(us / 1000.0, 'f', 2);
+    }
+}
+
+LatencyMonitor::LatencyMonitor(QWidget *parent)
+    : QWidget(parent)
+    , m_tracer(nullptr)
+    , m_refreshTimer(new QTimer(this))
+    , m_table(nullptr)
+    , m_summaryLabel(nullptr)
+    , m_enableCheckBox(nullptr)
+    , m_resetButton(nullptr)
+    , m_exportButton(nullptr)
+{
+    setupUI();
+    connect(m_refreshTimer, &QTimer::timeout, this, &LatencyMonitor::onRefresh);
+}
+
+void LatencyMonitor::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(12, 12, 12, 12);
+    mainLayout->setSpacing(10);
+
+    QLabel *titleLabel = new QLabel("通信延迟");
+    titleLabel->setStyleSheet(
+        "QLabel {"
+        "    color: #ffffff;"
+        "    font-size: 18px;"
+        "    font-weight: bold;"
+        "    padding: 8px 0px;"
+        "    border-bottom: 1px solid #555555;"
+        "}"
+    );
+
+    QHBoxLayout *toolLayout = new QHBoxLayout();
+    m_summaryLabel = new QLabel("已应答 0 / 超时 0");
+    m_summaryLabel->setStyleSheet("QLabel { color: #4fc3f7; font-size: 15px; font-weight: bold; }");
+    m_enableCheckBox = new QCheckBox("启用跟踪");
+    m_enableCheckBox->setChecked(true);
+    m_enableCheckBox->setStyleSheet("QCheckBox { color: #cccccc; font-size: 14px; }");
+    m_resetButton = new QPushButton("清零");
+    m_exportButton = new QPushButton("导出...");
+    QLabel *hintLabel = new QLabel("时间单位ms；排队/USB/设备/接收为各段平均值");
+    hintLabel->setStyleSheet("QLabel { color: #888888; font-size: 13px; }");
+    toolLayout->addWidget(m_summaryLabel);
+    toolLayout->addSpacing(20);
+    toolLayout->addWidget(m_enableCheckBox);
+    toolLayout->addWidget(m_resetButton);
+    toolLayout->addWidget(m_exportButton);
+    toolLayout->addStretch();
+    toolLayout->addWidget(hintLabel);
+
+    m_table = new QTableWidget(0, COL_COLUMNS);
+    QStringList headers;
+    headers << "类型" << "节点" << "应答数" << "超时" << "平均" << "P50" << "P90" << "P99" << "最大"
+            << "排队" << "USB发送" << "设备" << "接收";
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setStyleSheet(
+        "QTableWidget {"
+        "    background-color: #3a3a3a;"
+        "    color: #ffffff;"
+        "    gridline-color: #555555;"
+        "    font-size: 14px;"
+        "}"
+        "QHeaderView::section {"
+        "    background-color: #454545;"
+        "    color: #ffffff;"
+        "    border: 1px solid #555555;"
+        "    padding: 4px;"
+        "}"
+    );
+
+    mainLayout->addWidget(titleLabel);
+    mainLayout->addLayout(toolLayout);
+    mainLayout->addWidget(m_table);
+
+    connect(m_enableCheckBox, &QCheckBox::toggled, this, &LatencyMonitor::onEnableToggled);
+    connect(m_resetButton, &QPushButton::clicked, this, &LatencyMonitor::onResetClicked);
+    connect(m_exportButton, &QPushButton::clicked, this, &LatencyMonitor::onExportClicked);
+}
+
+void LatencyMonitor::setCANTxRx(CANTxRx *canTxRx)
+{
+    m_tracer = canTxRx ? canTxRx->latencyTracer() : nullptr;
+    if (m_tracer) {
+        m_enableCheckBox->setChecked(m_tracer->isEnabled());
+        m_refreshTimer->start(REFRESH_INTERVAL_MS);
+        qDebug() << "✅ LatencyMonitor: 通信延迟监视已连接，刷新周期" << REFRESH_INTERVAL_MS << "ms";
+    } else {
+        m_refreshTimer->stop();
+    }
+}
+
+void LatencyMonitor::setCell(int row, int column, const QString &text)
+{
+    QTableWidgetItem *item = m_table->item(row, column);
+    if (!item) {
+        item = new QTableWidgetItem();
+        item->setTextAlignment(Qt::AlignCenter);
+        m_table->setItem(row, column, item);
+    }
+    if (item->text() != text)
+        item->setText(text);
+}
+
+void LatencyMonitor::onRefresh()
+{
+    if (!m_tracer || !isVisible())
+        return;
+
+    QVector<CANLatencyTracer::Stats> all = m_tracer->statistics();
+    m_table->setRowCount(all.size());
+    quint64 answered = 0;
+    quint64 timeouts = 0;
+    for (int row = 0; row < all.size(); row++) {
+        const CANLatencyTracer::Stats &stats = all.at(row);
+        setCell(row, COL_TYPE, canLatencyTypeName(stats.type));
+        setCell(row, COL_NODE, QString::number(stats.node));
+        setCell(row, COL_COUNT, QString::number(stats.count));
+        setCell(row, COL_TIMEOUTS, QString::number(stats.timeouts));
+        setCell(row, COL_MEAN, formatMs(stats.meanUs));
+        setCell(row, COL_P50, formatMs(stats.p50Us));
+        setCell(row, COL_P90, formatMs(stats.p90Us));
+        setCell(row, COL_P99, formatMs(stats.p99Us));
+        setCell(row, COL_MAX, formatMs(stats.maxUs));
+        setCell(row, COL_QUEUE, formatMs(stats.queueUs));
+        setCell(row, COL_USB, formatMs(stats.usbTxUs));
+        setCell(row, COL_DEVICE, formatMs(stats.deviceUs));
+        setCell(row, COL_RX, formatMs(stats.rxUs));
+        answered += stats.count;
+        timeouts += stats.timeouts;
+    }
+    m_summaryLabel->setText(QString("已应答 %1 / 超时 %2").arg(answered).arg(timeouts));
+}
+
+void LatencyMonitor::onEnableToggled(bool enabled)
+{
+    if (m_tracer)
+        m_tracer->setEnabled(enabled);
+}
+
+void LatencyMonitor::onResetClicked()
+{
+    if (!m_tracer)
+        return;
+    m_tracer->reset();
+    m_table->setRowCount(0);
+    onRefresh();
+}
+
+void LatencyMonitor::onExportClicked()
+{
+    if (!m_tracer)
+        return;
+
+    QString fileName = QFileDialog::getSaveFileName(
+        this,
+        "导出通信延迟统计",
+        QString("can_latency_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss")),
+        "CSV文件 (*.csv);;所有文件 (*)"
+    );
+    if (fileName.isEmpty())
+        return;
+
+    QString error;
+    if (m_tracer->dumpToFile(fileName, &error)) {
+        qDebug() << "通信延迟统计已导出:" << fileName;
+    } else {
+        QMessageBox::warning(this, "导出失败", error);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef LATENCY_MONITOR_H
+#define LATENCY_MONITOR_H
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QLabel>
+#include <QCheckBox>
+#include <QPushButton>
+#include <QTimer>
+#include "can_latency_tracer.h"
+
+class CANTxRx;
+
+// 通信延迟监视：按请求类型和节点显示SDO/数据上抛请求的往返时间分位数，
+// 以及排队/USB/设备/接收各段平均值，用于判断延迟来自本程序队列、USB还是固件
+class LatencyMonitor : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit LatencyMonitor(QWidget *parent = nullptr);
+
+    // 在g_canTxRx创建后调用
+    void setCANTxRx(CANTxRx *canTxRx);
+
+private slots:
+    void onRefresh();
+    void onEnableToggled(bool enabled);
+    void onResetClicked();
+    void onExportClicked();
+
+private:
+    enum Column {
+        COL_TYPE = 0,
+        COL_NODE,
+        COL_COUNT,
+        COL_TIMEOUTS,
+        COL_MEAN,
+        COL_P50,
+        COL_P90,
+        COL_P99,
+        COL_MAX,
+        COL_QUEUE,
+        COL_USB,
+        COL_DEVICE,
+        COL_RX,
+        COL_COLUMNS
+    };
+
+    void setupUI();
+    void setCell(int row, int column, const QString &text);
+
+    CANLatencyTracer *m_tracer;
+    QTimer *m_refreshTimer;
+    QTableWidget *m_table;
+    QLabel *m_summaryLabel;
+    QCheckBox *m_enableCheckBox;
+    QPushButton *m_resetButton;
+    QPushButton *m_exportButton;
+};
+
+#endif // LATENCY_MONITOR_H
@@ -26,14 +26,14 @@ int main(int argc, char *argv[])
             g_canTxRx = new CANTxRx();
         }
 
-        // 设置CAN线程到CANTxRx
-        g_canTxRx->setCANThread(canThread);
+        // 设置CAN设备到CANTxRx：登录时打开的全部适配器，槽位0即canThread
+        g_canTxRx->setDeviceManager(loginWindow.getDeviceManager());
 
         // 设置CAN参数
         g_canTxRx->setCANParams(4, deviceIndex, 0);
 
         // 启动CAN数据接收
-        g_canTxRx->startReceiving(1, true);  // 1ms间隔接收，高频模式
+        g_canTxRx->startReceiving(true);  // 高频模式，接收线程自适应调度
 
         // 设置数据采集组件给CANTxRx
         mainWindow.setupDataAcquisition();
@@ -85,6 +85,8 @@ MainWindow::MainWindow(QWidget *parent)
     , dataAcquisitionWidget(nullptr)
     , controlParamTab(nullptr)
     , motionControlTab(nullptr)
+    , nodeDashboardTab(nullptr)
+    , latencyMonitorTab(nullptr)
 {
     qDebug() << "========== MainWindow 构造函数开始 ==========";
     //ui->setupUi(this);
@@ -254,6 +256,19 @@ void MainWindow::setupUI()
     qDebug() << "【MainWindow】创建数据采集选项卡...";
     dataAcquisitionWidget = new DataAcquisition();
     qDebug() << "【MainWindow】数据采集选项卡创建成功";
+
+    qDebug() << "【MainWindow】创建节点监视选项卡...";
+    nodeDashboardTab = new NodeDashboard();
+    // 双击节点后切换当前命令目标，与手动输入CAN ID后点击应用相同
+    connect(nodeDashboardTab, &NodeDashboard::nodeSelected, this, [this](int node) {
+        canIdSpinBox->setValue(node);
+        onApplyCanIdClicked();
+    });
+    qDebug() << "【MainWindow】节点监视选项卡创建成功";
+
+    qDebug() << "【MainWindow】创建通信延迟选项卡...";
+    latencyMonitorTab = new LatencyMonitor();
+    qDebug() << "【MainWindow】通信延迟选项卡创建成功";
     
     // 注意：CAN组件的设置会在setupDataAcquisition()中进行
     // 因为在setupUI()调用时，g_canTxRx可能还未创建
@@ -271,6 +286,12 @@ void MainWindow::setupUI()
     
     tabWidget->addTab(dataAcquisitionWidget, "数据采集");
     qDebug() << "【MainWindow】数据采集选项卡已添加";
+
+    tabWidget->addTab(nodeDashboardTab, "节点监视");
+    qDebug() << "【MainWindow】节点监视选项卡已添加";
+
+    tabWidget->addTab(latencyMonitorTab, "通信延迟");
+    qDebug() << "【MainWindow】通信延迟选项卡已添加";
     
     // 设置默认选项卡为"控制参数"（索引1）
     tabWidget->setCurrentIndex(1);
@@ -486,7 +507,7 @@ void MainWindow::setCANConfig(int deviceIndex, int baudRate, int canId, bool ext
 
 //    // 告知底层，直接回调控制参数页槽函数（类似 parseUpdateProtocol 的直接调用）
 //    if (g_canTxRx) {
-//        g_canTxRx->setControlParam(controlParamTab);
+//        controlParamTab->setCANTxRx(g_canTxRx);
 //    }
 }
 
@@ -545,48 +566,6 @@ void MainWindow::on_pushButton_clicked()
 
 
 
-void MainWindow::onGetProtocolData(VCI_CAN_OBJ *vci, unsigned int dwRel, unsigned int channel)
-{
-    QList<VCI_CAN_OBJ> frames;
-    
-    for(unsigned int i = 0; i < dwRel; i++)
-    {
-        QString dataStr = "";
-        if(vci[i].RemoteFlag == 0)
-        {
-            for(int j = 0; j < vci[i].DataLen; j++)
-                dataStr += QString::number(vci[i].Data[j], 16).toUpper() + " ";
-        }
-
-//        // 打印原始数据
-//        qDebug() << QString("[%1] CH%2 接收 ID:0x%3 %4 %5 长度:%6 数据:%7")
-//                    .arg(QTime::currentTime().toString("hh:mm:ss"))
-//                    .arg(channel)
-//                    .arg(vci[i].ID, 8, 16, QChar('0'))
-//                    .arg(vci[i].ExternFlag == 1 ? "扩展帧" : "标准帧")
-//                    .arg(vci[i].RemoteFlag == 1 ? "远程帧" : "数据帧")
-//                    .arg(vci[i].DataLen)
-//                    .arg(dataStr);
-        
-        // 添加到帧列表
-        frames.append(vci[i]);
-        
-        // 数据采集组件的处理已移至can_rx_tx.cpp中，避免重复处理
-    }
-    
-    // 将接收到的帧传递给CANTxRx处理
-    if (g_canTxRx && !frames.isEmpty()) {
-        g_canTxRx->processReceivedFrames(frames);
-    }
-    
-//    // 将CAN帧传递给数据采集组件的示波器
-//    if (dataAcquisitionWidget && !frames.isEmpty()) {
-//        for (const VCI_CAN_OBJ &frame : frames) {
-//            dataAcquisitionWidget->onCANFrameReceived(frame);
-//        }
-//    }
-}
-
 QString versionStr(USHORT ver)
 {
     return "V" + QString::number((ver & 0x0FFF) /0x100,16).toUpper() + "." + QString("%1 ").arg((ver & 0x0FFF) % 0x100,2,16,QChar('0')).toUpper();
@@ -791,10 +770,6 @@ void MainWindow::setupDataAcquisition()
         // 设置CAN组件到数据采集组件
         dataAcquisitionWidget->setCANTxRx(g_canTxRx);
         qDebug() << "✅ CAN组件已设置到数据采集组件";
-        
-        // 设置数据采集组件给CANTxRx
-        g_canTxRx->setDataAcquisition(dataAcquisitionWidget);
-        qDebug() << "✅ 数据采集组件已设置给CANTxRx";
     } else {
         if (!dataAcquisitionWidget) {
             qDebug() << "❌ 数据采集组件为空，无法设置";
@@ -804,10 +779,10 @@ void MainWindow::setupDataAcquisition()
         }
     }
     
-    // 设置ControlParam到CANTxRx，用于接收SDO响应（在g_canTxRx创建后调用）
+    // ControlParam订阅SDO响应（在g_canTxRx创建后调用）
     if (controlParamTab && g_canTxRx) {
-        g_canTxRx->setControlParam(controlParamTab);
-        qDebug() << "✅ ControlParam已设置到CANTxRx，可以接收SDO响应";
+        controlParamTab->setCANTxRx(g_canTxRx);
+        qDebug() << "✅ ControlParam已订阅CANTxRx的SDO响应";
     } else {
         if (!controlParamTab) {
             qDebug() << "❌ ControlParam组件为空，无法设置";
@@ -830,13 +805,23 @@ void MainWindow::setupDataAcquisition()
             qDebug() << "❌ 全局CANTxRx为空，无法设置MotionControl";
         }
     }
+
+    // 节点监视读取CANTxRx的遥测存储和节点登记
+    if (nodeDashboardTab && g_canTxRx) {
+        nodeDashboardTab->setCANTxRx(g_canTxRx);
+    }
+
+    // 通信延迟读取CANTxRx的请求/应答跟踪统计
+    if (latencyMonitorTab && g_canTxRx) {
+        latencyMonitorTab->setCANTxRx(g_canTxRx);
+    }
 }
 
 void MainWindow::setCANThread(CANThread* thread)
 {
     if (thread) {
         canthread = thread;
-        connect(canthread, &CANThread::getProtocolData, this, &MainWindow::onGetProtocolData);
+        // 接收数据由CANThread写入环形缓冲，CANTxRx的接收线程直接读取，这里不再中转
         qDebug() << "✅ CAN线程已设置到MainWindow";
     } else {
         qWarning() << "❌ 传入的CAN线程为空";
@@ -13,6 +13,8 @@
 #include "control_param.h"
 #include "motor_param.h"
 #include "data_acquisition.h"
+#include "node_dashboard.h"
+#include "latency_monitor.h"
 #include "motor_debug.h"  // 添加调试日志头文件
 QT_BEGIN_NAMESPACE
 namespace Ui {
@@ -37,7 +39,6 @@ public:
     void setCANThread(CANThread* thread);
 
 private slots:
-    void onGetProtocolData(VCI_CAN_OBJ *vci, unsigned int dwRel, unsigned int channel);
     void on_open_close_button_clicked();
     void on_pushButton_clicked();
     
@@ -88,6 +89,10 @@ private:
     // 运动控制组件
     MotionControl *motionControlTab;
 
+    // 多轴节点监视组件
+    NodeDashboard *nodeDashboardTab;
+    LatencyMonitor *latencyMonitorTab;
+
 };
 
 #endif // MAINWINDOW_H
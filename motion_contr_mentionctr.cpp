@@ -1,6 +1,7 @@
 #include "motion_contr_mentionctr.h"
 #include <QDebug>
 #include "can_rx_tx.h"  // 包含CAN收发封装头文件
+#include "global_vars.h"
 
 MotionControlMotion::MotionControlMotion(QWidget *parent)
     : QWidget(parent)
@@ -11,6 +12,11 @@ MotionControlMotion::MotionControlMotion(QWidget *parent)
     , targetCurrentSpin(nullptr)
     , startStopBtn(nullptr)
     , modeSwitchBtn(nullptr)
+    , streamCheck(nullptr)
+    , streamRateSpin(nullptr)
+    , streamStatsLabel(nullptr)
+    , streamStatsTimer(new QTimer(this))
+    , streamNode(0)
     , isRunning(false)
 {
     setupUI();
@@ -199,9 +205,39 @@ void MotionControlMotion::setupUI()
         "}"
     );
 
+    // 周期发送：阻抗控制等实验需要稳定的1kHz运控指令流，由专用发送线程完成，界面线程只更新设定值
+    streamCheck = new QCheckBox("周期发送");
+    streamCheck->setStyleSheet("QCheckBox { color: #ffffff; font-size: 18px; font-weight: bold; }");
+    streamRateSpin = new QSpinBox();
+    streamRateSpin->setRange(CANSetpointStreamer::MIN_RATE_HZ, CANSetpointStreamer::MAX_RATE_HZ);
+    streamRateSpin->setValue(CANSetpointStreamer::DEFAULT_RATE_HZ);
+    streamRateSpin->setSingleStep(100);
+    streamRateSpin->setSuffix(" Hz");
+    streamRateSpin->setStyleSheet(
+        "QSpinBox {"
+        "    background-color: #454545;"
+        "    color: white;"
+        "    border: 1px solid #555555;"
+        "    border-radius: 4px;"
+        "    padding: 4px;"
+        "    font-size: 16px;"
+        "}"
+    );
+    streamStatsLabel = new QLabel("");
+    streamStatsLabel->setStyleSheet("QLabel { color: #cccccc; font-size: 14px; }");
+
+    QHBoxLayout *applyLayout = new QHBoxLayout();
+    applyLayout->setContentsMargins(0, 0, 0, 0);
+    applyLayout->setSpacing(10);
+    applyLayout->addWidget(streamCheck);
+    applyLayout->addWidget(streamRateSpin);
+    applyLayout->addWidget(streamStatsLabel);
+    applyLayout->addStretch();
+    applyLayout->addWidget(applyBtn);
+
     paramsLayout->addWidget(titleLabel);
     paramsLayout->addWidget(formWidget);
-    paramsLayout->addWidget(applyBtn, 0, Qt::AlignRight);
+    paramsLayout->addLayout(applyLayout);
 
     // 分隔符
     QFrame *separator = new QFrame();
@@ -333,6 +369,18 @@ void MotionControlMotion::setupUI()
     connect(applyBtn, &QPushButton::clicked, this, &MotionControlMotion::onApplyButtonClicked);
     connect(startStopBtn, &QPushButton::clicked, this, &MotionControlMotion::onStartStopButtonClicked);
     connect(modeSwitchBtn, &QPushButton::clicked, this, &MotionControlMotion::onModeSwitchButtonClicked);
+    connect(streamCheck, &QCheckBox::toggled, this, &MotionControlMotion::onStreamToggled);
+    connect(streamStatsTimer, &QTimer::timeout, this, &MotionControlMotion::onStreamStatsTimeout);
+    // 周期发送时参数修改立即生效，不需要再点应用
+    for (QDoubleSpinBox *spin : { kpSpin, kdSpin, targetPositionSpin, targetVelocitySpin, targetCurrentSpin }) {
+        connect(spin, QOverload<double>::of(&QDoubleSpinBox::valueChanged),
+                this, &MotionControlMotion::onSetpointChanged);
+    }
+    connect(streamRateSpin, QOverload<int>::of(&QSpinBox::valueChanged), this, [this](int hz) {
+        if (streamCheck->isChecked() && g_canTxRx) {
+            g_canTxRx->setpointStreamer()->setNodeRateHz(streamNode, hz);
+        }
+    });
 }
 
 // 其他成员函数保持不变...
@@ -410,6 +458,9 @@ void MotionControlMotion::onStartStopButtonClicked()
         );
         qDebug() << "停止按钮被点击 - 停止运行";
 
+        // 先停止周期发送，避免停机后设定值又把电机带起来
+        stopStreaming();
+
         // 发送停止CAN指令
         if (g_canTxRx && g_canTxRx->isDeviceReady()) {
             bool success = g_canTxRx->sendStopCommand();
@@ -460,6 +511,13 @@ void MotionControlMotion::onApplyButtonClicked()
              << "目标转速:" << targetVelocity << "rpm,"
              << "目标电流:" << targetCurrent << "A";
 
+    // 周期发送时只更新设定值，由发送线程按周期发出
+    if (streamCheck->isChecked()) {
+        updateStreamSetpoint();
+        emit parametersApplied();
+        return;
+    }
+
     // 发送运控指令到CAN
     if (g_canTxRx && g_canTxRx->isDeviceReady()) {
         bool success = g_canTxRx->sendMotionCommand(static_cast<float>(kp),
@@ -480,6 +538,67 @@ void MotionControlMotion::onApplyButtonClicked()
 }
 
 
+void MotionControlMotion::updateStreamSetpoint()
+{
+    if (!g_canTxRx)
+        return;
+    g_canTxRx->setpointStreamer()->setMotionSetpoint(streamNode,
+                                                     static_cast<float>(getKp()),
+                                                     static_cast<float>(getKd()),
+                                                     static_cast<float>(getTargetPosition()),
+                                                     static_cast<float>(getTargetVelocity()),
+                                                     static_cast<float>(getTargetCurrent()));
+}
+
+void MotionControlMotion::onStreamToggled(bool enabled)
+{
+    if (!g_canTxRx) {
+        qDebug() << "CAN设备未就绪，无法周期发送运控指令";
+        return;
+    }
+
+    CANSetpointStreamer *streamer = g_canTxRx->setpointStreamer();
+    if (enabled) {
+        streamNode = Can_id;
+        streamer->resetStatistics();
+        streamer->setNodeRateHz(streamNode, streamRateSpin->value());
+        updateStreamSetpoint();
+        streamStatsTimer->start(500);
+        qDebug() << "运控指令周期发送开始 - 节点:" << streamNode << "频率:" << streamRateSpin->value() << "Hz";
+    } else {
+        streamer->removeNode(streamNode);
+        streamStatsTimer->stop();
+        onStreamStatsTimeout();
+        qDebug() << "运控指令周期发送停止 - 节点:" << streamNode;
+    }
+}
+
+void MotionControlMotion::onSetpointChanged()
+{
+    if (streamCheck && streamCheck->isChecked()) {
+        updateStreamSetpoint();
+    }
+}
+
+void MotionControlMotion::stopStreaming()
+{
+    if (streamCheck && streamCheck->isChecked()) {
+        streamCheck->setChecked(false);
+    }
+}
+
+void MotionControlMotion::onStreamStatsTimeout()
+{
+    if (!g_canTxRx)
+        return;
+    CANSetpointStreamer::Statistics stats = g_canTxRx->setpointStreamer()->statistics();
+    streamStatsLabel->setText(QString("已发 %1  丢失周期 %2  抖动 P99 %3us / 最大 %4us")
+                              .arg(stats.framesSent)
+                              .arg(stats.missedDeadlines)
+                              .arg(stats.p99JitterUs)
+                              .arg(stats.maxJitterUs));
+}
+
 // 参数获取函数
 double MotionControlMotion::getKp() const
 {
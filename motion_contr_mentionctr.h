@@ -9,6 +9,9 @@
 #include <QDoubleSpinBox>
 #include <QPushButton>
 #include <QFrame>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QTimer>
 
 class MotionControlMotion : public QWidget
 {
@@ -45,10 +48,15 @@ private slots:
     void onApplyButtonClicked();
     void onStartStopButtonClicked();
     void onModeSwitchButtonClicked();
+    void onStreamToggled(bool enabled);
+    void onSetpointChanged();
+    void onStreamStatsTimeout();
 
 private:
     void setupUI();
     bool sendMotionCommand(float kp, float kd, float position, float velocity, float current);
+    void updateStreamSetpoint();
+    void stopStreaming();
 
     // UI 组件
     QDoubleSpinBox *kpSpin;
@@ -60,6 +68,13 @@ private:
     QPushButton *startStopBtn;
     QPushButton *modeSwitchBtn;
 
+    // 周期发送：由设定值发送线程按固定频率重复发送当前运控参数
+    QCheckBox *streamCheck;
+    QSpinBox *streamRateSpin;
+    QLabel *streamStatsLabel;
+    QTimer *streamStatsTimer;
+    uint8_t streamNode;
+
     bool isRunning;
 };
 
@@ -1,6 +1,9 @@
 #include "motor_contr_position.h"
 #include <QDebug>
 #include "can_rx_tx.h"  // 包含CAN收发封装头文件
+#include "global_vars.h"
+#include "trajectory_planner.h"
+#include <cmath>
 MotionControlPosition::MotionControlPosition(QWidget *parent)
     : QWidget(parent)
     , kpSpin(nullptr)
@@ -10,6 +13,7 @@ MotionControlPosition::MotionControlPosition(QWidget *parent)
     , decelerationSpin(nullptr)
     , jerkSpin(nullptr)
     , motionProfileCombo(nullptr)
+    , planner(nullptr)
     , startStopBtn(nullptr)
     , modeSwitchBtn(nullptr)
     , homeBtn(nullptr)
@@ -18,6 +22,11 @@ MotionControlPosition::MotionControlPosition(QWidget *parent)
     setupUI();
 }
 
+MotionControlPosition::~MotionControlPosition()
+{
+    delete planner;
+}
+
 void MotionControlPosition::setupUI()
 {
     QVBoxLayout *mainLayout = new QVBoxLayout(this);
@@ -633,14 +642,17 @@ void MotionControlPosition::onApplyButtonClicked()
 
     // 发送位置指令到CAN
     if (g_canTxRx && g_canTxRx->isDeviceReady()) {
-        bool success = g_canTxRx->sendPositionCommand(static_cast<float>(targetPosition),
-                                         static_cast<float>(maxSpeed));
-        if (success) {
-            qDebug() << "位置指令发送成功 - 目标位置:" << targetPosition
-                     << "rad, 最大转速:" << maxSpeed << "rad/s";
-        } else {
-            qDebug() << "位置指令发送失败:" << g_canTxRx->getLastError();
+        int profile = getMotionProfile();
+        if (profile == TrajectoryTrapezoidal || profile == TrajectorySCurve) {
+            if (!startTrajectory(targetPosition, maxSpeed))
+                qDebug() << "轨迹规划失败，请检查最大转速/加速度/减速度/加加速度是否大于0";
+            emit parametersApplied();
+            return;
         }
+
+        // 多项式/正弦规划暂未在上位机实现，仍直接发送目标位置，由驱动器规划
+        qDebug() << "曲线规划" << motionProfileCombo->currentText() << "未在上位机实现，直接发送目标位置";
+        sendDirectPosition(targetPosition, maxSpeed);
     } else {
         qDebug() << "CAN设备未就绪，无法发送位置指令";
     }
@@ -648,6 +660,47 @@ void MotionControlPosition::onApplyButtonClicked()
     emit parametersApplied();
 }
 
+bool MotionControlPosition::startTrajectory(double targetPosition, double maxSpeed)
+{
+    if (!planner)
+        planner = new TrajectoryPlanner();
+    planner->setStreamer(g_canTxRx->setpointStreamer());
+
+    // 起点取最新反馈位置；轴正在按轨迹运动时由规划器从当前设定值接续
+    // 两者都没有时不知道轴在哪，不能假定从0出发（会让轴以最大速度跳向目标），改为直接发送目标位置
+    double start = 0.0;
+    CANStatusSample sample;
+    if (g_canTxRx->telemetryStore()->latest(canNodeKey(g_canTxRx->commandChannel(), Can_id), &sample)) {
+        start = sample.position;
+    } else if (!planner->hasTrajectory(Can_id)) {
+        qDebug() << "节点" << Can_id << "尚无状态反馈，无法确定轨迹起点，改为直接发送目标位置";
+        sendDirectPosition(targetPosition, maxSpeed);
+        return true;
+    }
+
+    TrajectoryLimits limits;
+    limits.maxVelocity = std::fabs(maxSpeed);
+    limits.maxAcceleration = getAcceleration();
+    limits.maxDeceleration = getDeceleration();
+    limits.maxJerk = getJerk();
+
+    TrajectoryProfileType type = getMotionProfile() == TrajectorySCurve ? TrajectorySCurve
+                                                                      : TrajectoryTrapezoidal;
+    return planner->move(Can_id, start, targetPosition, type, limits);
+}
+
+void MotionControlPosition::sendDirectPosition(double targetPosition, double maxSpeed)
+{
+    bool success = g_canTxRx->sendPositionCommand(static_cast<float>(targetPosition),
+                                     static_cast<float>(maxSpeed));
+    if (success) {
+        qDebug() << "位置指令发送成功 - 目标位置:" << targetPosition
+                 << "rad, 最大转速:" << maxSpeed << "rad/s";
+    } else {
+        qDebug() << "位置指令发送失败:" << g_canTxRx->getLastError();
+    }
+}
+
 void MotionControlPosition::onStartStopButtonClicked()
 {
     if (!isRunning) {
@@ -721,6 +774,10 @@ void MotionControlPosition::onStartStopButtonClicked()
         );
         qDebug() << "停止按钮被点击 - 停止位置控制";
 
+        // 先停止轨迹的周期发送，避免停止后又被位置设定值覆盖
+        if (planner)
+            planner->stop(Can_id);
+
         // 发送停止CAN指令
         if (g_canTxRx && g_canTxRx->isDeviceReady()) {
             bool success = g_canTxRx->sendStopCommand();
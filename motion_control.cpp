@@ -2,6 +2,9 @@
 #include <QSpacerItem>
 #include <QDebug>
 #include "can_rx_tx.h"
+#include "global_vars.h"
+#include <QGuiApplication>
+#include <QScreen>
 
 MotionControl::MotionControl(QWidget *parent)
     : QWidget(parent)
@@ -11,6 +14,8 @@ MotionControl::MotionControl(QWidget *parent)
     , motionControlWidget(new MotionControlMotion(this))
     , positionControlWidget(new MotionControlPosition(this))  // 初始化位置控制组件
     , motorStatus(new MotorStatus(this))
+    , statusRefreshTimer(new QTimer(this))
+    , statusKey(-1)
 {
     setupUI();
     // 不在这里连接，因为g_canTxRx可能还未创建
@@ -19,19 +24,40 @@ MotionControl::MotionControl(QWidget *parent)
 
 void MotionControl::setupConnections()
 {
-    // 连接CAN状态数据到电机状态显示
+    // 电机状态显示：按屏幕刷新率从遥测存储取当前电机的快照
     if (g_canTxRx) {
-        connect(g_canTxRx, &CANTxRx::statusDataReceived, this, [this](DWORD canId, float speed, float position, float current) {
-            motorStatus->updateCurrentSpeed(speed);
-            motorStatus->updateCurrentPosition(position);
-            motorStatus->updateCurrentCurrent(current);
-        }, Qt::QueuedConnection);
-        qDebug() << "✅ MotionControl: CAN状态数据已连接到电机状态显示";
+        statusSampler.setStore(g_canTxRx->telemetryStore());
+        statusKey = -1;
+
+        qreal refreshRate = 60.0;
+        QScreen *screen = QGuiApplication::primaryScreen();
+        if (screen && screen->refreshRate() > 1.0) {
+            refreshRate = screen->refreshRate();
+        }
+        disconnect(statusRefreshTimer, &QTimer::timeout, this, &MotionControl::onStatusRefresh);
+        connect(statusRefreshTimer, &QTimer::timeout, this, &MotionControl::onStatusRefresh);
+        statusRefreshTimer->start(qMax(1, qRound(1000.0 / refreshRate)));
+        qDebug() << "✅ MotionControl: 电机状态显示按" << refreshRate << "Hz刷新";
     } else {
         qDebug() << "⚠️ MotionControl: g_canTxRx为空，无法连接状态数据";
     }
 }
 
+void MotionControl::onStatusRefresh()
+{
+    // 切换电机（或命令通道）后只显示新电机此后的样本
+    int key = canNodeKey(g_canTxRx->commandChannel(), Can_id);
+    if (key != statusKey) {
+        statusSampler.skip(key);
+        statusKey = key;
+    }
+
+    CANStatusSnapshot snapshot;
+    if (statusSampler.take(key, &snapshot)) {
+        motorStatus->updateStatusSnapshot(snapshot);
+    }
+}
+
 void MotionControl::setupUI()
 {
     QHBoxLayout *mainLayout = new QHBoxLayout(this);
@@ -13,7 +13,9 @@
 #include <QRadioButton>
 #include <QDoubleSpinBox>
 #include <QFrame>
+#include <QTimer>
 #include "motor_status.h"
+#include "can_status_snapshot.h"
 #include "motion_contr_speed.h"  // 添加速度模式头文件
 #include "motion_contr_current.h"  // 添加电流控制头文件
 #include "motion_contr_mentionctr.h"
@@ -28,6 +30,7 @@ public:
 
 private slots:
     void onControlModeChanged(int mode);
+    void onStatusRefresh();
 
 private:
     void setupUI();
@@ -49,6 +52,11 @@ private:
     MotionControlCurrent *currentControlWidget;  // 添加电流控制组件
     MotionControlMotion *motionControlWidget;  // 添加运控控制组件
     MotionControlPosition *positionControlWidget;  // 添加位置控制组件
+
+    // 电机状态按显示刷新率从遥测存储取快照，不再逐样本更新标签
+    QTimer *statusRefreshTimer;
+    CANStatusSampler statusSampler;
+    int statusKey;      // 当前显示电机的节点键
     
     // 控制模式常量
     enum ControlMode {
@@ -0,0 +1,79 @@
+# 核心库源文件（只依赖QtCore），由core/core.pro编译成静态库
+# 使用核心库的工程请包含motor_can_core_link.pri
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+SOURCES += \
+    $$PWD/acquisition_engine.cpp \
+    $$PWD/can_acceptance_filter.cpp \
+    $$PWD/can_backend.cpp \
+    $$PWD/can_backend_controlcan.cpp \
+    $$PWD/can_backend_loopback.cpp \
+    $$PWD/can_backend_socketcan.cpp \
+    $$PWD/can_capture.cpp \
+    $$PWD/can_capture_replay.cpp \
+    $$PWD/can_device_manager.cpp \
+    $$PWD/can_dispatcher.cpp \
+    $$PWD/can_frame_ring.cpp \
+    $$PWD/can_group_command.cpp \
+    $$PWD/can_latency_tracer.cpp \
+    $$PWD/can_node_registry.cpp \
+    $$PWD/can_overflow_policy.cpp \
+    $$PWD/can_rx_tx.cpp \
+    $$PWD/can_rx_worker.cpp \
+    $$PWD/can_setpoint_streamer.cpp \
+    $$PWD/can_status_decoder.cpp \
+    $$PWD/can_status_snapshot.cpp \
+    $$PWD/can_telemetry_store.cpp \
+    $$PWD/can_timestamp.cpp \
+    $$PWD/can_tx_batcher.cpp \
+    $$PWD/can_types.cpp \
+    $$PWD/canthread.cpp \
+    $$PWD/can_communication_thread.cpp \
+    $$PWD/global_vars.cpp \
+    $$PWD/param_dictionary.cpp \
+    $$PWD/trajectory_planner.cpp
+
+HEADERS += \
+    $$PWD/ControlCAN.h \
+    $$PWD/acquisition_engine.h \
+    $$PWD/can_acceptance_filter.h \
+    $$PWD/can_backend.h \
+    $$PWD/can_backend_controlcan.h \
+    $$PWD/can_backend_loopback.h \
+    $$PWD/can_backend_socketcan.h \
+    $$PWD/can_capture.h \
+    $$PWD/can_capture_replay.h \
+    $$PWD/can_command_codec.h \
+    $$PWD/can_device_manager.h \
+    $$PWD/can_dispatcher.h \
+    $$PWD/can_frame_ring.h \
+    $$PWD/can_group_command.h \
+    $$PWD/can_latency_tracer.h \
+    $$PWD/can_node_registry.h \
+    $$PWD/can_overflow_policy.h \
+    $$PWD/can_rx_tx.h \
+    $$PWD/can_rx_worker.h \
+    $$PWD/can_setpoint_streamer.h \
+    $$PWD/can_status_decoder.h \
+    $$PWD/can_status_sample.h \
+    $$PWD/can_status_snapshot.h \
+    $$PWD/can_telemetry_store.h \
+    $$PWD/can_timestamp.h \
+    $$PWD/can_tx_batcher.h \
+    $$PWD/can_types.h \
+    $$PWD/canthread.h \
+    $$PWD/can_communication_thread.h \
+    $$PWD/global_vars.h \
+    $$PWD/param_dictionary.h \
+    $$PWD/trajectory_planner.h
+
+# CAN后端：Windows下使用ZLG ControlCAN库；Linux下如果存在libcontrolcan.so也启用，
+# 否则只编译SocketCAN和仿真总线后端
+win32 {
+    DEFINES += MOTOR_CAN_HAS_CONTROLCAN
+} else:exists($$PWD/libcontrolcan.so) {
+    DEFINES += MOTOR_CAN_HAS_CONTROLCAN
+}
+unix: DEFINES += __stdcall=
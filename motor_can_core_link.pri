@@ -0,0 +1,24 @@
+# 链接核心静态库（core/core.pro）及其依赖的ControlCAN库
+# 静态库输出在影子构建目录的core子目录下（Windows下再分release/debug）
+
+INCLUDEPATH += $$PWD
+DEPENDPATH += $$PWD
+
+MOTOR_CAN_CORE_DIR = $$shadowed($$PWD)/core
+win32 {
+    CONFIG(debug, debug|release): MOTOR_CAN_CORE_DIR = $$MOTOR_CAN_CORE_DIR/debug
+    else: MOTOR_CAN_CORE_DIR = $$MOTOR_CAN_CORE_DIR/release
+}
+
+LIBS += -L$$MOTOR_CAN_CORE_DIR -lmotor_can_core
+win32-msvc*: PRE_TARGETDEPS += $$MOTOR_CAN_CORE_DIR/motor_can_core.lib
+else: PRE_TARGETDEPS += $$MOTOR_CAN_CORE_DIR/libmotor_can_core.a
+
+win32 {
+    DEFINES += MOTOR_CAN_HAS_CONTROLCAN
+    LIBS += -L$$PWD -lControlCAN
+} else:exists($$PWD/libcontrolcan.so) {
+    DEFINES += MOTOR_CAN_HAS_CONTROLCAN
+    LIBS += -L$$PWD -lcontrolcan
+}
+unix: DEFINES += __stdcall=
@@ -11,13 +11,15 @@
 #include <QFrame>
 #include <QComboBox>
 
+class TrajectoryPlanner;
+
 class MotionControlPosition : public QWidget
 {
     Q_OBJECT
 
 public:
     explicit MotionControlPosition(QWidget *parent = nullptr);
-    ~MotionControlPosition() = default;
+    ~MotionControlPosition();
 
     // 获取参数值
     double getKp() const;
@@ -59,6 +61,10 @@ private slots:
 private:
     void setupUI();
     QPushButton* createControlButton(const QString &text, const QString &color = "#2196f3");
+    // 梯形/S曲线规划：在上位机生成轨迹，由周期发送线程逐周期发送位置设定值
+    bool startTrajectory(double targetPosition, double maxSpeed);
+    // 直接发送目标位置，由驱动器规划
+    void sendDirectPosition(double targetPosition, double maxSpeed);
 
     // UI 组件
     QDoubleSpinBox *kpSpin;
@@ -70,6 +76,8 @@ private:
     QDoubleSpinBox *maxSpeedSpin;  // 添加最大转速控件
     QComboBox *motionProfileCombo;
 
+    TrajectoryPlanner *planner;  // 首次使用时创建
+
     QPushButton *startStopBtn;
     QPushButton *modeSwitchBtn;
     QPushButton *homeBtn;
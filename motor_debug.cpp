@@ -8,6 +8,7 @@
 #include <QTextCursor>    // 添加这个头文件
 #include <QDateTime>      // 添加这个头文件
 #include <QApplication>
+#include <QStringList>
 #include "can_rx_tx.h"
 
 // 静态成员初始化
@@ -18,6 +19,7 @@ MotorDebug::MotorDebug(QObject *parent)
     , logTextEdit(nullptr)
     , clearButton(nullptr)
     , saveButton(nullptr)
+    , frameLogCheckBox(nullptr)
 {
     setupUI();
     
@@ -159,6 +161,11 @@ void MotorDebug::setupUI()
         "}"
     );
 
+    // 记录CAN帧（默认关闭，开启后按批订阅全部ID）
+    frameLogCheckBox = new QCheckBox("记录CAN帧");
+    frameLogCheckBox->setStyleSheet("QCheckBox { color: #cccccc; font-size: 14px; }");
+
+    buttonLayout->addWidget(frameLogCheckBox);
     buttonLayout->addWidget(clearButton);
     buttonLayout->addWidget(saveButton);
     buttonLayout->addStretch();
@@ -197,6 +204,7 @@ void MotorDebug::setupUI()
     // 连接信号槽
     connect(clearButton, &QPushButton::clicked, this, &MotorDebug::onClearButtonClicked);
     connect(saveButton, &QPushButton::clicked, this, &MotorDebug::onSaveButtonClicked);
+    connect(frameLogCheckBox, &QCheckBox::toggled, this, &MotorDebug::onFrameLogToggled);
 
     // 添加欢迎信息
     logInfo("系统日志初始化完成");
@@ -274,6 +282,44 @@ void MotorDebug::logCAN(const QString &message)
     addLogMessage(QString("[%1] CAN: %2").arg(QTime::currentTime().toString("hh:mm:ss")).arg(message), "#4caf50");
 }
 
+void MotorDebug::logCANFrames(const CANFrameBatch &frames)
+{
+    if (frames.isEmpty()) return;
+
+    QString time = QTime::currentTime().toString("hh:mm:ss");
+    QStringList lines;
+    int shown = qMin(frames.size(), static_cast<int>(MAX_FRAMES_PER_BATCH));
+    for (int i = 0; i < shown; i++) {
+        const VCI_CAN_OBJ &frame = frames.at(i);
+        QString dataHex = QByteArray(reinterpret_cast<const char*>(frame.Data), frame.DataLen).toHex(' ').toUpper();
+        lines << QString("[%1] CAN: 通道%2 ID:0x%3 %4")
+                     .arg(time)
+                     .arg(canFrameChannel(frame))
+                     .arg(frame.ID, 3, 16, QLatin1Char('0'))
+                     .arg(dataHex);
+    }
+    if (frames.size() > shown) {
+        lines << QString("[%1] CAN: ……本批另有%2帧未显示").arg(time).arg(frames.size() - shown);
+    }
+    addLogMessage(lines.join("\n"), "#4caf50");
+}
+
+void MotorDebug::onFrameLogToggled(bool enabled)
+{
+    if (!g_canTxRx) return;
+
+    CANDispatcher *dispatcher = g_canTxRx->dispatcher();
+    dispatcher->unsubscribe(this);
+    if (enabled) {
+        CANFrameHandler handler = [this](const CANFrameBatch &frames) { logCANFrames(frames); };
+        dispatcher->subscribeRange(0x000, 0x7FF, this, handler);
+        dispatcher->subscribeRange(0x00000000, 0x1FFFFFFF, this, handler, Qt::AutoConnection, true);
+        logInfo("开始记录CAN帧");
+    } else {
+        logInfo("停止记录CAN帧");
+    }
+}
+
 void MotorDebug::clearLog()
 {
     logTextEdit->clear();
@@ -6,11 +6,13 @@
 #include <QVBoxLayout>
 #include <QHBoxLayout>
 #include <QPushButton>
+#include <QCheckBox>
 #include <QLabel>
 #include <QTime>
 #include <QScrollBar>
 #include <QTextDocument>  // 添加这个头文件
 #include <QTextCursor>    // 添加这个头文件
+#include "can_types.h"
 
 class MotorDebug : public QObject
 {
@@ -33,6 +35,8 @@ public:
     // static void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
     static MotorDebug* instance;
     void logCAN(const QString &message);
+    // 一批CAN帧合并为一次日志追加
+    void logCANFrames(const CANFrameBatch &frames);
 
     // 清空日志
     void clearLog();
@@ -40,6 +44,7 @@ public:
 private slots:
     void onClearButtonClicked();
     void onSaveButtonClicked();
+    void onFrameLogToggled(bool enabled);
 
 private:
     void setupUI();
@@ -49,6 +54,9 @@ private:
     QTextEdit *logTextEdit;
     QPushButton *clearButton;
     QPushButton *saveButton;
+    QCheckBox *frameLogCheckBox;
+
+    static const int MAX_FRAMES_PER_BATCH = 20;   // 每批最多显示的帧数，其余只计数
 
     static const int MAX_LOG_LINES = 1000; // 最大日志行数
 };
@@ -8,6 +8,7 @@ MotorStatus::MotorStatus(QWidget *parent)
     , currentSpeedLabel(nullptr)
     , currentCurrentLabel(nullptr)
     , currentPositionLabel(nullptr)
+    , peakCheckBox(nullptr)
     , motorTemperature(0.0)
     , controlBoardTemperature(0.0)
     , currentSpeed(0.0)
@@ -119,6 +120,18 @@ void MotorStatus::setupUI()
     statusLayout->addRow(currentCurrentText, currentCurrentLabel);
     statusLayout->addRow(currentPositionText, currentPositionLabel);
 
+    // 区间极值：两次刷新之间的最小/最大值，避免按刷新率采样漏掉峰值
+    peakCheckBox = new QCheckBox("显示刷新区间内最小/最大值");
+    peakCheckBox->setChecked(true);
+    peakCheckBox->setStyleSheet(
+        "QCheckBox {"
+        "    color: #cccccc;"
+        "    font-size: 14px;"
+        "    border: none;"
+        "}"
+    );
+    statusLayout->addRow(peakCheckBox);
+
     // 状态说明区域
     QWidget *descContainer = new QWidget();
     descContainer->setStyleSheet(
@@ -215,6 +228,43 @@ void MotorStatus::updateCurrentPosition(double position)
     currentPositionLabel->setText(QString::number(position, 'f', 3) + " rad");
 }
 
+void MotorStatus::updateStatusSnapshot(const CANStatusSnapshot &snapshot)
+{
+    currentSpeed = snapshot.latest.speed;
+    currentCurrent = snapshot.latest.current;
+    currentPosition = snapshot.latest.position;
+
+    currentSpeedLabel->setText(formatValue(snapshot.latest.speed, 1, "rad/s",
+                                           snapshot.speedMin, snapshot.speedMax));
+    currentCurrentLabel->setText(formatValue(snapshot.latest.current, 1, "A",
+                                             snapshot.currentMin, snapshot.currentMax));
+    currentPositionLabel->setText(formatValue(snapshot.latest.position, 3, "rad",
+                                              snapshot.positionMin, snapshot.positionMax));
+}
+
+QString MotorStatus::formatValue(double value, int precision, const QString &unit,
+                                 double minValue, double maxValue) const
+{
+    QString text = QString::number(value, 'f', precision) + " " + unit;
+    if (!showPeaks()) {
+        return text;
+    }
+    return QString("%1<br><span style=\"font-size:12px; color:#aaaaaa;\">%2 ~ %3</span>")
+            .arg(text)
+            .arg(minValue, 0, 'f', precision)
+            .arg(maxValue, 0, 'f', precision);
+}
+
+void MotorStatus::setShowPeaks(bool show)
+{
+    peakCheckBox->setChecked(show);
+}
+
+bool MotorStatus::showPeaks() const
+{
+    return peakCheckBox && peakCheckBox->isChecked();
+}
+
 double MotorStatus::getMotorTemperature() const
 {
     return motorTemperature;
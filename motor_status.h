@@ -7,6 +7,8 @@
 #include <QFormLayout>
 #include <QLabel>
 #include <QPushButton>
+#include <QCheckBox>
+#include "can_status_snapshot.h"
 
 class MotorStatus : public QWidget
 {
@@ -21,6 +23,10 @@ public:
     void updateCurrentSpeed(double speed);
     void updateCurrentCurrent(double current);
     void updateCurrentPosition(double position);
+    // 按刷新节奏显示节点快照（最新值，开启时附带区间最小/最大值）
+    void updateStatusSnapshot(const CANStatusSnapshot &snapshot);
+    void setShowPeaks(bool show);
+    bool showPeaks() const;
 
     // 获取当前状态值
     double getMotorTemperature() const;
@@ -37,6 +43,7 @@ private slots:
 
 private:
     void setupUI();
+    QString formatValue(double value, int precision, const QString &unit, double minValue, double maxValue) const;
 
     // UI 组件
     QLabel *motorTempLabel;
@@ -44,6 +51,7 @@ private:
     QLabel *currentSpeedLabel;
     QLabel *currentCurrentLabel;
     QLabel *currentPositionLabel;
+    QCheckBox *peakCheckBox;
 
     // 状态值
     double motorTemperature;
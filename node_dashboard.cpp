@@ -0,0 +1,314 @@
+#include "node_dashboard.h"
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QBrush>
+#include <QColor>
+#include <QDebug>
+#include "can_rx_tx.h"
+#include "can_timestamp.h"
+
+namespace {
+    const int REFRESH_INTERVAL_MS = 100;   // 表格按10Hz刷新，节点数多时仍然轻量
+    const double RATE_FILTER = 0.3;        // 帧率显示的低通系数
+}
+
+NodeDashboard::NodeDashboard(QWidget *parent)
+    : QWidget(parent)
+    , m_canTxRx(nullptr)
+    , m_registry(nullptr)
+    , m_refreshTimer(new QTimer(this))
+    , m_table(nullptr)
+    , m_summaryLabel(nullptr)
+    , m_onlineOnlyCheckBox(nullptr)
+    , m_syncCobIdSpin(nullptr)
+    , m_startAllButton(nullptr)
+    , m_stopAllButton(nullptr)
+    , m_updating(false)
+{
+    setupUI();
+    connect(m_refreshTimer, &QTimer::timeout, this, &NodeDashboard::onRefresh);
+}
+
+void NodeDashboard::setupUI()
+{
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setContentsMargins(12, 12, 12, 12);
+    mainLayout->setSpacing(10);
+
+    QLabel *titleLabel = new QLabel("多轴节点监视");
+    titleLabel->setStyleSheet(
+        "QLabel {"
+        "    color: #ffffff;"
+        "    font-size: 18px;"
+        "    font-weight: bold;"
+        "    padding: 8px 0px;"
+        "    border-bottom: 1px solid #555555;"
+        "}"
+    );
+
+    QHBoxLayout *toolLayout = new QHBoxLayout();
+    m_summaryLabel = new QLabel("在线 0 / 已发现 0");
+    m_summaryLabel->setStyleSheet("QLabel { color: #4fc3f7; font-size: 15px; font-weight: bold; }");
+    m_onlineOnlyCheckBox = new QCheckBox("只显示在线节点");
+    m_onlineOnlyCheckBox->setStyleSheet("QCheckBox { color: #cccccc; font-size: 14px; }");
+    // 同步帧默认不追加：固件是否支持未确认，COB-ID需按固件填写（十六进制）
+    m_syncCobIdSpin = new QSpinBox();
+    m_syncCobIdSpin->setRange(CAN_SYNC_COB_ID_NONE, 0x7FF);
+    m_syncCobIdSpin->setDisplayIntegerBase(16);
+    m_syncCobIdSpin->setPrefix("同步帧 0x");
+    m_syncCobIdSpin->setSpecialValueText("不追加同步帧");
+    m_syncCobIdSpin->setValue(CAN_SYNC_COB_ID_NONE);
+    m_syncCobIdSpin->setStyleSheet("QSpinBox { color: #cccccc; font-size: 14px; }");
+    m_startAllButton = new QPushButton("全部启动");
+    m_stopAllButton = new QPushButton("全部停止");
+    QLabel *hintLabel = new QLabel("双击节点行设为当前命令目标，名称列可编辑");
+    hintLabel->setStyleSheet("QLabel { color: #888888; font-size: 13px; }");
+    toolLayout->addWidget(m_summaryLabel);
+    toolLayout->addSpacing(20);
+    toolLayout->addWidget(m_onlineOnlyCheckBox);
+    toolLayout->addSpacing(20);
+    toolLayout->addWidget(m_startAllButton);
+    toolLayout->addWidget(m_stopAllButton);
+    toolLayout->addWidget(m_syncCobIdSpin);
+    toolLayout->addStretch();
+    toolLayout->addWidget(hintLabel);
+
+    m_table = new QTableWidget(0, COL_COUNT);
+    QStringList headers;
+    headers << "节点" << "名称" << "通道" << "状态" << "速度(rad/s)" << "位置(rad)"
+            << "电流(A)" << "电流区间(A)" << "帧率(Hz)" << "最大间隔(ms)" << "距上次(ms)" << "样本数";
+    m_table->setHorizontalHeaderLabels(headers);
+    m_table->verticalHeader()->setVisible(false);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    m_table->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_table->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_table->setEditTriggers(QAbstractItemView::DoubleClicked | QAbstractItemView::EditKeyPressed);
+    m_table->setStyleSheet(
+        "QTableWidget {"
+        "    background-color: #3a3a3a;"
+        "    color: #ffffff;"
+        "    gridline-color: #555555;"
+        "    font-size: 14px;"
+        "}"
+        "QHeaderView::section {"
+        "    background-color: #454545;"
+        "    color: #ffffff;"
+        "    border: 1px solid #555555;"
+        "    padding: 4px;"
+        "}"
+    );
+
+    mainLayout->addWidget(titleLabel);
+    mainLayout->addLayout(toolLayout);
+    mainLayout->addWidget(m_table);
+
+    connect(m_table, &QTableWidget::cellDoubleClicked, this, &NodeDashboard::onCellDoubleClicked);
+    connect(m_table, &QTableWidget::itemChanged, this, &NodeDashboard::onItemChanged);
+    connect(m_onlineOnlyCheckBox, &QCheckBox::toggled, this, &NodeDashboard::onRefresh);
+    connect(m_startAllButton, &QPushButton::clicked, this, &NodeDashboard::onStartAllClicked);
+    connect(m_stopAllButton, &QPushButton::clicked, this, &NodeDashboard::onStopAllClicked);
+}
+
+void NodeDashboard::setCANTxRx(CANTxRx *canTxRx)
+{
+    m_canTxRx = canTxRx;
+    m_registry = canTxRx ? canTxRx->nodeRegistry() : nullptr;
+    m_sampler.setStore(canTxRx ? canTxRx->telemetryStore() : nullptr);
+
+    if (m_registry) {
+        m_refreshTimer->start(REFRESH_INTERVAL_MS);
+        qDebug() << "✅ NodeDashboard: 节点监视已连接，刷新周期" << REFRESH_INTERVAL_MS << "ms";
+    } else {
+        m_refreshTimer->stop();
+    }
+}
+
+int NodeDashboard::rowForNode(int key)
+{
+    auto it = m_rows.find(key);
+    if (it != m_rows.end())
+        return it->row;
+
+    // 按节点键（通道号、节点号）顺序插入，其后的行下移
+    int row = 0;
+    for (auto other = m_rows.begin(); other != m_rows.end(); ++other) {
+        if (other.key() < key)
+            row++;
+    }
+    for (auto other = m_rows.begin(); other != m_rows.end(); ++other) {
+        if (other->row >= row)
+            other->row++;
+    }
+    m_table->insertRow(row);
+    for (int column = 0; column < COL_COUNT; column++) {
+        QTableWidgetItem *item = new QTableWidgetItem();
+        item->setTextAlignment(Qt::AlignCenter);
+        if (column != COL_NAME)
+            item->setFlags(Qt::ItemIsSelectable | Qt::ItemIsEnabled);
+        m_table->setItem(row, column, item);
+    }
+    m_table->item(row, COL_NODE)->setText(QString::number(canNodeKeyNode(key)));
+    m_table->item(row, COL_NODE)->setData(Qt::UserRole, key);
+    m_table->item(row, COL_CHANNEL)->setText(QString::number(canNodeKeyChannel(key)));
+    m_table->item(row, COL_NAME)->setText(m_registry->nodeName(key));
+
+    RowState state;
+    state.row = row;
+    state.samples = 0;
+    state.timeUs = 0;
+    state.rateHz = 0.0;
+    m_rows.insert(key, state);
+    return row;
+}
+
+void NodeDashboard::setCell(int row, int column, const QString &text)
+{
+    QTableWidgetItem *item = m_table->item(row, column);
+    if (item && item->text() != text)
+        item->setText(text);
+}
+
+void NodeDashboard::onRefresh()
+{
+    if (!m_registry || !isVisible())
+        return;
+
+    m_updating = true;
+    qint64 nowUs = canMonotonicUs();
+    QVector<int> nodes = m_registry->knownNodes();
+    bool onlineOnly = m_onlineOnlyCheckBox->isChecked();
+    int online = 0;
+
+    for (int key : nodes) {
+        CANNodeRegistry::NodeInfo info = m_registry->info(key, nowUs, true);
+        int row = rowForNode(key);
+        RowState &state = m_rows[key];
+
+        // 帧率按两次刷新之间的样本增量计算
+        if (state.timeUs > 0 && nowUs > state.timeUs) {
+            double rate = (info.samples - state.samples) * 1e6 / (nowUs - state.timeUs);
+            state.rateHz += (rate - state.rateHz) * RATE_FILTER;
+        }
+        state.samples = info.samples;
+        state.timeUs = nowUs;
+        if (!info.online)
+            state.rateHz = 0.0;
+
+        CANStatusSnapshot snapshot;
+        if (m_sampler.take(key, &snapshot)) {
+            setCell(row, COL_SPEED, QString::number(snapshot.latest.speed, 'f', 1));
+            setCell(row, COL_POSITION, QString::number(snapshot.latest.position, 'f', 3));
+            setCell(row, COL_CURRENT, QString::number(snapshot.latest.current, 'f', 2));
+            setCell(row, COL_CURRENT_RANGE, QString("%1 ~ %2")
+                    .arg(snapshot.currentMin, 0, 'f', 2)
+                    .arg(snapshot.currentMax, 0, 'f', 2));
+        }
+
+        setCell(row, COL_STATE, info.online ? "在线" : "离线");
+        m_table->item(row, COL_STATE)->setForeground(QBrush(QColor(info.online ? "#66bb6a" : "#ef5350")));
+        setCell(row, COL_RATE, QString::number(state.rateHz, 'f', 0));
+        setCell(row, COL_MAX_INTERVAL, QString::number(info.maxIntervalUs / 1000.0, 'f', 1));
+        setCell(row, COL_LAST_SEEN, QString::number(qMax<qint64>(0, nowUs - info.lastSeenUs) / 1000));
+        setCell(row, COL_SAMPLES, QString::number(info.samples));
+
+        m_table->setRowHidden(row, onlineOnly && !info.online);
+        if (info.online)
+            online++;
+    }
+
+    m_summaryLabel->setText(QString("在线 %1 / 已发现 %2").arg(online).arg(nodes.size()));
+    m_updating = false;
+}
+
+void NodeDashboard::onCellDoubleClicked(int row, int column)
+{
+    if (column == COL_NAME)
+        return;
+    QTableWidgetItem *item = m_table->item(row, COL_NODE);
+    if (!item)
+        return;
+    int key = item->data(Qt::UserRole).toInt();
+    int node = canNodeKeyNode(key);
+    qDebug() << "节点监视选中节点:" << node << "通道:" << canNodeKeyChannel(key);
+    if (m_canTxRx && static_cast<int>(m_canTxRx->commandChannel()) != canNodeKeyChannel(key))
+        qDebug() << "⚠️ 节点监视：该节点不在当前命令通道" << m_canTxRx->commandChannel() << "上";
+    emit nodeSelected(node);
+}
+
+void NodeDashboard::onItemChanged(QTableWidgetItem *item)
+{
+    if (m_updating || !m_registry || !item || item->column() != COL_NAME)
+        return;
+    QTableWidgetItem *nodeItem = m_table->item(item->row(), COL_NODE);
+    if (nodeItem)
+        m_registry->setNodeName(nodeItem->data(Qt::UserRole).toInt(), item->text().trimmed());
+}
+
+void NodeDashboard::onStartAllClicked()
+{
+    sendToNodes(true);
+}
+
+void NodeDashboard::onStopAllClicked()
+{
+    sendToNodes(false);
+}
+
+void NodeDashboard::sendToNodes(bool start)
+{
+    if (!m_canTxRx || !m_registry)
+        return;
+
+    // 按节点所在通道分组，每个通道一组命令；-1为当前命令通道
+    // 启动只发给在线节点；停止发给所有见过的节点，状态反馈暂时超时的节点同样要停下
+    qint64 nowUs = canMonotonicUs();
+    QMap<int, QVector<int>> channels;
+    QVector<int> knownNodes = m_registry->knownNodes();
+    for (int key : knownNodes) {
+        CANNodeRegistry::NodeInfo info = m_registry->info(key, nowUs);
+        if (info.online || !start)
+            channels[info.channel].append(info.node);
+    }
+    if (!start) {
+        // 先停止周期发送（含轨迹），否则停止命令发出后设定值仍以最高2kHz继续发送；
+        // 正在周期发送但从未收到状态的节点也一并停止
+        // 周期发送走当前命令通道，已在该通道上登记的节点上面已经加入
+        CANSetpointStreamer *streamer = m_canTxRx->setpointStreamer();
+        int commandChannel = static_cast<int>(m_canTxRx->commandChannel());
+        for (int node = 0; node < CANSetpointStreamer::MAX_NODES; node++) {
+            if (streamer->isStreaming(static_cast<uint8_t>(node))
+                    && !m_registry->isKnown(canNodeKey(commandChannel, node)))
+                channels[-1].append(node);
+        }
+        streamer->clear();
+    }
+    if (channels.isEmpty()) {
+        qDebug() << (start ? "节点监视：没有在线节点" : "节点监视：没有已知节点");
+        return;
+    }
+
+    UINT syncCobId = static_cast<UINT>(m_syncCobIdSpin->value());
+    if (syncCobId != CAN_SYNC_COB_ID_NONE && canSyncCobIdCollides(syncCobId)) {
+        qDebug() << "节点监视：同步帧COB-ID" << QString("0x%1").arg(syncCobId, 3, 16, QChar('0'))
+                 << "与命令/状态/SDO/心跳帧冲突，不追加同步帧";
+        syncCobId = CAN_SYNC_COB_ID_NONE;
+    }
+
+    CANGroupCommand group;
+    group.setSyncCobId(syncCobId);
+    for (auto it = channels.begin(); it != channels.end(); ++it) {
+        group.clear();
+        for (int node : it.value()) {
+            if (start)
+                group.addStart(static_cast<uint8_t>(node));
+            else
+                group.addStop(static_cast<uint8_t>(node));
+        }
+        bool ok = m_canTxRx->deviceManager() && it.key() >= 0
+                ? m_canTxRx->sendGroupCommandTo(static_cast<UINT>(it.key()), group)
+                : m_canTxRx->sendGroupCommand(group);
+        qDebug() << "节点监视：通道" << it.key() << (start ? "全部启动" : "全部停止")
+                 << it.value().size() << "个节点" << (ok ? "已发送" : "发送失败");
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef NODE_DASHBOARD_H
+#define NODE_DASHBOARD_H
+
+#include <QWidget>
+#include <QTableWidget>
+#include <QLabel>
+#include <QCheckBox>
+#include <QSpinBox>
+#include <QPushButton>
+#include <QTimer>
+#include <QMap>
+#include "can_status_snapshot.h"
+#include "can_node_registry.h"
+
+class CANTxRx;
+
+// 多轴节点监视：一张表显示总线上全部节点的状态、帧率和通信间隔
+// 每行对应一个节点键（通道号, 节点号），不同总线上的同号节点分行显示
+// 数值按刷新周期从遥测存储取快照（带区间最小/最大值），在线状态和间隔取自节点登记
+// 双击一行选中该节点作为命令目标（nodeSelected）
+// 全部启动/停止按通道对所有在线节点发送成组命令，各轴在同一次总线突发中收到
+class NodeDashboard : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit NodeDashboard(QWidget *parent = nullptr);
+
+    // 在g_canTxRx创建后调用
+    void setCANTxRx(CANTxRx *canTxRx);
+
+signals:
+    void nodeSelected(int node);
+
+private slots:
+    void onRefresh();
+    void onCellDoubleClicked(int row, int column);
+    void onItemChanged(QTableWidgetItem *item);
+    void onStartAllClicked();
+    void onStopAllClicked();
+
+private:
+    enum Column {
+        COL_NODE = 0,
+        COL_NAME,
+        COL_CHANNEL,
+        COL_STATE,
+        COL_SPEED,
+        COL_POSITION,
+        COL_CURRENT,
+        COL_CURRENT_RANGE,
+        COL_RATE,
+        COL_MAX_INTERVAL,
+        COL_LAST_SEEN,
+        COL_SAMPLES,
+        COL_COUNT
+    };
+
+    // 每行的上次刷新数据，用于计算帧率
+    struct RowState {
+        int row;
+        quint64 samples;
+        qint64 timeUs;
+        double rateHz;
+    };
+
+    void setupUI();
+    int rowForNode(int key);
+    void setCell(int row, int column, const QString &text);
+    // 成组发送启动（在线节点）/停止（所有已知节点，并先停止周期发送）
+    void sendToNodes(bool start);
+
+    CANTxRx *m_canTxRx;
+    CANNodeRegistry *m_registry;
+    CANStatusSampler m_sampler;
+    QTimer *m_refreshTimer;
+    QTableWidget *m_table;
+    QLabel *m_summaryLabel;
+    QCheckBox *m_onlineOnlyCheckBox;
+    QSpinBox *m_syncCobIdSpin;     // 成组命令末尾的同步帧COB-ID，0为不追加
+    QPushButton *m_startAllButton;
+    QPushButton *m_stopAllButton;
+    QMap<int, RowState> m_rows;    // 按节点键
+    bool m_updating;
+};
+
+#endif // NODE_DASHBOARD_H
@@ -0,0 +1,16 @@
+# 无界面CAN数据记录：只依赖QtCore，不需要X服务器
+# 记录状态反馈样本、数据上抛通道数据（CSV）和/或二进制抓包
+QT = core
+
+CONFIG += console c++11
+CONFIG -= app_bundle
+
+TEMPLATE = app
+TARGET = can_logger
+
+DEFINES += QT_DEPRECATED_WARNINGS
+
+include(../../motor_can_core_link.pri)
+
+SOURCES += \
+    main.cpp
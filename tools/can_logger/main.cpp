@@ -0,0 +1,241 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QFile>
+#include <QTextStream>
+#include <QTimer>
+#include <QAtomicInt>
+#include <csignal>
+#include <cstdio>
+#include "acquisition_engine.h"
+#include "can_device_manager.h"
+#include "can_rx_tx.h"
+#include "can_status_sample.h"
+#include "global_vars.h"
+
+// 无界面CAN数据记录：打开适配器，按需记录
+//   --status-csv  状态反馈样本（所有节点，帧到达时间）
+//   --scope-csv   数据上抛通道数据（--param指定参数，最多4个通道）
+//   --capture     二进制抓包（格式见can_capture.h，可在界面程序中回放）
+//   --latency-csv 退出时导出请求/应答往返延迟统计（见can_latency_tracer.h）
+// 到达--duration秒数或收到SIGINT/SIGTERM后停止，写完文件退出
+
+namespace {
+    QAtomicInt g_stopRequested(0);
+
+    void onStopSignal(int)
+    {
+        g_stopRequested.store(1);
+    }
+
+    bool parseBackend(const QString &name, CANBackend::Type *type)
+    {
+        QString lower = name.toLower();
+        if (lower == "controlcan" || lower == "usbcan") {
+            *type = CANBackend::ControlCANType;
+        } else if (lower == "socketcan") {
+            *type = CANBackend::SocketCANType;
+        } else if (lower == "loopback" || lower == "sim") {
+            *type = CANBackend::LoopbackType;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    // "6064:00" 或 "0x6064:0"，索引和子索引均按十六进制解析
+    bool parseParameter(const QString &text, uint16_t *index, uint8_t *subindex)
+    {
+        QStringList parts = text.split(':');
+        if (parts.size() > 2)
+            return false;
+        bool ok = false;
+        uint value = parts[0].trimmed().toUInt(&ok, 16);
+        if (!ok || value > 0xFFFF)
+            return false;
+        *index = static_cast<uint16_t>(value);
+        *subindex = 0;
+        if (parts.size() == 2) {
+            value = parts[1].trimmed().toUInt(&ok, 16);
+            if (!ok || value > 0xFF)
+                return false;
+            *subindex = static_cast<uint8_t>(value);
+        }
+        return true;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("can_logger");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("无界面CAN数据记录");
+    parser.addHelpOption();
+    QCommandLineOption backendOption("backend", "CAN后端: controlcan | socketcan | loopback（默认按MOTOR_CAN_BACKEND环境变量）", "name");
+    QCommandLineOption deviceOption("device", "适配器索引（默认0）", "index", "0");
+    QCommandLineOption bitrateOption("bitrate", "波特率kbps（默认1000）", "kbps", "1000");
+    QCommandLineOption durationOption("duration", "记录秒数，0表示直到收到中断信号（默认0）", "seconds", "0");
+    QCommandLineOption statusOption("status-csv", "状态反馈样本CSV文件", "path");
+    QCommandLineOption scopeOption("scope-csv", "数据上抛通道数据CSV文件", "path");
+    QCommandLineOption nodeOption("node", "数据上抛目标节点（默认5）", "id", "5");
+    QCommandLineOption paramOption("param", "数据上抛参数 index:subindex（十六进制，可重复，最多4个）", "index:sub");
+    QCommandLineOption intervalOption("interval", "数据上抛请求间隔ms（默认25）", "ms",
+                                      QString::number(AcquisitionEngine::DEFAULT_REQUEST_INTERVAL_MS));
+    QCommandLineOption captureOption("capture", "二进制抓包文件", "path");
+    QCommandLineOption latencyOption("latency-csv", "退出时导出请求/应答延迟统计CSV", "path");
+    parser.addOptions({ backendOption, deviceOption, bitrateOption, durationOption, statusOption,
+                        scopeOption, nodeOption, paramOption, intervalOption, captureOption, latencyOption });
+    parser.process(app);
+
+    CANBackend::Type backendType = CANBackend::defaultType();
+    if (parser.isSet(backendOption) && !parseBackend(parser.value(backendOption), &backendType)) {
+        fprintf(stderr, "未知的CAN后端: %s\n", qPrintable(parser.value(backendOption)));
+        return 1;
+    }
+    if (!CANBackend::isAvailable(backendType)) {
+        fprintf(stderr, "CAN后端不可用: %s\n", qPrintable(CANBackend::typeName(backendType)));
+        return 1;
+    }
+
+    QVector<ChannelConfig> channels;
+    for (const QString &text : parser.values(paramOption)) {
+        ChannelConfig config;
+        if (!parseParameter(text, &config.parameterIndex, &config.parameterSubindex)) {
+            fprintf(stderr, "参数格式错误: %s\n", qPrintable(text));
+            return 1;
+        }
+        if (channels.size() >= AcquisitionEngine::MAX_CHANNELS) {
+            fprintf(stderr, "数据上抛最多%d个通道\n", AcquisitionEngine::MAX_CHANNELS);
+            return 1;
+        }
+        config.channelIndex = channels.size();
+        config.enabled = true;
+        channels.append(config);
+    }
+    if (parser.isSet(scopeOption) && channels.isEmpty()) {
+        fprintf(stderr, "--scope-csv需要至少一个--param\n");
+        return 1;
+    }
+    if (!parser.isSet(statusOption) && !parser.isSet(scopeOption) && !parser.isSet(captureOption)) {
+        fprintf(stderr, "未指定记录内容（--status-csv / --scope-csv / --capture）\n");
+        return 1;
+    }
+
+    CANDeviceManager manager;
+    int slot = manager.openDevice(backendType, 4, parser.value(deviceOption).toUInt(),
+                                  parser.value(bitrateOption).toUInt());
+    if (slot < 0) {
+        fprintf(stderr, "打开CAN适配器失败\n");
+        return 2;
+    }
+
+    CANTxRx txrx;
+    g_canTxRx = &txrx;
+    txrx.setDeviceManager(&manager);
+
+    // 状态样本：接收线程按批解码，每批一个事件
+    QFile statusFile;
+    QTextStream statusStream;
+    quint64 statusSamples = 0;
+    if (parser.isSet(statusOption)) {
+        statusFile.setFileName(parser.value(statusOption));
+        if (!statusFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            fprintf(stderr, "无法创建文件 %s\n", qPrintable(statusFile.fileName()));
+            return 2;
+        }
+        statusStream.setDevice(&statusFile);
+        statusStream << "time_us,node,channel,speed,position,current\n";
+        QObject::connect(&txrx, &CANTxRx::statusSamplesReceived, &app,
+                         [&statusStream, &statusSamples](const CANStatusBatch &samples) {
+            for (const CANStatusSample &sample : samples) {
+                statusStream << sample.timeUs << ',' << int(sample.node) << ',' << int(sample.channel) << ','
+                             << sample.speed << ',' << sample.position << ',' << sample.current << '\n';
+            }
+            statusSamples += static_cast<quint64>(samples.size());
+        });
+    }
+
+    // 数据上抛：与示波器界面相同的采集引擎
+    AcquisitionEngine engine;
+    QFile scopeFile;
+    QTextStream scopeStream;
+    quint64 scopePoints = 0;
+    if (parser.isSet(scopeOption)) {
+        scopeFile.setFileName(parser.value(scopeOption));
+        if (!scopeFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            fprintf(stderr, "无法创建文件 %s\n", qPrintable(scopeFile.fileName()));
+            return 2;
+        }
+        scopeStream.setDevice(&scopeFile);
+        scopeStream << "time_s,channel,value,name\n";
+
+        for (ChannelConfig &config : channels) {
+            config.parameterName = engine.getParameterName(config.parameterIndex, config.parameterSubindex);
+        }
+        engine.setCANTxRx(&txrx);
+        engine.setNodeId(static_cast<uint8_t>(parser.value(nodeOption).toUInt()));
+        engine.setChannelConfigs(channels);
+        engine.setRequestInterval(parser.value(intervalOption).toInt());
+        QObject::connect(&engine, &AcquisitionEngine::dataPointAdded, &app,
+                         [&scopeStream, &scopePoints](const QString &key, double timestamp, double value, const QString &name) {
+            scopeStream << QString::number(timestamp, 'f', 6) << ',' << key << ',' << value << ',' << name << '\n';
+            scopePoints++;
+        });
+    }
+
+    if (parser.isSet(captureOption) && !txrx.startCapture(parser.value(captureOption))) {
+        fprintf(stderr, "无法开始抓包录制 %s\n", qPrintable(parser.value(captureOption)));
+        return 2;
+    }
+
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+
+    QTimer stopPoll;
+    QObject::connect(&stopPoll, &QTimer::timeout, &app, [&app]() {
+        if (g_stopRequested.load())
+            app.quit();
+    });
+    stopPoll.start(100);
+
+    int duration = parser.value(durationOption).toInt();
+    if (duration > 0) {
+        QTimer::singleShot(duration * 1000, &app, &QCoreApplication::quit);
+    }
+
+    txrx.startReceiving(true);
+    if (parser.isSet(scopeOption)) {
+        engine.start();
+    }
+    printf("开始记录（%s，设备%d）...\n", qPrintable(CANBackend::typeName(backendType)),
+           parser.value(deviceOption).toInt());
+    fflush(stdout);
+
+    app.exec();
+
+    engine.stop();
+    txrx.stopCapture();
+    txrx.stopReceiving();
+    // 处理接收线程停止前已投递的批次
+    QCoreApplication::processEvents();
+
+    CANTxRx::CANStatistics stats = txrx.getStatistics();
+    printf("接收 %d 帧，状态样本 %llu，数据上抛点 %llu，环形缓冲溢出 %d\n",
+           stats.framesReceived, static_cast<unsigned long long>(statusSamples),
+           static_cast<unsigned long long>(scopePoints), stats.queueOverflows);
+
+    if (parser.isSet(latencyOption)) {
+        QString error;
+        if (!txrx.latencyTracer()->dumpToFile(parser.value(latencyOption), &error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+        }
+    }
+
+    statusStream.flush();
+    scopeStream.flush();
+    txrx.setDeviceManager(nullptr);
+    g_canTxRx = nullptr;
+    manager.closeAll();
+    return 0;
+}
@@ -0,0 +1,414 @@
+#include "trajectory_planner.h"
+#include "can_command_codec.h"
+#include "can_timestamp.h"
+#include <QDebug>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+    const int BISECT_ITERATIONS = 60;
+    const double EPSILON = 1e-9;
+
+    // 速度改变dv（取绝对值）所需时间：梯形为dv/a；S曲线加速度能到上限时为dv/a + a/j，否则为2*sqrt(dv/j)
+    double velocityChangeTime(double dv, double accelLimit, bool sCurve, double jerkLimit)
+    {
+        dv = std::fabs(dv);
+        if (!sCurve)
+            return dv / accelLimit;
+        if (dv * jerkLimit >= accelLimit * accelLimit)
+            return dv / accelLimit + accelLimit / jerkLimit;
+        return 2.0 * std::sqrt(dv / jerkLimit);
+    }
+
+    // 加速段关于中点对称，位移 = 平均速度 * 时间
+    double velocityChangeDistance(double v0, double v1, double accelLimit, bool sCurve, double jerkLimit)
+    {
+        return 0.5 * (v0 + v1) * velocityChangeTime(v1 - v0, accelLimit, sCurve, jerkLimit);
+    }
+}
+
+TrajectoryProfile::TrajectoryProfile()
+    : m_type(TrajectoryTrapezoidal)
+    , m_start(0.0)
+    , m_startVelocity(0.0)
+    , m_target(0.0)
+    , m_duration(0.0)
+    , m_endPosition(0.0)
+    , m_endVelocity(0.0)
+    , m_count(0)
+{
+    m_limits.maxVelocity = 0.0;
+    m_limits.maxAcceleration = 0.0;
+    m_limits.maxDeceleration = 0.0;
+    m_limits.maxJerk = 0.0;
+}
+
+void TrajectoryProfile::reset(double start, double startVelocity)
+{
+    m_count = 0;
+    m_duration = 0.0;
+    m_endPosition = start;
+    m_endVelocity = startVelocity;
+}
+
+void TrajectoryProfile::append(double duration, double acceleration, double jerk)
+{
+    if (duration <= EPSILON || m_count >= MAX_SEGMENTS)
+        return;
+    Segment &segment = m_segments[m_count++];
+    segment.t0 = m_duration;
+    segment.duration = duration;
+    segment.position = m_endPosition;
+    segment.velocity = m_endVelocity;
+    segment.acceleration = acceleration;
+    segment.jerk = jerk;
+
+    double t = duration;
+    m_endPosition += m_endVelocity * t + acceleration * t * t / 2.0 + jerk * t * t * t / 6.0;
+    m_endVelocity += acceleration * t + jerk * t * t / 2.0;
+    m_duration += duration;
+}
+
+void TrajectoryProfile::appendVelocityChange(double deltaV, double accelLimit, bool sCurve, double jerkLimit)
+{
+    double dv = std::fabs(deltaV);
+    if (dv <= EPSILON)
+        return;
+    double s = deltaV > 0 ? 1.0 : -1.0;
+
+    if (!sCurve) {
+        append(dv / accelLimit, s * accelLimit, 0.0);
+    } else if (dv * jerkLimit >= accelLimit * accelLimit) {
+        // 加加速 - 匀加速 - 减加速
+        double tj = accelLimit / jerkLimit;
+        append(tj, 0.0, s * jerkLimit);
+        append(dv / accelLimit - tj, s * accelLimit, 0.0);
+        append(tj, s * accelLimit, -s * jerkLimit);
+    } else {
+        // 加速度达不到上限：加加速 - 减加速
+        double tj = std::sqrt(dv / jerkLimit);
+        append(tj, 0.0, s * jerkLimit);
+        append(tj, s * jerkLimit * tj, -s * jerkLimit);
+    }
+}
+
+bool TrajectoryProfile::plan(TrajectoryProfileType type, double start, double startVelocity, double target,
+                             const TrajectoryLimits &limits)
+{
+    if (!(limits.maxVelocity > 0.0) || !(limits.maxAcceleration > 0.0) || !(limits.maxDeceleration > 0.0)
+            || (type == TrajectorySCurve && !(limits.maxJerk > 0.0))) {
+        return false;
+    }
+    if (!std::isfinite(start) || !std::isfinite(startVelocity) || !std::isfinite(target)) {
+        return false;
+    }
+
+    m_type = type;
+    m_limits = limits;
+    m_start = start;
+    m_startVelocity = startVelocity;
+    m_target = target;
+    return planFrom(start, startVelocity);
+}
+
+bool TrajectoryProfile::planFrom(double start, double startVelocity)
+{
+    const bool sCurve = (m_type == TrajectorySCurve);
+    const double vmax = m_limits.maxVelocity;
+    const double acc = m_limits.maxAcceleration;
+    const double dec = m_limits.maxDeceleration;
+    const double jerk = m_limits.maxJerk;
+
+    reset(start, startVelocity);
+
+    double distance = m_target - start;
+    double dir = distance >= 0.0 ? 1.0 : -1.0;
+    if (std::fabs(distance) <= EPSILON) {
+        dir = startVelocity >= 0.0 ? 1.0 : -1.0;
+    }
+    double d = std::fabs(distance);
+    double v0 = dir * startVelocity;   // 按运动方向归一化的初速度
+
+    // 总位移：初速度 -> 峰值速度vp（升速用加速度上限，降速用减速度上限） -> 0
+    auto travel = [&](double vp) {
+        double first = velocityChangeDistance(v0, vp, vp >= v0 ? acc : dec, sCurve, jerk);
+        return first + velocityChangeDistance(vp, 0.0, dec, sCurve, jerk);
+    };
+
+    double vLow = qMin(qMax(v0, 0.0), vmax);
+    if (v0 < -EPSILON || travel(vLow) > d + EPSILON) {
+        // 初速度背离目标或来不及停下：先减速到0，再从停止点规划
+        appendVelocityChange(-startVelocity, dec, sCurve, jerk);
+        double stopPosition = m_endPosition;
+        double stopTime = m_duration;
+
+        TrajectoryProfile rest;
+        if (!rest.plan(m_type, stopPosition, 0.0, m_target, m_limits))
+            return false;
+        for (int i = 0; i < rest.m_count && m_count < MAX_SEGMENTS; i++) {
+            Segment segment = rest.m_segments[i];
+            segment.t0 += stopTime;
+            m_segments[m_count++] = segment;
+        }
+        m_duration = stopTime + rest.m_duration;
+        m_endPosition = rest.m_endPosition;
+        m_endVelocity = 0.0;
+        return true;
+    }
+
+    double vPeak;
+    double cruise = 0.0;
+    if (travel(vmax) <= d) {
+        vPeak = vmax;
+        cruise = (d - travel(vmax)) / vmax;
+    } else {
+        // 位移随峰值速度单调增加，二分求刚好到达目标的峰值速度
+        double lo = vLow;
+        double hi = vmax;
+        for (int i = 0; i < BISECT_ITERATIONS; i++) {
+            double mid = 0.5 * (lo + hi);
+            if (travel(mid) > d)
+                hi = mid;
+            else
+                lo = mid;
+        }
+        vPeak = lo;
+    }
+
+    appendVelocityChange(dir * (vPeak - v0), vPeak >= v0 ? acc : dec, sCurve, jerk);
+    append(cruise, 0.0, 0.0);
+    appendVelocityChange(-dir * vPeak, dec, sCurve, jerk);
+    m_endVelocity = 0.0;
+    return true;
+}
+
+bool TrajectoryProfile::stretchTo(double duration)
+{
+    if (duration <= m_duration + EPSILON || m_duration <= EPSILON)
+        return true;
+
+    // 限制按时间比例缩放：速度/λ、加速度/λ²、加加速度/λ³，从静止出发时时长恰为λ倍
+    const TrajectoryLimits base = m_limits;
+    auto planScaled = [&](double lambda) {
+        TrajectoryLimits scaled = base;
+        // 速度上限不低于初速度，否则会先按缩小后的减速度降速，时长随λ跳变
+        scaled.maxVelocity = std::max(base.maxVelocity / lambda, std::fabs(m_startVelocity));
+        scaled.maxAcceleration = base.maxAcceleration / (lambda * lambda);
+        scaled.maxDeceleration = base.maxDeceleration / (lambda * lambda);
+        scaled.maxJerk = base.maxJerk / (lambda * lambda * lambda);
+        m_limits = scaled;
+        return planFrom(m_start, m_startVelocity);
+    };
+
+    double lambda = duration / m_duration;
+    if (!planScaled(lambda))
+        return false;
+    if (std::fabs(m_startVelocity) <= EPSILON || std::fabs(m_duration - duration) < 1e-6)
+        return true;
+
+    // 带初速度时时长与λ不成正比，二分求解
+    double lo = 1.0;
+    double hi = lambda;
+    while (m_duration < duration && hi < 1e6) {
+        lo = hi;
+        hi *= 2.0;
+        if (!planScaled(hi))
+            return false;
+    }
+    for (int i = 0; i < BISECT_ITERATIONS; i++) {
+        double mid = 0.5 * (lo + hi);
+        if (!planScaled(mid))
+            return false;
+        if (m_duration < duration)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    return planScaled(hi);
+}
+
+TrajectoryState TrajectoryProfile::state(double t) const
+{
+    TrajectoryState result;
+    if (m_count == 0 || t >= m_duration) {
+        // 终点直接取目标值，不带二分求解的残差
+        result.position = m_target;
+        result.velocity = 0.0;
+        result.acceleration = 0.0;
+        return result;
+    }
+    if (t < 0.0)
+        t = 0.0;
+
+    int index = m_count - 1;
+    while (index > 0 && m_segments[index].t0 > t)
+        index--;
+    const Segment &segment = m_segments[index];
+    double tau = t - segment.t0;
+    result.position = segment.position + segment.velocity * tau
+            + segment.acceleration * tau * tau / 2.0 + segment.jerk * tau * tau * tau / 6.0;
+    result.velocity = segment.velocity + segment.acceleration * tau + segment.jerk * tau * tau / 2.0;
+    result.acceleration = segment.acceleration + segment.jerk * tau;
+    return result;
+}
+
+TrajectoryPlanner::TrajectoryPlanner(CANSetpointStreamer *streamer)
+    : m_streamer(streamer)
+{
+    for (int i = 0; i < MAX_NODES; i++) {
+        m_axes[i].valid = false;
+        m_axes[i].startUs = 0;
+        m_axes[i].maxSpeed = 0.0f;
+    }
+}
+
+TrajectoryPlanner::~TrajectoryPlanner()
+{
+    // 发送线程在其锁内调用frameAt，移除后不会再访问本对象
+    if (m_streamer)
+        m_streamer->removeSource(this);
+}
+
+void TrajectoryPlanner::setStreamer(CANSetpointStreamer *streamer)
+{
+    if (m_streamer == streamer)
+        return;
+    if (m_streamer)
+        m_streamer->removeSource(this);
+    QMutexLocker locker(&m_mutex);
+    m_streamer = streamer;
+    for (int i = 0; i < MAX_NODES; i++)
+        m_axes[i].valid = false;
+}
+
+void TrajectoryPlanner::startState(uint8_t node, double fallback, qint64 nowUs, double *position, double *velocity) const
+{
+    const Axis &axis = m_axes[node];
+    if (axis.valid) {
+        TrajectoryState current = axis.profile.state((nowUs - axis.startUs) / 1e6);
+        *position = current.position;
+        *velocity = current.velocity;
+    } else {
+        *position = fallback;
+        *velocity = 0.0;
+    }
+}
+
+bool TrajectoryPlanner::move(uint8_t node, double start, double target, TrajectoryProfileType type,
+                             const TrajectoryLimits &limits)
+{
+    AxisMove axisMove;
+    axisMove.node = node;
+    axisMove.start = start;
+    axisMove.target = target;
+    return moveSynchronized(QVector<AxisMove>() << axisMove, type, limits);
+}
+
+bool TrajectoryPlanner::moveSynchronized(const QVector<AxisMove> &moves, TrajectoryProfileType type,
+                                         const TrajectoryLimits &limits)
+{
+    if (moves.isEmpty())
+        return false;
+
+    QVector<TrajectoryProfile> profiles(moves.size());
+    CANSetpointStreamer *streamer;
+    {
+        QMutexLocker locker(&m_mutex);
+        streamer = m_streamer;
+        qint64 nowUs = canMonotonicUs();
+
+        // 先按各自限制规划，取最长时长作为同步时长
+        double longest = 0.0;
+        for (int i = 0; i < moves.size(); i++) {
+            double position, velocity;
+            startState(moves[i].node & 0x7F, moves[i].start, nowUs, &position, &velocity);
+            if (!profiles[i].plan(type, position, velocity, moves[i].target, limits)) {
+                qDebug() << "轨迹规划失败 - 节点" << (moves[i].node & 0x7F) << "限制参数无效";
+                return false;
+            }
+            longest = qMax(longest, profiles[i].duration());
+        }
+        if (moves.size() > 1) {
+            for (TrajectoryProfile &profile : profiles) {
+                if (!profile.stretchTo(longest))
+                    return false;
+            }
+        }
+
+        for (int i = 0; i < moves.size(); i++) {
+            Axis &axis = m_axes[moves[i].node & 0x7F];
+            axis.profile = profiles[i];
+            axis.startUs = nowUs;
+            axis.maxSpeed = static_cast<float>(limits.maxVelocity);
+            axis.valid = true;
+        }
+        qDebug() << "轨迹规划 -" << moves.size() << "轴，"
+                 << (type == TrajectorySCurve ? "S曲线" : "梯形") << "，时长" << longest << "s";
+    }
+
+    // 在本规划器的锁外接入发送线程（发送线程持有自己的锁调用frameAt）
+    if (streamer) {
+        for (const AxisMove &axisMove : moves)
+            streamer->setSource(axisMove.node & 0x7F, this);
+    }
+    return true;
+}
+
+void TrajectoryPlanner::stop(uint8_t node)
+{
+    CANSetpointStreamer *streamer;
+    {
+        QMutexLocker locker(&m_mutex);
+        m_axes[node & 0x7F].valid = false;
+        streamer = m_streamer;
+    }
+    if (streamer)
+        streamer->removeNode(node & 0x7F);
+}
+
+void TrajectoryPlanner::stopAll()
+{
+    CANSetpointStreamer *streamer;
+    {
+        QMutexLocker locker(&m_mutex);
+        for (int i = 0; i < MAX_NODES; i++)
+            m_axes[i].valid = false;
+        streamer = m_streamer;
+    }
+    if (streamer)
+        streamer->removeSource(this);
+}
+
+bool TrajectoryPlanner::hasTrajectory(uint8_t node) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_axes[node & 0x7F].valid;
+}
+
+bool TrajectoryPlanner::isMoving(uint8_t node, qint64 nowUs) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Axis &axis = m_axes[node & 0x7F];
+    return axis.valid && (nowUs - axis.startUs) / 1e6 < axis.profile.duration();
+}
+
+bool TrajectoryPlanner::state(uint8_t node, qint64 nowUs, TrajectoryState *state) const
+{
+    QMutexLocker locker(&m_mutex);
+    const Axis &axis = m_axes[node & 0x7F];
+    if (!axis.valid)
+        return false;
+    *state = axis.profile.state((nowUs - axis.startUs) / 1e6);
+    return true;
+}
+
+bool TrajectoryPlanner::frameAt(uint8_t node, qint64 timeUs, VCI_CAN_OBJ *frame)
+{
+    QMutexLocker locker(&m_mutex);
+    const Axis &axis = m_axes[node & 0x7F];
+    if (!axis.valid)
+        return false;
+    TrajectoryState current = axis.profile.state((timeUs - axis.startUs) / 1e6);
+    *frame = canEncodePosition(node & 0x7F, static_cast<float>(current.position), axis.maxSpeed);
+    return true;
+}
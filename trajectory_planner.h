@@ -0,0 +1,129 @@
+#ifndef TRAJECTORY_PLANNER_H
+#define TRAJECTORY_PLANNER_H
+
+#include <QMutex>
+#include <QPointer>
+#include <QVector>
+#include <cstdint>
+#include "can_setpoint_streamer.h"
+
+enum TrajectoryProfileType {
+    TrajectoryTrapezoidal = 0,  // 梯形速度：加速度阶跃
+    TrajectorySCurve            // S曲线：加加速度受限，加速度连续
+};
+
+struct TrajectoryLimits {
+    double maxVelocity;         // rad/s
+    double maxAcceleration;     // rad/s²
+    double maxDeceleration;     // rad/s²
+    double maxJerk;             // rad/s³，仅S曲线使用
+};
+
+struct TrajectoryState {
+    double position;
+    double velocity;
+    double acceleration;
+};
+
+// 单轴点到点轨迹：由最多MAX_SEGMENTS段恒定加加速度的多项式组成
+// - 终点速度为0，起点可带初速度（起点加速度按0处理，在线重规划时从当前位置和速度接续）
+// - 朝目标方向的初速度来不及在目标前停下、或初速度背离目标时，先减速到0再规划回到目标
+// - 规划只做少量浮点运算（峰值速度二分求解），可在控制周期内在线重规划
+class TrajectoryProfile
+{
+public:
+    static const int MAX_SEGMENTS = 10;
+
+    TrajectoryProfile();
+
+    bool plan(TrajectoryProfileType type, double start, double startVelocity, double target,
+              const TrajectoryLimits &limits);
+    // 时间缩放：加速度等限制按比例缩小，使总时长为duration（不短于当前时长），多轴同步用
+    bool stretchTo(double duration);
+
+    double duration() const { return m_duration; }
+    double target() const { return m_target; }
+    // t为相对起点的秒数，超出时长后保持在目标位置
+    TrajectoryState state(double t) const;
+
+private:
+    struct Segment {
+        double t0;
+        double duration;
+        double position;
+        double velocity;
+        double acceleration;
+        double jerk;
+    };
+
+    void reset(double start, double startVelocity);
+    void append(double duration, double acceleration, double jerk);
+    void appendVelocityChange(double deltaV, double accelLimit, bool sCurve, double jerkLimit);
+    bool planFrom(double start, double startVelocity);
+
+    TrajectoryProfileType m_type;
+    TrajectoryLimits m_limits;
+    double m_start;
+    double m_startVelocity;
+    double m_target;
+    double m_duration;
+    double m_endPosition;
+    double m_endVelocity;
+    Segment m_segments[MAX_SEGMENTS];
+    int m_count;
+};
+
+// 多轴轨迹规划：为每个节点生成位置轨迹，作为设定值来源接入周期发送线程，
+// 发送线程在每个发送周期按截止时间取轨迹上的位置，编码为位置指令（最大转速取规划的速度上限）
+// 多轴同步时各轴同时开始，较短的轴按时间缩放与最长的轴同时到达
+class TrajectoryPlanner : public CANSetpointSource
+{
+public:
+    static const int MAX_NODES = CANSetpointStreamer::MAX_NODES;
+
+    struct AxisMove {
+        uint8_t node;
+        double start;       // 轴当前不在运动时的起点（通常取最新反馈位置）
+        double target;
+    };
+
+    explicit TrajectoryPlanner(CANSetpointStreamer *streamer = nullptr);
+    ~TrajectoryPlanner();
+
+    // 更换发送线程时先从原线程移除本规划器的所有节点
+    void setStreamer(CANSetpointStreamer *streamer);
+
+    // 单轴运动；轴正在运动时从当前位置和速度接续重规划
+    bool move(uint8_t node, double start, double target, TrajectoryProfileType type,
+              const TrajectoryLimits &limits);
+    // 多轴同步运动
+    bool moveSynchronized(const QVector<AxisMove> &moves, TrajectoryProfileType type,
+                          const TrajectoryLimits &limits);
+    // 停止向该节点发送（节点保持在最后一个设定值）
+    void stop(uint8_t node);
+    void stopAll();
+
+    bool hasTrajectory(uint8_t node) const;
+    bool isMoving(uint8_t node, qint64 nowUs) const;
+    bool state(uint8_t node, qint64 nowUs, TrajectoryState *state) const;
+
+    bool frameAt(uint8_t node, qint64 timeUs, VCI_CAN_OBJ *frame) override;
+
+private:
+    struct Axis {
+        bool valid;
+        qint64 startUs;
+        float maxSpeed;
+        TrajectoryProfile profile;
+    };
+
+    // 已持有m_mutex
+    void startState(uint8_t node, double fallback, qint64 nowUs, double *position, double *velocity) const;
+
+    mutable QMutex m_mutex;
+    // 发送线程归CANTxRx所有，可能先于规划器销毁（如退出时先释放g_canTxRx）
+    QPointer<CANSetpointStreamer> m_streamer;
+    Axis m_axes[MAX_NODES];
+};
+
+#endif // TRAJECTORY_PLANNER_H